@@ -0,0 +1,469 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "CitymodelGenerator.h"
+
+#include "ramses-citymodel/Math.h"
+#include "ramses-citymodel/Writer.h"
+
+#include "openctm.h"
+#include "algorithm"
+#include "cmath"
+
+namespace
+{
+    /// Center of the generated city, placed at the start position of the demo camera.
+    const Vector3 CityCenter(7670.0f, 5716.0f, 0.0f);
+
+    /// Width of the streets between the tiles in meters.
+    const float StreetWidth = 12.0f;
+
+    /// Minimum and maximum height of the buildings in meters.
+    const float MinBuildingHeight = 8.0f;
+    const float MaxBuildingHeight = 40.0f;
+
+    /// Size in meters of one facade texture repetition.
+    const float FacadeTextureScale = 30.0f;
+
+    /// Number of triangles of a building box (4 walls and the roof).
+    const uint32_t TrianglesPerBuilding = 10;
+
+    /// Render order of the tile meshes and of the carsor.
+    const uint32_t TileRenderOrder   = 0;
+    const uint32_t CarsorRenderOrder = 2;
+
+    /// Block size of the ASTC_RGBA_12x12 format.
+    const uint32_t AstcBlockSize = 12;
+
+    CTMuint CTMWrite(const void* buffer, CTMuint count, void* userData)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+        std::vector<uint8_t>* data = static_cast<std::vector<uint8_t>*>(userData);
+        data->insert(data->end(), bytes, bytes + count);
+        return count;
+    }
+}
+
+CitymodelGenerator::CitymodelGenerator(const GeneratorArguments& arguments)
+    : m_arguments(arguments)
+{
+    m_columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(m_arguments.m_tileCount))));
+    m_rows    = (m_arguments.m_tileCount + m_columns - 1) / m_columns;
+    m_origin  = CityCenter - Vector3(m_columns * m_arguments.m_tileSize, m_rows * m_arguments.m_tileSize, 0.0f) * 0.5f;
+}
+
+bool CitymodelGenerator::generate()
+{
+    Writer writer;
+    if (!writer.open(m_arguments.m_outputFile, m_arguments.m_legacyFormat))
+    {
+        return false;
+    }
+    writer.setChunkSize(m_arguments.m_chunkSize * 1024);
+
+    m_textures.resize(m_arguments.m_textureVariants);
+    for (uint32_t i = 0; i < m_arguments.m_textureVariants; i++)
+    {
+        if (m_arguments.m_mipMaps)
+        {
+            m_textures[i].reset(new RexTexture2D(EType_Texture2DMipMapResource));
+            // the chain ends at 1 texel or at the number of levels the readers accept
+            for (uint32_t size = m_arguments.m_textureSize / 2;
+                 size > 0 && m_textures[i]->m_mipMaps.size() + 1 < RexTexture2D::MaxMipLevels;
+                 size /= 2)
+            {
+                m_textures[i]->m_mipMaps.emplace_back();
+                createTextureData(i, size, m_textures[i]->m_mipMaps.back());
+            }
+        }
+        else
+        {
+            m_textures[i].reset(new RexTexture2D());
+        }
+        createTextureData(i, m_arguments.m_textureSize, m_textures[i]->m_data);
+    }
+
+    createRoute();
+
+    // The scene ids stay valid, so that the tiles can reference the ground material.
+    std::shared_ptr<RexScene> scene = createScene();
+    writer.setSceneIndex(*scene);
+    if (!writer.write(scene, false))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < m_arguments.m_tileCount; i++)
+    {
+        if (!writer.write(createTile(i)))
+        {
+            return false;
+        }
+    }
+
+    if (!writer.close())
+    {
+        return false;
+    }
+
+    printf("Written %u tiles with %llu triangles, file size %llu bytes: %s\n",
+           m_arguments.m_tileCount,
+           static_cast<unsigned long long>(m_triangleCount),
+           static_cast<unsigned long long>(writer.getFileSize()),
+           m_arguments.m_outputFile.c_str());
+    return true;
+}
+
+std::shared_ptr<RexScene> CitymodelGenerator::createScene()
+{
+    std::shared_ptr<RexScene> scene(new RexScene());
+
+    m_carsorMaterial = CreateUntexturedMaterial(Vector4(0.9f, 0.2f, 0.1f, 1.0f));
+    m_groundMaterial = CreateUntexturedMaterial(Vector4(0.45f, 0.45f, 0.42f, 1.0f));
+    scene->m_materials.push_back(m_carsorMaterial);
+    scene->m_materials.push_back(m_groundMaterial);
+
+    for (uint32_t i = 0; i < m_arguments.m_tileCount; i++)
+    {
+        std::shared_ptr<RexTile> tile(new RexTile());
+        tile->m_boundingBox = getTileBoundingBox(i);
+        scene->m_tiles.push_back(tile);
+    }
+
+    scene->m_carsor = createCarsor();
+
+    for (uint32_t i = 0; i < m_route.size(); i++)
+    {
+        const Vector3& p0        = m_route[i];
+        const Vector3& p1        = m_route[(i + 1) % m_route.size()];
+        const Vector3  direction = (p1 - p0).normalize();
+        const float    length    = (p1 - p0).length();
+        const float    heading   = Math::Rad2Deg(std::atan2(direction.getY(), direction.getX())) - 90.0f;
+
+        for (float d = 0.0f; d < length; d += m_arguments.m_speed)
+        {
+            scene->m_animationKeys.push_back(AnimationPath::Key(p0 + direction * d, Vector3(0.0f, 0.0f, heading)));
+        }
+    }
+
+    const uint32_t nameCount = 16;
+    for (uint32_t i = 0; i < nameCount; i++)
+    {
+        scene->m_names.push_back("Street " + std::to_string(i + 1));
+    }
+
+    for (uint32_t i = 0; i < m_route.size(); i++)
+    {
+        const Vector3& p0        = m_route[i];
+        const Vector3& p1        = m_route[(i + 1) % m_route.size()];
+        const Vector3  direction = (p1 - p0).normalize();
+        const Vector3  center    = (p0 + p1) * 0.5f + Vector3(0.0f, 0.0f, 3.0f);
+        scene->m_namePoints.push_back(center);
+        scene->m_namePoints.push_back(center + direction * 30.0f);
+    }
+
+    for (uint32_t i = 0; i <= m_route.size(); i++)
+    {
+        scene->m_routePoints.push_back(m_route[i % m_route.size()] + Vector3(0.0f, 0.0f, 1.0f));
+    }
+
+    return scene;
+}
+
+std::shared_ptr<RexNode> CitymodelGenerator::createCarsor()
+{
+    MeshData car;
+    AddBox(car, Vector3(-1.0f, -2.25f, 0.0f), Vector3(1.0f, 2.25f, 1.5f), 1.0f);
+
+    std::shared_ptr<RexNode> carsor(new RexNode());
+    carsor->m_children.push_back(CreateMeshNode(static_cast<int32_t>(car.indices.size()),
+                                                m_carsorMaterial,
+                                                CarsorRenderOrder,
+                                                CreateRawGeometryNode(car, EEffect_Untextured)));
+
+    m_triangleCount += car.indices.size() / 3;
+    return carsor;
+}
+
+std::shared_ptr<RexNode> CitymodelGenerator::createTile(uint32_t tileIndex)
+{
+    MeshData buildings;
+    MeshData ground;
+    buildTileMeshes(tileIndex, buildings, ground);
+
+    const uint32_t triangleCount = static_cast<uint32_t>(buildings.indices.size() / 3);
+    const uint32_t meshCount     = std::max(1u, std::min(m_arguments.m_meshesPerTile, triangleCount));
+
+    std::shared_ptr<RexNode> root(new RexNode());
+
+    // Neighbouring meshes alternate between two facade textures, so that materials are shared inside the tile.
+    const uint32_t variants[2] = {(tileIndex * 7) % m_arguments.m_textureVariants,
+                                  (tileIndex * 7 + 1) % m_arguments.m_textureVariants};
+    std::shared_ptr<RexMaterial> materials[2];
+
+    std::shared_ptr<RexGeometryNode> geometry =
+        m_arguments.m_rawGeometry ? CreateRawGeometryNode(buildings, EEffect_Textured) : CreateCTMGeometryNode(buildings);
+
+    for (uint32_t i = 0; i < meshCount; i++)
+    {
+        const uint32_t startTriangle = static_cast<uint32_t>(static_cast<uint64_t>(triangleCount) * i / meshCount);
+        const uint32_t endTriangle   = static_cast<uint32_t>(static_cast<uint64_t>(triangleCount) * (i + 1) / meshCount);
+
+        const uint32_t variant = variants[i % 2];
+        const uint32_t slot    = (variant == variants[0]) ? 0 : 1;
+        if (!materials[slot])
+        {
+            materials[slot] = createTexturedMaterial(variant);
+        }
+
+        root->m_children.push_back(CreateMeshNode(static_cast<int32_t>((endTriangle - startTriangle) * 3),
+                                                  materials[slot],
+                                                  TileRenderOrder,
+                                                  geometry,
+                                                  startTriangle * 3));
+    }
+
+    root->m_children.push_back(CreateMeshNode(static_cast<int32_t>(ground.indices.size()),
+                                              m_groundMaterial,
+                                              TileRenderOrder,
+                                              CreateRawGeometryNode(ground, EEffect_Untextured)));
+
+    m_triangleCount += (buildings.indices.size() + ground.indices.size()) / 3;
+    return root;
+}
+
+std::shared_ptr<RexMeshNode> CitymodelGenerator::CreateMeshNode(int32_t                                 indexCount,
+                                                                const std::shared_ptr<RexMaterial>&     material,
+                                                                uint32_t                                renderOrder,
+                                                                const std::shared_ptr<RexGeometryNode>& geometry,
+                                                                uint32_t                                startIndex)
+{
+    std::shared_ptr<RexMeshNode> mesh(new RexMeshNode());
+    mesh->m_startIndex  = startIndex;
+    mesh->m_indexCount  = indexCount;
+    mesh->m_material    = material;
+    mesh->m_renderOrder = renderOrder;
+    mesh->m_geometry    = geometry;
+    return mesh;
+}
+
+std::shared_ptr<RexMaterial> CitymodelGenerator::CreateUntexturedMaterial(const Vector4& color)
+{
+    std::shared_ptr<RexMaterial> material(new RexMaterial());
+    material->m_diffuseColor = color;
+    material->m_effect       = EEffect_Untextured;
+    return material;
+}
+
+std::shared_ptr<RexMaterial> CitymodelGenerator::createTexturedMaterial(uint32_t variant)
+{
+    std::shared_ptr<RexMaterial> material(new RexMaterial());
+    material->m_diffuseColor = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+    material->m_effect       = EEffect_Textured;
+    material->m_texture      = m_textures[variant];
+    return material;
+}
+
+std::shared_ptr<RexGeometryNode> CitymodelGenerator::CreateCTMGeometryNode(const MeshData& mesh)
+{
+    std::shared_ptr<RexGeometryNode> geometryNode(new RexGeometryNode());
+    geometryNode->m_effect = EEffect_Textured;
+    geometryNode->m_useCTM = true;
+
+    try
+    {
+        CTMexporter ctm;
+        ctm.DefineMesh(mesh.positions.data(),
+                       static_cast<CTMuint>(mesh.positions.size() / 3),
+                       mesh.indices.data(),
+                       static_cast<CTMuint>(mesh.indices.size() / 3),
+                       nullptr);
+        ctm.AddUVMap(mesh.texCoords.data(), "diffuse", nullptr);
+        ctm.CompressionMethod(CTM_METHOD_MG1);
+        ctm.SaveCustom(CTMWrite, &geometryNode->m_ctmData);
+    }
+    catch (const ctm_error& e)
+    {
+        printf("CitymodelGenerator::CreateCTMGeometryNode CTM export failed: %s\n", e.what());
+        exit(1);
+    }
+    return geometryNode;
+}
+
+std::shared_ptr<RexGeometryNode> CitymodelGenerator::CreateRawGeometryNode(const MeshData& mesh, EEffect effect)
+{
+    std::shared_ptr<RexGeometryNode> geometryNode(new RexGeometryNode());
+    geometryNode->m_effect    = effect;
+    geometryNode->m_positions = CreateFloatArray(mesh.positions, 3);
+    if (effect == EEffect_Untextured)
+    {
+        geometryNode->m_normals = CreateFloatArray(mesh.normals, 3);
+    }
+    else
+    {
+        geometryNode->m_texCoords = CreateFloatArray(mesh.texCoords, 2);
+    }
+
+    geometryNode->m_indices.reset(new RexIndexArray());
+    geometryNode->m_indices->m_data = mesh.indices;
+    return geometryNode;
+}
+
+std::shared_ptr<RexVertexArray> CitymodelGenerator::CreateFloatArray(const std::vector<float>& data, uint32_t components)
+{
+    const EObjectType types[3] = {EType_VertexArrayResource2f, EType_VertexArrayResource3f, EType_VertexArrayResource4f};
+
+    std::shared_ptr<RexVertexArray> array(new RexVertexArray(types[components - 2]));
+    array->m_data = data;
+    return array;
+}
+
+BoundingBox CitymodelGenerator::getTileBoundingBox(uint32_t tileIndex) const
+{
+    const float   tileSize = m_arguments.m_tileSize;
+    const Vector3 min      = m_origin + Vector3((tileIndex % m_columns) * tileSize, (tileIndex / m_columns) * tileSize, 0.0f);
+    return BoundingBox(min, min + Vector3(tileSize, tileSize, MaxBuildingHeight));
+}
+
+void CitymodelGenerator::buildTileMeshes(uint32_t tileIndex, MeshData& buildings, MeshData& ground)
+{
+    std::minstd_rand                      random(m_arguments.m_seed * 7919u + tileIndex + 1u);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    const BoundingBox bbox = getTileBoundingBox(tileIndex);
+    const Vector3&    min  = bbox.getMinimumBoxCorner();
+    const Vector3&    max  = bbox.getMaximumBoxCorner();
+
+    const Vector3 groundPoints[4] = {Vector3(min.getX(), min.getY(), 0.0f),
+                                     Vector3(max.getX(), min.getY(), 0.0f),
+                                     Vector3(max.getX(), max.getY(), 0.0f),
+                                     Vector3(min.getX(), max.getY(), 0.0f)};
+    const float   groundUv[8]     = {0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
+    AddQuad(ground, groundPoints, Vector3(0.0f, 0.0f, 1.0f), groundUv);
+
+    const uint32_t buildingCount = std::max(1u, m_arguments.m_trianglesPerTile / TrianglesPerBuilding);
+    const uint32_t gridSize      = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(buildingCount))));
+    const float    innerSize     = m_arguments.m_tileSize - StreetWidth;
+    const float    cellSize      = innerSize / gridSize;
+
+    for (uint32_t i = 0; i < buildingCount; i++)
+    {
+        const float   width  = cellSize * (0.5f + 0.3f * unit(random));
+        const float   depth  = cellSize * (0.5f + 0.3f * unit(random));
+        const float   height = MinBuildingHeight + (MaxBuildingHeight - MinBuildingHeight) * unit(random);
+        const float   x      = min.getX() + StreetWidth * 0.5f + (i % gridSize) * cellSize + (cellSize - width) * unit(random);
+        const float   y      = min.getY() + StreetWidth * 0.5f + (i / gridSize) * cellSize + (cellSize - depth) * unit(random);
+        AddBox(buildings, Vector3(x, y, 0.0f), Vector3(x + width, y + depth, height), FacadeTextureScale);
+    }
+}
+
+void CitymodelGenerator::AddQuad(MeshData& mesh, const Vector3 (&p)[4], const Vector3& normal, const float (&uv)[8])
+{
+    const uint32_t base = static_cast<uint32_t>(mesh.positions.size() / 3);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        mesh.positions.push_back(p[i].getX());
+        mesh.positions.push_back(p[i].getY());
+        mesh.positions.push_back(p[i].getZ());
+        mesh.normals.push_back(normal.getX());
+        mesh.normals.push_back(normal.getY());
+        mesh.normals.push_back(normal.getZ());
+        mesh.texCoords.push_back(uv[i * 2]);
+        mesh.texCoords.push_back(uv[i * 2 + 1]);
+    }
+
+    const uint32_t indices[6] = {0, 1, 2, 0, 2, 3};
+    for (uint32_t index : indices)
+    {
+        mesh.indices.push_back(base + index);
+    }
+}
+
+void CitymodelGenerator::AddBox(MeshData& mesh, const Vector3& min, const Vector3& max, float texScale)
+{
+    // Ground corners in counter clockwise order, seen from above.
+    const Vector3 corners[4] = {Vector3(min.getX(), min.getY(), min.getZ()),
+                                Vector3(max.getX(), min.getY(), min.getZ()),
+                                Vector3(max.getX(), max.getY(), min.getZ()),
+                                Vector3(min.getX(), max.getY(), min.getZ())};
+    const Vector3 up(0.0f, 0.0f, max.getZ() - min.getZ());
+    const float   v = up.getZ() / texScale;
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        const Vector3& a      = corners[i];
+        const Vector3& b      = corners[(i + 1) % 4];
+        const Vector3  edge   = b - a;
+        const Vector3  normal = Vector3(edge.getY(), -edge.getX(), 0.0f).normalize();
+        const float    u      = edge.length() / texScale;
+
+        const Vector3 points[4] = {a, b, b + up, a + up};
+        const float   uv[8]     = {0.0f, 0.0f, u, 0.0f, u, v, 0.0f, v};
+        AddQuad(mesh, points, normal, uv);
+    }
+
+    const Vector3 roof[4] = {corners[0] + up, corners[1] + up, corners[2] + up, corners[3] + up};
+    const float   roofUv[8] = {0.0f, 0.0f, 0.1f, 0.0f, 0.1f, 0.1f, 0.0f, 0.1f};
+    AddQuad(mesh, roof, Vector3(0.0f, 0.0f, 1.0f), roofUv);
+}
+
+void CitymodelGenerator::createTextureData(uint32_t variant, uint32_t size, std::vector<uint8_t>& data) const
+{
+    const uint32_t blocksX      = (size + AstcBlockSize - 1) / AstcBlockSize;
+    const uint32_t blocksY      = (size + AstcBlockSize - 1) / AstcBlockSize;
+    const uint32_t floorBlocks  = std::max(2u, blocksY / 8);
+    const uint32_t windowBlocks = std::max(2u, blocksX / 8);
+
+    std::minstd_rand                      random(variant + 1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const Vector4 wallColor(0.45f + 0.4f * unit(random), 0.45f + 0.4f * unit(random), 0.4f + 0.4f * unit(random), 1.0f);
+    const Vector4 windowColor(0.1f + 0.1f * unit(random), 0.12f + 0.1f * unit(random), 0.2f + 0.15f * unit(random), 1.0f);
+
+    const uint8_t header[16] = {0x13, 0xAB, 0xA1, 0x5C,
+                                AstcBlockSize, AstcBlockSize, 1,
+                                static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8), static_cast<uint8_t>(size >> 16),
+                                static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8), static_cast<uint8_t>(size >> 16),
+                                1, 0, 0};
+    data.assign(header, header + sizeof(header));
+    data.reserve(sizeof(header) + blocksX * blocksY * 16);
+
+    for (uint32_t y = 0; y < blocksY; y++)
+    {
+        for (uint32_t x = 0; x < blocksX; x++)
+        {
+            const bool     window = (y % floorBlocks) >= floorBlocks / 3 && (x % windowBlocks) >= windowBlocks / 3;
+            const Vector4& color  = window ? windowColor : wallColor;
+
+            // ASTC void-extent block: constant LDR color, given as 4 x UNORM16.
+            const uint8_t block[8] = {0xFC, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+            data.insert(data.end(), block, block + sizeof(block));
+            const float components[4] = {color.getX(), color.getY(), color.getZ(), color.getW()};
+            for (float component : components)
+            {
+                const uint16_t value = static_cast<uint16_t>(component * 65535.0f);
+                data.push_back(static_cast<uint8_t>(value));
+                data.push_back(static_cast<uint8_t>(value >> 8));
+            }
+        }
+    }
+}
+
+void CitymodelGenerator::createRoute()
+{
+    const uint32_t c0 = m_columns / 4;
+    const uint32_t c1 = std::max(c0 + 1, m_columns - m_columns / 4);
+    const uint32_t r0 = m_rows / 4;
+    const uint32_t r1 = std::max(r0 + 1, m_rows - m_rows / 4);
+
+    const float tileSize = m_arguments.m_tileSize;
+    m_route.clear();
+    m_route.push_back(m_origin + Vector3(c0 * tileSize, r0 * tileSize, 0.0f));
+    m_route.push_back(m_origin + Vector3(c1 * tileSize, r0 * tileSize, 0.0f));
+    m_route.push_back(m_origin + Vector3(c1 * tileSize, r1 * tileSize, 0.0f));
+    m_route.push_back(m_origin + Vector3(c0 * tileSize, r1 * tileSize, 0.0f));
+}
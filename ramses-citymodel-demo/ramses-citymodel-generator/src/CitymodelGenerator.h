@@ -0,0 +1,165 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_CITYMODELGENERATOR_H
+#define RAMSES_CITYMODEL_CITYMODELGENERATOR_H
+
+#include "GeneratorArguments.h"
+#include "ramses-citymodel/RexObjects.h"
+
+#include "random"
+#include "vector"
+
+/// Generator for synthetic procedural ".rex" city files.
+/** Writes a grid of tiles with box shaped buildings, textured with ASTC facade textures, together with the carsor,
+ *  an animation path around the city center, street names, name points and route points. The object layout is the
+ *  one parsed by Reader: object 0 is the scene, object i + 1 is the node of tile i. */
+class CitymodelGenerator
+{
+public:
+    /// Constructor.
+    /** @param arguments The generator arguments. */
+    CitymodelGenerator(const GeneratorArguments& arguments);
+
+    /// Generates the file.
+    /** @return "true" on success. */
+    bool generate();
+
+private:
+    /// Effect indices as registered by Citymodel::createEffects().
+    enum EEffect
+    {
+        EEffect_Textured   = 0,
+        EEffect_Untextured = 1
+    };
+
+    /// Vertex and index data of a mesh.
+    struct MeshData
+    {
+        std::vector<float>    positions;
+        std::vector<float>    normals;
+        std::vector<float>    texCoords;
+        std::vector<uint32_t> indices;
+    };
+
+    /// Creates the scene object.
+    /** @return The scene. */
+    std::shared_ptr<RexScene> createScene();
+
+    /// Creates the node object of a tile.
+    /** @param tileIndex Index of the tile.
+     *  @return The root node of the tile. */
+    std::shared_ptr<RexNode> createTile(uint32_t tileIndex);
+
+    /// Creates the carsor node.
+    /** @return The carsor node. */
+    std::shared_ptr<RexNode> createCarsor();
+
+    /// Creates a mesh node with identity transformation.
+    /** @param indexCount Number of indices to draw.
+     *  @param material The material.
+     *  @param renderOrder The render order.
+     *  @param geometry The geometry node.
+     *  @param startIndex First index to draw.
+     *  @return The mesh node. */
+    static std::shared_ptr<RexMeshNode> CreateMeshNode(int32_t                                 indexCount,
+                                                       const std::shared_ptr<RexMaterial>&     material,
+                                                       uint32_t                                renderOrder,
+                                                       const std::shared_ptr<RexGeometryNode>& geometry,
+                                                       uint32_t                                startIndex = 0);
+
+    /// Creates an untextured material.
+    /** @param color The diffuse color.
+     *  @return The material. */
+    static std::shared_ptr<RexMaterial> CreateUntexturedMaterial(const Vector4& color);
+
+    /// Creates a textured material.
+    /** @param variant Index of the facade texture.
+     *  @return The material. */
+    std::shared_ptr<RexMaterial> createTexturedMaterial(uint32_t variant);
+
+    /// Creates a geometry node with CTM compressed positions, texture coordinates and indices.
+    /** @param mesh The mesh data.
+     *  @return The geometry node. */
+    static std::shared_ptr<RexGeometryNode> CreateCTMGeometryNode(const MeshData& mesh);
+
+    /// Creates a geometry node with raw vertex and index array resources.
+    /** @param mesh The mesh data.
+     *  @param effect The effect index.
+     *  @return The geometry node. */
+    static std::shared_ptr<RexGeometryNode> CreateRawGeometryNode(const MeshData& mesh, EEffect effect);
+
+    /// Creates a float array resource.
+    /** @param data The data.
+     *  @param components Number of components per element (2-4).
+     *  @return The array. */
+    static std::shared_ptr<RexVertexArray> CreateFloatArray(const std::vector<float>& data, uint32_t components);
+
+    /// Builds the buildings and the ground of a tile.
+    /** @param tileIndex Index of the tile.
+     *  @param buildings The buildings mesh is returned here.
+     *  @param ground The ground mesh is returned here. */
+    void buildTileMeshes(uint32_t tileIndex, MeshData& buildings, MeshData& ground);
+
+    /// Adds a box to a mesh.
+    /** @param mesh The mesh.
+     *  @param min Minimum corner of the box.
+     *  @param max Maximum corner of the box.
+     *  @param texScale Size in meters of one texture repetition. */
+    static void AddBox(MeshData& mesh, const Vector3& min, const Vector3& max, float texScale);
+
+    /// Adds a quad to a mesh.
+    /** @param mesh The mesh.
+     *  @param p Corner points in counter clockwise order, seen from the front side.
+     *  @param normal The normal.
+     *  @param uv Texture coordinates of the corners. */
+    static void AddQuad(MeshData& mesh, const Vector3 (&p)[4], const Vector3& normal, const float (&uv)[8]);
+
+    /// Creates the ASTC data of a facade texture.
+    /** @param variant Index of the texture.
+     *  @param size Width and height of the texture, smaller for the mip levels.
+     *  @param data The ASTC file data is returned here. */
+    void createTextureData(uint32_t variant, uint32_t size, std::vector<uint8_t>& data) const;
+
+    /// Computes the bounding box of a tile.
+    /** @param tileIndex Index of the tile.
+     *  @return The bounding box. */
+    BoundingBox getTileBoundingBox(uint32_t tileIndex) const;
+
+    /// Computes the route polygon, which is driven by the animation path.
+    void createRoute();
+
+    /// The generator arguments.
+    const GeneratorArguments& m_arguments;
+
+    /// Number of tile columns.
+    uint32_t m_columns = 0;
+
+    /// Number of tile rows.
+    uint32_t m_rows = 0;
+
+    /// Minimum corner of the tile grid.
+    Vector3 m_origin;
+
+    /// Untextured material of the carsor, stored in the scene.
+    std::shared_ptr<RexMaterial> m_carsorMaterial;
+
+    /// Untextured material of the ground, stored in the scene and referenced by all tiles.
+    std::shared_ptr<RexMaterial> m_groundMaterial;
+
+    /// Corner points of the route.
+    std::vector<Vector3> m_route;
+
+    /// The facade textures.
+    std::vector<std::shared_ptr<RexTexture2D>> m_textures;
+
+    /// Number of triangles written.
+    uint64_t m_triangleCount = 0;
+};
+
+#endif
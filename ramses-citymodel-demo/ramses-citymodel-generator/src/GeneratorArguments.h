@@ -0,0 +1,89 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_GENERATORARGUMENTS_H
+#define RAMSES_CITYMODEL_GENERATORARGUMENTS_H
+
+#include "cxxopts.hpp"
+#include "stdint.h"
+#include "string"
+
+/// Command line arguments of the synthetic ".rex" city generator.
+class GeneratorArguments
+{
+public:
+    bool parse(int argc, char* argv[])
+    {
+        try
+        {
+            cxxopts::Options options(argv[0], "Writes a synthetic procedural citymodel \".rex\" file");
+
+            createOptions(options);
+
+            auto result = options.parse(argc, argv);
+
+            if (m_help)
+            {
+                printf("%s\n", options.help({""}).c_str());
+                return false;
+            }
+        } catch (const cxxopts::OptionException& e)
+        {
+            printf("Error parsing options: %s. Use --help to show command line options.\n", e.what());
+            return false;
+        }
+
+        if (m_tileCount == 0 || m_meshesPerTile == 0 || m_textureSize == 0 || m_textureVariants == 0)
+        {
+            printf("Error: tiles, meshesPerTile, textureSize and textureVariants must be greater than 0.\n");
+            return false;
+        }
+        return true;
+    }
+
+    void createOptions(cxxopts::Options& options)
+    {
+        options.add_options()
+            ("help", "Print help", cxxopts::value<bool>(m_help))
+            ("o,output", "Output file", cxxopts::value<std::string>(m_outputFile)->default_value("./ramses-citymodel.rex"))
+            ("tiles", "Number of tiles", cxxopts::value<uint32_t>(m_tileCount)->default_value("256"))
+            ("tileSize", "Edge length of a tile in meters", cxxopts::value<float>(m_tileSize)->default_value("250.0"))
+            ("trianglesPerTile", "Number of triangles per tile", cxxopts::value<uint32_t>(m_trianglesPerTile)->default_value("20000"))
+            ("meshesPerTile", "Number of mesh nodes per tile, sharing one geometry node", cxxopts::value<uint32_t>(m_meshesPerTile)->default_value("4"))
+            ("textureSize", "Width and height of the tile textures in texels", cxxopts::value<uint32_t>(m_textureSize)->default_value("1024"))
+            ("textureVariants", "Number of different facade textures, repeated across the tiles", cxxopts::value<uint32_t>(m_textureVariants)->default_value("8"))
+            ("mipMaps", "Store the facade textures with all mip levels, which older versions cannot read",
+                        cxxopts::value<bool>(m_mipMaps))
+            ("rawGeometry", "Store the tile geometry as raw vertex arrays instead of CTM", cxxopts::value<bool>(m_rawGeometry))
+            ("chunkSize", "Chunk size in KB, objects larger than a chunk are split into chunks, which are decompressed in "
+                          "parallel. 0 stores single LZ4 blocks, readable by older versions.",
+                          cxxopts::value<uint32_t>(m_chunkSize)->default_value("0"))
+            ("legacyFormat", "Write the legacy format without header, checksums and tile index, readable by older versions",
+                             cxxopts::value<bool>(m_legacyFormat))
+            ("speed", "Distance in meters the car drives per animation frame", cxxopts::value<float>(m_speed)->default_value("0.4"))
+            ("seed", "Seed for the random number generator", cxxopts::value<uint32_t>(m_seed)->default_value("1"))
+            ;
+    }
+
+    bool        m_help         = false;
+    bool        m_rawGeometry  = false;
+    bool        m_legacyFormat = false;
+    bool        m_mipMaps      = false;
+    std::string m_outputFile;
+    uint32_t    m_tileCount;
+    float       m_tileSize;
+    uint32_t    m_trianglesPerTile;
+    uint32_t    m_meshesPerTile;
+    uint32_t    m_textureSize;
+    uint32_t    m_textureVariants;
+    uint32_t    m_chunkSize;
+    float       m_speed;
+    uint32_t    m_seed;
+};
+
+#endif
@@ -0,0 +1,286 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "HttpFileServer.h"
+
+#include "algorithm"
+#include "cerrno"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "fcntl.h"
+#include "netinet/in.h"
+#include "sys/socket.h"
+#include "sys/stat.h"
+#include "thread"
+#include "unistd.h"
+#include "vector"
+
+HttpFileServer::~HttpFileServer()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_connectionClosed.wait(lock, [this]() { return m_numberOfConnections == 0; });
+    }
+    if (m_listener >= 0)
+    {
+        close(m_listener);
+    }
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+    }
+}
+
+bool HttpFileServer::run(const std::string& filename, uint16_t port)
+{
+    return open(filename, port) && serve();
+}
+
+bool HttpFileServer::open(const std::string& filename, uint16_t port)
+{
+    m_fd = ::open(filename.c_str(), O_RDONLY);
+    struct stat status;
+    if (m_fd < 0 || fstat(m_fd, &status) != 0)
+    {
+        printf("Could not open %s\n", filename.c_str());
+        return false;
+    }
+    m_size = static_cast<uint64_t>(status.st_size);
+
+    char etag[64];
+    snprintf(etag, sizeof(etag), "\"%llx-%llx\"", static_cast<unsigned long long>(m_size), static_cast<unsigned long long>(status.st_mtime));
+    m_etag = etag;
+
+    m_listener      = socket(AF_INET, SOCK_STREAM, 0);
+    const int reuse = 1;
+    setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (m_listener < 0 || bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(m_listener, 16) != 0)
+    {
+        printf("Could not listen on port %u\n", port);
+        return false;
+    }
+
+    printf("Serving %s (%.1f MB) on http://127.0.0.1:%u/ramses-citymodel.rex, any path returns the file\n",
+           filename.c_str(),
+           static_cast<float>(m_size) / (1024.0f * 1024.0f),
+           port);
+    return true;
+}
+
+bool HttpFileServer::serve()
+{
+    for (;;)
+    {
+        const int connection = accept(m_listener, nullptr, nullptr);
+        if (connection < 0)
+        {
+            if (!m_stopped && (errno == EINTR || errno == ECONNABORTED))
+            {
+                continue;
+            }
+            return m_stopped;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_numberOfConnections++;
+        }
+        std::thread([this, connection]() {
+            serveConnection(connection);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_numberOfConnections--;
+            m_connectionClosed.notify_all();
+        }).detach();
+    }
+}
+
+void HttpFileServer::stop()
+{
+    m_stopped = true;
+    shutdown(m_listener, SHUT_RDWR);
+}
+
+void HttpFileServer::serveConnection(int socket) const
+{
+    std::string received;
+    bool        keepAlive = true;
+    while (keepAlive)
+    {
+        size_t headerEnd = received.find("\r\n\r\n");
+        while (headerEnd == std::string::npos && received.size() < 65536)
+        {
+            char          chunk[4096];
+            const ssize_t n = recv(socket, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            received.append(chunk, static_cast<size_t>(n));
+            headerEnd = received.find("\r\n\r\n");
+        }
+        if (headerEnd == std::string::npos)
+        {
+            break;
+        }
+
+        const std::string request = received.substr(0, headerEnd + 2);
+        received.erase(0, headerEnd + 4);
+        if (!respond(socket, request, keepAlive))
+        {
+            break;
+        }
+    }
+    close(socket);
+}
+
+bool HttpFileServer::respond(int socket, const std::string& request, bool& keepAlive) const
+{
+    char     method[16] = {0};
+    uint32_t minorVersion = 0;
+    if (sscanf(request.c_str(), "%15s %*s HTTP/1.%u", method, &minorVersion) != 2)
+    {
+        keepAlive = false;
+        const char response[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        return Send(socket, response, sizeof(response) - 1);
+    }
+    keepAlive = minorVersion >= 1;
+
+    std::string range;
+    for (size_t start = request.find("\r\n") + 2; start < request.size();)
+    {
+        const size_t end  = request.find("\r\n", start);
+        std::string  line = request.substr(start, end - start);
+        start             = end + 2;
+        std::transform(line.begin(), line.end(), line.begin(), ::tolower);
+        if (line.compare(0, 6, "range:") == 0)
+        {
+            range = line.substr(line.find_first_not_of(' ', 6));
+        }
+        else if (line.compare(0, 11, "connection:") == 0 && line.find("close") != std::string::npos)
+        {
+            keepAlive = false;
+        }
+    }
+
+    const bool head = strcmp(method, "HEAD") == 0;
+    if (!head && strcmp(method, "GET") != 0)
+    {
+        const char response[] = "HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\n\r\n";
+        return Send(socket, response, sizeof(response) - 1);
+    }
+
+    // a single range "bytes=first-last", "bytes=first-" or "bytes=-suffix", other ranges return the whole file
+    uint64_t first   = 0;
+    uint64_t last    = m_size > 0 ? m_size - 1 : 0;
+    bool     partial = false;
+    if (range.compare(0, 6, "bytes=") == 0 && range.find(',') == std::string::npos)
+    {
+        const char*  spec  = range.c_str() + 6;
+        const char*  dash  = strchr(spec, '-');
+        const bool   valid = dash != nullptr && (dash != spec || dash[1] != '\0');
+        if (valid && dash == spec)
+        {
+            const uint64_t suffix = strtoull(dash + 1, nullptr, 10);
+            first                 = m_size > suffix ? m_size - suffix : 0;
+        }
+        else if (valid)
+        {
+            first = strtoull(spec, nullptr, 10);
+            if (dash[1] != '\0')
+            {
+                last = std::min(last, static_cast<uint64_t>(strtoull(dash + 1, nullptr, 10)));
+            }
+        }
+        partial = valid;
+        if (valid && (first >= m_size || first > last))
+        {
+            char response[256];
+            const int size = snprintf(response,
+                                      sizeof(response),
+                                      "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */%llu\r\nContent-Length: 0\r\n\r\n",
+                                      static_cast<unsigned long long>(m_size));
+            return Send(socket, response, static_cast<size_t>(size));
+        }
+    }
+
+    const uint64_t length = m_size > 0 ? last - first + 1 : 0;
+    char           headers[512];
+    int            size = snprintf(headers,
+                        sizeof(headers),
+                        "HTTP/1.1 %s\r\nContent-Type: application/octet-stream\r\nAccept-Ranges: bytes\r\nETag: %s\r\n"
+                        "Content-Length: %llu\r\n",
+                        partial ? "206 Partial Content" : "200 OK",
+                        m_etag.c_str(),
+                        static_cast<unsigned long long>(length));
+    if (partial)
+    {
+        size += snprintf(headers + size,
+                         sizeof(headers) - static_cast<size_t>(size),
+                         "Content-Range: bytes %llu-%llu/%llu\r\n",
+                         static_cast<unsigned long long>(first),
+                         static_cast<unsigned long long>(last),
+                         static_cast<unsigned long long>(m_size));
+    }
+    size += snprintf(headers + size, sizeof(headers) - static_cast<size_t>(size), "%s\r\n", keepAlive ? "" : "Connection: close\r\n");
+    if (!Send(socket, headers, static_cast<size_t>(size)))
+    {
+        return false;
+    }
+    if (head)
+    {
+        return true;
+    }
+
+    std::vector<char> buffer(static_cast<size_t>(std::min<uint64_t>(length, 1024 * 1024)));
+    for (uint64_t position = first; position < first + length;)
+    {
+        const size_t  count = static_cast<size_t>(std::min<uint64_t>(buffer.size(), first + length - position));
+        const ssize_t n     = pread(m_fd, buffer.data(), count, static_cast<off_t>(position));
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0 || !Send(socket, buffer.data(), static_cast<size_t>(n)))
+        {
+            return false;
+        }
+        position += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool HttpFileServer::Send(int socket, const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        const ssize_t n = send(socket, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
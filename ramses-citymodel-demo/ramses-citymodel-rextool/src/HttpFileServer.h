@@ -0,0 +1,91 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_HTTPFILESERVER_H
+#define RAMSES_CITYMODEL_HTTPFILESERVER_H
+
+#include "atomic"
+#include "condition_variable"
+#include "mutex"
+#include "stdint.h"
+#include "string"
+
+/// Minimal HTTP/1.1 server of one file with range requests on the loopback interface.
+/** A local stand-in for the static web server read by HttpTileSource, for trying and testing the demo without one.
+ *  Each connection is served by a thread of its own, so that the concurrent range requests are answered in parallel.
+ *  Every path returns the file. */
+class HttpFileServer
+{
+public:
+    /// Destructor, waits until the clients closed their connections and closes the file.
+    ~HttpFileServer();
+
+    /// Serves a file, until the process is terminated.
+    /** @param filename The file.
+     *  @param port The port on the loopback interface.
+     *  @return "false", when the file could not be opened or the port not be bound. */
+    bool run(const std::string& filename, uint16_t port);
+
+    /// Opens a file and listens on a port, so that clients can connect before serve() is called.
+    /** @param filename The file.
+     *  @param port The port on the loopback interface.
+     *  @return "false", when the file could not be opened or the port not be bound. */
+    bool open(const std::string& filename, uint16_t port);
+
+    /// Accepts connections and serves them, until stop() is called.
+    /** @return "true", when stopped by stop(), "false" on an error. */
+    bool serve();
+
+    /// Stops accepting connections, so that serve() returns. Called from another thread than serve().
+    void stop();
+
+private:
+    /// Answers the requests of a connection, until the client closes it, and closes the socket.
+    /** @param socket The socket of the connection. */
+    void serveConnection(int socket) const;
+
+    /// Answers a request.
+    /** @param socket The socket of the connection.
+     *  @param request The request line and the headers.
+     *  @param keepAlive Returns "false", when the connection is closed after the response.
+     *  @return "true", when the response was sent. */
+    bool respond(int socket, const std::string& request, bool& keepAlive) const;
+
+    /// Sends all bytes.
+    /** @param socket The socket.
+     *  @param data The bytes.
+     *  @param size Number of bytes.
+     *  @return "true" on success. */
+    static bool Send(int socket, const void* data, size_t size);
+
+    /// The file descriptor of the file.
+    int m_fd = -1;
+
+    /// Size of the file in bytes.
+    uint64_t m_size = 0;
+
+    /// ETag of the file, from its size and modification time.
+    std::string m_etag;
+
+    /// The listening socket.
+    int m_listener = -1;
+
+    /// Flag, that stop() was called.
+    std::atomic<bool> m_stopped{false};
+
+    /// Mutex for the number of connections.
+    std::mutex m_mutex;
+
+    /// Condition to signal, that a connection was closed.
+    std::condition_variable m_connectionClosed;
+
+    /// Number of connections being served.
+    uint32_t m_numberOfConnections = 0;
+};
+
+#endif
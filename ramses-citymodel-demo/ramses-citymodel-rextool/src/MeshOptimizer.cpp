@@ -0,0 +1,182 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "MeshOptimizer.h"
+
+#include "algorithm"
+#include "cstring"
+
+uint64_t MeshOptimizer::CountCacheMisses(const uint32_t* indices, uint32_t numberOfIndices, uint32_t numberOfVertices)
+{
+    // a vertex is in the cache, when it was added less than CacheSize misses ago
+    std::vector<uint64_t> addedAt(numberOfVertices, 0);
+    uint64_t              misses = 0;
+    for (uint32_t i = 0; i < numberOfIndices; i++)
+    {
+        const uint32_t vertex = indices[i];
+        if (addedAt[vertex] == 0 || misses - addedAt[vertex] >= CacheSize)
+        {
+            misses++;
+            addedAt[vertex] = misses;
+        }
+    }
+    return misses;
+}
+
+void MeshOptimizer::ReorderTriangles(uint32_t* indices, uint32_t numberOfIndices, uint32_t numberOfVertices)
+{
+    const uint32_t numberOfTriangles = numberOfIndices / 3;
+
+    // triangles of each vertex
+    std::vector<uint32_t> liveTriangles(numberOfVertices, 0);
+    for (uint32_t i = 0; i < numberOfTriangles * 3; i++)
+    {
+        liveTriangles[indices[i]]++;
+    }
+    std::vector<uint32_t> adjacencyOffset(numberOfVertices + 1, 0);
+    for (uint32_t v = 0; v < numberOfVertices; v++)
+    {
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+    }
+    std::vector<uint32_t> adjacency(adjacencyOffset[numberOfVertices]);
+    std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (uint32_t i = 0; i < numberOfTriangles * 3; i++)
+    {
+        adjacency[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<uint32_t> cacheTime(numberOfVertices, 0);
+    std::vector<bool>     emitted(numberOfTriangles, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(numberOfTriangles * 3);
+
+    uint32_t time   = CacheSize + 1;
+    uint32_t cursor = 0;
+    int64_t  fan    = numberOfVertices > 0 ? 0 : -1;
+    while (fan >= 0)
+    {
+        // emit all triangles around the fanning vertex
+        candidates.clear();
+        for (uint32_t a = adjacencyOffset[fan]; a < adjacencyOffset[fan + 1]; a++)
+        {
+            const uint32_t triangle = adjacency[a];
+            if (emitted[triangle])
+            {
+                continue;
+            }
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t vertex = indices[3 * triangle + k];
+                output.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (time - cacheTime[vertex] > CacheSize)
+                {
+                    cacheTime[vertex] = time++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // next fanning vertex: the candidate still in the cache after emitting its triangles, which entered the
+        // cache first
+        fan               = -1;
+        int64_t bestScore = -1;
+        for (uint32_t vertex : candidates)
+        {
+            if (liveTriangles[vertex] == 0)
+            {
+                continue;
+            }
+            int64_t score = 0;
+            if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= CacheSize)
+            {
+                score = time - cacheTime[vertex];
+            }
+            if (score > bestScore)
+            {
+                bestScore = score;
+                fan       = vertex;
+            }
+        }
+
+        // dead end: the most recently used vertex with triangles left, otherwise the next one in input order
+        while (fan < 0 && !deadEnd.empty())
+        {
+            const uint32_t vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[vertex] > 0)
+            {
+                fan = vertex;
+            }
+        }
+        while (fan < 0 && cursor < numberOfVertices)
+        {
+            if (liveTriangles[cursor] > 0)
+            {
+                fan = cursor;
+            }
+            cursor++;
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+uint32_t MeshOptimizer::WeldVertices(const float* attributes, uint32_t stride, uint32_t numberOfVertices, std::vector<uint32_t>& remap)
+{
+    // vertices sorted by their attributes, equal vertices are neighbours then
+    std::vector<uint32_t> order(numberOfVertices);
+    for (uint32_t v = 0; v < numberOfVertices; v++)
+    {
+        order[v] = v;
+    }
+    const size_t rowSize = sizeof(float) * stride;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const int compare = std::memcmp(attributes + static_cast<size_t>(a) * stride, attributes + static_cast<size_t>(b) * stride, rowSize);
+        return compare < 0 || (compare == 0 && a < b);
+    });
+
+    remap.resize(numberOfVertices);
+    uint32_t numberOfUnique = 0;
+    for (uint32_t i = 0; i < numberOfVertices; i++)
+    {
+        const uint32_t vertex = order[i];
+        if (i > 0 && std::memcmp(attributes + static_cast<size_t>(vertex) * stride,
+                                 attributes + static_cast<size_t>(order[i - 1]) * stride,
+                                 rowSize) == 0)
+        {
+            remap[vertex] = remap[order[i - 1]];
+        }
+        else
+        {
+            remap[vertex] = vertex;
+            numberOfUnique++;
+        }
+    }
+    return numberOfUnique;
+}
+
+uint32_t MeshOptimizer::ReorderVertices(uint32_t* indices, uint32_t numberOfIndices, uint32_t numberOfVertices, std::vector<uint32_t>& newIndex)
+{
+    newIndex.assign(numberOfVertices, static_cast<uint32_t>(UnusedVertex));
+    uint32_t numberOfUsed = 0;
+    for (uint32_t i = 0; i < numberOfIndices; i++)
+    {
+        uint32_t& index = newIndex[indices[i]];
+        if (index == UnusedVertex)
+        {
+            index = numberOfUsed++;
+        }
+        indices[i] = index;
+    }
+    return numberOfUsed;
+}
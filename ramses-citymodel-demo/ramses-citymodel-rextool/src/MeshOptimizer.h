@@ -0,0 +1,59 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_MESHOPTIMIZER_H
+#define RAMSES_CITYMODEL_MESHOPTIMIZER_H
+
+#include "stdint.h"
+#include "vector"
+
+/// Offline optimization of indexed triangle meshes for the vertex cache and the vertex fetch of the GPU.
+/** The triangles are reordered with Tipsify (Sander, Nehab, Barczak: "Fast Triangle Reordering for Vertex Locality
+ *  and Reduced Overdraw", 2007), vertices with equal attributes are welded and the vertices are reordered in the order
+ *  of their first use. The vertex cache is simulated as FIFO cache of CacheSize entries on the CPU. */
+class MeshOptimizer
+{
+public:
+    /// Number of entries of the simulated vertex cache, also the cache size Tipsify optimizes for.
+    static const uint32_t CacheSize = 16;
+
+    /// Marks vertices, which are not referenced by any index, in the result of ReorderVertices.
+    static const uint32_t UnusedVertex = 0xffffffff;
+
+    /// Counts the vertex cache misses for drawing the triangles, divided by the number of triangles this is the
+    /// average cache miss ratio (ACMR).
+    /** @param indices The indices, 3 per triangle.
+     *  @param numberOfIndices Number of indices.
+     *  @param numberOfVertices Number of vertices, all indices must be less.
+     *  @return The number of cache misses. */
+    static uint64_t CountCacheMisses(const uint32_t* indices, uint32_t numberOfIndices, uint32_t numberOfVertices);
+
+    /// Reorders the triangles for the vertex cache.
+    /** @param indices The indices, 3 per triangle, reordered in place.
+     *  @param numberOfIndices Number of indices.
+     *  @param numberOfVertices Number of vertices, all indices must be less. */
+    static void ReorderTriangles(uint32_t* indices, uint32_t numberOfIndices, uint32_t numberOfVertices);
+
+    /// Finds vertices with equal attributes.
+    /** @param attributes The attributes of all vertices, stride floats per vertex.
+     *  @param stride Number of floats per vertex.
+     *  @param numberOfVertices Number of vertices.
+     *  @param remap For each vertex the first vertex with equal attributes is returned here.
+     *  @return The number of different vertices. */
+    static uint32_t WeldVertices(const float* attributes, uint32_t stride, uint32_t numberOfVertices, std::vector<uint32_t>& remap);
+
+    /// Renumbers the vertices in the order of their first use by the indices.
+    /** @param indices The indices, renumbered in place.
+     *  @param numberOfIndices Number of indices.
+     *  @param numberOfVertices Number of vertices, all indices must be less.
+     *  @param newIndex For each vertex the new index is returned here, UnusedVertex for unreferenced vertices.
+     *  @return The number of referenced vertices. */
+    static uint32_t ReorderVertices(uint32_t* indices, uint32_t numberOfIndices, uint32_t numberOfVertices, std::vector<uint32_t>& newIndex);
+};
+
+#endif
@@ -0,0 +1,1881 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "RexTool.h"
+#include "HttpFileServer.h"
+#include "MeshOptimizer.h"
+#include "SpaceFillingCurve.h"
+
+#include "ramses-citymodel/AsyncFileReader.h"
+#include "ramses-citymodel/HttpTileSource.h"
+#include "ramses-citymodel/MeshCodec.h"
+#include "ramses-citymodel/TextureCache.h"
+#include "ramses-citymodel/Timer.h"
+
+#include "algorithm"
+#include "cmath"
+#include "cstring"
+#include "fcntl.h"
+#include "map"
+#include "set"
+#include "thread"
+#include "tuple"
+#include "unistd.h"
+
+RexTool::RexTool(const RexToolArguments& arguments)
+    : m_arguments(arguments)
+{
+}
+
+bool RexTool::run()
+{
+    if (m_arguments.m_roundTrip)
+    {
+        return roundTrip();
+    }
+    if (m_arguments.m_repack)
+    {
+        return repack();
+    }
+    if (m_arguments.m_benchmark)
+    {
+        return benchmark();
+    }
+    if (m_arguments.m_verify)
+    {
+        return verify();
+    }
+    if (m_arguments.m_truncationCheck)
+    {
+        return truncationCheck();
+    }
+    if (m_arguments.m_readBenchmark)
+    {
+        return readBenchmark();
+    }
+    if (m_arguments.m_serve)
+    {
+        return serve();
+    }
+    if (m_arguments.m_httpCheck)
+    {
+        return httpCheck();
+    }
+    if (m_arguments.m_batchStats)
+    {
+        return batchStatistics();
+    }
+    if (m_arguments.m_textureStats)
+    {
+        return textureStatistics();
+    }
+    if (m_arguments.m_arrayStats)
+    {
+        return arrayStatistics();
+    }
+    return false;
+}
+
+bool RexTool::roundTrip()
+{
+    RexObjectReader reader;
+    if (!reader.open(m_arguments.m_inputFile))
+    {
+        return false;
+    }
+
+    // The arrays keep the alignment of the input file, unless converted by --alignArrays or --legacyFormat.
+    const bool inputAlignedArrays = reader.getArchive().hasAlignedArrays();
+    const bool alignedArrays      = !m_arguments.m_legacyFormat && (inputAlignedArrays || m_arguments.m_alignArrays);
+    const bool convertArrays      = alignedArrays != inputAlignedArrays;
+
+    const bool writeOutput = !m_arguments.m_outputFile.empty();
+    Writer     writer;
+    writer.setAlignedArrays(alignedArrays);
+    if (writeOutput && !writer.open(m_arguments.m_outputFile, m_arguments.m_legacyFormat))
+    {
+        return false;
+    }
+
+    const uint32_t       numberOfObjects = reader.getNumberOfObjects();
+    uint32_t             failedObjects   = 0;
+    std::vector<uint8_t> original;
+    std::vector<uint8_t> serialized;
+
+    for (uint32_t i = 0; i < numberOfObjects; i++)
+    {
+        // Object 0 is the scene, its ids are referenced by the tiles.
+        const bool resetIds = i > 0;
+
+        if (!reader.getArchive().read(i, original))
+        {
+            failedObjects++;
+            continue;
+        }
+
+        RexObjectPtr object = reader.read(original, resetIds);
+        if (!object)
+        {
+            printf("Object %u: Could not be parsed\n", i);
+            failedObjects++;
+            continue;
+        }
+
+        if (object->getType() == EType_Scene)
+        {
+            writer.setSceneIndex(static_cast<const RexScene&>(*object));
+        }
+
+        writer.serialize(object, resetIds, serialized);
+        if (!convertArrays && !Compare(i, original, serialized))
+        {
+            failedObjects++;
+        }
+
+        if (writeOutput && !writer.writeData(serialized))
+        {
+            return false;
+        }
+    }
+
+    if (writeOutput)
+    {
+        if (!writer.close())
+        {
+            return false;
+        }
+
+        RexArchive written;
+        if (!written.open(m_arguments.m_outputFile) || written.getNumberOfObjects() != numberOfObjects)
+        {
+            printf("Written file %s has a wrong object table\n", m_arguments.m_outputFile.c_str());
+            return false;
+        }
+
+        if (!convertArrays)
+        {
+            for (uint32_t i = 0; i < numberOfObjects; i++)
+            {
+                if (!reader.getArchive().read(i, original) || !written.read(i, serialized) ||
+                    !Compare(i, original, serialized))
+                {
+                    printf("Object %u: Written file differs\n", i);
+                    failedObjects++;
+                }
+            }
+        }
+        else
+        {
+            // The converted objects differ from the original ones, so the written file gets a round trip of its own.
+            RexObjectReader convertedReader;
+            Writer          convertedWriter;
+            convertedWriter.setAlignedArrays(alignedArrays);
+            if (!convertedReader.open(m_arguments.m_outputFile))
+            {
+                return false;
+            }
+            for (uint32_t i = 0; i < numberOfObjects; i++)
+            {
+                RexObjectPtr object;
+                if (convertedReader.getArchive().read(i, original))
+                {
+                    object = convertedReader.read(original, i > 0);
+                }
+                if (object)
+                {
+                    convertedWriter.serialize(object, i > 0, serialized);
+                }
+                if (!object || !Compare(i, original, serialized))
+                {
+                    printf("Object %u: Written file differs\n", i);
+                    failedObjects++;
+                }
+            }
+        }
+        printf("Written %u objects, file size %llu bytes: %s\n",
+               numberOfObjects,
+               static_cast<unsigned long long>(writer.getFileSize()),
+               m_arguments.m_outputFile.c_str());
+    }
+
+    if (failedObjects > 0)
+    {
+        printf("Round trip FAILED: %u of %u objects differ\n", failedObjects, numberOfObjects);
+        return false;
+    }
+    printf("Round trip OK: %u objects\n", numberOfObjects);
+    return true;
+}
+
+bool RexTool::verify()
+{
+    Timer      timer;
+    RexArchive archive;
+    if (!archive.open(m_arguments.m_inputFile))
+    {
+        printf("Verify FAILED: invalid object table\n");
+        return false;
+    }
+    const float openTime = timer.getTime();
+
+    const uint32_t numberOfObjects = archive.getNumberOfObjects();
+    Vector3        carPosition;
+    Vector3        carRotation;
+    printf("Format version %u, %u objects, %u tiles in the tile index, %s, opened in %.2f ms\n",
+           archive.getFormatVersion(),
+           numberOfObjects,
+           static_cast<uint32_t>(archive.getTileIndex().size()),
+           archive.getStartKey(carPosition, carRotation) ? "with start key" : "no start key",
+           openTime * 1000.0f);
+    if (!archive.hasChecksums())
+    {
+        printf("File has no checksums, only the object table is checked\n");
+    }
+
+    uint32_t failedObjects = 0;
+    uint64_t storedSize    = 0;
+    timer.reset();
+    for (uint32_t i = 0; i < numberOfObjects; i++)
+    {
+        if (!archive.verify(i))
+        {
+            failedObjects++;
+        }
+        storedSize += archive.getObjectReference(i).compressedSize();
+    }
+    const float verifyTime = timer.getTime();
+
+    if (failedObjects > 0)
+    {
+        printf("Verify FAILED: %u of %u objects are corrupt\n", failedObjects, numberOfObjects);
+        return false;
+    }
+    printf("Verify OK: %.1f MB checked in %.1f ms\n", static_cast<float>(storedSize) / (1024.0f * 1024.0f), verifyTime * 1000.0f);
+    return true;
+}
+
+bool RexTool::truncationCheck()
+{
+    RexArchive archive;
+    if (!archive.open(m_arguments.m_inputFile))
+    {
+        printf("Truncation check FAILED: input file is invalid\n");
+        return false;
+    }
+
+    uint64_t       dataEnd         = 0;
+    uint32_t       lastObjectSize  = 0;
+    const uint32_t numberOfObjects = archive.getNumberOfObjects();
+    for (uint32_t i = 0; i < numberOfObjects; i++)
+    {
+        const RexArchive::FileReference& fileRef = archive.getObjectReference(i);
+        if (fileRef.position() + fileRef.compressedSize() > dataEnd)
+        {
+            dataEnd        = fileRef.position() + fileRef.compressedSize();
+            lastObjectSize = fileRef.compressedSize();
+        }
+    }
+    if (lastObjectSize == 0)
+    {
+        printf("Truncation check FAILED: input file has no object data\n");
+        return false;
+    }
+
+    const int input = open(m_arguments.m_inputFile.c_str(), O_RDONLY);
+    if (input < 0)
+    {
+        return false;
+    }
+    const off_t          fileSize = lseek(input, 0, SEEK_END);
+    std::vector<uint8_t> file(static_cast<size_t>(fileSize > 0 ? fileSize : 0));
+    const bool           readSuccess = pread(input, file.data(), file.size(), 0) == static_cast<ssize_t>(file.size());
+    close(input);
+    if (!readSuccess)
+    {
+        return false;
+    }
+
+    // the end of the object data is cut off, while the table is kept, so the last object exceeds the object data
+    const uint32_t cuts[]         = {1, lastObjectSize / 2, lastObjectSize};
+    uint32_t       acceptedCopies = 0;
+    for (uint32_t cut : cuts)
+    {
+        if (cut == 0)
+        {
+            continue;
+        }
+        const int output = open(m_arguments.m_outputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (output < 0)
+        {
+            printf("Truncation check FAILED: could not write %s\n", m_arguments.m_outputFile.c_str());
+            return false;
+        }
+        const size_t keptData     = static_cast<size_t>(dataEnd - cut);
+        const size_t tableSize    = file.size() - static_cast<size_t>(dataEnd);
+        const bool   writeSuccess = write(output, file.data(), keptData) == static_cast<ssize_t>(keptData) &&
+                                  write(output, file.data() + dataEnd, tableSize) == static_cast<ssize_t>(tableSize);
+        close(output);
+        if (!writeSuccess)
+        {
+            printf("Truncation check FAILED: could not write %s\n", m_arguments.m_outputFile.c_str());
+            return false;
+        }
+
+        RexArchive truncated;
+        if (truncated.open(m_arguments.m_outputFile))
+        {
+            printf("Copy with %u bytes of object data cut off was accepted\n", cut);
+            acceptedCopies++;
+        }
+    }
+    unlink(m_arguments.m_outputFile.c_str());
+
+    if (acceptedCopies > 0)
+    {
+        printf("Truncation check FAILED: %u truncated copies accepted\n", acceptedCopies);
+        return false;
+    }
+    printf("Truncation check OK: format version %u, all truncated copies rejected\n", archive.getFormatVersion());
+    return true;
+}
+
+bool RexTool::batchStatistics()
+{
+    RexObjectReader reader;
+    if (!reader.open(m_arguments.m_inputFile))
+    {
+        return false;
+    }
+
+    // The scene is read first, its materials are referenced by the tiles.
+    const uint32_t numberOfObjects = reader.getNumberOfObjects();
+    if (numberOfObjects == 0 || !reader.read(0, false))
+    {
+        printf("Could not read the scene\n");
+        return false;
+    }
+
+    typedef std::tuple<const RexMaterial*, uint32_t, bool, bool, bool> BatchKey;
+
+    uint32_t numberOfTiles      = 0;
+    uint64_t numberOfMeshNodes  = 0;
+    uint64_t numberOfBatches    = 0;
+    uint32_t maxMeshNodesOfTile = 0;
+    uint32_t maxBatchesOfTile   = 0;
+    Timer    timer;
+    for (uint32_t i = 1; i < numberOfObjects; i++)
+    {
+        RexObjectPtr object = reader.read(i);
+        if (!object || (object->getType() != EType_Node && object->getType() != EType_MeshNode))
+        {
+            printf("Object %u: Could not be read as tile node\n", i);
+            return false;
+        }
+
+        uint32_t                    meshNodes = 0;
+        std::set<BatchKey>          batches;
+        std::vector<const RexNode*> stack;
+        stack.push_back(static_cast<const RexNode*>(object.get()));
+        while (!stack.empty())
+        {
+            const RexNode* node = stack.back();
+            stack.pop_back();
+            if (node->getType() == EType_MeshNode)
+            {
+                const RexMeshNode& mesh = static_cast<const RexMeshNode&>(*node);
+                if (mesh.m_geometry)
+                {
+                    meshNodes++;
+                    batches.insert(BatchKey(mesh.m_material.get(),
+                                            mesh.m_renderOrder,
+                                            !mesh.m_geometry->m_useCTM && mesh.m_geometry->m_normals,
+                                            mesh.m_geometry->m_useCTM || mesh.m_geometry->m_texCoords,
+                                            mesh.m_geometry->m_texCoords2 != nullptr));
+                }
+            }
+            for (const auto& child : node->m_children)
+            {
+                stack.push_back(child.get());
+            }
+        }
+
+        numberOfTiles++;
+        numberOfMeshNodes += meshNodes;
+        numberOfBatches += batches.size();
+        maxMeshNodesOfTile = std::max(maxMeshNodesOfTile, meshNodes);
+        maxBatchesOfTile   = std::max(maxBatchesOfTile, static_cast<uint32_t>(batches.size()));
+    }
+
+    if (numberOfTiles == 0)
+    {
+        printf("File has no tiles\n");
+        return false;
+    }
+    printf("Tiles: %u read in %.1f ms\n", numberOfTiles, timer.getTime() * 1000.0f);
+    printf("Without merging: %llu mesh nodes, %.1f per tile, at most %u\n",
+           static_cast<unsigned long long>(numberOfMeshNodes),
+           static_cast<float>(numberOfMeshNodes) / numberOfTiles,
+           maxMeshNodesOfTile);
+    printf("With merging:    %llu mesh nodes, %.1f per tile, at most %u (%.1f times fewer draw calls)\n",
+           static_cast<unsigned long long>(numberOfBatches),
+           static_cast<float>(numberOfBatches) / numberOfTiles,
+           maxBatchesOfTile,
+           numberOfBatches > 0 ? static_cast<float>(numberOfMeshNodes) / numberOfBatches : 0.0f);
+    return true;
+}
+
+bool RexTool::arrayStatistics()
+{
+    RexObjectReader reader;
+    if (!reader.open(m_arguments.m_inputFile))
+    {
+        return false;
+    }
+
+    const uint32_t numberOfObjects = reader.getNumberOfObjects();
+    if (numberOfObjects == 0 || !reader.read(0, false))
+    {
+        printf("Could not read the scene\n");
+        return false;
+    }
+
+    const uint64_t sceneArraySize           = reader.getArraySize();
+    const uint64_t sceneUnalignedArraySize  = reader.getUnalignedArraySize();
+    uint32_t       numberOfGeometryNodes    = 0;
+    uint32_t       numberOfShortGeometries  = 0;
+    uint32_t       numberOfShortIndexArrays = 0;
+    uint64_t       indexSize                = 0;
+    uint64_t       shortIndexSize           = 0;
+    for (uint32_t i = 1; i < numberOfObjects; i++)
+    {
+        RexObjectPtr object = reader.read(i);
+        if (!object)
+        {
+            printf("Object %u: Could not be read\n", i);
+            return false;
+        }
+
+        // the indices of geometry with few enough vertices are created with 16 bit by the demo
+        std::set<RexGeometryNode*> geometryNodes;
+        if (object->getType() == EType_Node || object->getType() == EType_MeshNode)
+        {
+            CollectGeometryNodes(static_cast<const RexNode&>(*object), geometryNodes);
+        }
+        for (const RexGeometryNode* geometry : geometryNodes)
+        {
+            const uint32_t numberOfVertices =
+                geometry->m_useCTM ? geometry->m_ctmVertexCount : (geometry->m_positions ? geometry->m_positions->getCount() : 0);
+            const uint64_t numberOfIndices =
+                geometry->m_useCTM ? geometry->m_ctmIndexCount : (geometry->m_indices ? geometry->m_indices->m_data.size() : 0);
+            const bool shortIndices = numberOfVertices <= RexIndexArray::MaxShortIndexVertices;
+
+            numberOfGeometryNodes++;
+            numberOfShortGeometries += shortIndices ? 1 : 0;
+            numberOfShortIndexArrays += geometry->m_indices && geometry->m_indices->getType() == EType_ShortIndexArrayResource ? 1 : 0;
+            indexSize += numberOfIndices * sizeof(uint32_t);
+            shortIndexSize += numberOfIndices * (shortIndices ? sizeof(uint16_t) : sizeof(uint32_t));
+        }
+    }
+
+    const uint32_t numberOfTiles = numberOfObjects - 1;
+    if (numberOfTiles == 0)
+    {
+        printf("File has no tiles\n");
+        return false;
+    }
+    const uint64_t arraySize          = reader.getArraySize() - sceneArraySize;
+    const uint64_t unalignedArraySize = reader.getUnalignedArraySize() - sceneUnalignedArraySize;
+    printf("Format version %u, %s arrays\n",
+           reader.getArchive().getFormatVersion(),
+           reader.getArchive().hasAlignedArrays() ? "aligned" : "unaligned");
+    printf("Array elements: %.1f KB per tile\n", static_cast<float>(arraySize) / numberOfTiles / 1024.0f);
+    printf("Copied before creating the resources: %.1f KB per tile before, %.1f KB per tile now\n",
+           static_cast<float>(arraySize) / numberOfTiles / 1024.0f,
+           static_cast<float>(unalignedArraySize) / numberOfTiles / 1024.0f);
+    printf("Geometry nodes: %u, %u (%.1f%%) with at most %u vertices for 16 bit indices, %u stored with 16 bit indices\n",
+           numberOfGeometryNodes,
+           numberOfShortGeometries,
+           numberOfGeometryNodes > 0 ? 100.0f * numberOfShortGeometries / numberOfGeometryNodes : 0.0f,
+           RexIndexArray::MaxShortIndexVertices,
+           numberOfShortIndexArrays);
+    printf("Index data: %.1f KB per tile with 32 bit indices, %.1f KB per tile with 16 bit indices where possible\n",
+           static_cast<float>(indexSize) / numberOfTiles / 1024.0f,
+           static_cast<float>(shortIndexSize) / numberOfTiles / 1024.0f);
+    return true;
+}
+
+bool RexTool::textureStatistics()
+{
+    RexObjectReader reader;
+    if (!reader.open(m_arguments.m_inputFile))
+    {
+        return false;
+    }
+
+    const uint32_t numberOfObjects = reader.getNumberOfObjects();
+    if (numberOfObjects == 0 || !reader.read(0, false))
+    {
+        printf("Could not read the scene\n");
+        return false;
+    }
+
+    // A texture is stored once per tile using it, the reader creates it once per tile without the cache.
+    uint32_t                              numberOfTextures = 0;
+    uint64_t                              textureSize      = 0;
+    uint64_t                              uniqueSize       = 0;
+    std::map<TextureCache::Key, uint32_t> contents;
+    for (uint32_t i = 1; i < numberOfObjects; i++)
+    {
+        RexObjectPtr object = reader.read(i);
+        if (!object || (object->getType() != EType_Node && object->getType() != EType_MeshNode))
+        {
+            printf("Object %u: Could not be read as tile node\n", i);
+            return false;
+        }
+
+        std::set<const RexTexture2D*> textures;
+        std::vector<const RexNode*>   stack;
+        stack.push_back(static_cast<const RexNode*>(object.get()));
+        while (!stack.empty())
+        {
+            const RexNode* node = stack.back();
+            stack.pop_back();
+            if (node->getType() == EType_MeshNode)
+            {
+                const RexMeshNode& mesh = static_cast<const RexMeshNode&>(*node);
+                if (mesh.m_material && mesh.m_material->m_texture)
+                {
+                    textures.insert(mesh.m_material->m_texture.get());
+                }
+            }
+            for (const auto& child : node->m_children)
+            {
+                stack.push_back(child.get());
+            }
+        }
+
+        for (const RexTexture2D* texture : textures)
+        {
+            const TextureCache::Key key  = TextureCache::ComputeKey(texture->m_data.data(), texture->m_data.size());
+            uint64_t                size = texture->m_data.size();
+            for (const auto& mipMap : texture->m_mipMaps)
+            {
+                size += mipMap.size();
+            }
+            numberOfTextures++;
+            textureSize += size;
+            if (contents[key]++ == 0)
+            {
+                uniqueSize += size;
+            }
+        }
+    }
+
+    const float megaByte = 1024.0f * 1024.0f;
+    printf("Textures: %u in all tiles, %u with different content\n", numberOfTextures, static_cast<uint32_t>(contents.size()));
+    printf("Texture memory with all tiles loaded: %.1f MB without sharing, %.1f MB with sharing, %.1f MB saved (%.0f%%)\n",
+           static_cast<float>(textureSize) / megaByte,
+           static_cast<float>(uniqueSize) / megaByte,
+           static_cast<float>(textureSize - uniqueSize) / megaByte,
+           textureSize > 0 ? 100.0f * static_cast<float>(textureSize - uniqueSize) / static_cast<float>(textureSize) : 0.0f);
+    return true;
+}
+
+bool RexTool::repack()
+{
+    RexObjectReader reader;
+    if (!reader.open(m_arguments.m_inputFile) || reader.getNumberOfObjects() == 0)
+    {
+        return false;
+    }
+
+    RexObjectPtr object = reader.read(0, false);
+    if (!object || object->getType() != EType_Scene)
+    {
+        printf("Object 0 is not a scene\n");
+        return false;
+    }
+    const RexScene& scene           = static_cast<const RexScene&>(*object);
+    const uint32_t  numberOfObjects = reader.getNumberOfObjects();
+    const uint32_t  numberOfTiles   = static_cast<uint32_t>(scene.m_tiles.size());
+    if (numberOfTiles + 1 > numberOfObjects)
+    {
+        printf("File has %u tiles, but only %u objects\n", numberOfTiles, numberOfObjects);
+        return false;
+    }
+
+    BoundingBox sceneBox;
+    for (const auto& tile : scene.m_tiles)
+    {
+        sceneBox.add(tile->m_boundingBox);
+    }
+    const Vector3 sceneMin    = sceneBox.getMinimumBoxCorner();
+    const Vector3 sceneExtent = sceneBox.getMaximumBoxCorner() - sceneMin;
+    const float   maxCoordinate = static_cast<float>((1u << SpaceFillingCurve::Bits) - 1);
+    const bool    hilbert       = m_arguments.m_order == "hilbert";
+
+    std::vector<std::pair<uint64_t, uint32_t>> tileOrder;
+    for (uint32_t i = 0; i < numberOfTiles; i++)
+    {
+        const BoundingBox& box    = scene.m_tiles[i]->m_boundingBox;
+        const Vector3      center = (box.getMinimumBoxCorner() + box.getMaximumBoxCorner()) * 0.5f - sceneMin;
+        const uint32_t     x = static_cast<uint32_t>(sceneExtent.getX() > 0.0f ? center.getX() / sceneExtent.getX() * maxCoordinate : 0.0f);
+        const uint32_t     y = static_cast<uint32_t>(sceneExtent.getY() > 0.0f ? center.getY() / sceneExtent.getY() * maxCoordinate : 0.0f);
+        const uint64_t     key = hilbert ? SpaceFillingCurve::HilbertIndex(x, y) : SpaceFillingCurve::MortonIndex(x, y);
+        tileOrder.push_back(std::make_pair(key, i + 1));
+    }
+    std::sort(tileOrder.begin(), tileOrder.end());
+
+    // Scene first, then the tiles along the curve, then any further objects in their original order.
+    std::vector<uint32_t> objectOrder;
+    objectOrder.push_back(0);
+    for (const auto& tile : tileOrder)
+    {
+        objectOrder.push_back(tile.second);
+    }
+    for (uint32_t i = numberOfTiles + 1; i < numberOfObjects; i++)
+    {
+        objectOrder.push_back(i);
+    }
+
+    // The object data is copied, so the arrays keep their alignment, which the legacy format does not have.
+    if (m_arguments.m_legacyFormat && reader.getArchive().hasAlignedArrays())
+    {
+        printf("Objects with aligned arrays can not be repacked in the legacy format, use --roundtrip --legacyFormat\n");
+        return false;
+    }
+
+    // Converted objects are written again, with aligned arrays, as they need a reader of this version anyway.
+    const bool convert =
+        m_arguments.m_quantize || m_arguments.m_shortIndices || m_arguments.m_optimizeMeshes || m_arguments.m_encodeMeshes;
+    Writer     writer;
+    writer.setAlignedArrays(convert || reader.getArchive().hasAlignedArrays());
+    if (!writer.open(m_arguments.m_outputFile, m_arguments.m_legacyFormat))
+    {
+        return false;
+    }
+    writer.setSceneIndex(scene);
+
+    writer.setChunkSize(m_arguments.m_chunkSize * 1024);
+    writer.setCodec(m_arguments.m_codec, m_arguments.m_level);
+
+    std::vector<char>      stored;
+    std::vector<uint8_t>   data;
+    std::vector<uint8_t>   serialized;
+    ConversionStatistics   conversion;
+    OptimizationStatistics optimization;
+    EncodingStatistics     encoding;
+    for (uint32_t index : objectOrder)
+    {
+        if (convert)
+        {
+            RexObjectPtr convertedObject = object;
+            if (index > 0)
+            {
+                convertedObject = reader.getArchive().read(index, data) ? reader.read(data, true) : nullptr;
+            }
+            if (!convertedObject)
+            {
+                printf("Object %u: Could not be parsed\n", index);
+                return false;
+            }
+
+            if (convertedObject->getType() == EType_Node || convertedObject->getType() == EType_MeshNode)
+            {
+                // CTM geometry is decoded first, so that it is optimized as well
+                if (m_arguments.m_encodeMeshes)
+                {
+                    EncodeMeshes(static_cast<RexNode&>(*convertedObject), encoding);
+                }
+                // optimized with the float arrays, before they are quantized
+                if (m_arguments.m_optimizeMeshes)
+                {
+                    OptimizeMeshes(static_cast<const RexNode&>(*convertedObject), optimization);
+                }
+                convertArrays(static_cast<const RexNode&>(*convertedObject), conversion);
+            }
+            writer.serialize(convertedObject, index > 0, serialized);
+            if (!writer.writeData(index, serialized))
+            {
+                return false;
+            }
+        }
+        else if (m_arguments.m_recompress)
+        {
+            if (!reader.getArchive().read(index, data) || !writer.writeData(index, data))
+            {
+                return false;
+            }
+        }
+        else if (!reader.getArchive().readStored(index, stored) ||
+                 !writer.writeStoredData(index, reader.getArchive().getObjectReference(index), stored))
+        {
+            return false;
+        }
+    }
+    if (!writer.close())
+    {
+        return false;
+    }
+    printf("Written %u objects with %u tiles in %s order, file size %llu bytes: %s\n",
+           numberOfObjects,
+           numberOfTiles,
+           m_arguments.m_order.c_str(),
+           static_cast<unsigned long long>(writer.getFileSize()),
+           m_arguments.m_outputFile.c_str());
+    if (m_arguments.m_encodeMeshes)
+    {
+        printf("Encoded %u CTM geometry nodes (%u not decodable) with %llu vertices, %.1f MB CTM data as %.1f MB encoded data\n",
+               encoding.numberOfGeometryNodes,
+               encoding.numberOfFailedNodes,
+               static_cast<unsigned long long>(encoding.numberOfVertices),
+               static_cast<double>(encoding.ctmSize) / (1024.0 * 1024.0),
+               static_cast<double>(encoding.encodedSize) / (1024.0 * 1024.0));
+    }
+    if (m_arguments.m_optimizeMeshes)
+    {
+        const float triangles = static_cast<float>(std::max<uint64_t>(optimization.numberOfTriangles, 1));
+        printf("Optimized %u geometry nodes (%u skipped) with %llu triangles, cache size %u\n",
+               optimization.numberOfGeometryNodes,
+               optimization.numberOfSkippedNodes,
+               static_cast<unsigned long long>(optimization.numberOfTriangles),
+               MeshOptimizer::CacheSize);
+        printf("Vertices: %llu before, %llu after\n",
+               static_cast<unsigned long long>(optimization.numberOfVerticesBefore),
+               static_cast<unsigned long long>(optimization.numberOfVerticesAfter));
+        printf("ACMR: %.3f before, %.3f after (vertices transformed per triangle, 0.5 is the optimum)\n",
+               static_cast<float>(optimization.numberOfMissesBefore) / triangles,
+               static_cast<float>(optimization.numberOfMissesAfter) / triangles);
+    }
+    if (m_arguments.m_quantize)
+    {
+        printf("Quantized %u position, %u normal and %u texture coordinate arrays, vertex data %.1f MB instead of %.1f MB\n",
+               conversion.numberOfPositionArrays,
+               conversion.numberOfNormalArrays,
+               conversion.numberOfTexCoordArrays,
+               static_cast<double>(conversion.quantizedSize) / (1024.0 * 1024.0),
+               static_cast<double>(conversion.floatSize) / (1024.0 * 1024.0));
+        printf("Maximum error: positions %.5f m, normals %.4f degrees, texture coordinates %.7f\n",
+               conversion.maxPositionError,
+               conversion.maxNormalError,
+               conversion.maxTexCoordError);
+    }
+    if (m_arguments.m_shortIndices)
+    {
+        printf("Narrowed %u index arrays to 16 bit, index data %.1f MB instead of %.1f MB\n",
+               conversion.numberOfShortIndexArrays,
+               static_cast<double>(conversion.shortIndexSize) / (1024.0 * 1024.0),
+               static_cast<double>(conversion.indexSize) / (1024.0 * 1024.0));
+    }
+
+    RexArchive repacked;
+    if (!repacked.open(m_arguments.m_outputFile))
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> accessOrder;
+    ComputeAccessOrder(scene, m_arguments.m_loadRadius, accessOrder);
+    PrintSeekStatistics("before", reader.getArchive(), accessOrder);
+    PrintSeekStatistics("after ", repacked, accessOrder);
+    return true;
+}
+
+void RexTool::CollectGeometryNodes(const RexNode& node, std::set<RexGeometryNode*>& geometryNodes)
+{
+    std::vector<const RexNode*> stack;
+    stack.push_back(&node);
+    while (!stack.empty())
+    {
+        const RexNode* current = stack.back();
+        stack.pop_back();
+        if (current->getType() == EType_MeshNode && static_cast<const RexMeshNode&>(*current).m_geometry)
+        {
+            geometryNodes.insert(static_cast<const RexMeshNode&>(*current).m_geometry.get());
+        }
+        for (const auto& child : current->m_children)
+        {
+            if (child)
+            {
+                stack.push_back(child.get());
+            }
+        }
+    }
+}
+
+void RexTool::EncodeMeshes(RexNode& node, EncodingStatistics& statistics)
+{
+    std::map<const RexGeometryNode*, std::shared_ptr<RexGeometryNode>> encodedNodes;
+    std::vector<RexNode*>                                               stack;
+    stack.push_back(&node);
+    while (!stack.empty())
+    {
+        RexNode* current = stack.back();
+        stack.pop_back();
+        if (current->getType() == EType_MeshNode)
+        {
+            RexMeshNode& mesh = static_cast<RexMeshNode&>(*current);
+            if (mesh.m_geometry && mesh.m_geometry->m_useCTM)
+            {
+                auto it = encodedNodes.find(mesh.m_geometry.get());
+                if (it == encodedNodes.end())
+                {
+                    std::shared_ptr<RexGeometryNode> encoded = DecodeCTM(*mesh.m_geometry);
+                    if (encoded)
+                    {
+                        std::vector<uint8_t> indices;
+                        MeshCodec::EncodeIndices(encoded->m_indices->m_data.data(), static_cast<uint32_t>(encoded->m_indices->m_data.size()), indices);
+                        statistics.numberOfGeometryNodes++;
+                        statistics.numberOfVertices += encoded->m_positions->getCount();
+                        statistics.ctmSize += mesh.m_geometry->m_ctmData.size();
+                        statistics.encodedSize += indices.size() + sizeof(float) * encoded->m_positions->m_data.size() +
+                                                  (encoded->m_normals ? sizeof(float) * encoded->m_normals->m_data.size() : 0) +
+                                                  (encoded->m_texCoords ? sizeof(float) * encoded->m_texCoords->m_data.size() : 0);
+                    }
+                    else
+                    {
+                        statistics.numberOfFailedNodes++;
+                    }
+                    it = encodedNodes.insert(std::make_pair(mesh.m_geometry.get(), encoded)).first;
+                }
+                if (it->second)
+                {
+                    mesh.m_geometry = it->second;
+                }
+            }
+        }
+        for (const auto& child : current->m_children)
+        {
+            if (child)
+            {
+                stack.push_back(child.get());
+            }
+        }
+    }
+}
+
+std::shared_ptr<RexGeometryNode> RexTool::DecodeCTM(const RexGeometryNode& geometry)
+{
+    CTMStream                        stream = {geometry.m_ctmData.data(), geometry.m_ctmData.data() + geometry.m_ctmData.size()};
+    std::shared_ptr<RexGeometryNode> encoded(new RexGeometryNode(EType_EncodedGeometryNode));
+    encoded->m_effect = geometry.m_effect;
+    try
+    {
+        CTMimporter ctm;
+        ctm.LoadCustom(CTMRead, &stream);
+
+        const uint32_t  numberOfVertices = ctm.GetInteger(CTM_VERTEX_COUNT);
+        const uint32_t  numberOfIndices  = ctm.GetInteger(CTM_TRIANGLE_COUNT) * 3;
+        const CTMfloat* positions        = ctm.GetFloatArray(CTM_VERTICES);
+        const CTMuint*  indices          = ctm.GetIntegerArray(CTM_INDICES);
+
+        encoded->m_positions.reset(new RexVertexArray(EType_VertexArrayResource3f));
+        encoded->m_positions->m_data.assign(positions, positions + 3 * static_cast<size_t>(numberOfVertices));
+        if (ctm.GetInteger(CTM_HAS_NORMALS))
+        {
+            const CTMfloat* normals = ctm.GetFloatArray(CTM_NORMALS);
+            encoded->m_normals.reset(new RexVertexArray(EType_VertexArrayResource3f));
+            encoded->m_normals->m_data.assign(normals, normals + 3 * static_cast<size_t>(numberOfVertices));
+        }
+        if (ctm.GetInteger(CTM_UV_MAP_COUNT) > 0)
+        {
+            const CTMfloat* texCoords = ctm.GetFloatArray(CTM_UV_MAP_1);
+            encoded->m_texCoords.reset(new RexVertexArray(EType_VertexArrayResource2f));
+            encoded->m_texCoords->m_data.assign(texCoords, texCoords + 2 * static_cast<size_t>(numberOfVertices));
+        }
+        encoded->m_indices.reset(new RexIndexArray());
+        encoded->m_indices->m_data.assign(indices, indices + numberOfIndices);
+    }
+    catch (ctm_error& e)
+    {
+        printf("Could not decode CTM data: %s\n", e.what());
+        return nullptr;
+    }
+    return encoded;
+}
+
+CTMuint RexTool::CTMRead(void* buffer, CTMuint count, void* userData)
+{
+    CTMStream*    stream = static_cast<CTMStream*>(userData);
+    const CTMuint n      = static_cast<CTMuint>(std::min<size_t>(count, static_cast<size_t>(stream->end - stream->data)));
+    std::memcpy(buffer, stream->data, n);
+    stream->data += n;
+    return n;
+}
+
+void RexTool::OptimizeMeshes(const RexNode& node, OptimizationStatistics& statistics)
+{
+    // index ranges of the mesh nodes by geometry node
+    std::map<RexGeometryNode*, std::vector<std::pair<uint32_t, uint32_t>>> ranges;
+    std::vector<const RexNode*>                                            stack;
+    stack.push_back(&node);
+    while (!stack.empty())
+    {
+        const RexNode* current = stack.back();
+        stack.pop_back();
+        if (current->getType() == EType_MeshNode)
+        {
+            const RexMeshNode& mesh = static_cast<const RexMeshNode&>(*current);
+            if (mesh.m_geometry)
+            {
+                ranges[mesh.m_geometry.get()].push_back(
+                    std::make_pair(mesh.m_startIndex, static_cast<uint32_t>(std::max(mesh.m_indexCount, 0))));
+            }
+        }
+        for (const auto& child : current->m_children)
+        {
+            if (child)
+            {
+                stack.push_back(child.get());
+            }
+        }
+    }
+
+    // arrays used by more than one geometry node can not be reordered for one of them
+    std::map<const RexObject*, uint32_t> arrayUses;
+    for (const auto& geometry : ranges)
+    {
+        const RexObject* arrays[] = {geometry.first->m_positions.get(),
+                                     geometry.first->m_normals.get(),
+                                     geometry.first->m_texCoords.get(),
+                                     geometry.first->m_texCoords2.get(),
+                                     geometry.first->m_indices.get()};
+        for (const RexObject* array : arrays)
+        {
+            if (array)
+            {
+                arrayUses[array]++;
+            }
+        }
+    }
+
+    for (auto& geometry : ranges)
+    {
+        RexGeometryNode& geometryNode = *geometry.first;
+        if (geometryNode.m_useCTM)
+        {
+            continue;
+        }
+
+        const RexObject* arrays[] = {geometryNode.m_positions.get(),
+                                     geometryNode.m_normals.get(),
+                                     geometryNode.m_texCoords.get(),
+                                     geometryNode.m_texCoords2.get(),
+                                     geometryNode.m_indices.get()};
+        bool shared = false;
+        for (const RexObject* array : arrays)
+        {
+            shared = shared || (array && arrayUses[array] > 1);
+        }
+
+        if (shared || !OptimizeGeometry(geometryNode, geometry.second, statistics))
+        {
+            statistics.numberOfSkippedNodes++;
+        }
+    }
+}
+
+bool RexTool::OptimizeGeometry(RexGeometryNode&                                    geometry,
+                               const std::vector<std::pair<uint32_t, uint32_t>>& ranges,
+                               OptimizationStatistics&                            statistics)
+{
+    if (!geometry.m_positions || !geometry.m_indices)
+    {
+        return false;
+    }
+
+    const uint32_t          numberOfVertices = geometry.m_positions->getCount();
+    std::vector<uint32_t>&  indices          = geometry.m_indices->m_data;
+    const uint32_t          numberOfIndices  = static_cast<uint32_t>(indices.size());
+    RexVertexArray* const   arrays[]         = {geometry.m_positions.get(),
+                                                geometry.m_normals.get(),
+                                                geometry.m_texCoords.get(),
+                                                geometry.m_texCoords2.get()};
+
+    uint32_t stride = 0;
+    for (const RexVertexArray* array : arrays)
+    {
+        if (array && array->getCount() != numberOfVertices)
+        {
+            return false;
+        }
+        stride += array ? array->getComponents() : 0;
+    }
+    for (uint32_t index : indices)
+    {
+        if (index >= numberOfVertices)
+        {
+            return false;
+        }
+    }
+
+    // the triangles are reordered within the range of each mesh node, ranges used by several mesh nodes once
+    std::vector<std::pair<uint32_t, uint32_t>> sortedRanges(ranges);
+    std::sort(sortedRanges.begin(), sortedRanges.end());
+    sortedRanges.erase(std::unique(sortedRanges.begin(), sortedRanges.end()), sortedRanges.end());
+    bool reorderTriangles = true;
+    for (size_t i = 0; i < sortedRanges.size(); i++)
+    {
+        const uint64_t end = static_cast<uint64_t>(sortedRanges[i].first) + sortedRanges[i].second;
+        if (sortedRanges[i].second % 3 != 0 || end > numberOfIndices ||
+            (i + 1 < sortedRanges.size() && end > sortedRanges[i + 1].first))
+        {
+            reorderTriangles = false;
+        }
+    }
+
+    statistics.numberOfGeometryNodes++;
+    statistics.numberOfTriangles += numberOfIndices / 3;
+    statistics.numberOfVerticesBefore += numberOfVertices;
+    statistics.numberOfMissesBefore += MeshOptimizer::CountCacheMisses(indices.data(), numberOfIndices, numberOfVertices);
+
+    // vertices with all attributes equal are replaced by the first of them
+    std::vector<float> attributes(static_cast<size_t>(numberOfVertices) * stride);
+    uint32_t           offset = 0;
+    for (const RexVertexArray* array : arrays)
+    {
+        if (!array)
+        {
+            continue;
+        }
+        const uint32_t components = array->getComponents();
+        for (uint32_t v = 0; v < numberOfVertices; v++)
+        {
+            std::copy(&array->m_data[static_cast<size_t>(v) * components],
+                      &array->m_data[static_cast<size_t>(v) * components] + components,
+                      &attributes[static_cast<size_t>(v) * stride + offset]);
+        }
+        offset += components;
+    }
+    std::vector<uint32_t> remap;
+    MeshOptimizer::WeldVertices(attributes.data(), stride, numberOfVertices, remap);
+    for (uint32_t& index : indices)
+    {
+        index = remap[index];
+    }
+
+    if (reorderTriangles)
+    {
+        for (const auto& range : sortedRanges)
+        {
+            MeshOptimizer::ReorderTriangles(&indices[range.first], range.second, numberOfVertices);
+        }
+    }
+
+    std::vector<uint32_t> newIndex;
+    const uint32_t        numberOfUsed = MeshOptimizer::ReorderVertices(indices.data(), numberOfIndices, numberOfVertices, newIndex);
+    for (RexVertexArray* array : arrays)
+    {
+        if (array)
+        {
+            ReorderArray(*array, newIndex, numberOfUsed);
+        }
+    }
+
+    statistics.numberOfVerticesAfter += numberOfUsed;
+    statistics.numberOfMissesAfter += MeshOptimizer::CountCacheMisses(indices.data(), numberOfIndices, numberOfUsed);
+    return true;
+}
+
+void RexTool::ReorderArray(RexVertexArray& array, const std::vector<uint32_t>& newIndex, uint32_t count)
+{
+    const uint32_t     components = array.getComponents();
+    std::vector<float> data(static_cast<size_t>(count) * components);
+    for (size_t v = 0; v < newIndex.size(); v++)
+    {
+        if (newIndex[v] != MeshOptimizer::UnusedVertex)
+        {
+            std::copy(&array.m_data[v * components], &array.m_data[v * components] + components, &data[static_cast<size_t>(newIndex[v]) * components]);
+        }
+    }
+    array.m_data.swap(data);
+
+    if (array.isQuantized())
+    {
+        const uint32_t        quantizedComponents = array.getQuantizedComponents();
+        std::vector<uint16_t> quantized(static_cast<size_t>(count) * quantizedComponents);
+        for (size_t v = 0; v < newIndex.size(); v++)
+        {
+            if (newIndex[v] != MeshOptimizer::UnusedVertex)
+            {
+                std::copy(&array.m_quantized[v * quantizedComponents],
+                          &array.m_quantized[v * quantizedComponents] + quantizedComponents,
+                          &quantized[static_cast<size_t>(newIndex[v]) * quantizedComponents]);
+            }
+        }
+        array.m_quantized.swap(quantized);
+    }
+}
+
+void RexTool::convertArrays(const RexNode& node, ConversionStatistics& statistics) const
+{
+    std::set<RexGeometryNode*> geometryNodes;
+    CollectGeometryNodes(node, geometryNodes);
+
+    ConvertedArrays convertedArrays;
+    for (RexGeometryNode* geometry : geometryNodes)
+    {
+        // the arrays of encoded geometry are stored within the geometry node as floats and 32 bit indices
+        if (geometry->m_useCTM || geometry->getType() == EType_EncodedGeometryNode)
+        {
+            continue;
+        }
+        if (m_arguments.m_shortIndices && geometry->m_positions)
+        {
+            NarrowIndexArray(geometry->m_indices, geometry->m_positions->getCount(), convertedArrays, statistics);
+        }
+        if (m_arguments.m_quantize)
+        {
+            QuantizeArray(geometry->m_positions, EType_QuantizedVertexArrayResource3f, convertedArrays, statistics);
+            QuantizeArray(geometry->m_normals, EType_OctahedralNormalArrayResource, convertedArrays, statistics);
+            QuantizeArray(geometry->m_texCoords, EType_QuantizedVertexArrayResource2f, convertedArrays, statistics);
+        }
+    }
+}
+
+void RexTool::QuantizeArray(std::shared_ptr<RexVertexArray>& array,
+                            EObjectType                      type,
+                            ConvertedArrays&                 convertedArrays,
+                            ConversionStatistics&            statistics)
+{
+    if (!array || array->isQuantized())
+    {
+        return;
+    }
+
+    auto it = convertedArrays.find(array.get());
+    if (it != convertedArrays.end())
+    {
+        array = std::static_pointer_cast<RexVertexArray>(it->second);
+        return;
+    }
+
+    float                           maxError  = 0.0f;
+    std::shared_ptr<RexVertexArray> quantized = RexVertexArray::Quantize(*array, type, maxError);
+    switch (type)
+    {
+    case EType_QuantizedVertexArrayResource3f:
+        statistics.numberOfPositionArrays++;
+        statistics.maxPositionError = std::max(statistics.maxPositionError, maxError);
+        break;
+    case EType_OctahedralNormalArrayResource:
+        statistics.numberOfNormalArrays++;
+        statistics.maxNormalError = std::max(statistics.maxNormalError, maxError);
+        break;
+    default:
+        statistics.numberOfTexCoordArrays++;
+        statistics.maxTexCoordError = std::max(statistics.maxTexCoordError, maxError);
+        break;
+    }
+    statistics.floatSize += array->m_data.size() * sizeof(float);
+    statistics.quantizedSize += quantized->m_quantized.size() * sizeof(uint16_t);
+
+    convertedArrays[array.get()] = quantized;
+    array                        = quantized;
+}
+
+void RexTool::NarrowIndexArray(std::shared_ptr<RexIndexArray>& array,
+                               uint32_t                        numberOfVertices,
+                               ConvertedArrays&                convertedArrays,
+                               ConversionStatistics&           statistics)
+{
+    if (!array || array->getType() == EType_ShortIndexArrayResource)
+    {
+        return;
+    }
+
+    auto it = convertedArrays.find(array.get());
+    if (it != convertedArrays.end())
+    {
+        array = std::static_pointer_cast<RexIndexArray>(it->second);
+        return;
+    }
+
+    statistics.indexSize += array->m_data.size() * sizeof(uint32_t);
+    if (numberOfVertices > RexIndexArray::MaxShortIndexVertices || !array->fitsShortIndices())
+    {
+        statistics.shortIndexSize += array->m_data.size() * sizeof(uint32_t);
+        return;
+    }
+
+    std::shared_ptr<RexIndexArray> shortIndices(new RexIndexArray(EType_ShortIndexArrayResource));
+    shortIndices->m_data = array->m_data;
+    statistics.numberOfShortIndexArrays++;
+    statistics.shortIndexSize += shortIndices->m_data.size() * sizeof(uint16_t);
+
+    convertedArrays[array.get()] = shortIndices;
+    array                        = shortIndices;
+}
+
+bool RexTool::benchmark()
+{
+    RexArchive archive;
+    if (!archive.open(m_arguments.m_inputFile))
+    {
+        return false;
+    }
+
+    const uint32_t                    numberOfObjects = archive.getNumberOfObjects();
+    std::vector<std::vector<uint8_t>> objects(numberOfObjects);
+    uint64_t                          uncompressedSize = 0;
+    for (uint32_t i = 0; i < numberOfObjects; i++)
+    {
+        if (!archive.read(i, objects[i]))
+        {
+            return false;
+        }
+        uncompressedSize += objects[i].size();
+    }
+
+    const float megabyte       = 1024.0f * 1024.0f;
+    const float uncompressedMB = static_cast<float>(uncompressedSize) / megabyte;
+    printf("%u objects, %.1f MB uncompressed, chunk size %u KB, %u decompression threads\n",
+           numberOfObjects,
+           uncompressedMB,
+           m_arguments.m_chunkSize,
+           WorkerPool().getNumberOfThreads() + 1);
+
+    printf("codec    stored MB  ratio  compress MB/s  decompress MB/s");
+    for (float bandwidth : m_arguments.m_ioBandwidth)
+    {
+        printf("  load@%5.0fMB/s", bandwidth);
+    }
+    printf("\n");
+
+    std::vector<std::vector<char>>         stored(numberOfObjects);
+    std::vector<RexArchive::FileReference> references;
+    std::vector<uint8_t>                   decompressed;
+    for (uint32_t c = 0; c < ECodec_NumberOfCodecs; c++)
+    {
+        const ECodec codec = static_cast<ECodec>(c);
+        if (!RexCodec::IsSupported(codec))
+        {
+            printf("%-8s not available in this build\n", RexCodec::GetName(codec));
+            continue;
+        }
+
+        references.clear();
+        uint64_t storedSize = 0;
+        Timer    compressTimer;
+        for (uint32_t i = 0; i < numberOfObjects; i++)
+        {
+            bool chunked = false;
+            if (!RexArchive::Compress(objects[i], codec, m_arguments.m_level, m_arguments.m_chunkSize * 1024, stored[i], chunked))
+            {
+                printf("Object %u: Failed to compress with %s\n", i, RexCodec::GetName(codec));
+                return false;
+            }
+            references.push_back(RexArchive::FileReference(
+                0, static_cast<uint32_t>(stored[i].size()), static_cast<uint32_t>(objects[i].size()), chunked, codec));
+            storedSize += stored[i].size();
+        }
+        const float compressTime = compressTimer.getTime();
+
+        // best of three runs, to reduce the influence of the first touch of the memory
+        float decompressTime = 0.0f;
+        for (uint32_t run = 0; run < 3; run++)
+        {
+            Timer decompressTimer;
+            for (uint32_t i = 0; i < numberOfObjects; i++)
+            {
+                if (!archive.decompress(references[i], stored[i], decompressed) || decompressed != objects[i])
+                {
+                    printf("Object %u: Failed to decompress with %s\n", i, RexCodec::GetName(codec));
+                    return false;
+                }
+            }
+            const float time = decompressTimer.getTime();
+            decompressTime   = run == 0 ? time : std::min(decompressTime, time);
+        }
+
+        const float storedMB = static_cast<float>(storedSize) / megabyte;
+        printf("%-8s %9.1f  %5.2f  %13.1f  %15.1f",
+               RexCodec::GetName(codec),
+               storedMB,
+               storedSize > 0 ? static_cast<float>(uncompressedSize) / static_cast<float>(storedSize) : 0.0f,
+               uncompressedMB / std::max(compressTime, 1e-6f),
+               uncompressedMB / std::max(decompressTime, 1e-6f));
+        for (float bandwidth : m_arguments.m_ioBandwidth)
+        {
+            const float loadTime = storedMB / std::max(bandwidth, 1e-6f) + decompressTime;
+            printf("  %15.1f", uncompressedMB / std::max(loadTime, 1e-6f));
+        }
+        printf("\n");
+    }
+    printf("load = uncompressed MB / (stored MB / bandwidth + decompression time), reading and decompressing not overlapped\n");
+    return benchmarkGeometry();
+}
+
+bool RexTool::readBenchmark()
+{
+    RexObjectReader reader;
+    if (!reader.open(m_arguments.m_inputFile) || reader.getNumberOfObjects() == 0)
+    {
+        return false;
+    }
+
+    RexObjectPtr object = reader.read(0, false);
+    if (!object || object->getType() != EType_Scene)
+    {
+        printf("Object 0 is not a scene\n");
+        return false;
+    }
+
+    std::vector<uint32_t> order;
+    ComputeAccessOrder(static_cast<const RexScene&>(*object), m_arguments.m_loadRadius, order);
+    uint64_t storedSize = 0;
+    for (uint32_t index : order)
+    {
+        storedSize += reader.getArchive().getObjectReference(index).compressedSize();
+    }
+
+    const float megabyte = 1024.0f * 1024.0f;
+    printf("%u tile reads along the animation path, %.1f MB stored, queue depth %u\n",
+           static_cast<uint32_t>(order.size()),
+           static_cast<float>(storedSize) / megabyte,
+           m_arguments.m_readQueueDepth);
+    printf("reads               time ms   MB/s  reads/s  read ops\n");
+
+    const bool ioUring = AsyncFileReader::IsIoUringSupported();
+    if (!ioUring)
+    {
+        printf("io_uring            not available\n");
+    }
+    for (uint32_t mode = 0; mode < 5; mode++)
+    {
+        static const char* const names[] = {"synchronous", "io_uring", "io_uring merged", "pread", "pread merged"};
+        const bool               useIoUring = mode == 1 || mode == 2;
+        const bool               coalesce   = mode == 2 || mode == 4;
+        const uint32_t           queueDepth = mode == 0 ? 0 : m_arguments.m_readQueueDepth;
+        if ((useIoUring && !ioUring) || (mode > 0 && queueDepth == 0))
+        {
+            continue;
+        }
+
+        float    time           = 0.0f;
+        uint32_t readOperations = 0;
+        if (!measureReads(order, queueDepth, useIoUring, coalesce, time, readOperations))
+        {
+            return false;
+        }
+        printf("%-18s %8.1f %6.1f %8.0f %9u\n",
+               names[mode],
+               time * 1000.0f,
+               time > 0.0f ? static_cast<float>(storedSize) / megabyte / time : 0.0f,
+               time > 0.0f ? static_cast<float>(order.size()) / time : 0.0f,
+               readOperations);
+    }
+    printf("merged: tiles read ahead within %u KB of each other are read with a single read operation\n",
+           m_arguments.m_readGapTolerance);
+    return true;
+}
+
+bool RexTool::measureReads(const std::vector<uint32_t>& order,
+                           uint32_t                     queueDepth,
+                           bool                         useIoUring,
+                           bool                         coalesce,
+                           float&                       time,
+                           uint32_t&                    readOperations) const
+{
+    if (!DropPageCache(m_arguments.m_inputFile))
+    {
+        printf("Could not drop the page cache of %s\n", m_arguments.m_inputFile.c_str());
+    }
+
+    Timer      timer;
+    RexArchive archive;
+    archive.setReadQueue(queueDepth, useIoUring);
+    if (coalesce)
+    {
+        archive.setReadCoalescing(m_arguments.m_readGapTolerance * 1024);
+    }
+    else
+    {
+        archive.setReadCoalescing(0, 0);
+    }
+    if (!archive.open(m_arguments.m_inputFile))
+    {
+        return false;
+    }
+
+    // same as the pager of the demo: the tile and the next tiles are read ahead, before the tile is read
+    std::vector<uint32_t> next;
+    std::vector<uint8_t>  data;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        if (queueDepth > 0)
+        {
+            next.assign(order.begin() + i, order.begin() + std::min(order.size(), i + queueDepth));
+            archive.prefetch(next);
+        }
+        if (!archive.read(order[i], data))
+        {
+            return false;
+        }
+    }
+    time           = timer.getTime();
+    readOperations = archive.getNumberOfReadOperations();
+    return true;
+}
+
+bool RexTool::serve()
+{
+    if (m_arguments.m_port == 0 || m_arguments.m_port > 65535)
+    {
+        printf("Invalid port %u\n", m_arguments.m_port);
+        return false;
+    }
+    HttpFileServer server;
+    return server.run(m_arguments.m_inputFile, static_cast<uint16_t>(m_arguments.m_port));
+}
+
+bool RexTool::httpCheck()
+{
+    if (m_arguments.m_port == 0 || m_arguments.m_port > 65535)
+    {
+        printf("Invalid port %u\n", m_arguments.m_port);
+        return false;
+    }
+    RexArchive file;
+    if (!file.open(m_arguments.m_inputFile))
+    {
+        printf("HTTP check FAILED: input file is invalid\n");
+        return false;
+    }
+
+    HttpFileServer server;
+    if (!server.open(m_arguments.m_inputFile, static_cast<uint16_t>(m_arguments.m_port)))
+    {
+        return false;
+    }
+    std::thread serverThread([&server]() { server.serve(); });
+
+    const bool withCache = !m_arguments.m_outputFile.empty();
+    bool       success   = checkHttpReads(file, false);
+    if (success && withCache)
+    {
+        success = checkHttpReads(file, true);
+    }
+
+    server.stop();
+    serverThread.join();
+    if (success)
+    {
+        printf("HTTP check OK: %u objects%s\n", file.getNumberOfObjects(), withCache ? ", read again from the block cache" : "");
+    }
+    return success;
+}
+
+bool RexTool::checkHttpReads(RexArchive& file, bool fromCache)
+{
+    std::unique_ptr<HttpTileSource> source(new HttpTileSource());
+    HttpTileSource&                 http = *source;
+    if (!m_arguments.m_outputFile.empty() && !http.setCache(m_arguments.m_outputFile, static_cast<uint64_t>(64) * 1024 * 1024))
+    {
+        printf("HTTP check FAILED: could not use the cache directory %s\n", m_arguments.m_outputFile.c_str());
+        return false;
+    }
+
+    char url[64];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/ramses-citymodel.rex", m_arguments.m_port);
+    RexArchive archive;
+    archive.setTileSource(std::move(source));
+    archive.setReadQueue(m_arguments.m_readQueueDepth);
+    archive.setVerifyChecksums(true);
+    const uint32_t numberOfObjects = file.getNumberOfObjects();
+    if (!archive.open(url) || archive.getNumberOfObjects() != numberOfObjects)
+    {
+        printf("HTTP check FAILED: could not open %s\n", url);
+        return false;
+    }
+
+    // the objects are read in file order with the next ones read ahead, like the tiles by the pager of the demo
+    std::vector<uint8_t>  data;
+    std::vector<uint8_t>  expected;
+    std::vector<uint32_t> next;
+    for (uint32_t i = 0; i < numberOfObjects; i++)
+    {
+        next.clear();
+        for (uint32_t j = i; j < numberOfObjects && j < i + m_arguments.m_readQueueDepth; j++)
+        {
+            next.push_back(j);
+        }
+        archive.prefetch(next);
+        if (!archive.read(i, data) || !file.read(i, expected) || data != expected)
+        {
+            printf("HTTP check FAILED: object %u differs\n", i);
+            return false;
+        }
+    }
+
+    const HttpTileSourceStatistics statistics = http.getStatistics();
+    printf("%s: %u range requests, %u failed, %u blocks fetched, %u blocks from the block cache\n",
+           fromCache ? "Cached pass" : "First pass",
+           statistics.m_numberOfRequests,
+           statistics.m_numberOfFailedRequests,
+           statistics.m_numberOfFetchedBlocks,
+           statistics.m_numberOfCachedBlocks);
+    if (fromCache && statistics.m_numberOfFetchedBlocks > 0)
+    {
+        printf("HTTP check FAILED: %u blocks fetched again instead of reading them from the cache\n", statistics.m_numberOfFetchedBlocks);
+        return false;
+    }
+    return true;
+}
+
+bool RexTool::DropPageCache(const std::string& filename)
+{
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    const bool success = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return success;
+}
+
+bool RexTool::benchmarkGeometry()
+{
+    RexObjectReader reader;
+    if (!reader.open(m_arguments.m_inputFile))
+    {
+        return false;
+    }
+
+    const uint32_t numberOfObjects = reader.getNumberOfObjects();
+    if (numberOfObjects == 0 || !reader.read(0, false))
+    {
+        printf("Could not read the scene\n");
+        return false;
+    }
+
+    uint32_t              numberOfGeometryNodes = 0;
+    uint32_t              numberOfCTMNodes      = 0;
+    uint64_t              numberOfVertices      = 0;
+    uint64_t              numberOfIndices       = 0;
+    uint64_t              numberOfCTMVertices   = 0;
+    uint64_t              rawSize               = 0;
+    uint64_t              rawStoredSize         = 0;
+    uint64_t              ctmSize               = 0;
+    uint64_t              ctmRawSize            = 0;
+    uint64_t              encodedSize           = 0;
+    uint64_t              encodedStoredSize     = 0;
+    float                 ctmTime               = 0.0f;
+    float                 codecTime             = 0.0f;
+    std::vector<uint8_t>  raw;
+    std::vector<uint8_t>  encoded;
+    std::vector<char>     stored;
+    std::vector<uint32_t> decodedIndices;
+    std::vector<float>    decodedValues;
+    for (uint32_t i = 1; i < numberOfObjects; i++)
+    {
+        RexObjectPtr object = reader.read(i);
+        if (!object || (object->getType() != EType_Node && object->getType() != EType_MeshNode))
+        {
+            printf("Object %u: Could not be read as tile node\n", i);
+            return false;
+        }
+
+        std::set<RexGeometryNode*> geometryNodes;
+        CollectGeometryNodes(static_cast<const RexNode&>(*object), geometryNodes);
+        for (const RexGeometryNode* geometry : geometryNodes)
+        {
+            // the time of OpenCTM includes copying the arrays out of the importer
+            std::shared_ptr<RexGeometryNode> decoded;
+            if (geometry->m_useCTM)
+            {
+                Timer ctmTimer;
+                decoded = DecodeCTM(*geometry);
+                ctmTime += ctmTimer.getTime();
+                if (!decoded)
+                {
+                    printf("Object %u: Could not decode CTM data\n", i);
+                    return false;
+                }
+                numberOfCTMNodes++;
+                numberOfCTMVertices += decoded->m_positions->getCount();
+                ctmSize += geometry->m_ctmData.size();
+                geometry = decoded.get();
+            }
+            if (!geometry->m_positions || !geometry->m_indices)
+            {
+                continue;
+            }
+
+            const uint32_t        vertices = geometry->m_positions->getCount();
+            const uint32_t        indices  = static_cast<uint32_t>(geometry->m_indices->m_data.size());
+            const RexVertexArray* arrays[] = {geometry->m_positions.get(),
+                                              geometry->m_normals.get(),
+                                              geometry->m_texCoords.get(),
+                                              geometry->m_texCoords2.get()};
+
+            // raw: the indices and the float values of all arrays, encoded: the same with MeshCodec
+            raw.assign(reinterpret_cast<const uint8_t*>(geometry->m_indices->m_data.data()),
+                       reinterpret_cast<const uint8_t*>(geometry->m_indices->m_data.data() + indices));
+            encoded.clear();
+            MeshCodec::EncodeIndices(geometry->m_indices->m_data.data(), indices, encoded);
+            const uint32_t indexSize  = static_cast<uint32_t>(encoded.size());
+            uint32_t       components = 0;
+            for (const RexVertexArray* array : arrays)
+            {
+                if (array && array->getCount() == vertices)
+                {
+                    raw.insert(raw.end(),
+                               reinterpret_cast<const uint8_t*>(array->m_data.data()),
+                               reinterpret_cast<const uint8_t*>(array->m_data.data() + array->m_data.size()));
+                    MeshCodec::EncodeVertices(array->m_data.data(), vertices, array->getComponents(), encoded);
+                    components += array->getComponents();
+                }
+            }
+
+            bool chunked = false;
+            if (!RexArchive::Compress(raw, m_arguments.m_codec, m_arguments.m_level, 0, stored, chunked))
+            {
+                return false;
+            }
+            rawStoredSize += stored.size();
+            if (!RexArchive::Compress(encoded, m_arguments.m_codec, m_arguments.m_level, 0, stored, chunked))
+            {
+                return false;
+            }
+            encodedStoredSize += stored.size();
+
+            // best of three runs, the decoded data is compared with the original
+            decodedIndices.resize(indices);
+            decodedValues.resize(static_cast<size_t>(vertices) * components);
+            float decodeTime = 0.0f;
+            for (uint32_t run = 0; run < 3; run++)
+            {
+                Timer decodeTimer;
+                if (!MeshCodec::DecodeIndices(encoded.data(), indexSize, indices, vertices, decodedIndices.data()))
+                {
+                    printf("Object %u: Could not decode the encoded indices\n", i);
+                    return false;
+                }
+                size_t   offset = indexSize;
+                uint32_t value  = 0;
+                for (const RexVertexArray* array : arrays)
+                {
+                    if (array && array->getCount() == vertices)
+                    {
+                        MeshCodec::DecodeVertices(&encoded[offset], vertices, array->getComponents(), &decodedValues[value]);
+                        offset += static_cast<size_t>(MeshCodec::GetEncodedVertexSize(vertices, array->getComponents()));
+                        value += vertices * array->getComponents();
+                    }
+                }
+                const float time = decodeTimer.getTime();
+                decodeTime       = run == 0 ? time : std::min(decodeTime, time);
+            }
+            if (decodedIndices != geometry->m_indices->m_data ||
+                std::memcmp(decodedValues.data(), &raw[sizeof(uint32_t) * indices], sizeof(float) * decodedValues.size()) != 0)
+            {
+                printf("Object %u: Decoded geometry differs\n", i);
+                return false;
+            }
+
+            numberOfGeometryNodes++;
+            numberOfVertices += vertices;
+            numberOfIndices += indices;
+            rawSize += raw.size();
+            ctmRawSize += geometry == decoded.get() ? raw.size() : 0;
+            encodedSize += encoded.size();
+            codecTime += decodeTime;
+        }
+    }
+
+    const double megabyte = 1024.0 * 1024.0;
+    printf("Geometry: %u geometry nodes with %llu vertices and %llu indices, decoded by one thread\n",
+           numberOfGeometryNodes,
+           static_cast<unsigned long long>(numberOfVertices),
+           static_cast<unsigned long long>(numberOfIndices));
+    printf("format      size MB  stored MB  ns/vertex  decode MB/s\n");
+    printf("raw arrays  %7.1f  %9.1f\n", rawSize / megabyte, rawStoredSize / megabyte);
+    printf("mesh codec  %7.1f  %9.1f  %9.1f  %11.1f\n",
+           encodedSize / megabyte,
+           encodedStoredSize / megabyte,
+           numberOfVertices > 0 ? codecTime * 1e9f / static_cast<float>(numberOfVertices) : 0.0f,
+           rawSize / megabyte / std::max(codecTime, 1e-6f));
+    if (numberOfCTMNodes > 0)
+    {
+        printf("CTM         %7s  %9.1f  %9.1f  %11.1f (%u geometry nodes)\n",
+               "",
+               ctmSize / megabyte,
+               ctmTime * 1e9f / static_cast<float>(std::max<uint64_t>(numberOfCTMVertices, 1)),
+               ctmRawSize / megabyte / std::max(ctmTime, 1e-6f),
+               numberOfCTMNodes);
+    }
+    printf("stored = with %s, decode MB/s = raw MB per second\n", RexCodec::GetName(m_arguments.m_codec));
+    return true;
+}
+
+void RexTool::ComputeAccessOrder(const RexScene& scene, float loadRadius, std::vector<uint32_t>& order)
+{
+    const uint32_t    numberOfTiles = static_cast<uint32_t>(scene.m_tiles.size());
+    std::vector<bool> loaded(numberOfTiles, false);
+    const float       unloadRadius = loadRadius * 1.2f;
+    const float       updateDistance = loadRadius * 0.05f;
+
+    std::vector<Vector3>  centers;
+    std::vector<uint32_t> tilesX;
+    for (uint32_t i = 0; i < numberOfTiles; i++)
+    {
+        const BoundingBox& box = scene.m_tiles[i]->m_boundingBox;
+        centers.push_back((box.getMinimumBoxCorner() + box.getMaximumBoxCorner()) * 0.5f);
+        tilesX.push_back(i);
+    }
+    std::stable_sort(tilesX.begin(), tilesX.end(), [&centers](uint32_t a, uint32_t b) {
+        return centers[a].getX() < centers[b].getX();
+    });
+
+    std::vector<uint32_t> cullingOrder;
+    ComputeCullingOrder(centers, tilesX, cullingOrder);
+    std::vector<uint32_t> cullingRank(numberOfTiles, 0);
+    for (uint32_t i = 0; i < cullingOrder.size(); i++)
+    {
+        cullingRank[cullingOrder[i]] = i;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> tilesToLoad;
+    Vector3                                 lastPosition;
+    for (uint32_t k = 0; k < scene.m_animationKeys.size(); k++)
+    {
+        const Vector3& position = scene.m_animationKeys[k].getCarPosition();
+        if (k > 0 && (position - lastPosition).length() < updateDistance)
+        {
+            continue;
+        }
+        lastPosition = position;
+
+        tilesToLoad.clear();
+        for (uint32_t i = 0; i < numberOfTiles; i++)
+        {
+            // Distance in the ground plane from the car to the bounding box.
+            const BoundingBox& box = scene.m_tiles[i]->m_boundingBox;
+            const float dx = std::max(0.0f, std::max(box.getMinimumBoxCorner().getX() - position.getX(), position.getX() - box.getMaximumBoxCorner().getX()));
+            const float dy = std::max(0.0f, std::max(box.getMinimumBoxCorner().getY() - position.getY(), position.getY() - box.getMaximumBoxCorner().getY()));
+            const float distance = std::sqrt(dx * dx + dy * dy);
+
+            if (!loaded[i] && distance <= loadRadius)
+            {
+                tilesToLoad.push_back(std::make_pair(cullingRank[i], i));
+            }
+            else if (loaded[i] && distance > unloadRadius)
+            {
+                loaded[i] = false;
+            }
+        }
+
+        std::sort(tilesToLoad.begin(), tilesToLoad.end());
+        for (const auto& tile : tilesToLoad)
+        {
+            loaded[tile.second] = true;
+            order.push_back(tile.second + 1);
+        }
+    }
+}
+
+void RexTool::ComputeCullingOrder(const std::vector<Vector3>& centers, const std::vector<uint32_t>& tiles, std::vector<uint32_t>& order)
+{
+    if (tiles.empty())
+    {
+        return;
+    }
+
+    // Split at the median X, then each half at its median Y, lower values first.
+    std::vector<uint32_t> halves[2];
+    const float medianX = centers[tiles[(tiles.size() - 1) / 2]].getX();
+    for (uint32_t tile : tiles)
+    {
+        halves[centers[tile].getX() <= medianX ? 0 : 1].push_back(tile);
+    }
+
+    std::vector<uint32_t> children[4];
+    uint32_t              nonEmptyChildren = 0;
+    for (uint32_t h = 0; h < 2; h++)
+    {
+        if (halves[h].empty())
+        {
+            continue;
+        }
+        std::vector<float> y;
+        for (uint32_t tile : halves[h])
+        {
+            y.push_back(centers[tile].getY());
+        }
+        std::sort(y.begin(), y.end());
+        const float medianY = y[(y.size() - 1) / 2];
+        for (uint32_t tile : halves[h])
+        {
+            children[h * 2 + (centers[tile].getY() <= medianY ? 0 : 1)].push_back(tile);
+        }
+        nonEmptyChildren += (children[h * 2].empty() ? 0 : 1) + (children[h * 2 + 1].empty() ? 0 : 1);
+    }
+
+    if (nonEmptyChildren <= 1)
+    {
+        order.insert(order.end(), tiles.begin(), tiles.end());
+        return;
+    }
+    for (const auto& child : children)
+    {
+        ComputeCullingOrder(centers, child, order);
+    }
+}
+
+void RexTool::PrintSeekStatistics(const char* label, const RexArchive& archive, const std::vector<uint32_t>& order)
+{
+    const RexArchive::FileReference& sceneRef = archive.getObjectReference(0);
+
+    uint64_t readPosition = sceneRef.position() + sceneRef.compressedSize();
+    uint64_t seekDistance = 0;
+    uint64_t bytesRead    = 0;
+    uint32_t seeks        = 0;
+    for (uint32_t index : order)
+    {
+        const RexArchive::FileReference& fileRef = archive.getObjectReference(index);
+        const uint64_t distance = fileRef.position() > readPosition ? fileRef.position() - readPosition : readPosition - fileRef.position();
+        if (distance > 0)
+        {
+            seeks++;
+        }
+        seekDistance += distance;
+        bytesRead += fileRef.compressedSize();
+        readPosition = fileRef.position() + fileRef.compressedSize();
+    }
+
+    printf("Seek distance %s: %llu reads, %u seeks, total seek distance %.1f MB, mean %.1f KB per read, %.1f MB read\n",
+           label,
+           static_cast<unsigned long long>(order.size()),
+           seeks,
+           static_cast<double>(seekDistance) / (1024.0 * 1024.0),
+           order.empty() ? 0.0 : static_cast<double>(seekDistance) / 1024.0 / static_cast<double>(order.size()),
+           static_cast<double>(bytesRead) / (1024.0 * 1024.0));
+}
+
+bool RexTool::Compare(uint32_t index, const std::vector<uint8_t>& expected, const std::vector<uint8_t>& actual)
+{
+    const size_t size = std::min(expected.size(), actual.size());
+    for (size_t i = 0; i < size; i++)
+    {
+        if (expected[i] != actual[i])
+        {
+            printf("Object %u: Data differs at byte %llu\n", index, static_cast<unsigned long long>(i));
+            return false;
+        }
+    }
+    if (expected.size() != actual.size())
+    {
+        printf("Object %u: Size %llu differs from expected size %llu\n",
+               index,
+               static_cast<unsigned long long>(actual.size()),
+               static_cast<unsigned long long>(expected.size()));
+        return false;
+    }
+    return true;
+}
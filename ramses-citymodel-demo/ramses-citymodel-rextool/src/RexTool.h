@@ -0,0 +1,294 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_REXTOOL_H
+#define RAMSES_CITYMODEL_REXTOOL_H
+
+#include "RexToolArguments.h"
+
+#include "ramses-citymodel/RexObjectReader.h"
+#include "ramses-citymodel/Writer.h"
+
+#include "map"
+#include "set"
+
+/// Offline tool for checking and converting ".rex" files.
+class RexTool
+{
+public:
+    /// Constructor.
+    /** @param arguments The tool arguments. */
+    RexTool(const RexToolArguments& arguments);
+
+    /// Runs the command given by the arguments.
+    /** @return "true" on success. */
+    bool run();
+
+private:
+    /// Parses and re-serializes all objects of the input file and compares the data.
+    /** When an output file is given, the re-serialized objects are written and the written file is compared as well.
+     *  When the arrays are aligned or unaligned for the output, the written file is checked by a round trip of its
+     *  own instead.
+     *  @return "true", when all objects are unchanged. */
+    bool roundTrip();
+
+    /// Checks the object table and the checksums of all objects of the input file.
+    /** @return "true", when the file is valid. */
+    bool verify();
+
+    /// Writes copies of the input file with the end of the object data cut off and the object table kept to the
+    /// output file, and checks that RexArchive rejects each of them on open.
+    /** @return "true", when all truncated copies are rejected. */
+    bool truncationCheck();
+
+    /// Rewrites the input file with the tiles ordered along a space filling curve of their bounding box centers.
+    /** The object table keeps its order, so that object i + 1 is still the node of tile i. Only the position of the
+     *  object data in the file changes, the stored data is copied without recompression. With --quantize,
+     *  --shortIndices, --optimizeMeshes and --encodeMeshes, the objects are parsed and written with quantized vertex
+     *  arrays, 16 bit indices, vertex cache optimized geometry and CTM geometry converted to MeshCodec instead.
+     *  @return "true" on success. */
+    bool repack();
+
+    /// Recompresses all objects in memory with each available codec and prints the compression ratio, the
+    /// decompression speed and the resulting load throughput.
+    /** The load throughput of a codec is the uncompressed size divided by the time for reading the stored data with
+     *  the given storage bandwidth plus the time for decompressing it, so it shows which codec is the best for slow
+     *  and for fast storage.
+     *  @return "true" on success. */
+    bool benchmark();
+
+    /// Decodes the geometry nodes of all tiles with OpenCTM and with MeshCodec and prints the decoding speed of one
+    /// thread and the stored sizes.
+    /** CTM geometry nodes are decoded with OpenCTM and encoded with MeshCodec, the other geometry nodes are only
+     *  encoded with MeshCodec. The stored sizes are those of the --codec of the objects.
+     *  @return "true" on success. */
+    bool benchmarkGeometry();
+
+    /// Reads the tile objects in the order of the animation path from a cold page cache, synchronously and with the
+    /// read queue of RexArchive, and prints the throughput and the number of read operations of each.
+    /** The tiles are read and decompressed like by the pager of the demo, with the next --readQueueDepth tiles read
+     *  ahead, with io_uring when available and with pread, each with and without merging the reads of tiles stored
+     *  near each other.
+     *  @return "true" on success. */
+    bool readBenchmark();
+
+    /// Serves the input file over HTTP on the loopback interface with HttpFileServer, until terminated.
+    /** @return "false", when the server could not be started. */
+    bool serve();
+
+    /// Serves the input file with HttpFileServer and reads all objects through HttpTileSource, as the demo does with
+    /// --filePath http://..., and compares them with the file.
+    /** With an output directory, the fetched blocks are cached there and the objects are read a second time, which
+     *  must not fetch any block from the server.
+     *  @return "true", when all objects are unchanged. */
+    bool httpCheck();
+
+    /// Reads all objects of the input file from the server started by httpCheck() and compares them with the file.
+    /** @param file The input file.
+     *  @param fromCache "true" for the second pass, which must read all blocks from the cache.
+     *  @return "true", when all objects are unchanged. */
+    bool checkHttpReads(RexArchive& file, bool fromCache);
+
+    /// Reads objects from the input file in the given order and returns the time.
+    /** The pages of the file are dropped from the page cache before.
+     *  @param order The object indices of the reads.
+     *  @param queueDepth Number of objects read ahead, 0 for synchronous reads.
+     *  @param useIoUring "true" for reading ahead with io_uring.
+     *  @param coalesce "true" for merging the reads ahead of objects within --readGapTolerance.
+     *  @param time The time in seconds is returned here.
+     *  @param readOperations The number of read operations is returned here.
+     *  @return "true" on success. */
+    bool measureReads(const std::vector<uint32_t>& order,
+                      uint32_t                     queueDepth,
+                      bool                         useIoUring,
+                      bool                         coalesce,
+                      float&                       time,
+                      uint32_t&                    readOperations) const;
+
+    /// Drops the pages of a file from the page cache, so that it is read from the storage again.
+    /** Only drops unmodified pages, which is enough for a file, which is not written.
+     *  @param filename The file.
+     *  @return "true" on success. */
+    static bool DropPageCache(const std::string& filename);
+
+    /// Counts the mesh nodes of all tiles and the batches, which remain when the demo merges them with --batchMeshes.
+    /** Meshes of a tile are merged, when they have the same material, render order and vertex attributes, same as in
+     *  Reader::batchMeshes. Prints the number of draw calls per tile without and with merging.
+     *  @return "true" on success. */
+    bool batchStatistics();
+
+    /// Counts the textures of all tiles and the textures with different content, which the demo creates, when all
+    /// tiles are loaded.
+    /** Textures are identified by their content, same as in the texture cache of the demo. Prints the texture memory
+     *  without and with sharing.
+     *  @return "true" on success. */
+    bool textureStatistics();
+
+    /// Sums up the vertex and index array elements of all tiles and the elements, which the demo copies before
+    /// creating the RAMSES resources.
+    /** Elements aligned in the object data are passed to RAMSES in place, the others are copied. Before, all elements
+     *  were copied. Prints the bytes copied per tile for both, and the share of the geometry nodes, which have few
+     *  enough vertices for 16 bit indices, with the index memory saved by them.
+     *  @return "true" on success. */
+    bool arrayStatistics();
+
+    /// Computes the order, in which the tile objects are read when driving the animation path.
+    /** Approximates the paging of the demo: tiles get loaded, when their bounding box comes closer to the car than
+     *  the load radius, and unloaded when they are farther away than 1.2 times the load radius. Tiles getting visible
+     *  in the same frame are queued in the traversal order of the culling tree, same as in the demo.
+     *  @param scene The scene.
+     *  @param loadRadius The load radius in meters.
+     *  @param order The object indices of the tile reads are returned here. */
+    static void ComputeAccessOrder(const RexScene& scene, float loadRadius, std::vector<uint32_t>& order);
+
+    /// Computes the traversal order of the tiles in the culling tree, built the same way as in CullingNode.
+    /** @param centers Bounding box centers of all tiles.
+     *  @param tiles Indices of the tiles of the current culling node, sorted by the X coordinate.
+     *  @param order The tile indices in traversal order are appended here. */
+    static void ComputeCullingOrder(const std::vector<Vector3>& centers, const std::vector<uint32_t>& tiles, std::vector<uint32_t>& order);
+
+    /// Prints the seek distances for reading objects from a file in the given order.
+    /** The read position starts behind the scene object, which is read first.
+     *  @param label Label for the output.
+     *  @param archive The file.
+     *  @param order The object indices of the reads. */
+    static void PrintSeekStatistics(const char* label, const RexArchive& archive, const std::vector<uint32_t>& order);
+
+    /// Statistics of converting the arrays with --quantize and --shortIndices.
+    struct ConversionStatistics
+    {
+        uint32_t numberOfPositionArrays   = 0;
+        uint32_t numberOfTexCoordArrays   = 0;
+        uint32_t numberOfNormalArrays     = 0;
+        uint32_t numberOfShortIndexArrays = 0;
+        float    maxPositionError         = 0.0f;
+        float    maxTexCoordError         = 0.0f;
+        float    maxNormalError           = 0.0f;
+        uint64_t floatSize                = 0;
+        uint64_t quantizedSize            = 0;
+        uint64_t indexSize                = 0;
+        uint64_t shortIndexSize           = 0;
+    };
+
+    /// Statistics of optimizing the meshes with --optimizeMeshes.
+    struct OptimizationStatistics
+    {
+        uint32_t numberOfGeometryNodes  = 0;
+        uint32_t numberOfSkippedNodes   = 0;
+        uint64_t numberOfTriangles      = 0;
+        uint64_t numberOfVerticesBefore = 0;
+        uint64_t numberOfVerticesAfter  = 0;
+        uint64_t numberOfMissesBefore   = 0;
+        uint64_t numberOfMissesAfter    = 0;
+    };
+
+    /// Statistics of converting the CTM geometry with --encodeMeshes.
+    struct EncodingStatistics
+    {
+        uint32_t numberOfGeometryNodes = 0;
+        uint32_t numberOfFailedNodes   = 0;
+        uint64_t numberOfVertices      = 0;
+        uint64_t ctmSize               = 0;
+        uint64_t encodedSize           = 0;
+    };
+
+    /// Read position in a CTM stream held in memory.
+    struct CTMStream
+    {
+        const uint8_t* data;
+        const uint8_t* end;
+    };
+
+    /// Map from the arrays to their converted copies, so that shared arrays stay shared.
+    typedef std::map<const RexObject*, RexObjectPtr> ConvertedArrays;
+
+    /// Collects the geometry nodes of the mesh nodes below a node.
+    /** @param node The node.
+     *  @param geometryNodes The geometry nodes are added here. */
+    static void CollectGeometryNodes(const RexNode& node, std::set<RexGeometryNode*>& geometryNodes);
+
+    /// Replaces the CTM geometry nodes of the mesh nodes below a node by EType_EncodedGeometryNode.
+    /** Geometry nodes used by several mesh nodes are converted once. CTM streams which can not be decoded are kept.
+     *  @param node The node.
+     *  @param statistics The converted geometry nodes and their sizes are counted here. */
+    static void EncodeMeshes(RexNode& node, EncodingStatistics& statistics);
+
+    /// Decodes the CTM stream of a geometry node.
+    /** @param geometry The geometry node with the CTM stream.
+     *  @return An EType_EncodedGeometryNode with the decoded arrays and the effect of the geometry node, nullptr when
+     *  the stream can not be decoded. */
+    static std::shared_ptr<RexGeometryNode> DecodeCTM(const RexGeometryNode& geometry);
+
+    /// Callback function for reading a CTM stream from memory.
+    /** @param buffer The destination buffer.
+     *  @param count Number of bytes to read.
+     *  @param userData The CTMStream.
+     *  @return Number of bytes read, less than count at the end of the stream. */
+    static CTMuint CTMRead(void* buffer, CTMuint count, void* userData);
+
+    /// Optimizes the geometry nodes below a node for the vertex cache and the vertex fetch with MeshOptimizer.
+    /** Equal vertices are welded, the triangles of the index range of each mesh node are reordered and the vertices
+     *  are reordered in the order of their first use. Geometry nodes stored as CTM stream and geometry nodes sharing
+     *  arrays with other geometry nodes are skipped, as well as the triangle order of partly overlapping ranges.
+     *  @param node The node.
+     *  @param statistics The vertices and the cache misses before and after are counted here. */
+    static void OptimizeMeshes(const RexNode& node, OptimizationStatistics& statistics);
+
+    /// Optimizes a geometry node for the vertex cache and the vertex fetch.
+    /** @param geometry The geometry node with float or quantized arrays.
+     *  @param ranges Start index and index count of the mesh nodes using the geometry node.
+     *  @param statistics The vertices and the cache misses before and after are counted here.
+     *  @return "false", when the geometry node can not be optimized and is unchanged. */
+    static bool OptimizeGeometry(RexGeometryNode&                                    geometry,
+                                 const std::vector<std::pair<uint32_t, uint32_t>>& ranges,
+                                 OptimizationStatistics&                            statistics);
+
+    /// Reorders the elements of a vertex array.
+    /** @param array The array, the stored values of quantized arrays are reordered as well.
+     *  @param newIndex New index of each element, MeshOptimizer::UnusedVertex for elements to be removed.
+     *  @param count Number of elements remaining. */
+    static void ReorderArray(RexVertexArray& array, const std::vector<uint32_t>& newIndex, uint32_t count);
+
+    /// Converts the arrays of the geometry nodes below a node as selected by --quantize and --shortIndices.
+    /** Geometry nodes stored as CTM stream are kept, the second texture coordinates keep their floats.
+     *  @param node The node.
+     *  @param statistics The converted arrays are counted here. */
+    void convertArrays(const RexNode& node, ConversionStatistics& statistics) const;
+
+    /// Replaces a float vertex array by a quantized array.
+    /** @param array The array, nothing is done for nullptr or quantized arrays.
+     *  @param type The quantized type.
+     *  @param convertedArrays The arrays converted so far for the current object.
+     *  @param statistics The array is counted here. */
+    static void QuantizeArray(std::shared_ptr<RexVertexArray>& array,
+                              EObjectType                      type,
+                              ConvertedArrays&                 convertedArrays,
+                              ConversionStatistics&            statistics);
+
+    /// Replaces an index array by an array with 16 bit indices, when the geometry allows it.
+    /** @param array The array, nothing is done for nullptr or 16 bit arrays.
+     *  @param numberOfVertices Number of vertices of the geometry node.
+     *  @param convertedArrays The arrays converted so far for the current object.
+     *  @param statistics The array is counted here. */
+    static void NarrowIndexArray(std::shared_ptr<RexIndexArray>& array,
+                                 uint32_t                        numberOfVertices,
+                                 ConvertedArrays&                convertedArrays,
+                                 ConversionStatistics&           statistics);
+
+    /// Compares the data of two objects and prints the first difference.
+    /** @param index Index of the object.
+     *  @param expected The original data.
+     *  @param actual The re-serialized data.
+     *  @return "true", when the data is equal. */
+    static bool Compare(uint32_t index, const std::vector<uint8_t>& expected, const std::vector<uint8_t>& actual);
+
+    /// The tool arguments.
+    const RexToolArguments& m_arguments;
+};
+
+#endif
@@ -0,0 +1,190 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_REXTOOLARGUMENTS_H
+#define RAMSES_CITYMODEL_REXTOOLARGUMENTS_H
+
+#include "ramses-citymodel/RexCodec.h"
+
+#include "cxxopts.hpp"
+#include "stdint.h"
+#include "string"
+#include "vector"
+
+/// Command line arguments of the ".rex" file tool.
+class RexToolArguments
+{
+public:
+    bool parse(int argc, char* argv[])
+    {
+        try
+        {
+            cxxopts::Options options(argv[0], "Checks and converts citymodel \".rex\" files");
+
+            createOptions(options);
+
+            auto result = options.parse(argc, argv);
+
+            if (m_help)
+            {
+                printf("%s\n", options.help({""}).c_str());
+                return false;
+            }
+        } catch (const cxxopts::OptionException& e)
+        {
+            printf("Error parsing options: %s. Use --help to show command line options.\n", e.what());
+            return false;
+        }
+
+        if (m_inputFile.empty())
+        {
+            printf("Error: No input file given. Use --help to show command line options.\n");
+            return false;
+        }
+        if (m_repack && m_outputFile.empty())
+        {
+            printf("Error: --repack needs an output file.\n");
+            return false;
+        }
+        if (m_order != "hilbert" && m_order != "morton")
+        {
+            printf("Error: Unknown tile order: %s\n", m_order.c_str());
+            return false;
+        }
+        if (!RexCodec::FromName(m_codecName, m_codec) || !RexCodec::IsSupported(m_codec))
+        {
+            printf("Error: Codec not supported: %s\n", m_codecName.c_str());
+            return false;
+        }
+        if (m_truncationCheck && m_outputFile.empty())
+        {
+            printf("Error: --truncationCheck needs an output file for the truncated copies.\n");
+            return false;
+        }
+        if (m_alignArrays && (!m_roundTrip || m_outputFile.empty() || m_legacyFormat))
+        {
+            printf("Error: --alignArrays needs --roundtrip with an output file and is not possible with --legacyFormat.\n");
+            return false;
+        }
+        if ((m_quantize || m_shortIndices || m_optimizeMeshes || m_encodeMeshes) && (!m_repack || m_legacyFormat))
+        {
+            printf("Error: --quantize, --shortIndices, --optimizeMeshes and --encodeMeshes need --repack and are not "
+                   "possible with --legacyFormat.\n");
+            return false;
+        }
+        if (!m_roundTrip && !m_repack && !m_benchmark && !m_readBenchmark && !m_verify && !m_truncationCheck && !m_batchStats &&
+            !m_textureStats && !m_arrayStats && !m_serve && !m_httpCheck)
+        {
+            printf("Error: No command given. Use --help to show command line options.\n");
+            return false;
+        }
+        return true;
+    }
+
+    void createOptions(cxxopts::Options& options)
+    {
+        options.add_options()
+            ("help", "Print help", cxxopts::value<bool>(m_help))
+            ("i,input", "Input file", cxxopts::value<std::string>(m_inputFile))
+            ("o,output", "Output file", cxxopts::value<std::string>(m_outputFile))
+            ("roundtrip", "Parses and re-serializes all objects and checks, that the data is unchanged. "
+                          "When an output file is given, the objects are also written and the written file is compared.",
+                          cxxopts::value<bool>(m_roundTrip))
+            ("verify", "Checks the object table and the checksums of all objects", cxxopts::value<bool>(m_verify))
+            ("truncationCheck", "Writes copies of the input file with the end of the object data cut off to the output file "
+                                "and checks, that they are rejected", cxxopts::value<bool>(m_truncationCheck))
+            ("repack", "Rewrites the file with the tiles ordered along a space filling curve of their bounding box centers "
+                       "and reports the seek distances of the animation path before and after",
+                       cxxopts::value<bool>(m_repack))
+            ("legacyFormat", "Write the output file in the legacy format without header, checksums and tile index, "
+                             "readable by older versions", cxxopts::value<bool>(m_legacyFormat))
+            ("order", "Tile order for --repack: hilbert or morton", cxxopts::value<std::string>(m_order)->default_value("hilbert"))
+            ("recompress", "Recompress the objects with --repack, instead of copying the stored data", cxxopts::value<bool>(m_recompress))
+            ("quantize", "Stores positions, normals and texture coordinates of the geometry with 16 bit values with --repack, "
+                         "which older versions cannot read", cxxopts::value<bool>(m_quantize))
+            ("shortIndices", "Stores the indices of geometry with at most 65536 vertices with 16 bit with --repack, which "
+                             "older versions cannot read", cxxopts::value<bool>(m_shortIndices))
+            ("optimizeMeshes", "Welds equal vertices and reorders the triangles and vertices of the geometry for the vertex "
+                               "cache with --repack, and reports the vertices and the average cache miss ratio before and after",
+                               cxxopts::value<bool>(m_optimizeMeshes))
+            ("encodeMeshes", "Converts the CTM geometry to geometry encoded for fast decoding with --repack, which older "
+                             "versions cannot read", cxxopts::value<bool>(m_encodeMeshes))
+            ("codec", "Compression codec for --recompress: lz4, lz4hc, zstd or stored. Codecs other than lz4 need the "
+                      "versioned object table, which older versions cannot read.",
+                      cxxopts::value<std::string>(m_codecName)->default_value("lz4"))
+            ("level", "Compression level for --recompress and --benchmark, 0 for the default level of the codec",
+                      cxxopts::value<int32_t>(m_level)->default_value("0"))
+            ("chunkSize", "Chunk size in KB for --recompress and --benchmark, objects larger than a chunk are split into "
+                          "chunks, which are decompressed in parallel. 0 stores single blocks, readable by older versions.",
+                          cxxopts::value<uint32_t>(m_chunkSize)->default_value("0"))
+            ("benchmark", "Recompresses all objects in memory with each available codec and reports the compression ratio, "
+                          "the decompression speed and the resulting load throughput for the bandwidths of --ioBandwidth",
+                          cxxopts::value<bool>(m_benchmark))
+            ("readBenchmark", "Reads the tiles in the order of the animation path from a cold page cache, synchronously and "
+                              "with --readQueueDepth tiles read ahead with io_uring and pread, and reports the throughput",
+                              cxxopts::value<bool>(m_readBenchmark))
+            ("readQueueDepth", "Number of tiles read ahead for --readBenchmark and --httpCheck",
+                               cxxopts::value<uint32_t>(m_readQueueDepth)->default_value("32"))
+            ("serve", "Serves the input file over HTTP with range requests on the loopback interface, as local stand-in "
+                      "for the web server of the demo's --filePath http://...", cxxopts::value<bool>(m_serve))
+            ("httpCheck", "Serves the input file like --serve and reads all objects over HTTP like the demo, checking that "
+                          "they are unchanged. With an output directory, the blocks are cached there and read again from "
+                          "the cache", cxxopts::value<bool>(m_httpCheck))
+            ("port", "Port for --serve and --httpCheck", cxxopts::value<uint32_t>(m_port)->default_value("8080"))
+            ("readGapTolerance", "Gap in KB up to which tiles read ahead by --readBenchmark are merged into a single read",
+                                 cxxopts::value<uint32_t>(m_readGapTolerance)->default_value("64"))
+            ("batchStats", "Reports the number of mesh nodes of the tiles and the number of draw calls remaining, when the demo "
+                           "merges the meshes of a tile with --batchMeshes",
+                           cxxopts::value<bool>(m_batchStats))
+            ("textureStats", "Reports the textures of all tiles and the memory saved, when textures with the same content "
+                             "are created once", cxxopts::value<bool>(m_textureStats))
+            ("arrayStats", "Reports the vertex and index array data of the tiles and the data copied before creating the "
+                           "resources, which is only needed for unaligned arrays", cxxopts::value<bool>(m_arrayStats))
+            ("alignArrays", "Aligns the arrays of older files with --roundtrip, so that the demo uses them without a copy",
+                            cxxopts::value<bool>(m_alignArrays))
+            ("ioBandwidth", "Storage read bandwidths in MB/s for the load throughput of --benchmark",
+                            cxxopts::value<std::vector<float>>(m_ioBandwidth)->default_value("50,200,1000,3000"))
+            ("loadRadius", "Distance in meters from the car, in which tiles are loaded for the seek distance report",
+                           cxxopts::value<float>(m_loadRadius)->default_value("1500.0"))
+            ;
+    }
+
+    bool               m_help            = false;
+    bool               m_roundTrip       = false;
+    bool               m_repack          = false;
+    bool               m_recompress      = false;
+    bool               m_quantize        = false;
+    bool               m_shortIndices    = false;
+    bool               m_optimizeMeshes  = false;
+    bool               m_encodeMeshes    = false;
+    bool               m_benchmark       = false;
+    bool               m_readBenchmark   = false;
+    bool               m_serve           = false;
+    bool               m_httpCheck       = false;
+    bool               m_verify          = false;
+    bool               m_truncationCheck = false;
+    bool               m_batchStats      = false;
+    bool               m_textureStats    = false;
+    bool               m_arrayStats      = false;
+    bool               m_alignArrays     = false;
+    bool               m_legacyFormat    = false;
+    std::string        m_inputFile;
+    std::string        m_outputFile;
+    std::string        m_order;
+    std::string        m_codecName;
+    ECodec             m_codec = ECodec_LZ4;
+    int32_t            m_level;
+    uint32_t           m_chunkSize;
+    uint32_t           m_readQueueDepth;
+    uint32_t           m_readGapTolerance;
+    uint32_t           m_port;
+    float              m_loadRadius;
+    std::vector<float> m_ioBandwidth;
+};
+
+#endif
@@ -0,0 +1,45 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "SpaceFillingCurve.h"
+
+#include "utility"
+
+uint64_t SpaceFillingCurve::MortonIndex(uint32_t x, uint32_t y)
+{
+    uint64_t index = 0;
+    for (uint32_t i = 0; i < Bits; i++)
+    {
+        index |= static_cast<uint64_t>((x >> i) & 1) << (2 * i);
+        index |= static_cast<uint64_t>((y >> i) & 1) << (2 * i + 1);
+    }
+    return index;
+}
+
+uint64_t SpaceFillingCurve::HilbertIndex(uint32_t x, uint32_t y)
+{
+    uint64_t index = 0;
+    for (uint32_t s = 1u << (Bits - 1); s > 0; s /= 2)
+    {
+        const uint32_t rx = (x & s) > 0 ? 1 : 0;
+        const uint32_t ry = (y & s) > 0 ? 1 : 0;
+        index += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant, so that the curve of the next level connects to this one.
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
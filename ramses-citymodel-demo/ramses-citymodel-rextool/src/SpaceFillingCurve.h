@@ -0,0 +1,34 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_SPACEFILLINGCURVE_H
+#define RAMSES_CITYMODEL_SPACEFILLINGCURVE_H
+
+#include "stdint.h"
+
+/// Index computation on 2D space filling curves, used for ordering tiles by spatial locality.
+class SpaceFillingCurve
+{
+public:
+    /// Number of bits per coordinate.
+    static const uint32_t Bits = 16;
+
+    /// Computes the index on the Morton (Z-order) curve by interleaving the coordinate bits.
+    /** @param x X coordinate (0 - 2^Bits-1).
+     *  @param y Y coordinate (0 - 2^Bits-1).
+     *  @return The curve index. */
+    static uint64_t MortonIndex(uint32_t x, uint32_t y);
+
+    /// Computes the index on the Hilbert curve.
+    /** @param x X coordinate (0 - 2^Bits-1).
+     *  @param y Y coordinate (0 - 2^Bits-1).
+     *  @return The curve index. */
+    static uint64_t HilbertIndex(uint32_t x, uint32_t y);
+};
+
+#endif
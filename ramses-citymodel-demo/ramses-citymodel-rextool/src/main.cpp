@@ -0,0 +1,21 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "RexTool.h"
+
+int main(int argc, char* argv[])
+{
+    RexToolArguments arguments;
+    if (!arguments.parse(argc, argv))
+    {
+        return 0;
+    }
+
+    RexTool tool(arguments);
+    return tool.run() ? 0 : 1;
+}
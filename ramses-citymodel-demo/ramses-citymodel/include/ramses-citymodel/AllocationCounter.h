@@ -0,0 +1,32 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_ALLOCATIONCOUNTER_H
+#define RAMSES_CITYMODEL_ALLOCATIONCOUNTER_H
+
+#include "stdint.h"
+
+/// Counts the heap allocations of each thread.
+/** Counted by the global operator new of AllocationCounter.cpp, which is only built with the CMake option
+ *  ramses-citymodel_COUNT_ALLOCATIONS (RAMSES_CITYMODEL_COUNT_ALLOCATIONS). */
+class AllocationCounter
+{
+public:
+    /// Returns the number of heap allocations of the calling thread so far.
+    /** @return The number of allocations. */
+    static uint64_t GetNumberOfAllocations();
+
+    /// Counts a heap allocation of the calling thread, called by operator new.
+    static void CountAllocation();
+
+private:
+    /// Number of heap allocations of the thread.
+    static thread_local uint64_t m_numberOfAllocations;
+};
+
+#endif
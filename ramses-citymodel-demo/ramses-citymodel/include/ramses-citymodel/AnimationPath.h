@@ -28,11 +28,11 @@ public:
 
         /// Returns the car position.
         /** @return The car position. */
-        const Vector3& getCarPosition();
+        const Vector3& getCarPosition() const;
 
         /// Returns the car rotation.
         /** @return The car rotation. */
-        const Vector3& getCarRotation();
+        const Vector3& getCarRotation() const;
 
     private:
         /// The car position.
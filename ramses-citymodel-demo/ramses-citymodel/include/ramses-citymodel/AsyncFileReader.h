@@ -0,0 +1,146 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_ASYNCFILEREADER_H
+#define RAMSES_CITYMODEL_ASYNCFILEREADER_H
+
+#include "deque"
+#include "map"
+#include "memory"
+#include "stdint.h"
+#include "string"
+
+/// Reads blocks of a file asynchronously with a queue of configurable depth.
+/** Uses io_uring, when it was available at build time (RAMSES_CITYMODEL_HAS_IO_URING) and the kernel allows it, so
+ *  that many reads are in flight at once and the storage can reorder them. Otherwise the reads are done with pread,
+ *  one at a time, when their completion is waited for. Not thread safe, used by one thread. */
+class AsyncFileReader
+{
+public:
+    /// A completed read.
+    struct Completion
+    {
+        /// Id of the read, as given to submit().
+        uint64_t id;
+
+        /// "true", when all bytes were read.
+        bool success;
+    };
+
+    /// Constructor.
+    AsyncFileReader();
+
+    /// Destructor, waits for the reads in flight.
+    ~AsyncFileReader();
+
+    /// Returns if io_uring can be used.
+    /** @return "true", when io_uring was available at build time and a ring can be created. */
+    static bool IsIoUringSupported();
+
+    /// Opens a file.
+    /** @param filename The name of the file.
+     *  @param queueDepth Maximum number of reads in flight, at least 1.
+     *  @param useIoUring "true" for using io_uring when supported, "false" for reading with pread.
+     *  @return "true" on success. */
+    bool open(const std::string& filename, uint32_t queueDepth, bool useIoUring);
+
+    /// Waits for the reads in flight and closes the file.
+    void close();
+
+    /// Returns if the reads are done with io_uring.
+    /** @return "true" for io_uring, "false" for pread. */
+    bool usesIoUring() const;
+
+    /// Returns the maximum number of reads in flight.
+    /** @return The queue depth. */
+    uint32_t getQueueDepth() const;
+
+    /// Returns the number of reads submitted, whose completion was not returned by wait() yet.
+    /** @return The number of reads. */
+    uint32_t getNumberOfPending() const;
+
+    /// Submits a read.
+    /** The buffer must stay valid, until the completion of the read is returned by wait().
+     *  @param id Id of the read, returned with its completion, unique among the pending reads.
+     *  @param position Position in the file in bytes.
+     *  @param buffer The read data is stored here.
+     *  @param size Number of bytes to read.
+     *  @return "true" on success, "false" when the queue is full or the file is not open. */
+    bool submit(uint64_t id, uint64_t position, void* buffer, uint32_t size);
+
+    /// Waits for the completion of a submitted read.
+    /** Reads, which io_uring did not complete, are repeated with pread. When waiting for io_uring fails, the queues
+     *  are destroyed after the reads in flight, and all pending and later reads are done with pread.
+     *  @param completion The completed read is returned here.
+     *  @return "true", when a completion is returned, "false" when no read is pending. */
+    bool wait(Completion& completion);
+
+    /// Reads a block synchronously with pread.
+    /** @param position Position in the file in bytes.
+     *  @param buffer The read data is stored here.
+     *  @param size Number of bytes to read.
+     *  @return "true", when all bytes were read. */
+    bool read(uint64_t position, void* buffer, uint32_t size) const;
+
+private:
+    /// A submitted read.
+    struct Request
+    {
+        /// Position in the file in bytes.
+        uint64_t position;
+
+        /// Destination of the data.
+        void* buffer;
+
+        /// Number of bytes to read.
+        uint32_t size;
+
+        /// "true", when submitted to io_uring, otherwise it is read with pread.
+        bool submitted;
+    };
+
+    /// The io_uring submission and completion queues, mapped from the kernel.
+    struct Ring;
+
+    /// Creates the io_uring queues.
+    /** @param entries Number of entries of the submission queue.
+     *  @return "true" on success. */
+    bool openRing(uint32_t entries);
+
+    /// Waits for the reads in flight and destroys the io_uring queues.
+    void closeRing();
+
+    /// Submits a read to io_uring.
+    /** @param id Id of the read.
+     *  @param request The read.
+     *  @return "true" on success. */
+    bool submitRing(uint64_t id, const Request& request);
+
+    /// Waits for the next io_uring completion.
+    /** @param id Id of the completed read is returned here.
+     *  @param result Number of bytes read or negative error code is returned here.
+     *  @return "true" on success. */
+    bool waitRing(uint64_t& id, int32_t& result);
+
+    /// The file descriptor, -1 when closed.
+    int m_fd = -1;
+
+    /// Maximum number of reads in flight.
+    uint32_t m_queueDepth = 0;
+
+    /// The io_uring queues, nullptr when reading with pread.
+    std::unique_ptr<Ring> m_ring;
+
+    /// The pending reads by id.
+    std::map<uint64_t, Request> m_requests;
+
+    /// Ids of the pending reads in the order of submission, for reading with pread.
+    std::deque<uint64_t> m_order;
+};
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "ramses-client-api/EffectDescription.h"
 
+#include "atomic"
 #include "set"
 #include "string"
 #include "map"
@@ -35,6 +36,8 @@ namespace ramses
     class MeshNode;
 }
 
+class HttpTileSource;
+
 /// Citymodel main class.
 class Citymodel : public IInputReceiver
 {
@@ -89,6 +92,11 @@ public:
     /**  @param tile The tile. */
     void removeTileToDelete(Tile* tile);
 
+    /// Creates a box proxy shown instead of a tile, that is not loaded yet.
+    /** @param boundingBox Bounding box of the tile.
+     *  @return The mesh node of the proxy, nullptr when not in progressive mode. */
+    ramses::MeshNode* createTileProxy(const BoundingBox& boundingBox);
+
     /// Returns the Ramses scene.
     /** @return The scene. */
     ramses::Scene& getRamsesScene();
@@ -143,10 +151,23 @@ private:
     ramses::Effect*
     createEffect(ramses::EffectDescription& effectDesc, const char* vertexShaderFile, const char* fragmentShaderFile);
 
-    /// Does the complete setup of the renderable scene (reading / building the culling tree / creating the naming
-    /// labels).
+    /// Opens the database file and sets up the tiles and the culling tree.
+    /** When the file has a tile index and a start key, only these are read and the scene object is read in the
+     *  background by the pager. Otherwise the scene object is read immediately. */
     void readScene();
 
+    /// Creates the tiles from the tile index of the file and places the camera at the start key.
+    /** @return "true", when the file has a tile index and a start key. */
+    bool bootstrapScene();
+
+    /// Sets the read scene object and creates the carsor, the route and the naming labels.
+    /** @param scene The scene. */
+    void setScene(CitymodelScene* scene);
+
+    /// Returns the current key of the animation path, the start key while the scene is not read yet.
+    /** @return The key. */
+    AnimationPath::Key* getAnimationKey();
+
     /// Builds the tree for hierarchical view frustum culling.
     void buildTree();
 
@@ -190,6 +211,31 @@ private:
     /// Creates geometry for a marker in the scene.
     void createMarkerGeometry();
 
+    /// Creates geometry and appearance for the tile proxies, in progressive mode only.
+    void createProxyGeometry();
+
+    /// Creates a box geometry from -1 to 1 in each axis.
+    /** @param effect The effect the geometry is used with.
+     *  @return The geometry. */
+    ramses::GeometryBinding* createBoxGeometry(const ramses::Effect& effect);
+
+    /// Prints the time to the complete view, when the first view is completely loaded, and with
+    /// --showPerformanceValues the statistics of reading the tiles.
+    void checkViewComplete();
+
+    /// Prints the statistics of the caches, of reading and decoding the tiles and of the created meshes.
+    void printStatistics() const;
+
+    /// Prints the statistics of a cache directory.
+    /** @param name Name of the cache.
+     *  @param statistics The statistics. */
+    static void PrintCacheStatistics(const char* name, const DiskCacheStatistics& statistics);
+
+    /// Returns the decoding time per vertex.
+    /** @param statistics The decoding statistics.
+     *  @return The time in seconds, 0 when no vertex was decoded. */
+    static float GetDecodeTimePerVertex(const GeometryDecodeStatistics& statistics);
+
     /// Create a marker in the scene at a certain position.
     /** @param position Center position of the marker.
      *  @param size Size of the marker. */
@@ -232,6 +278,9 @@ private:
     /// Prints the naming points on the console.
     void printNamingPoints();
 
+    /// Prints the tiles read and the read operations of the round driven last on the console.
+    void printRoundStatistics();
+
     CitymodelArguments m_arguments;
 
     /// GUI Overlay elements.
@@ -281,9 +330,24 @@ private:
     /// Name label for the current performance value string.
     Name* m_statusName = nullptr;
 
-    /// The scene of the citymodel.
+    /// The scene of the citymodel, nullptr while it is read in the background.
     CitymodelScene* m_scene = nullptr;
 
+    /// The scene read in the background by the pager.
+    std::atomic<CitymodelScene*> m_loadedScene{nullptr};
+
+    /// Flag, if the pager finished reading the scene in the background.
+    std::atomic<bool> m_sceneReadDone{false};
+
+    /// The tiles of the scene.
+    std::vector<Tile*> m_tiles;
+
+    /// Animation path with the start key only, used while the scene is read in the background.
+    AnimationPath m_startPath;
+
+    /// Time since the start of the initialization, for the first frame budget.
+    Timer m_startupTimer;
+
     /// The RAMSES scene.
     ramses::Scene* m_ramsesScene = nullptr;
 
@@ -293,6 +357,9 @@ private:
     /// Effect for the debug markers.
     ramses::Effect* m_markerEffect = nullptr;
 
+    /// Effect for the tile proxies, only in progressive mode.
+    ramses::Effect* m_proxyEffect = nullptr;
+
     /// The scene and tile reader.
     Reader* m_reader = nullptr;
 
@@ -319,9 +386,21 @@ private:
     /// Setting whether scene is animated (moving scene, streetnames fade in/out, etc.)
     bool m_showAnimation = true;
 
+    /// Source of the tiles for an http:// file path, owned by the reader, nullptr for a local file.
+    HttpTileSource* m_httpTileSource = nullptr;
+
     /// Number of rounds the route has been driven.
     uint32_t m_numRoundsDriven = 0;
 
+    /// Number of tiles read at the start of the current round.
+    uint32_t m_roundStartTilesRead = 0;
+
+    /// Number of read operations at the start of the current round.
+    uint32_t m_roundStartReadOperations = 0;
+
+    /// Number of bytes read at the start of the current round.
+    uint64_t m_roundStartReadSize = 0;
+
     /// Flag, if the main loop shall exit.
     bool m_exit = false;
 
@@ -382,6 +461,18 @@ private:
     /// Geometry for a marker.
     ramses::GeometryBinding* m_markerGeometry = nullptr;
 
+    /// Geometry for the tile proxies.
+    ramses::GeometryBinding* m_proxyGeometry = nullptr;
+
+    /// Appearance shared by all tile proxies.
+    ramses::Appearance* m_proxyAppearance = nullptr;
+
+    /// Number of tile proxies created.
+    uint32_t m_numberOfProxies = 0;
+
+    /// Flag, if the first view was completely loaded.
+    bool m_viewComplete = false;
+
     /// The route points.
     std::vector<Vector3> m_routePoints;
 
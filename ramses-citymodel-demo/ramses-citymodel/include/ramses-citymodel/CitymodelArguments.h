@@ -14,6 +14,7 @@
 #include "cstdlib"
 #include "string"
 
+#include "ramses-citymodel/PickingMesh.h"
 #include "ramses-citymodel/Vector2.h"
 
 /// Citymodel command line arguments
@@ -40,6 +41,12 @@ public:
             printf("Error parsing options: %s. Use --help to show command line options.\n", e.what());
             return false;
         }
+
+        if (!PickingMesh::FromName(m_pickingGeometryName, m_pickingGeometry))
+        {
+            printf("Error: Unknown picking geometry mode: %s\n", m_pickingGeometryName.c_str());
+            return false;
+        }
         return true;
     }
 
@@ -53,7 +60,40 @@ public:
             ("staticFrame", "Render only a given static frame instead animating", cxxopts::value<int32_t>(m_staticFrame))
             ("showPerformanceValues", "Show fps/cpu usage performance values", cxxopts::value<bool>(m_showPerformanceValues))
             ("rounds", "Limit number of rounds to drive", cxxopts::value<uint32_t>(m_roundsToDrive))
-            ("filePath", "Path to the database file", cxxopts::value<std::string>(m_filePath)->default_value("./res"))
+            ("filePath", "Path to the database file, or the http:// URL of its directory for reading the tiles with range "
+                         "requests", cxxopts::value<std::string>(m_filePath)->default_value("./res"))
+            ("mapFile", "Map the local database file into memory instead of reading it", cxxopts::value<bool>(m_mapFile))
+            ("httpConnections", "Number of connections fetching the tiles of --readQueueDepth ahead from an http:// "
+                                "--filePath", cxxopts::value<uint32_t>(m_httpConnections)->default_value("4"))
+            ("httpCache", "Directory for keeping the blocks of an http:// --filePath between runs, disabled when empty",
+                          cxxopts::value<std::string>(m_httpCache))
+            ("httpCacheSize", "Size limit of the HTTP block cache in MB, the least recently used blocks are removed first",
+                              cxxopts::value<uint32_t>(m_httpCacheSize)->default_value("512"))
+            ("firstFrameBudget", "Time in ms after which the scene is published, even when tiles are still loading",
+                                 cxxopts::value<float>(m_firstFrameBudget)->default_value("1000"))
+            ("progressive", "Publish the scene with the first frame, showing boxes for tiles not loaded yet, and load the "
+                            "tiles nearest to the camera first",
+                            cxxopts::value<bool>(m_progressive))
+            ("batchMeshes", "Merge the meshes of a tile with the same material into a single mesh, when the tile is loaded",
+                            cxxopts::value<bool>(m_batchMeshes))
+            ("textureBudget", "Texture memory in MB for the fine mip levels of textures near the camera, 0 creates all "
+                              "levels when a tile is loaded", cxxopts::value<uint32_t>(m_textureBudget)->default_value("64"))
+            ("textureDetailDistance", "Distance in meters, up to which the finest texture level is used",
+                                      cxxopts::value<float>(m_textureDetailDistance)->default_value("150"))
+            ("pickingGeometry", "Geometry kept in memory for picking with the mouse: none, compact (quantized positions, "
+                                "16 bit indices) or full", cxxopts::value<std::string>(m_pickingGeometryName)->default_value("compact"))
+            ("disableDecodeArena", "Allocate the temporaries of reading a tile from the heap instead of the decode arena, "
+                                   "for comparing the number of allocations per tile", cxxopts::value<bool>(m_disableDecodeArena))
+            ("readQueueDepth", "Number of queued tiles read ahead asynchronously while a tile is loaded, 0 reads each "
+                               "tile synchronously", cxxopts::value<uint32_t>(m_readQueueDepth)->default_value("0"))
+            ("disableIoUring", "Read the tiles of --readQueueDepth with pread instead of io_uring", cxxopts::value<bool>(m_disableIoUring))
+            ("readGapTolerance", "Gap in KB up to which tiles of --readQueueDepth stored near each other in the file are "
+                                 "read with a single read", cxxopts::value<uint32_t>(m_readGapTolerance)->default_value("64"))
+            ("geometryCache", "Directory for keeping the decoded CTM geometry of the tiles between runs, disabled when empty",
+                              cxxopts::value<std::string>(m_geometryCache))
+            ("geometryCacheSize", "Size limit of the geometry cache in MB, the least recently used tiles are removed first",
+                                  cxxopts::value<uint32_t>(m_geometryCacheSize)->default_value("512"))
+            ("verifyChecksums", "Check the checksum of each object read from the database file", cxxopts::value<bool>(m_verifyChecksums))
             ("resPath", "Path to the resource files", cxxopts::value<std::string>(m_resPath)->default_value("./res"))
             ("fovy", "Field of view in degrees", cxxopts::value<float>(m_fovy)->default_value("19.0"))
             ("w,width", "Window width", cxxopts::value<uint32_t>(m_windowWidth)->default_value("1280"))
@@ -64,21 +104,39 @@ public:
             ;
     }
 
-    bool        m_help = false;
-    uint32_t    m_sceneId;
-    bool        m_disableRoute          = false;
-    bool        m_disableNaming         = false;
-    int32_t     m_staticFrame           = -1;
-    bool        m_showPerformanceValues = false;
-    uint32_t    m_roundsToDrive         = 0;
-    std::string m_filePath;
-    std::string m_resPath;
-    float       m_fovy;
-    uint32_t    m_windowWidth;
-    uint32_t    m_windowHeight;
-    uint32_t    m_logLevel;
-    std::string m_myIp;
-    std::string m_daemonIp;
+    bool             m_help = false;
+    uint32_t         m_sceneId;
+    bool             m_disableRoute          = false;
+    bool             m_disableNaming         = false;
+    int32_t          m_staticFrame           = -1;
+    bool             m_showPerformanceValues = false;
+    uint32_t         m_roundsToDrive         = 0;
+    std::string      m_filePath;
+    bool             m_mapFile               = false;
+    uint32_t         m_httpConnections;
+    std::string      m_httpCache;
+    uint32_t         m_httpCacheSize;
+    bool             m_verifyChecksums       = false;
+    uint32_t         m_readQueueDepth;
+    bool             m_disableIoUring        = false;
+    uint32_t         m_readGapTolerance;
+    std::string      m_geometryCache;
+    uint32_t         m_geometryCacheSize;
+    bool             m_progressive           = false;
+    bool             m_batchMeshes           = false;
+    bool             m_disableDecodeArena    = false;
+    float            m_firstFrameBudget;
+    uint32_t         m_textureBudget;
+    float            m_textureDetailDistance;
+    std::string      m_pickingGeometryName;
+    EPickingGeometry m_pickingGeometry = EPickingGeometry_Compact;
+    std::string      m_resPath;
+    float            m_fovy;
+    uint32_t         m_windowWidth;
+    uint32_t         m_windowHeight;
+    uint32_t         m_logLevel;
+    std::string      m_myIp;
+    std::string      m_daemonIp;
 };
 
 #endif
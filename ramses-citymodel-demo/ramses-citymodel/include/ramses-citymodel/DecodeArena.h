@@ -0,0 +1,158 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_DECODEARENA_H
+#define RAMSES_CITYMODEL_DECODEARENA_H
+
+#include "cstddef"
+#include "memory"
+#include "stdint.h"
+#include "vector"
+
+/// Growable memory arena for the temporaries of reading an object.
+/** Not thread safe, each reader thread has its own arena. */
+class DecodeArena
+{
+public:
+    /// Minimum size of a block in bytes.
+    static const size_t MinimumBlockSize = 64 * 1024;
+
+    /// Allocates memory, valid until the next reset().
+    /** @param size Size in bytes.
+     *  @param alignment Alignment in bytes, a power of two.
+     *  @return The memory. */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /// Allocates an uninitialized array, valid until the next reset().
+    /** @param n Number of elements.
+     *  @return The array. */
+    template <typename T>
+    T* allocateArray(size_t n)
+    {
+        return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /// Frees all allocations at once and merges the blocks into one block of their total size.
+    /** So after the first objects, reading an object of similar size takes no memory from the heap. */
+    void reset();
+
+    /// Enables the arena, when disabled each allocation gets a block of its own, which is freed by reset().
+    /** For comparing the number of heap allocations with and without the arena.
+     *  @param enabled "true" for using the arena (the default). */
+    void setEnabled(bool enabled);
+
+    /// Returns the memory held by the arena.
+    /** @return The size in bytes. */
+    size_t getCapacity() const;
+
+    /// Returns the most memory allocated between two resets.
+    /** @return The size in bytes. */
+    size_t getPeakSize() const;
+
+private:
+    /// Appends a block with space for an allocation.
+    /** @param size Size of the allocation in bytes.
+     *  @param alignment Alignment of the allocation in bytes. */
+    void addBlock(size_t size, size_t alignment);
+
+    /// Memory block of the arena.
+    struct Block
+    {
+        /// The memory.
+        std::unique_ptr<uint8_t[]> data;
+
+        /// Size of the memory in bytes.
+        size_t size;
+    };
+
+    /// The blocks, allocations are taken from the last one.
+    std::vector<Block> m_blocks;
+
+    /// Offset of the free memory in the last block.
+    size_t m_offset = 0;
+
+    /// Memory allocated since the last reset.
+    size_t m_size = 0;
+
+    /// Most memory allocated between two resets.
+    size_t m_peakSize = 0;
+
+    /// "false", when each allocation gets a block of its own.
+    bool m_enabled = true;
+};
+
+/// Allocator for standard containers, taking their memory from a decode arena.
+/** Freed memory is only reused after the arena is reset, so the containers must be cleared before. */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    /// Type of the elements.
+    typedef T value_type;
+
+    /// Constructor.
+    /** @param arena The arena. */
+    explicit ArenaAllocator(DecodeArena& arena)
+        : m_arena(&arena)
+    {
+    }
+
+    /// Copy constructor for other element types.
+    /** @param other The allocator to copy. */
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : m_arena(other.getArena())
+    {
+    }
+
+    /// Allocates memory for elements.
+    /** @param n Number of elements.
+     *  @return The memory. */
+    T* allocate(size_t n)
+    {
+        return m_arena->allocateArray<T>(n);
+    }
+
+    /// Frees memory of elements, which is done by resetting the arena, so the parameters are not used.
+    void deallocate(T*, size_t)
+    {
+    }
+
+    /// Returns the arena.
+    /** @return The arena. */
+    DecodeArena* getArena() const
+    {
+        return m_arena;
+    }
+
+private:
+    /// The arena.
+    DecodeArena* m_arena;
+};
+
+/// Compares two arena allocators.
+/** @param a The first allocator.
+ *  @param b The second allocator.
+ *  @return "true", when both use the same arena. */
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return a.getArena() == b.getArena();
+}
+
+/// Compares two arena allocators.
+/** @param a The first allocator.
+ *  @param b The second allocator.
+ *  @return "true", when they use different arenas. */
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return a.getArena() != b.getArena();
+}
+
+#endif
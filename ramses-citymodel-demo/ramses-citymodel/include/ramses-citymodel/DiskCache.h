@@ -0,0 +1,120 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_DISKCACHE_H
+#define RAMSES_CITYMODEL_DISKCACHE_H
+
+#include "map"
+#include "stdint.h"
+#include "string"
+#include "vector"
+
+/// Statistics of a disk cache.
+class DiskCacheStatistics
+{
+public:
+    uint32_t m_numberOfHits      = 0;
+    uint32_t m_numberOfMisses    = 0;
+    uint32_t m_numberOfStores    = 0;
+    uint32_t m_numberOfEvictions = 0;
+    uint32_t m_numberOfEntries   = 0;
+    uint64_t m_size              = 0;
+};
+
+/// Persistent cache of blocks of data in a local directory, kept between runs of the demo.
+/** Entries are named by the key of their source, e.g. a file, and their index in it, and store the identity of the
+ *  source, so that entries of a changed source are not used. The data of an entry is checked against its size and an
+ *  XXH32 of it, an entry damaged on disk is deleted. The cache is bounded in size, the least recently used entries are
+ *  deleted first. The order of use is kept in the modification times of the entry files. The reader keeps the decoded
+ *  geometry of the tiles in one, HttpTileSource the blocks of files read over HTTP in another directory. Not thread
+ *  safe. */
+class DiskCache
+{
+public:
+    /// Marks the start of an entry file ("REXC").
+    static const uint32_t EntryMagic = 0x43584552u;
+
+    /// Version of the entry format, entries of other versions are not used.
+    static const uint32_t EntryVersion = 2;
+
+    /// Extension of the entry files.
+    static const char* const EntryExtension;
+
+    /// Opens the cache directory, which is created when it does not exist, and finds the entries in it.
+    /** Deletes the least recently used entries, when they exceed the maximum size.
+     *  @param directory The directory.
+     *  @param maximumSize Maximum size of all entries in bytes.
+     *  @return "true" on success. */
+    bool open(const std::string& directory, uint64_t maximumSize);
+
+    /// Loads an entry.
+    /** @param key Key of the source.
+     *  @param index Index of the entry in the source.
+     *  @param identity Identity of the current content of the source, e.g. a checksum.
+     *  @param data The data of the entry is returned here, 4 byte aligned.
+     *  @return "true" on success, "false" when there is no valid entry with the identity. */
+    bool load(uint32_t key, uint32_t index, uint32_t identity, std::vector<uint8_t>& data);
+
+    /// Stores an entry, replacing an existing entry.
+    /** The entry is written to a temporary file, which is renamed, so that a reader never sees a partial entry.
+     *  @param key Key of the source.
+     *  @param index Index of the entry in the source.
+     *  @param identity Identity of the current content of the source, e.g. a checksum.
+     *  @param data The data of the entry.
+     *  @return "true" on success. */
+    bool store(uint32_t key, uint32_t index, uint32_t identity, const std::vector<uint8_t>& data);
+
+    /// Returns the statistics of the cache.
+    /** @return The statistics. */
+    const DiskCacheStatistics& getStatistics() const;
+
+private:
+    /// Size of the entry header in bytes: magic, version, key, index, identity, data size and data hash.
+    static const uint32_t EntryHeaderSize = 7 * sizeof(uint32_t);
+
+    /// Entry of the cache.
+    struct Entry
+    {
+        /// Size of the entry file in bytes.
+        uint64_t size;
+
+        /// Order of the last use, the entry with the lowest value is evicted first.
+        uint64_t lastUse;
+    };
+
+    /// Returns the name of the file of an entry.
+    /** @param key Key of the source.
+     *  @param index Index of the entry in the source.
+     *  @return The file name, without the directory. */
+    static std::string GetEntryName(uint32_t key, uint32_t index);
+
+    /// Deletes an entry file and removes it from the cache.
+    /** @param name Name of the entry file. */
+    void remove(const std::string& name);
+
+    /// Deletes the least recently used entries, until the entries fit into the maximum size.
+    /** @param keep Name of an entry, which is not deleted. */
+    void evict(const std::string& keep);
+
+    /// The cache directory.
+    std::string m_directory;
+
+    /// Maximum size of all entries in bytes.
+    uint64_t m_maximumSize = 0;
+
+    /// The entries by the names of their files.
+    std::map<std::string, Entry> m_entries;
+
+    /// Counter for the order of use of the entries.
+    uint64_t m_useCounter = 0;
+
+    /// The statistics.
+    DiskCacheStatistics m_statistics;
+};
+
+#endif
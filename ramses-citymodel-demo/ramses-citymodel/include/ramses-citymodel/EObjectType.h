@@ -24,7 +24,13 @@ enum EObjectType
     EType_Texture2DResource,
     EType_TextureCubeResource,
     EType_Scene,
-    EType_Tile
+    EType_Tile,
+    EType_Texture2DMipMapResource,
+    EType_QuantizedVertexArrayResource2f,
+    EType_QuantizedVertexArrayResource3f,
+    EType_OctahedralNormalArrayResource,
+    EType_ShortIndexArrayResource,
+    EType_EncodedGeometryNode
 };
 
 #endif
@@ -0,0 +1,50 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_FILETILESOURCE_H
+#define RAMSES_CITYMODEL_FILETILESOURCE_H
+
+#include "ramses-citymodel/ITileSource.h"
+
+/// Reads a local file with pread, the default source of RexArchive.
+class FileTileSource : public ITileSource
+{
+public:
+    /// Destructor, closes the file.
+    ~FileTileSource() override;
+
+    /// Opens a local file, see ITileSource::open().
+    bool open(const std::string& name) override;
+
+    /// See ITileSource::getSize().
+    uint64_t getSize() const override;
+
+    /// Reads with pread, see ITileSource::read().
+    bool read(uint64_t position, void* buffer, uint32_t size) override;
+
+    /// Asks the kernel to read the ranges into the page cache, see ITileSource::prefetch().
+    void prefetch(const std::vector<ReadPlanner::Slice>& ranges) override;
+
+    /// Returns "true", see ITileSource::isLocalFile().
+    bool isLocalFile() const override;
+
+    /// Returns "file", see ITileSource::getType().
+    const char* getType() const override;
+
+private:
+    /// Closes the file.
+    void close();
+
+    /// The file descriptor, -1 when not open.
+    int m_fd = -1;
+
+    /// Size of the file in bytes.
+    uint64_t m_size = 0;
+};
+
+#endif
@@ -0,0 +1,88 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_HTTPCONNECTION_H
+#define RAMSES_CITYMODEL_HTTPCONNECTION_H
+
+#include "stdint.h"
+#include "string"
+
+/// Connection to a web server for HTTP/1.1 range requests of one file, kept open between the requests.
+/** Supports plain "http://" URLs and responses with a Content-Length, as sent by static file servers for ranges. A
+ *  connection closed by the server while idle is opened again. Not thread safe, each thread uses its own connection. */
+class HttpConnection
+{
+public:
+    /// Destructor, closes the connection.
+    ~HttpConnection();
+
+    /// Splits an "http://" URL into its parts.
+    /** @param url The URL.
+     *  @param host The host name is returned here.
+     *  @param port The port is returned here, "80" when the URL has no port.
+     *  @param path The path is returned here, starting with "/".
+     *  @return "true" for a valid "http://" URL. */
+    static bool ParseUrl(const std::string& url, std::string& host, std::string& port, std::string& path);
+
+    /// Sets the URL of the file, the connection is opened with the first request.
+    /** @param url The URL.
+     *  @return "true" for a valid "http://" URL. */
+    bool open(const std::string& url);
+
+    /// Closes the connection.
+    void close();
+
+    /// Requests a range of the file.
+    /** @param position Position of the range in the file.
+     *  @param size Size of the range in bytes, at least 1.
+     *  @param buffer The bytes of the range are returned here.
+     *  @param fileSize The size of the file is returned here.
+     *  @param validator The ETag of the file is returned here, or its modification time when the server sends no
+     *                   ETag, for detecting changes of the file.
+     *  @return "true", when the server returned the range. */
+    bool requestRange(uint64_t position, uint32_t size, void* buffer, uint64_t& fileSize, std::string& validator);
+
+private:
+    /// Connects to the server.
+    /** @return "true" on success. */
+    bool connect();
+
+    /// Sends a request and receives the response, on the open connection.
+    /** @param position Position of the range in the file.
+     *  @param size Size of the range in bytes.
+     *  @param buffer The bytes of the range are returned here.
+     *  @param fileSize The size of the file is returned here.
+     *  @param validator The validator of the file is returned here.
+     *  @param received Returns "true", when the server sent a response, so that repeating the request makes no sense.
+     *  @return "true" on success. */
+    bool
+    transfer(uint64_t position, uint32_t size, void* buffer, uint64_t& fileSize, std::string& validator, bool& received);
+
+    /// Receives bytes from the connection.
+    /** @param buffer The bytes are returned here.
+     *  @param size Maximum number of bytes.
+     *  @return The number of bytes received, 0 when the connection was closed or failed. */
+    size_t receive(void* buffer, size_t size);
+
+    /// Host name of the server.
+    std::string m_host;
+
+    /// Port of the server.
+    std::string m_port;
+
+    /// Path of the file.
+    std::string m_path;
+
+    /// The socket, -1 when not connected.
+    int m_socket = -1;
+
+    /// Bytes received after the end of the headers, which belong to the body.
+    std::string m_received;
+};
+
+#endif
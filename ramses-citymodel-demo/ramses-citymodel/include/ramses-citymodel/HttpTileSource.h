@@ -0,0 +1,206 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_HTTPTILESOURCE_H
+#define RAMSES_CITYMODEL_HTTPTILESOURCE_H
+
+#include "ramses-citymodel/DiskCache.h"
+#include "ramses-citymodel/HttpConnection.h"
+#include "ramses-citymodel/ITileSource.h"
+
+#include "condition_variable"
+#include "deque"
+#include "map"
+#include "memory"
+#include "mutex"
+#include "set"
+#include "thread"
+
+/// Statistics of reading a file over HTTP.
+class HttpTileSourceStatistics
+{
+public:
+    uint32_t m_numberOfRequests       = 0;
+    uint32_t m_numberOfFailedRequests = 0;
+    uint64_t m_fetchedSize            = 0;
+    uint32_t m_numberOfFetchedBlocks  = 0;
+    uint32_t m_numberOfCachedBlocks   = 0;
+};
+
+/// Reads a file from a web server with HTTP/1.1 range requests, so that only the tiles read are transferred.
+/** The file is read in blocks of BlockSize. Blocks of ranges given to prefetch() are fetched in the background by
+ *  several connections at once, consecutive blocks with a single request. Fetched blocks are kept in memory, up to
+ *  MaximumMemoryBlocks, and in an optional cache in a local directory, which is bounded in size and kept between runs,
+ *  so that a route driven again reads its tiles from the disk. Entries of a file changed on the server are not used. */
+class HttpTileSource : public ITileSource
+{
+public:
+    /// Size of the blocks of the file in bytes.
+    static const uint32_t BlockSize = 256 * 1024;
+
+    /// Maximum number of blocks kept in memory, the least recently used blocks are dropped first.
+    static const uint32_t MaximumMemoryBlocks = 128;
+
+    /// Maximum number of consecutive blocks fetched with one request.
+    static const uint32_t MaximumRequestBlocks = 16;
+
+    /// Constructor.
+    HttpTileSource();
+
+    /// Destructor, stops the fetching.
+    ~HttpTileSource() override;
+
+    /// Returns if a name is a URL read by this source.
+    /** @param name The file name or URL.
+     *  @return "true" for "http://" URLs. */
+    static bool IsUrl(const std::string& name);
+
+    /// Sets the number of connections fetching blocks in the background. Takes effect with the next open().
+    /** @param numberOfConnections Number of connections, 4 by default, 0 fetches blocks only when they are read. */
+    void setConnections(uint32_t numberOfConnections);
+
+    /// Enables the cache of fetched blocks in a local directory.
+    /** @param directory The directory, created when it does not exist.
+     *  @param maximumSize Maximum size of the cached blocks in bytes.
+     *  @return "true" on success. */
+    bool setCache(const std::string& directory, uint64_t maximumSize);
+
+    /// Opens a file on a web server and requests its size, see ITileSource::open().
+    bool open(const std::string& name) override;
+
+    /// See ITileSource::getSize().
+    uint64_t getSize() const override;
+
+    /// Reads from the blocks in memory, the cache or the server, see ITileSource::read().
+    bool read(uint64_t position, void* buffer, uint32_t size) override;
+
+    /// Queues the blocks of the ranges, which are not in memory, for fetching, see ITileSource::prefetch().
+    void prefetch(const std::vector<ReadPlanner::Slice>& ranges) override;
+
+    /// Returns "false", see ITileSource::isLocalFile().
+    bool isLocalFile() const override;
+
+    /// Returns "http", see ITileSource::getType().
+    const char* getType() const override;
+
+    /// Returns the statistics. Thread safe.
+    /** @return The statistics. */
+    HttpTileSourceStatistics getStatistics() const;
+
+    /// Returns the statistics of the cache of blocks. Thread safe.
+    /** @return The statistics, all 0 without cache. */
+    DiskCacheStatistics getCacheStatistics() const;
+
+private:
+    /// A block kept in memory.
+    struct Block
+    {
+        /// The bytes of the block, shorter than BlockSize for the last block of the file.
+        std::vector<uint8_t> data;
+
+        /// Order of the last use, the block with the lowest value is dropped first.
+        uint64_t lastUse = 0;
+    };
+
+    /// Stops the fetching threads and closes the connections.
+    void close();
+
+    /// Main function of the fetching threads.
+    /** @param connection The connection of the thread. */
+    void fetchLoop(HttpConnection& connection);
+
+    /// Fetches blocks, from the cache or the server, and keeps them in memory. Called without the lock.
+    /** @param connection The connection for the requests.
+     *  @param firstBlock Index of the first block.
+     *  @param numberOfBlocks Number of consecutive blocks.
+     *  @return "true" on success. */
+    bool fetchBlocks(HttpConnection& connection, uint64_t firstBlock, uint32_t numberOfBlocks);
+
+    /// Requests consecutive blocks from the server and keeps them in memory and in the cache. Called without the lock.
+    /** @param connection The connection for the request.
+     *  @param firstBlock Index of the first block.
+     *  @param numberOfBlocks Number of blocks.
+     *  @return "true" on success. */
+    bool requestBlocks(HttpConnection& connection, uint64_t firstBlock, uint32_t numberOfBlocks);
+
+    /// Keeps a block in memory, dropping the least recently used block when there are too many. Called with the lock.
+    /** @param block Index of the block.
+     *  @param data The bytes of the block, taken. */
+    void insertBlock(uint64_t block, std::vector<uint8_t>& data);
+
+    /// Returns the size of a block.
+    /** @param block Index of the block.
+     *  @return The size in bytes. */
+    uint32_t getBlockSize(uint64_t block) const;
+
+    /// URL of the file.
+    std::string m_url;
+
+    /// Size of the file in bytes.
+    uint64_t m_size = 0;
+
+    /// Validator of the file, as returned by the server when it was opened.
+    std::string m_validator;
+
+    /// Key of the URL for the cache entries.
+    uint32_t m_cacheKey = 0;
+
+    /// Identity of the file for the cache entries, a hash of its size and validator, so that entries of a changed
+    /// file are not used.
+    uint32_t m_cacheIdentity = 0;
+
+    /// Number of connections fetching in the background.
+    uint32_t m_numberOfConnections = 4;
+
+    /// Connection for the blocks fetched by read().
+    HttpConnection m_readConnection;
+
+    /// Connections of the fetching threads.
+    std::vector<std::unique_ptr<HttpConnection>> m_connections;
+
+    /// The fetching threads.
+    std::vector<std::thread> m_threads;
+
+    /// Mutex for the blocks, the queue and the statistics.
+    mutable std::mutex m_mutex;
+
+    /// Condition to wake up the fetching threads, when blocks are queued.
+    std::condition_variable m_fetchCondition;
+
+    /// Condition to signal, that fetching blocks finished.
+    std::condition_variable m_blockCondition;
+
+    /// The blocks in memory by index.
+    std::map<uint64_t, Block> m_blocks;
+
+    /// Blocks to be fetched in the order of the prefetch() calls, may contain blocks already taken.
+    std::deque<uint64_t> m_queue;
+
+    /// Blocks in the queue, which are not taken yet.
+    std::set<uint64_t> m_queuedBlocks;
+
+    /// Blocks queued or being fetched.
+    std::set<uint64_t> m_pendingBlocks;
+
+    /// Counter for the order of use of the blocks.
+    uint64_t m_useCounter = 0;
+
+    /// Flag to terminate the fetching threads.
+    bool m_terminate = false;
+
+    /// The statistics.
+    HttpTileSourceStatistics m_statistics;
+
+    /// Cache of blocks in a local directory, nullptr without cache.
+    std::unique_ptr<DiskCache> m_cache;
+
+    /// Serializes the access to the cache, which is not thread safe.
+    mutable std::mutex m_cacheMutex;
+};
+
+#endif
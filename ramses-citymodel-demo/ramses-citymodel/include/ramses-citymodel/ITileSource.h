@@ -0,0 +1,55 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_ITILESOURCE_H
+#define RAMSES_CITYMODEL_ITILESOURCE_H
+
+#include "ramses-citymodel/ReadPlanner.h"
+
+#include "stdint.h"
+#include "string"
+#include "vector"
+
+/// Source of the bytes of a ".rex" file, read by RexArchive.
+/** Implemented by FileTileSource for local files, MappedTileSource for local files mapped into memory and
+ *  HttpTileSource for files on a web server. read() and prefetch() are called by one thread at a time. */
+class ITileSource
+{
+public:
+    virtual ~ITileSource() {}
+
+    /// Opens the source, closing a source opened before.
+    /** @param name The file name or URL.
+     *  @return "true" on success. */
+    virtual bool open(const std::string& name) = 0;
+
+    /// Returns the size of the file.
+    /** @return The size in bytes. */
+    virtual uint64_t getSize() const = 0;
+
+    /// Reads bytes of the file.
+    /** @param position Position in the file.
+     *  @param buffer The bytes are returned here.
+     *  @param size Number of bytes.
+     *  @return "true", when all bytes were read. */
+    virtual bool read(uint64_t position, void* buffer, uint32_t size) = 0;
+
+    /// Hints the ranges of the file, which are read soon, so that they are fetched in the background.
+    /** @param ranges Positions and sizes of the ranges, in the order they are needed. */
+    virtual void prefetch(const std::vector<ReadPlanner::Slice>& ranges) = 0;
+
+    /// Returns if the source is a local file, which RexArchive reads ahead with AsyncFileReader.
+    /** @return "true" for a local file read with system calls. */
+    virtual bool isLocalFile() const = 0;
+
+    /// Returns the name of the kind of source, for messages.
+    /** @return The name. */
+    virtual const char* getType() const = 0;
+};
+
+#endif
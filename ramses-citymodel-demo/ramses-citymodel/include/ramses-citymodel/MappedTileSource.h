@@ -0,0 +1,52 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_MAPPEDTILESOURCE_H
+#define RAMSES_CITYMODEL_MAPPEDTILESOURCE_H
+
+#include "ramses-citymodel/ITileSource.h"
+
+/// Maps a local file into memory, reads copy from the mapping and page faults read the file.
+/** Saves the system call per read, the pages of the file are shared with the page cache. prefetch() asks the kernel to
+ *  read the pages of the ranges ahead. */
+class MappedTileSource : public ITileSource
+{
+public:
+    /// Destructor, unmaps the file.
+    ~MappedTileSource() override;
+
+    /// Maps a local file, see ITileSource::open().
+    bool open(const std::string& name) override;
+
+    /// See ITileSource::getSize().
+    uint64_t getSize() const override;
+
+    /// Copies from the mapping, see ITileSource::read().
+    bool read(uint64_t position, void* buffer, uint32_t size) override;
+
+    /// Asks the kernel to read the pages of the ranges, see ITileSource::prefetch().
+    void prefetch(const std::vector<ReadPlanner::Slice>& ranges) override;
+
+    /// Returns "false", the mapping is read instead of the file, see ITileSource::isLocalFile().
+    bool isLocalFile() const override;
+
+    /// Returns "mmap", see ITileSource::getType().
+    const char* getType() const override;
+
+private:
+    /// Unmaps the file.
+    void close();
+
+    /// Start of the mapping, nullptr when not open.
+    const uint8_t* m_data = nullptr;
+
+    /// Size of the file in bytes.
+    uint64_t m_size = 0;
+};
+
+#endif
@@ -0,0 +1,116 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_MATERIALCACHE_H
+#define RAMSES_CITYMODEL_MATERIALCACHE_H
+
+#include "ramses-citymodel/Vector4.h"
+
+#include "map"
+#include "stdint.h"
+
+class Material;
+class TextureResidency;
+
+namespace ramses
+{
+    class Effect;
+    class Scene;
+    class Texture2D;
+}
+
+/// Reference counted cache of materials, shared by all tiles.
+/** Materials with the same effect, texture, color and blend mode share one appearance, instead of creating an
+ *  appearance for each material read. Not thread safe, the reader and the main thread call it with the scene
+ *  lock held. */
+class MaterialCache
+{
+public:
+    /// Properties, by which materials are shared.
+    struct Key
+    {
+        /// The effect.
+        const ramses::Effect* effect;
+
+        /// The texture, nullptr for untextured materials.
+        const ramses::Texture2D* texture;
+
+        /// The diffuse color, only set for untextured materials.
+        Vector4 color;
+
+        /// "true", when alpha blending is enabled.
+        bool blending;
+
+        /// Orders the keys for the cache.
+        /** @param other The other key.
+         *  @return "true", when this key is ordered before the other key. */
+        bool operator<(const Key& other) const;
+    };
+
+    /// Destructor, deletes the material objects still cached.
+    ~MaterialCache();
+
+    /// Returns a cached material and increments its reference count.
+    /** @param key Properties of the material.
+     *  @return The material, nullptr when there is no material for the key yet. */
+    Material* acquire(const Key& key);
+
+    /// Adds a newly created material with a reference count of 1.
+    /** @param key Properties of the material.
+     *  @param material The material, owned by the cache from now on. */
+    void add(const Key& key, Material* material);
+
+    /// Sets the texture residency, which is informed before a material is destroyed.
+    /** @param residency The texture residency. */
+    void setTextureResidency(TextureResidency* residency);
+
+    /// Decrements the reference count of a material, the material is destroyed when it is no longer used.
+    /** @param material The material.
+     *  @param scene The RAMSES scene, where the appearance and sampler of the material were created. */
+    void release(Material* material, ramses::Scene& scene);
+
+    /// Returns the number of materials requested, as read from the file.
+    /** @return The number of acquire() calls. */
+    uint32_t getNumberOfRequests() const;
+
+    /// Returns the number of materials created, each with its own appearance.
+    /** @return The number of add() calls. */
+    uint32_t getNumberOfCreatedMaterials() const;
+
+    /// Returns the number of materials currently in use.
+    /** @return The number of cached materials. */
+    uint32_t getNumberOfCachedMaterials() const;
+
+private:
+    /// A cached material.
+    struct Entry
+    {
+        /// The material.
+        Material* material;
+
+        /// Number of users of the material.
+        uint32_t refCount;
+    };
+
+    /// The cached materials by their properties.
+    std::map<Key, Entry> m_entries;
+
+    /// The properties of the cached materials, for finding them on release().
+    std::map<Material*, Key> m_keys;
+
+    /// The texture residency, nullptr when not set.
+    TextureResidency* m_textureResidency = nullptr;
+
+    /// Number of acquire() calls.
+    uint32_t m_numberOfRequests = 0;
+
+    /// Number of add() calls.
+    uint32_t m_numberOfCreatedMaterials = 0;
+};
+
+#endif
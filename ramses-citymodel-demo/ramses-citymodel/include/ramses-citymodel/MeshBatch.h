@@ -0,0 +1,80 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_MESHBATCH_H
+#define RAMSES_CITYMODEL_MESHBATCH_H
+
+#include "ramses-citymodel/Matrix44.h"
+#include "ramses-citymodel/Vector3.h"
+
+#include "stdint.h"
+#include "vector"
+
+class GeometryNode;
+
+/// Mesh merged from the meshes of a tile with the same material.
+/** The transformations of the meshes are baked into the vertices. */
+class MeshBatch
+{
+public:
+    /// Constructor.
+    /** @param hasNormals "true", when the merged meshes have normals.
+     *  @param hasTexCoords "true", when the merged meshes have texture coordinates.
+     *  @param hasTexCoords2 "true", when the merged meshes have second texture coordinates. */
+    MeshBatch(bool hasNormals, bool hasTexCoords, bool hasTexCoords2);
+
+    /// Removes all merged meshes for merging the next batch, keeping the memory of the data.
+    /** @param hasNormals "true", when the merged meshes have normals.
+     *  @param hasTexCoords "true", when the merged meshes have texture coordinates.
+     *  @param hasTexCoords2 "true", when the merged meshes have second texture coordinates. */
+    void reset(bool hasNormals, bool hasTexCoords, bool hasTexCoords2);
+
+    /// Appends the vertices referenced by an index range of a geometry node.
+    /** Only the referenced vertices are copied. The positions are transformed, the normals are transformed with the
+     *  inverse transpose of the transformation.
+     *  @param geometryNode The geometry node, with its vertex data in memory.
+     *  @param transform Transformation of the mesh relative to the merged mesh.
+     *  @param startIndex First index of the range.
+     *  @param indexCount Number of indices of the range.
+     *  @return "true" on success, "false" when the range or an index exceeds the data of the geometry node. */
+    bool append(const GeometryNode& geometryNode, const Matrix44& transform, uint32_t startIndex, uint32_t indexCount);
+
+    /// Returns the number of vertices.
+    /** @return The number of vertices. */
+    uint32_t getNumberOfVertices() const;
+
+    /// Transformed positions of the vertices.
+    std::vector<Vector3> m_positions;
+
+    /// Transformed normals of the vertices, empty without normals.
+    std::vector<Vector3> m_normals;
+
+    /// Texture coordinates of the vertices, 2 floats each, empty without texture coordinates.
+    std::vector<float> m_texCoords;
+
+    /// Second texture coordinates of the vertices, 2 floats each, empty without second texture coordinates.
+    std::vector<float> m_texCoords2;
+
+    /// Indices of the triangles.
+    std::vector<uint32_t> m_indices;
+
+private:
+    /// "true", when the merged meshes have normals.
+    bool m_hasNormals;
+
+    /// "true", when the merged meshes have texture coordinates.
+    bool m_hasTexCoords;
+
+    /// "true", when the merged meshes have second texture coordinates.
+    bool m_hasTexCoords2;
+
+    /// New index of each vertex of the geometry node currently appended, for copying each vertex only once.
+    std::vector<uint32_t> m_remap;
+};
+
+#endif
@@ -0,0 +1,73 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_MESHCODEC_H
+#define RAMSES_CITYMODEL_MESHCODEC_H
+
+#include "stdint.h"
+#include "vector"
+
+/// Lossless encoding of the vertices and indices of EType_EncodedGeometryNode, made for fast decoding.
+/** Indices are stored as variable length differences to the next vertex not referenced yet, which is a single byte for
+ *  most indices of meshes with the vertices in the order of their first use. Each float component is stored as the
+ *  difference of its bits to the previous vertex, zigzag encoded and split into four byte planes, so that the mostly
+ *  zero high bytes follow each other. The entropy coding is left to the codec of the object (LZ4 or zstd). Decoding
+ *  is a single pass without tables and takes a few nanoseconds per vertex, compared to the LZMA decompression of
+ *  OpenCTM. */
+class MeshCodec
+{
+public:
+    /// Number of vertices decoded together, so that their output stays in the cache.
+    static const uint32_t VertexBlockSize = 256;
+
+    /// Maximum number of float components per vertex.
+    static const uint32_t MaxComponents = 4;
+
+    /// Flag of the stored attributes for normals, 3 floats per vertex.
+    static const uint8_t HasNormals = 1;
+
+    /// Flag of the stored attributes for texture coordinates, 2 floats per vertex.
+    static const uint8_t HasTexCoords = 2;
+
+    /// Encodes indices.
+    /** @param indices The indices.
+     *  @param count Number of indices.
+     *  @param data The encoded indices are appended here. */
+    static void EncodeIndices(const uint32_t* indices, uint32_t count, std::vector<uint8_t>& data);
+
+    /// Decodes indices.
+    /** @param data The encoded indices.
+     *  @param size Size of the encoded indices in bytes.
+     *  @param count Number of indices.
+     *  @param numberOfVertices Number of vertices, all indices must be less.
+     *  @param indices The decoded indices are returned here.
+     *  @return "false", when the data is not valid for the given counts. */
+    static bool DecodeIndices(const uint8_t* data, uint32_t size, uint32_t count, uint32_t numberOfVertices, uint32_t* indices);
+
+    /// Returns the size of encoded vertices.
+    /** @param count Number of vertices.
+     *  @param components Number of float components per vertex.
+     *  @return The size in bytes, the same as of the float values. */
+    static uint64_t GetEncodedVertexSize(uint32_t count, uint32_t components);
+
+    /// Encodes vertices.
+    /** @param values The float components of the vertices.
+     *  @param count Number of vertices.
+     *  @param components Number of components per vertex, at most MaxComponents.
+     *  @param data GetEncodedVertexSize() bytes are appended here. */
+    static void EncodeVertices(const float* values, uint32_t count, uint32_t components, std::vector<uint8_t>& data);
+
+    /// Decodes vertices.
+    /** @param data The encoded vertices, GetEncodedVertexSize() bytes.
+     *  @param count Number of vertices.
+     *  @param components Number of components per vertex.
+     *  @param values The float components are returned here, components * count values. */
+    static void DecodeVertices(const uint8_t* data, uint32_t count, uint32_t components, float* values);
+};
+
+#endif
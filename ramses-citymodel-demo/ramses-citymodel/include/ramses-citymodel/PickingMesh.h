@@ -0,0 +1,99 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+
+#ifndef RAMSES_CITYMODEL_PICKINGMESH_H
+#define RAMSES_CITYMODEL_PICKINGMESH_H
+
+#include "ramses-citymodel/Vector3.h"
+
+#include "stddef.h"
+#include "stdint.h"
+#include "string"
+#include "vector"
+
+/// How much of the geometry is kept in memory for computing intersections with the mouse ray.
+enum EPickingGeometry
+{
+    EPickingGeometry_None = 0,
+    EPickingGeometry_Compact,
+    EPickingGeometry_Full,
+    EPickingGeometry_NumberOfModes
+};
+
+/// Triangles of a geometry node kept in memory for computing intersections.
+/** EPickingGeometry_Full keeps float positions and 32 bit indices. EPickingGeometry_Compact quantizes the positions
+ *  to 16 bit in the bounding box of the geometry and uses 16 bit indices, when there are at most 65536 vertices, which
+ *  takes less than half of the memory. The position error is at most 1/131070 of the bounding box size. */
+class PickingMesh
+{
+public:
+    /// Returns the name of a mode.
+    /** @param mode The mode.
+     *  @return The name, as used for command line options. */
+    static const char* GetName(EPickingGeometry mode);
+
+    /// Finds a mode by name.
+    /** @param name The name of the mode (none, compact or full).
+     *  @param mode The mode is returned here.
+     *  @return "true", when the name is known. */
+    static bool FromName(const std::string& name, EPickingGeometry& mode);
+
+    /// Sets the triangles.
+    /** @param mode How the triangles are kept, EPickingGeometry_None keeps nothing.
+     *  @param positions The vertex positions, 3 floats per vertex.
+     *  @param numberOfVertices Number of vertices.
+     *  @param indices The vertex indices, 3 per triangle.
+     *  @param numberOfIndices Number of indices. */
+    void set(EPickingGeometry mode,
+             const float*     positions,
+             uint32_t         numberOfVertices,
+             const uint32_t*  indices,
+             uint32_t         numberOfIndices);
+
+    /// Returns the number of triangles.
+    /** @return The number of triangles. */
+    uint32_t getNumberOfTriangles() const;
+
+    /// Returns the corners of a triangle.
+    /** @param triangle Index of the triangle.
+     *  @param a First corner is returned here.
+     *  @param b Second corner is returned here.
+     *  @param c Third corner is returned here. */
+    void getTriangle(uint32_t triangle, Vector3& a, Vector3& b, Vector3& c) const;
+
+    /// Returns the memory used for the triangles.
+    /** @return The size in bytes. */
+    size_t getMemorySize() const;
+
+private:
+    /// Returns the position of a vertex.
+    /** @param index Index of the vertex.
+     *  @return The position. */
+    Vector3 getPosition(uint32_t index) const;
+
+    /// Float positions of EPickingGeometry_Full.
+    std::vector<Vector3> m_positions;
+
+    /// Quantized positions of EPickingGeometry_Compact, 3 values per vertex.
+    std::vector<uint16_t> m_quantizedPositions;
+
+    /// Minimum corner of the bounding box, to which the positions are quantized.
+    Vector3 m_offset;
+
+    /// Size of a quantization step.
+    Vector3 m_scale;
+
+    /// 32 bit indices.
+    std::vector<uint32_t> m_indices;
+
+    /// 16 bit indices of EPickingGeometry_Compact.
+    std::vector<uint16_t> m_shortIndices;
+};
+
+#endif
@@ -0,0 +1,64 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_READPLANNER_H
+#define RAMSES_CITYMODEL_READPLANNER_H
+
+#include "stdint.h"
+#include "vector"
+
+/// Plans the reads of objects from a file, merging objects with nearby positions into one read.
+/** Objects, which are stored one after the other, as the tiles of a repacked file along the animation path often are,
+ *  are read with a single read instead of one read each, which saves system calls and seeks. Gaps between the objects
+ *  up to the gap tolerance are read as well and skipped when the read is sliced into the objects. */
+class ReadPlanner
+{
+public:
+    /// Default maximum size of a merged read, so that the first object of a read is not delayed too long.
+    static const uint32_t DefaultMaximumReadSize = 4 * 1024 * 1024;
+
+    /// An object to be read, the part of a read with its data.
+    struct Slice
+    {
+        /// Index of the object.
+        uint32_t index;
+
+        /// Position of the object in the file.
+        uint64_t position;
+
+        /// Size of the object in bytes.
+        uint32_t size;
+    };
+
+    /// A read of one or more objects.
+    struct Read
+    {
+        /// Position in the file.
+        uint64_t position;
+
+        /// Size in bytes, including the gaps between the objects.
+        uint32_t size;
+
+        /// First slice of the read in the sorted slices.
+        uint32_t firstSlice;
+
+        /// Number of slices of the read.
+        uint32_t numberOfSlices;
+    };
+
+    /// Plans the reads of objects.
+    /** Objects are merged, when the gap to the previous object is not larger than the gap tolerance and the read
+     *  stays within the maximum read size. Overlapping objects are merged as well.
+     *  @param gapTolerance Maximum gap in bytes between two objects of a read.
+     *  @param maximumReadSize Maximum size of a read in bytes, single objects may be larger.
+     *  @param slices The objects, sorted by their position on return, so that the slices of a read follow each other.
+     *  @param reads The reads are returned here, in the order of their positions. */
+    static void Plan(uint32_t gapTolerance, uint32_t maximumReadSize, std::vector<Slice>& slices, std::vector<Read>& reads);
+};
+
+#endif
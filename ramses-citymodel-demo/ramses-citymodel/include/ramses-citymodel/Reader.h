@@ -12,14 +12,26 @@
 #include "ramses-client-api/Texture2D.h"
 #include "ramses-client-api/Vector2fArray.h"
 #include "ramses-client-api/Effect.h"
+#include "ramses-client-api/AttributeInput.h"
+#include "ramses-client-api/UniformInput.h"
 #include "openctm.h"
 
-#include "fstream"
+#include "map"
+#include "memory"
 #include "vector"
 #include "mutex"
 
 #include "ramses-citymodel/AnimationPath.h"
 #include "ramses-citymodel/BoundingBox.h"
+#include "ramses-citymodel/DecodeArena.h"
+#include "ramses-citymodel/EObjectType.h"
+#include "ramses-citymodel/DiskCache.h"
+#include "ramses-citymodel/MaterialCache.h"
+#include "ramses-citymodel/MeshBatch.h"
+#include "ramses-citymodel/PickingMesh.h"
+#include "ramses-citymodel/TextureCache.h"
+#include "ramses-citymodel/TextureResidency.h"
+#include "ramses-citymodel/RexArchive.h"
 #include "ramses-citymodel/Vector4.h"
 
 class Tile;
@@ -37,8 +49,12 @@ namespace ramses
     class Vector2fArray;
     class Vector3fArray;
     class Vector4fArray;
+    class Resource;
+    class UInt16Array;
     class UInt32Array;
     class Effect;
+    class GeometryBinding;
+    class MeshNode;
 }
 
 class GeometryNode
@@ -51,8 +67,45 @@ public:
     const ramses::UInt32Array*   m_indexArray = nullptr;
     ramses::Effect*              m_effect     = nullptr;
 
-    std::vector<Vector3>  m_positionsData;
-    std::vector<uint32_t> m_indexData;
+    /// 16 bit indices, used instead of m_indexArray for geometry with at most RexIndexArray::MaxShortIndexVertices
+    /// vertices.
+    const ramses::UInt16Array* m_shortIndexArray = nullptr;
+
+    /// Vertex data only kept for batching, in the object data or the decode arena of the reader until the tile is
+    /// read, see m_hasVertexData.
+    const Vector3*  m_positionsData    = nullptr;
+    const uint32_t* m_indexData        = nullptr;
+    const Vector3*  m_normalsData      = nullptr;
+    const float*    m_texCoordsData    = nullptr;
+    const float*    m_texCoords2Data   = nullptr;
+    uint32_t        m_numberOfVertices = 0;
+    uint32_t        m_numberOfIndices  = 0;
+
+    /// "true", when the geometry was read for batching, with all vertex data in memory instead of RAMSES resources.
+    bool m_hasVertexData = false;
+
+    /// Triangles kept for computing intersections, depending on the picking geometry mode of the reader.
+    PickingMesh m_pickingMesh;
+
+    /// Geometry bindings of the geometry node by effect, shared by all mesh nodes using the geometry node.
+    std::map<const ramses::Effect*, ramses::GeometryBinding*> m_geometryBindings;
+};
+
+/// Elements of a vertex or index array resource, in the object data or in an aligned copy of it.
+class ArrayElements
+{
+public:
+    const void* m_data;
+    uint32_t    m_numberOfValues;
+};
+
+/// Geometry nodes of one encoding read and the time for decoding their vertices and indices.
+class GeometryDecodeStatistics
+{
+public:
+    uint32_t m_numberOfGeometryNodes = 0;
+    uint64_t m_numberOfVertices      = 0;
+    float    m_decodeTime            = 0.0f;
 };
 
 /// Reader class for reading citymodel "rex" files.
@@ -73,52 +126,246 @@ public:
     ramses::Effect* getEffect(uint32_t effectIndex);
 
     /// Opens a file for reading.
-    /** @param filename The name of the file to be read. */
-    void open(const std::string& filename);
+    /** @param filename The name of the file to be read.
+     *  @param verifyChecksums "true" for checking the checksum of each object read.
+     *  @return "true" on success. */
+    bool open(const std::string& filename, bool verifyChecksums = false);
+
+    /// Enables reading tiles ahead asynchronously, see RexArchive::setReadQueue(). Call before open().
+    /** @param queueDepth Maximum number of tiles read ahead, 0 (the default) reads each tile synchronously.
+     *  @param useIoUring "true" for reading with io_uring when available, "false" for reading with pread. */
+    void setReadQueue(uint32_t queueDepth, bool useIoUring);
+
+    /// Sets the gap tolerance for merging the reads ahead of tiles, see RexArchive::setReadCoalescing().
+    /** @param gapTolerance Maximum gap in bytes between the tiles of a read. */
+    void setReadCoalescing(uint32_t gapTolerance);
+
+    /// Starts reading the objects of the tiles loaded next in the background.
+    /** Called by the pager thread before a tile is read.
+     *  @param indices The object indices, in the order they are read. */
+    void prefetch(const std::vector<uint32_t>& indices);
+
+    /// Returns if the tiles are read ahead with io_uring.
+    /** @return "true" for io_uring, "false" for pread or without read queue. */
+    bool usesIoUring() const;
+
+    /// Returns the number of tiles read, whose data was read ahead.
+    /** Call with the scene lock held.
+     *  @return The number of tiles. */
+    uint32_t getNumberOfPrefetchedReads() const;
+
+    /// Returns the number of tiles read ahead, which were dropped without being read.
+    /** Call with the scene lock held.
+     *  @return The number of tiles. */
+    uint32_t getNumberOfDroppedPrefetches() const;
+
+    /// Returns the number of read operations for tiles, a merged read of several tiles counts once.
+    /** Call with the scene lock held.
+     *  @return The number of read operations. */
+    uint32_t getNumberOfReadOperations() const;
+
+    /// Returns the number of bytes read for tiles.
+    /** Call with the scene lock held.
+     *  @return The number of bytes. */
+    uint64_t getReadSize() const;
+
+    /// Enables the persistent cache of decoded CTM geometry.
+    /** Tiles read again, in this run or a later one, copy the decoded vertices and indices from the cache instead of
+     *  decoding them. Only files with checksums are cached.
+     *  @param directory The cache directory, created when it does not exist.
+     *  @param maximumSize Maximum size of the cache in bytes.
+     *  @return "true" on success, the cache stays disabled otherwise. */
+    bool setGeometryCache(const std::string& directory, uint64_t maximumSize);
+
+    /// Sets the source of the bytes of the file, see RexArchive::setTileSource(). Call before open().
+    /** @param source The source, nullptr for the default. */
+    void setTileSource(std::unique_ptr<ITileSource> source);
 
     /// Reads an object from the file.
     /** @param index Index of the object to be read.
      *  @param resourceContainer The container where the tile related resources are stored
      *  @param resetIds When set to "true", read objects are not referenced by further reads.
-     *  @return The read object. */
+     *  @return The read object, nullptr when the object could not be read from the file. */
     void* read(uint32_t index, TileResourceContainer& resourceContainer, bool resetIds = true);
 
+    /// Reads the finer levels of the textures of an object for upgrade requests of the texture residency and creates
+    /// the finer textures, see TextureResidency::setLevelLoader().
+    /** The object is read and decompressed once for all requests. Called by the thread reading the tiles.
+     *  @param objectIndex Index of the object storing the textures.
+     *  @param requests The upgrade requests. */
+    void readTextureLevels(uint32_t objectIndex, const std::vector<TextureResidency::UpgradeRequest>& requests);
+
     std::mutex& getSceneLock();
 
+    /// Returns the archive of the opened file.
+    /** @return The archive. */
+    const RexArchive& getArchive() const;
+
+    /// Enables merging the meshes of a tile with the same material into a single mesh, when the tile is read.
+    /** The transformations of the meshes are baked into the vertices, so that a tile needs fewer mesh nodes,
+     *  geometry bindings and array resources. Off by default.
+     *  @param batchMeshes "true" for merging the meshes. */
+    void setBatchMeshes(bool batchMeshes);
+
+    /// Sets how much of the geometry is kept in memory for computing intersections with the mouse ray.
+    /** @param pickingGeometry The mode, EPickingGeometry_Compact by default. */
+    void setPickingGeometry(EPickingGeometry pickingGeometry);
+
+    /// Returns the memory used for the picking meshes of all tiles read so far, including unloaded tiles.
+    /** Call with the scene lock held.
+     *  @return The size in bytes. */
+    uint64_t getPickingGeometrySize() const;
+
+    /// Returns the size of the vertex and index array elements of all tiles read.
+    /** Call with the scene lock held.
+     *  @return The size in bytes. */
+    uint64_t getArraySize() const;
+
+    /// Returns the size of the array elements of all tiles read, which were copied before creating the resources.
+    /** The elements are only copied for files without aligned arrays, and for merging when batching.
+     *  Call with the scene lock held.
+     *  @return The size in bytes. */
+    uint64_t getCopiedArraySize() const;
+
+    /// Returns the number of index array resources created for all tiles read.
+    /** Call with the scene lock held.
+     *  @return The number of index arrays. */
+    uint32_t getNumberOfIndexArrays() const;
+
+    /// Returns the number of index array resources created with 16 bit indices.
+    /** Call with the scene lock held.
+     *  @return The number of 16 bit index arrays. */
+    uint32_t getNumberOfShortIndexArrays() const;
+
+    /// Returns the index memory saved by 16 bit indices for all tiles read.
+    /** Call with the scene lock held.
+     *  @return The size in bytes. */
+    uint64_t getShortIndexSavedSize() const;
+
+    /// Returns the CTM geometry nodes of all tiles read and the time for decoding them.
+    /** Call with the scene lock held.
+     *  @return The statistics. */
+    const GeometryDecodeStatistics& getCTMDecodeStatistics() const;
+
+    /// Returns the EType_EncodedGeometryNode geometry nodes of all tiles read and the time for decoding them.
+    /** Call with the scene lock held.
+     *  @return The statistics. */
+    const GeometryDecodeStatistics& getEncodedDecodeStatistics() const;
+
+    /// Returns the CTM geometry nodes of all tiles read, which were taken from the geometry cache, and the time for
+    /// loading them.
+    /** Call with the scene lock held.
+     *  @return The statistics. */
+    const GeometryDecodeStatistics& getCachedDecodeStatistics() const;
+
+    /// Returns the statistics of the geometry cache, after the last tile read.
+    /** Call with the scene lock held.
+     *  @return The statistics, all 0 when the cache is disabled. */
+    const DiskCacheStatistics& getGeometryCacheStatistics() const;
+
+    /// Enables the decode arena for the temporaries of reading a tile.
+    /** When disabled, each temporary is allocated from the heap, for comparing the number of allocations.
+     *  @param enabled "true" for using the arena (the default). */
+    void setDecodeArena(bool enabled);
+
+#ifdef RAMSES_CITYMODEL_COUNT_ALLOCATIONS
+    /// Returns the number of heap allocations of the reader thread while reading all tiles so far.
+    /** Includes the allocations of RAMSES and OpenCTM. Call with the scene lock held.
+     *  @return The number of allocations. */
+    uint64_t getNumberOfAllocations() const;
+#endif
+
+    /// Returns the memory held by the decode arena after the last tile read.
+    /** Call with the scene lock held.
+     *  @return The size in bytes. */
+    size_t getDecodeArenaSize() const;
+
+    /// Returns the number of meshes of the file, which were merged into batches.
+    /** Call with the scene lock held.
+     *  @return The number of merged meshes. */
+    uint32_t getNumberOfBatchedMeshes() const;
+
+    /// Returns the number of tiles read.
+    /** Call with the scene lock held.
+     *  @return The number of tiles. */
+    uint32_t getNumberOfTilesRead() const;
+
+    /// Returns the time spent reading tiles, including decompression and creating the scene objects.
+    /** Call with the scene lock held.
+     *  @return The time in seconds. */
+    float getTileReadTime() const;
+
+    /// Returns the number of mesh nodes created.
+    /** Call with the scene lock held.
+     *  @return The number of mesh nodes. */
+    uint32_t getNumberOfMeshes() const;
+
+    /// Returns the time spent for creating mesh nodes and their geometry bindings.
+    /** Call with the scene lock held.
+     *  @return The time in seconds. */
+    float getMeshCreationTime() const;
+
+    /// Returns the number of geometry bindings created for the mesh nodes.
+    /** Call with the scene lock held.
+     *  @return The number of geometry bindings. */
+    uint32_t getNumberOfGeometryBindings() const;
+
+    /// Returns the cache of the materials shared by the tiles.
+    /** @return The material cache. */
+    const MaterialCache& getMaterialCache() const;
+
+    /// Returns the cache of the textures shared by the tiles.
+    /** Call with the scene lock held.
+     *  @return The texture cache. */
+    const TextureCache& getTextureCache() const;
+
+    /// Returns the residency of the fine texture levels.
+    /** Call with the scene lock held.
+     *  @return The texture residency. */
+    TextureResidency& getTextureResidency();
+
+    /// Sets the tiles, which were created from the tile index before the scene is read.
+    /** The scene then refers to these tiles, instead of creating new ones.
+     *  @param tiles The tiles, tile i is the i-th tile of the scene. */
+    void setTiles(const std::vector<Tile*>& tiles);
+
 protected:
-    /// Reference of object data in a ".rex" file.
-    class FileReference
+    /// Inputs of an effect, found when the effect is added.
+    struct EffectInputs
     {
-    public:
-        /// Constructor.
-        /** @param position Byte position in the file
-         *  @param compressedSize Stored size of the data in bytes.
-         *  @param uncompressedSize Size of the data, when uncompressed. */
-        FileReference(uint64_t position, uint32_t compressedSize, uint32_t uncompressedSize);
-
-        /// Returns the position in the file.
-        /** @return The position in bytes. */
-        uint64_t position() const;
-
-        /// Compressed size of the data in bytes.
-        /** @return The size in bytes. */
-        uint32_t compressedSize() const;
-
-        /// Uncompressed size of the data in bytes.
-        /** @return The size in bytes. */
-        uint32_t uncompressedSize() const;
-
-    protected:
-        /// The position in bytes.
-        uint64_t m_position;
-
-        /// Compressed size of the data in bytes.
-        uint32_t m_compressedSize;
-
-        /// Uncompressed size of the data in bytes.
-        uint32_t m_uncompressedSize;
+        /// The effect.
+        const ramses::Effect* effect = nullptr;
+
+        /// Vertex positions ("a_position").
+        ramses::AttributeInput positions;
+
+        /// Vertex normals ("a_normal").
+        ramses::AttributeInput normals;
+
+        /// Texture coordinates ("a_texcoord").
+        ramses::AttributeInput texCoords;
+
+        /// Second texture coordinates ("a_customAttribute").
+        ramses::AttributeInput texCoords2;
+
+        /// Texture sampler ("u_texture").
+        ramses::UniformInput texture;
+
+        /// Diffuse color ("u_color").
+        ramses::UniformInput color;
+
+        /// Car position, bound to the scene ("u_carPos").
+        ramses::UniformInput carPos;
+
+        /// Light cone scale, bound to the scene ("u_lightConeScale").
+        ramses::UniformInput lightConeScale;
     };
 
+    /// Returns the inputs of an effect.
+    /** @param effect The effect, which must have been added by addEffect().
+     *  @return The inputs. */
+    const EffectInputs& getEffectInputs(const ramses::Effect& effect) const;
+
     /// Reads an object from the file.
     /** Can be either the object itself, or when already read just the pointer
      *  to the read object is returned.
@@ -141,16 +388,132 @@ protected:
      *  @return The read mesh node. */
     ramses::Node* readMeshNode(TileResourceContainer& resourceContainer);
 
+    /// Sets up a mesh node with the material and a range of the geometry of a geometry node.
+    /** @param mesh The mesh node.
+     *  @param material The material.
+     *  @param geometryNode The geometry node.
+     *  @param startIndex First index of the range.
+     *  @param indexCount Number of indices of the range.
+     *  @param renderOrder Render order of the mesh in the render group.
+     *  @param resourceContainer Created objects are stored here. */
+    void setupMeshNode(ramses::MeshNode&      mesh,
+                       Material&              material,
+                       GeometryNode&          geometryNode,
+                       uint32_t               startIndex,
+                       uint32_t               indexCount,
+                       uint32_t               renderOrder,
+                       TileResourceContainer& resourceContainer);
+
+    /// Merges the meshes of a tile read while batching, with the same material, render order and vertex attributes.
+    /** The merged meshes are added as children of the root node of the tile.
+     *  @param root Root node of the tile.
+     *  @param resourceContainer Created objects are stored here. */
+    void batchMeshes(ramses::Node& root, TileResourceContainer& resourceContainer);
+
+    /// Creates a geometry node with the RAMSES resources of merged meshes.
+    /** @param meshBatch The merged meshes, the positions and indices are moved to the geometry node.
+     *  @param resourceContainer Created objects are stored here.
+     *  @return The geometry node. */
+    GeometryNode* createGeometryNode(MeshBatch& meshBatch, TileResourceContainer& resourceContainer);
+
     ///// Reads a ramses geometry node from the file.
-    /** @param resourceContainer Loaded resources are stored here.
+    /** @param type EType_GeometryNode or EType_EncodedGeometryNode.
+        @param resourceContainer Loaded resources are stored here.
         @return The geometry node. */
-    GeometryNode* readGeometryNode(TileResourceContainer& resourceContainer);
+    GeometryNode* readGeometryNode(EObjectType type, TileResourceContainer& resourceContainer);
+
+    /// Decoded vertices and indices of a CTM geometry node.
+    struct DecodedGeometry
+    {
+        /// The positions, 3 floats per vertex.
+        const float* positions = nullptr;
+
+        /// The texture coordinates, 2 floats per vertex, nullptr when not available.
+        const float* texCoords = nullptr;
+
+        /// The indices.
+        const uint32_t* indices = nullptr;
+
+        /// Number of vertices.
+        uint32_t numberOfVertices = 0;
+
+        /// Number of indices.
+        uint32_t numberOfIndices = 0;
+    };
+
+    /// Computes the key of a file in the geometry cache, from the positions, sizes and checksums of its objects.
+    /** @param archive The opened archive.
+     *  @return The key, 0 for files without checksums, which can not be cached. */
+    static uint32_t ComputeGeometryCacheKey(const RexArchive& archive);
+
+    /// Takes the next CTM geometry node of the object currently read from its geometry cache entry, and skips its
+    /// CTM data.
+    /** @param geometry The geometry is returned here, valid until the next object is read.
+     *  @return "true" on success, "false" when the geometry must be decoded. */
+    bool readCachedGeometry(DecodedGeometry& geometry);
+
+    /// Appends a decoded CTM geometry node to the geometry cache entry of the object currently read.
+    /** @param geometry The geometry.
+     *  @param ctmSize Size of the CTM data of the geometry node in bytes. */
+    void recordGeometry(const DecodedGeometry& geometry, uint32_t ctmSize);
+
+    /// Decodes the vertices and indices of an EType_EncodedGeometryNode into the decode arena and creates the
+    /// resources of the geometry node from them, or sets its vertex data when batching.
+    /** @param geometryNode The geometry node.
+     *  @param resourceContainer Loaded resources are stored here.
+     *  @return false, if the sizes do not fit the object data or the indices are invalid. */
+    bool readEncodedGeometry(GeometryNode& geometryNode, TileResourceContainer& resourceContainer);
 
     /// Reads a material from the file.
     /** @param resourceContainer Loaded resources are stored here.
      *  @return The read material. */
     Material* readMaterial(TileResourceContainer& resourceContainer);
 
+    /// Creates a material for the material cache. Called with the scene lock held.
+    /** @param effect The effect.
+     *  @param texture The texture, nullptr for untextured materials.
+     *  @param key Properties of the material.
+     *  @return The created material. */
+    Material* createMaterial(ramses::Effect& effect, ramses::Texture2D* texture, const MaterialCache::Key& key);
+
+    /// Sets the vertex data of a geometry node read while batching.
+    /** @param geometryNode The geometry node.
+     *  @param positions The positions, nullptr when not read into memory.
+     *  @param normals The normals, nullptr when not available.
+     *  @param texCoords The texture coordinates, nullptr when not available.
+     *  @param texCoords2 The second texture coordinates, nullptr when not available.
+     *  @param indices The indices, nullptr when not read into memory. */
+    void setVertexData(GeometryNode&        geometryNode,
+                       const ArrayElements* positions,
+                       const ArrayElements* normals,
+                       const ArrayElements* texCoords,
+                       const ArrayElements* texCoords2,
+                       const ArrayElements* indices);
+
+    /// Reads a vertex or index array into memory, used instead of the resource while batching.
+    /** @param type Type of the array object.
+     *  @return The array elements, valid until the current object is read. */
+    void* readArrayData(EObjectType type);
+
+    /// Returns the elements of an array of the tile currently read.
+    /** @param object The array read while batching, or the position or index array resource for the picking meshes.
+     *  @return The elements, nullptr when the object is no array or the elements are not kept. */
+    const ArrayElements* findArrayElements(const void* object) const;
+
+    /// Reads the elements of a vertex or index array, after the padding of files with aligned arrays.
+    /** Returns the elements in place, when they are aligned. Otherwise they are copied into a buffer, which is kept
+     *  in the decode arena until the end of the read.
+     *  @param size Size of the elements in bytes.
+     *  @return The elements, aligned to RexArchive::ArrayAlignment. */
+    const uint8_t* readArrayElements(uint32_t size);
+
+    /// Reads the elements of a quantized vertex array and dequantizes them.
+    /** @param type EType_QuantizedVertexArrayResource2f, EType_QuantizedVertexArrayResource3f or
+     *  EType_OctahedralNormalArrayResource.
+     *  @param n Number of elements.
+     *  @return The float elements, 2 or 3 per element, kept in the decode arena until the end of the read. */
+    const float* readQuantizedArrayElements(EObjectType type, uint32_t n);
+
     /// Reads a ramses vector2f array resource from the file.
     /** @param resourceContainer Loaded resources are stored here.
      *  @return The read vertex array resource. */
@@ -161,20 +524,54 @@ protected:
      *  @return The read vertex array resource. */
     void* readVector3fArrayResource(TileResourceContainer& resourceContainer);
 
+    /// Reads a quantized vertex array from the file and creates a ramses vector2f or vector3f array resource.
+    /** @param type EType_QuantizedVertexArrayResource2f, EType_QuantizedVertexArrayResource3f or
+     *  EType_OctahedralNormalArrayResource.
+     *  @param resourceContainer Loaded resources are stored here.
+     *  @return The created vertex array resource. */
+    void* readQuantizedVertexArrayResource(EObjectType type, TileResourceContainer& resourceContainer);
+
     /// Reads a ramses vector4f array resource from the file.
     /** @param resourceContainer Loaded resources are stored here.
      *  @return The read vertex array resource. */
     void* readVector4fArrayResource(TileResourceContainer& resourceContainer);
 
     /// Reads a ramses index array resource from the file.
-    /** @param resourceContainer Loaded resources are stored here.
-     *  @return The read index array resource. */
-    const ramses::UInt32Array* readIndexArrayResource(TileResourceContainer& resourceContainer);
+    /** 32 bit indices are narrowed to 16 bit, when all of them are less than RexIndexArray::MaxShortIndexVertices.
+     *  @param type EType_IndexArrayResource or EType_ShortIndexArrayResource.
+     *  @param resourceContainer Loaded resources are stored here.
+     *  @return The read index array resource, an UInt16Array or an UInt32Array. */
+    void* readIndexArrayResource(EObjectType type, TileResourceContainer& resourceContainer);
+
+    /// Reads the elements of an EType_ShortIndexArrayResource and widens them to 32 bit.
+    /** @param n Number of indices.
+     *  @return The indices, kept in the decode arena until the end of the read. */
+    const uint32_t* readShortIndexElements(uint32_t n);
+
+    /// Creates an index array resource, with 16 bit indices when the geometry allows it.
+    /** @param indices The indices.
+     *  @param numberOfIndices Number of indices.
+     *  @param shortIndices "true" for creating 16 bit indices, all indices must be less than
+     *                      RexIndexArray::MaxShortIndexVertices.
+     *  @param resourceContainer The created resource is stored here.
+     *  @return The resource, an UInt16Array or an UInt32Array. */
+    const ramses::Resource* createIndexArray(const uint32_t*        indices,
+                                             uint32_t               numberOfIndices,
+                                             bool                   shortIndices,
+                                             TileResourceContainer& resourceContainer);
+
+    /// Sets the index array of a geometry node.
+    /** @param geometryNode The geometry node.
+     *  @param indexArray An UInt16Array or an UInt32Array, or nullptr. */
+    static void SetIndexArray(GeometryNode& geometryNode, const ramses::Resource* indexArray);
 
     /// Reads a ramses texture 2d resource from the file.
-    /** @param resourceContainer Loaded resources are stored here.
+    /** Textures with the same content as an already created texture share it through the texture cache. Of textures
+     *  with mip levels, only the coarse levels are created, when the texture residency is enabled.
+     *  @param resourceContainer Loaded resources are stored here.
+     *  @param mipMaps "true" for EType_Texture2DMipMapResource, which stores all mip levels.
      *  @return The read texture 2d resource. */
-    ramses::Texture2D* readTexture2DResource(TileResourceContainer& resourceContainer);
+    ramses::Texture2D* readTexture2DResource(TileResourceContainer& resourceContainer, bool mipMaps);
 
     /// Reads a scene from the file.
     /** @param resourceContainer Loaded resources are stored here.
@@ -235,6 +632,18 @@ protected:
     /** The id is used, when the same object is referenced later by an other read object. */
     uint32_t createId();
 
+    /// Sets the picking mesh of a geometry node, as configured by setPickingGeometry().
+    /** @param geometryNode The geometry node.
+     *  @param positions The vertex positions, 3 floats per vertex.
+     *  @param numberOfVertices Number of vertices.
+     *  @param indices The vertex indices.
+     *  @param numberOfIndices Number of indices. */
+    void setPickingMesh(GeometryNode&   geometryNode,
+                        const float*    positions,
+                        uint32_t        numberOfVertices,
+                        const uint32_t* indices,
+                        uint32_t        numberOfIndices);
+
     /// Reads an animation path from the file.
     /** @param animationPath The read animation path is returned here. */
     void readAnimationPath(AnimationPath& animationPath);
@@ -267,15 +676,18 @@ protected:
      *  @param userData The reader instance. */
     static CTMuint CTMRead(void* buffer, CTMuint count, void* userData);
 
-    /// The input stream.
-    std::ifstream m_f;
+    /// The ".rex" archive file.
+    RexArchive m_archive;
 
-    /// Data read from the file.
-    uint8_t* m_dataBuffer = nullptr;
+    /// Decompressed data of the object currently read.
+    std::vector<uint8_t> m_dataBuffer;
 
     /// Pointer to the current data in the buffer mDataBuffer.
     uint8_t* m_data = nullptr;
 
+    /// Index of the object currently read.
+    uint32_t m_objectIndex = 0;
+
     /// Stores all read objects.
     std::vector<void*> m_object;
 
@@ -288,14 +700,166 @@ protected:
     /// The read scene.
     CitymodelScene* m_scene = nullptr;
 
+    /// Materials shared by all tiles.
+    MaterialCache m_materialCache;
+
+    /// Textures shared by all tiles.
+    TextureCache m_textureCache;
+
+    /// Residency of the fine levels of the textures with mip levels.
+    TextureResidency m_textureResidency;
+
     /// List of effects.
     std::vector<ramses::Effect*> m_effects;
 
-    /// List of objects referencing the "rex" archive file.
-    std::vector<FileReference> m_objectReferences;
+    /// Inputs of the effects, in the order of m_effects.
+    std::vector<EffectInputs> m_effectInputs;
+
+    /// A mesh read while batching, which is merged after the tile is read.
+    struct PendingMesh
+    {
+        /// Node with the transformation of the mesh.
+        ramses::Node* node;
+
+        /// The material.
+        Material* material;
+
+        /// The geometry node, with the vertex data in memory.
+        GeometryNode* geometryNode;
+
+        /// First index of the mesh.
+        uint32_t startIndex;
+
+        /// Number of indices of the mesh.
+        uint32_t indexCount;
+
+        /// Render order of the mesh.
+        uint32_t renderOrder;
+    };
+
+    /// "true", when the meshes of the tiles are merged.
+    bool m_batchMeshes = false;
+
+    /// "true", while a tile is read with batching.
+    bool m_batching = false;
+
+    /// Meshes of the tile currently read, to be merged.
+    std::vector<PendingMesh> m_pendingMeshes;
+
+    /// Merged meshes of a batch, reused for all batches.
+    MeshBatch m_meshBatch;
+
+    /// Memory for the temporaries of the object currently read, reset after each read.
+    DecodeArena m_arena;
+
+    /// Elements of the arrays of the tile currently read, by object: the arrays read while batching, and the position
+    /// and index array resources for the picking meshes. Allocated in the decode arena.
+    std::map<const void*, ArrayElements, std::less<const void*>, ArenaAllocator<std::pair<const void* const, ArrayElements>>>
+        m_arrayElements;
+
+    /// Size of the array elements of the tile currently read.
+    uint64_t m_tileArraySize = 0;
+
+    /// Size of the copied array elements of the tile currently read.
+    uint64_t m_tileCopiedArraySize = 0;
+
+    /// Size of the array elements of all tiles read.
+    uint64_t m_arraySize = 0;
+
+    /// Size of the copied array elements of all tiles read.
+    uint64_t m_copiedArraySize = 0;
+
+    /// Number of index array resources created for all tiles read.
+    uint32_t m_numberOfIndexArrays = 0;
+
+    /// Number of index array resources created with 16 bit indices.
+    uint32_t m_numberOfShortIndexArrays = 0;
+
+    /// Index memory saved by 16 bit indices.
+    uint64_t m_shortIndexSavedSize = 0;
+
+    /// CTM geometry nodes read and their decoding time.
+    GeometryDecodeStatistics m_ctmDecodeStatistics;
+
+    /// Encoded geometry nodes read and their decoding time.
+    GeometryDecodeStatistics m_encodedDecodeStatistics;
+
+    /// CTM geometry nodes taken from the geometry cache and their loading time.
+    GeometryDecodeStatistics m_cachedDecodeStatistics;
+
+    /// Persistent cache of decoded CTM geometry, nullptr when disabled.
+    std::unique_ptr<DiskCache> m_geometryCache;
+
+    /// Key of the opened file in the geometry cache, 0 when the file can not be cached.
+    uint32_t m_geometryCacheKey = 0;
+
+    /// Statistics of the geometry cache after the last tile read.
+    DiskCacheStatistics m_geometryCacheStatistics;
+
+    /// Geometry cache entry of the object currently read, empty when there is none.
+    std::vector<uint8_t> m_cachedGeometry;
+
+    /// Position of the next geometry node in m_cachedGeometry.
+    size_t m_cachedGeometryPosition = 0;
+
+    /// "true", when the decoded geometry of the object currently read is recorded for the geometry cache.
+    bool m_recordGeometry = false;
+
+    /// Decoded geometry of the object currently read, stored in the geometry cache after the read.
+    std::vector<uint8_t> m_recordedGeometry;
+
+#ifdef RAMSES_CITYMODEL_COUNT_ALLOCATIONS
+    /// Number of heap allocations while reading all tiles.
+    uint64_t m_numberOfAllocations = 0;
+#endif
+
+    /// Memory held by the decode arena after the last tile read.
+    size_t m_decodeArenaSize = 0;
+
+    /// How much of the geometry is kept for computing intersections.
+    EPickingGeometry m_pickingGeometry = EPickingGeometry_Compact;
+
+    /// Memory of the picking meshes of the tile currently read.
+    uint64_t m_tilePickingGeometrySize = 0;
+
+    /// Memory of the picking meshes of all tiles read.
+    uint64_t m_pickingGeometrySize = 0;
+
+    /// Number of meshes of the file, which were merged into batches.
+    uint32_t m_numberOfBatchedMeshes = 0;
+
+    /// Number of tiles read.
+    uint32_t m_numberOfTilesRead = 0;
+
+    /// Number of tiles read, whose data was read ahead.
+    uint32_t m_numberOfPrefetchedReads = 0;
+
+    /// Number of tiles read ahead and dropped.
+    uint32_t m_numberOfDroppedPrefetches = 0;
+
+    /// Number of read operations for tiles.
+    uint32_t m_numberOfReadOperations = 0;
+
+    /// Number of bytes read for tiles.
+    uint64_t m_readSize = 0;
+
+    /// Time in seconds spent reading tiles.
+    float m_tileReadTime = 0.0f;
+
+    /// Number of mesh nodes created.
+    uint32_t m_numberOfMeshes = 0;
+
+    /// Number of geometry bindings created for the mesh nodes.
+    uint32_t m_numberOfGeometryBindings = 0;
+
+    /// Time in seconds spent for creating mesh nodes and their geometry bindings.
+    float m_meshCreationTime = 0.0f;
 
     /// Index for read tiles.
     uint32_t m_tileIndex = 0;
+
+    /// Tiles created from the tile index, used when the scene is read.
+    std::vector<Tile*> m_tiles;
 };
 
 #endif
@@ -0,0 +1,472 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_REXARCHIVE_H
+#define RAMSES_CITYMODEL_REXARCHIVE_H
+
+#include "ramses-citymodel/AsyncFileReader.h"
+#include "ramses-citymodel/BoundingBox.h"
+#include "ramses-citymodel/ITileSource.h"
+#include "ramses-citymodel/ReadPlanner.h"
+#include "ramses-citymodel/RexCodec.h"
+#include "ramses-citymodel/WorkerPool.h"
+
+#include "map"
+#include "memory"
+#include "string"
+#include "vector"
+
+/// Container level access to a ".rex" file.
+/** A ".rex" file consists of compressed objects, followed by the object table and the number of objects.
+ *  The archive reads the object table and returns the decompressed data of single objects.
+ *
+ *  In the legacy object table all objects are LZ4 compressed, an entry consists of the position (uint64), the
+ *  compressed and the uncompressed size (uint32). Legacy files have no header.
+ *
+ *  Files of FormatVersion start with a header of HeaderSize bytes: HeaderMagic, the format version and two reserved
+ *  fields (uint32). The object table entries consist of the position (uint64), the stored and the uncompressed size
+ *  (uint32), the codec (uint8), flags (uint8), a reserved field (uint16) and the XXHash32 checksum of the stored data
+ *  (uint32). The object table is followed by the tile index, which gives the object and the bounding box of each tile
+ *  id (TileIndexEntrySize bytes each), so that the tiles can be found without reading the scene object. It is
+ *  followed by the start key (StartKeySize bytes): flags (uint32, bit 0 set when the key is valid), the car position
+ *  and the car rotation of the first animation key (3 floats each), so that the camera can be placed before the scene
+ *  object is read. The file ends with the number of tile index entries, the format version, the number of objects and
+ *  TableMagic (uint32), by which it is distinguished from the legacy table. Files of format version 2 have no start
+ *  key. Files of format version 1 have no header, no checksums, no tile index and no start key, their footer lacks
+ *  the number of tile index entries.
+ *
+ *  In files of AlignedArraysVersion and later, the elements of vertex and index arrays are aligned to ArrayAlignment
+ *  bytes from the start of the object data, by zero padding after the number of elements, so that readers can pass
+ *  them to RAMSES in place. Earlier versions store the elements directly after the number of elements.
+ *
+ *  All positions and sizes of the table, versioned or legacy, are checked against the object data on open(), and
+ *  uncompressed sizes against MaximumUncompressedSize, so that truncated files are rejected before any object is
+ *  read. Checking the checksums on each read is optional, see setVerifyChecksums().
+ *
+ *  An object is either stored as a single block, or in chunked mode, which is marked by ChunkedFlag in the compressed
+ *  size of a legacy table entry, or by ChunkedEntryFlag in the flags of a versioned table entry. In chunked mode the
+ *  object is split into chunks of equal uncompressed size (except the last one), which are compressed independently
+ *  and decompressed in parallel. The stored data starts with the uncompressed chunk size, the number of chunks and the
+ *  compressed size of each chunk (all uint32), followed by the compressed chunks. */
+class RexArchive
+{
+public:
+    /// Reference of object data in a ".rex" file.
+    class FileReference
+    {
+    public:
+        /// Constructor.
+        /** @param position Byte position in the file
+         *  @param compressedSize Stored size of the data in bytes.
+         *  @param uncompressedSize Size of the data, when uncompressed.
+         *  @param chunked "true", when the data is stored in chunked mode.
+         *  @param codec The compression codec of the data.
+         *  @param checksum XXHash32 checksum of the stored data. */
+        FileReference(uint64_t position,
+                      uint32_t compressedSize,
+                      uint32_t uncompressedSize,
+                      bool     chunked  = false,
+                      ECodec   codec    = ECodec_LZ4,
+                      uint32_t checksum = 0);
+
+        /// Returns the position in the file.
+        /** @return The position in bytes. */
+        uint64_t position() const;
+
+        /// Compressed size of the data in bytes.
+        /** @return The size in bytes. */
+        uint32_t compressedSize() const;
+
+        /// Uncompressed size of the data in bytes.
+        /** @return The size in bytes. */
+        uint32_t uncompressedSize() const;
+
+        /// Returns if the data is stored in chunked mode.
+        /** @return "true" for chunked mode. */
+        bool chunked() const;
+
+        /// Returns the compression codec of the data.
+        /** @return The codec. */
+        ECodec codec() const;
+
+        /// Returns the checksum of the stored data.
+        /** @return The XXHash32 checksum, 0 for files without checksums. */
+        uint32_t checksum() const;
+
+    protected:
+        /// The position in bytes.
+        uint64_t m_position;
+
+        /// Compressed size of the data in bytes.
+        uint32_t m_compressedSize;
+
+        /// Uncompressed size of the data in bytes.
+        uint32_t m_uncompressedSize;
+
+        /// "true" for chunked mode.
+        bool m_chunked;
+
+        /// The compression codec.
+        ECodec m_codec;
+
+        /// XXHash32 checksum of the stored data.
+        uint32_t m_checksum;
+    };
+
+    /// Entry of the tile index.
+    struct TileIndexEntry
+    {
+        /// Id of the tile, the index of the tile in the scene.
+        uint32_t tileId;
+
+        /// Index of the object with the node of the tile.
+        uint32_t objectIndex;
+
+        /// Bounding box of the tile.
+        BoundingBox boundingBox;
+    };
+
+    /// Size of an entry of the legacy object table in the file.
+    static const uint32_t FileReferenceSize = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+    /// Size of an entry of the object table of format version 1 in the file.
+    static const uint32_t FileReferenceSizeV1 = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+
+    /// Size of an entry of the object table in the file.
+    static const uint32_t VersionedFileReferenceSize = sizeof(uint64_t) + 4 * sizeof(uint32_t);
+
+    /// Size of an entry of the tile index in the file.
+    static const uint32_t TileIndexEntrySize = 2 * sizeof(uint32_t) + 6 * sizeof(float);
+
+    /// Size of the start key in the file.
+    static const uint32_t StartKeySize = sizeof(uint32_t) + 6 * sizeof(float);
+
+    /// Marks the start of a file with header ("REXH").
+    static const uint32_t HeaderMagic = 0x48584552u;
+
+    /// Size of the file header in bytes.
+    static const uint32_t HeaderSize = 4 * sizeof(uint32_t);
+
+    /// Marks the end of a file with a versioned object table ("REXT").
+    static const uint32_t TableMagic = 0x54584552u;
+
+    /// Current format version.
+    static const uint32_t FormatVersion = 4;
+
+    /// First format version with aligned array elements.
+    static const uint32_t AlignedArraysVersion = 4;
+
+    /// Alignment of the array elements in the object data.
+    static const uint32_t ArrayAlignment = 4;
+
+    /// Flag in the flags of a versioned object table entry, marking objects stored in chunked mode.
+    static const uint8_t ChunkedEntryFlag = 0x01u;
+
+    /// Flag in the compressed size of an object table entry, marking objects stored in chunked mode.
+    static const uint32_t ChunkedFlag = 0x80000000u;
+
+    /// Default uncompressed size of a chunk in chunked mode.
+    static const uint32_t DefaultChunkSize = 256 * 1024;
+
+    /// Maximum uncompressed size of an object, larger sizes in the object table are rejected as corrupt.
+    static const uint32_t MaximumUncompressedSize = 1024 * 1024 * 1024;
+
+    /// Compresses object data.
+    /** @param data The uncompressed data.
+     *  @param codec The compression codec.
+     *  @param level Compression level, 0 for the default level of the codec.
+     *  @param chunkSize Uncompressed size of the chunks, 0 for storing the data as a single block. Data which is
+     *                   not larger than one chunk and data of ECodec_Stored is always stored as a single block.
+     *  @param stored The stored data is returned here.
+     *  @param chunked Returns "true", when the data was stored in chunked mode.
+     *  @return "true" on success. */
+    static bool Compress(const std::vector<uint8_t>& data,
+                         ECodec                      codec,
+                         int32_t                     level,
+                         uint32_t                    chunkSize,
+                         std::vector<char>&          stored,
+                         bool&                       chunked);
+
+    /// Enables reading objects ahead with prefetch(). Takes effect with the next open().
+    /** @param queueDepth Maximum number of objects read ahead, 0 (the default) disables reading ahead.
+     *  @param useIoUring "true" for reading ahead with io_uring when available, "false" for reading with pread. */
+    void setReadQueue(uint32_t queueDepth, bool useIoUring = true);
+
+    /// Sets how objects read ahead are merged into single reads, see ReadPlanner.
+    /** @param gapTolerance Maximum gap in bytes between the objects of a read, 0 (the default) merges only objects
+     *                      stored one after the other.
+     *  @param maximumReadSize Maximum size of a merged read in bytes, 0 disables merging. */
+    void setReadCoalescing(uint32_t gapTolerance, uint32_t maximumReadSize = ReadPlanner::DefaultMaximumReadSize);
+
+    /// Sets the source of the bytes of the file. Takes effect with the next open().
+    /** By default, files are read with FileTileSource and "http://" URLs with HttpTileSource.
+     *  @param source The source, nullptr for the default. */
+    void setTileSource(std::unique_ptr<ITileSource> source);
+
+    /// Opens a file and reads the object table.
+    /** @param filename The name of the file to be read, or its URL.
+     *  @return "true" on success. */
+    bool open(const std::string& filename);
+
+    /// Returns the source of the bytes of the file.
+    /** @return The source, nullptr before open(). */
+    const ITileSource* getTileSource() const;
+
+    /// Returns the number of objects in the file.
+    /** @return The number of objects. */
+    uint32_t getNumberOfObjects() const;
+
+    /// Returns the format version of the file.
+    /** @return 0 for legacy files, otherwise the format version. */
+    uint32_t getFormatVersion() const;
+
+    /// Returns if the file has checksums of the objects.
+    /** @return "true", when the file has checksums. */
+    bool hasChecksums() const;
+
+    /// Returns if the array elements in the objects are aligned to ArrayAlignment.
+    /** @return "true" for files of AlignedArraysVersion and later. */
+    bool hasAlignedArrays() const;
+
+    /// Enables checking the checksum of each object read.
+    /** Off by default. Has no effect for files without checksums.
+     *  @param verify "true" for checking the checksums. */
+    void setVerifyChecksums(bool verify);
+
+    /// Returns the tile index.
+    /** @return The tile index, empty for files without tile index. */
+    const std::vector<TileIndexEntry>& getTileIndex() const;
+
+    /// Returns the first key of the animation path, stored for placing the camera before the scene is read.
+    /** @param carPosition The car position is returned here.
+     *  @param carRotation The car rotation is returned here.
+     *  @return "true", when the file has a start key. */
+    bool getStartKey(Vector3& carPosition, Vector3& carRotation) const;
+
+    /// Finds the object of a tile in the tile index.
+    /** @param tileId Id of the tile.
+     *  @param objectIndex The index of the object with the node of the tile is returned here.
+     *  @return "true", when the tile was found. */
+    bool findTile(uint32_t tileId, uint32_t& objectIndex) const;
+
+    /// Reads the stored data of an object and checks its checksum.
+    /** @param index Index of the object.
+     *  @return "true", when the checksum matches or the file has no checksums. */
+    bool verify(uint32_t index);
+
+    /// Returns the reference of an object.
+    /** @param index Index of the object.
+     *  @return The reference. */
+    const FileReference& getObjectReference(uint32_t index) const;
+
+    /// Reads the data of an object as stored in the file, without decompressing it.
+    /** @param index Index of the object.
+     *  @param data The stored data is returned here.
+     *  @return "true" on success. */
+    bool readStored(uint32_t index, std::vector<char>& data);
+
+    /// Reads and decompresses an object.
+    /** @param index Index of the object.
+     *  @param data The decompressed data is returned here.
+     *  @return "true" on success. */
+    bool read(uint32_t index, std::vector<uint8_t>& data);
+
+    /// Starts reading objects, which are needed soon, in the background.
+    /** read() and readStored() of an object read ahead wait for its data. Objects read ahead, which are no longer in
+     *  the list, are dropped when their read completed. Sources other than local files get the ranges of the objects
+     *  with ITileSource::prefetch() instead. Does nothing without a read queue.
+     *  @param indices The objects in the order they are needed, only as many as the queue depth are read ahead. */
+    void prefetch(const std::vector<uint32_t>& indices);
+
+    /// Returns if objects are read ahead with io_uring.
+    /** @return "true" for io_uring, "false" for pread or without read queue. */
+    bool usesIoUring() const;
+
+    /// Returns the number of objects read, whose data was read ahead.
+    /** @return The number of objects. */
+    uint32_t getNumberOfPrefetchedReads() const;
+
+    /// Returns the number of objects read ahead, which were dropped without being read.
+    /** @return The number of objects. */
+    uint32_t getNumberOfDroppedPrefetches() const;
+
+    /// Returns the number of read operations for objects, synchronous reads and reads ahead.
+    /** A merged read of several objects read ahead counts as one operation.
+     *  @return The number of read operations. */
+    uint32_t getNumberOfReadOperations() const;
+
+    /// Returns the number of bytes read for objects, including the gaps read by merged reads.
+    /** @return The number of bytes. */
+    uint64_t getReadSize() const;
+
+    /// Decompresses stored object data, which was read by readStored() or produced by Compress().
+    /** @param fileRef Reference describing the stored data.
+     *  @param stored The stored data.
+     *  @param data The decompressed data is returned here.
+     *  @return "true" on success. */
+    bool decompress(const FileReference& fileRef, const std::vector<char>& stored, std::vector<uint8_t>& data);
+
+private:
+    /// Reads the versioned object table and the tile index, when the file ends with TableMagic.
+    /** @param fileSize Size of the file in bytes.
+     *  @param isVersioned Returns "true", when the file has a versioned object table.
+     *  @return "true" on success. */
+    bool readVersionedTable(uint64_t fileSize, bool& isVersioned);
+
+    /// Reads and checks the file header.
+    /** @return "true", when the header is valid. */
+    bool readHeader();
+
+    /// Reads bytes of the file from the source.
+    /** @param position Position in the file.
+     *  @param buffer The bytes are returned here.
+     *  @param size Number of bytes.
+     *  @return "true", when all bytes were read. */
+    bool readFile(uint64_t position, void* buffer, uint64_t size);
+
+    /// Checks the stored data of an object against the checksum in the object table.
+    /** @param index Index of the object.
+     *  @param data The stored data.
+     *  @param size Size of the stored data in bytes.
+     *  @return "true", when the checksum matches. */
+    bool checkChecksum(uint32_t index, const void* data, size_t size) const;
+
+    /// Reads the legacy object table.
+    /** @param fileSize Size of the file in bytes.
+     *  @return "true" on success. */
+    bool readLegacyTable(uint64_t fileSize);
+
+    /// Takes the stored data of an object read ahead, waiting for its read.
+    /** @param index Index of the object.
+     *  @param data The stored data is returned here.
+     *  @return "true" on success, "false" when the object was not read ahead or its read failed. */
+    bool takePrefetched(uint32_t index, std::vector<char>& data);
+
+    /// Records the completion of a read ahead, a merged read is sliced into its objects.
+    /** @param completion The completion. */
+    void completeRead(const AsyncFileReader::Completion& completion);
+
+    /// Decompresses an object stored in chunked mode, the chunks are decompressed in parallel.
+    /** @param fileRef Reference describing the stored data.
+     *  @param stored The stored data.
+     *  @param data The decompressed data is returned here.
+     *  @return "true" on success. */
+    bool decompressChunks(const FileReference& fileRef, const std::vector<char>& stored, std::vector<uint8_t>& data);
+
+    /// Source of the bytes of the file.
+    std::unique_ptr<ITileSource> m_source;
+
+    /// "true", when m_source was created by open() for the file name, instead of being set by setTileSource().
+    bool m_isDefaultSource = true;
+
+    /// List of objects referencing the "rex" archive file.
+    std::vector<FileReference> m_objectReferences;
+
+    /// The tile index.
+    std::vector<TileIndexEntry> m_tileIndex;
+
+    /// "true", when the file has a start key.
+    bool m_hasStartKey = false;
+
+    /// Car position of the start key.
+    Vector3 m_startPosition;
+
+    /// Car rotation of the start key.
+    Vector3 m_startRotation;
+
+    /// Format version of the file, 0 for legacy files.
+    uint32_t m_formatVersion = 0;
+
+    /// "true", when the checksums are checked on each read.
+    bool m_verifyChecksums = false;
+
+    /// Buffer for the compressed data of an object.
+    std::vector<char> m_compressedData;
+
+    /// Positions of the chunks in the stored data of an object, reused for all chunked objects.
+    std::vector<uint64_t> m_chunkPositions;
+
+    /// Worker threads for decompressing chunks, created when the first chunked object is read.
+    std::unique_ptr<WorkerPool> m_workerPool;
+
+    /// An object read ahead.
+    struct PrefetchedObject
+    {
+        /// The stored data.
+        std::vector<char> data;
+
+        /// "true", when the read completed.
+        bool completed = false;
+
+        /// "true", when the read succeeded.
+        bool success = false;
+    };
+
+    /// A read ahead of several objects, whose data is copied to the objects when it completes.
+    struct CoalescedRead
+    {
+        /// The data read.
+        std::vector<char> data;
+
+        /// The objects read, the position of their data in the data read is their position in the file minus the
+        /// position of the read.
+        std::vector<uint32_t> objects;
+
+        /// Position of the read in the file.
+        uint64_t position = 0;
+    };
+
+    /// Flag of the ids of merged reads, the ids of reads of single objects are the object indices.
+    static const uint64_t CoalescedReadFlag = 1ull << 63;
+
+    /// Maximum number of objects read ahead, 0 disables reading ahead.
+    uint32_t m_readQueueDepth = 0;
+
+    /// "true" for reading ahead with io_uring when available.
+    bool m_useIoUring = true;
+
+    /// The objects read ahead by index.
+    std::map<uint32_t, PrefetchedObject> m_prefetched;
+
+    /// Maximum gap in bytes between the objects of a merged read.
+    uint32_t m_gapTolerance = 0;
+
+    /// Maximum size of a merged read in bytes, 0 disables merging.
+    uint32_t m_maximumReadSize = ReadPlanner::DefaultMaximumReadSize;
+
+    /// The merged reads in flight by id.
+    std::map<uint64_t, CoalescedRead> m_coalescedReads;
+
+    /// Id of the next merged read.
+    uint64_t m_nextReadId = 0;
+
+    /// Objects and reads planned by prefetch(), reused for each call.
+    std::vector<ReadPlanner::Slice> m_slices;
+    std::vector<ReadPlanner::Read>  m_reads;
+
+    /// Buffers of objects read ahead, reused for the next objects.
+    std::vector<std::vector<char>> m_freeBuffers;
+
+    /// Number of objects read, whose data was read ahead.
+    uint32_t m_numberOfPrefetchedReads = 0;
+
+    /// Number of objects read ahead and dropped.
+    uint32_t m_numberOfDroppedPrefetches = 0;
+
+    /// Number of read operations for objects.
+    uint32_t m_numberOfReadOperations = 0;
+
+    /// Number of bytes read for objects.
+    uint64_t m_readSize = 0;
+
+    /// Reads the objects ahead, nullptr without read queue. Declared after m_prefetched and m_coalescedReads, so that it
+    /// is destroyed first and waits for the reads into the buffers.
+    std::unique_ptr<AsyncFileReader> m_asyncReader;
+};
+
+#endif
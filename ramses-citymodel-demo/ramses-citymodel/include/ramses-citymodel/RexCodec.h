@@ -0,0 +1,74 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_REXCODEC_H
+#define RAMSES_CITYMODEL_REXCODEC_H
+
+#include "stdint.h"
+#include "string"
+#include "vector"
+
+/// Compression codec of an object in a ".rex" file, stored in the object table.
+enum ECodec
+{
+    ECodec_LZ4 = 0,
+    ECodec_LZ4HC,
+    ECodec_Zstd,
+    ECodec_Stored,
+    ECodec_NumberOfCodecs
+};
+
+/// Compression and decompression of single blocks with the codecs of ".rex" files.
+/** ECodec_LZ4HC produces LZ4 blocks, which decompress as fast as ECodec_LZ4. ECodec_Zstd is only available, when
+ *  the library is built with zstd (RAMSES_CITYMODEL_HAS_ZSTD). */
+class RexCodec
+{
+public:
+    /// Checks if a codec is available in this build.
+    /** @param codec The codec.
+     *  @return "true", when data can be compressed and decompressed with the codec. */
+    static bool IsSupported(ECodec codec);
+
+    /// Returns the name of a codec.
+    /** @param codec The codec.
+     *  @return The name, as used for command line options. */
+    static const char* GetName(ECodec codec);
+
+    /// Finds a codec by name.
+    /** @param name The name of the codec (lz4, lz4hc, zstd or stored).
+     *  @param codec The codec is returned here.
+     *  @return "true", when the name is known. */
+    static bool FromName(const std::string& name, ECodec& codec);
+
+    /// Returns the maximum size of a compressed block.
+    /** @param codec The codec.
+     *  @param size Uncompressed size of the block.
+     *  @return The maximum compressed size. */
+    static size_t GetCompressBound(ECodec codec, size_t size);
+
+    /// Compresses a block.
+    /** @param codec The codec.
+     *  @param level Compression level, 0 for the default level of the codec.
+     *  @param source The uncompressed data.
+     *  @param sourceSize Size of the uncompressed data.
+     *  @param destination Destination for the compressed data.
+     *  @param destinationCapacity Size of the destination, at least GetCompressBound().
+     *  @return The compressed size, 0 on error. */
+    static size_t Compress(ECodec codec, int32_t level, const uint8_t* source, size_t sourceSize, char* destination, size_t destinationCapacity);
+
+    /// Decompresses a block.
+    /** @param codec The codec.
+     *  @param source The compressed data.
+     *  @param sourceSize Size of the compressed data.
+     *  @param destination Destination for the uncompressed data.
+     *  @param destinationSize Expected uncompressed size.
+     *  @return "true", when the block was decompressed to exactly the expected size. */
+    static bool Decompress(ECodec codec, const char* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+};
+
+#endif
@@ -0,0 +1,194 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_REXOBJECTREADER_H
+#define RAMSES_CITYMODEL_REXOBJECTREADER_H
+
+#include "ramses-citymodel/RexArchive.h"
+#include "ramses-citymodel/RexObjects.h"
+
+#include "openctm.h"
+
+/// Reads ".rex" files into RexObjects, without creating any RAMSES objects.
+/** Object ids and EType_Index back-references are resolved exactly like in Reader, so objects read with
+ *  resetIds = false (the scene) can be referenced by all objects read afterwards. */
+class RexObjectReader
+{
+public:
+    /// Opens a file for reading.
+    /** @param filename The name of the file to be read.
+     *  @return "true" on success. */
+    bool open(const std::string& filename);
+
+    /// Returns the number of objects in the file.
+    /** @return The number of objects. */
+    uint32_t getNumberOfObjects() const;
+
+    /// Returns the opened archive.
+    /** @return The archive. */
+    RexArchive& getArchive();
+
+    /// Reads an object from the file.
+    /** @param index Index of the object to be read.
+     *  @param resetIds When set to "true", read objects are not referenced by further reads.
+     *  @return The read object, or nullptr on error. */
+    RexObjectPtr read(uint32_t index, bool resetIds = true);
+
+    /// Reads an object from decompressed object data.
+    /** @param data The decompressed data of an object of the opened file.
+     *  @param resetIds When set to "true", read objects are not referenced by further reads.
+     *  @return The read object, or nullptr on error. */
+    RexObjectPtr read(const std::vector<uint8_t>& data, bool resetIds = true);
+
+    /// Returns the size of the vertex and index array elements read since the file was opened.
+    /** @return The size in bytes. */
+    uint64_t getArraySize() const;
+
+    /// Returns the size of the array elements read since the file was opened, which are not aligned to
+    /// RexArchive::ArrayAlignment in the object data, so that Reader has to copy them.
+    /** @return The size in bytes. */
+    uint64_t getUnalignedArraySize() const;
+
+protected:
+    /// Reads an object or a back-reference to an already read object.
+    /** @return The read object. */
+    RexObjectPtr readObject();
+
+    /// Reads an object and checks its type.
+    /** @param types Allowed object types, the list is terminated by EType_Null.
+     *  @return The read object, nullptr for EType_Null or when the type is not allowed. */
+    template <typename T>
+    std::shared_ptr<T> readObjectOfType(const EObjectType* types);
+
+    /// Reads the node transformation and childs.
+    /** @param node The node to be read. */
+    void readNode(RexNode& node);
+
+    /// Reads a mesh node.
+    /** @param mesh The mesh node to be read. */
+    void readMeshNode(RexMeshNode& mesh);
+
+    /// Reads a geometry node.
+    /** @param geometryNode The geometry node to be read. */
+    void readGeometryNode(RexGeometryNode& geometryNode);
+
+    /// Reads the vertices and indices of an EType_EncodedGeometryNode.
+    /** @param geometryNode The geometry node, its arrays are created. */
+    void readEncodedGeometry(RexGeometryNode& geometryNode);
+
+    /// Reads encoded vertices of an EType_EncodedGeometryNode.
+    /** @param type EType_VertexArrayResource3f or EType_VertexArrayResource2f.
+     *  @param numberOfVertices Number of vertices.
+     *  @return The decoded array. */
+    std::shared_ptr<RexVertexArray> readEncodedVertices(EObjectType type, uint32_t numberOfVertices);
+
+    /// Reads a material.
+    /** @param material The material to be read. */
+    void readMaterial(RexMaterial& material);
+
+    /// Reads a vertex array resource.
+    /** The elements of quantized arrays are dequantized into RexVertexArray::m_data as well.
+     *  @param array The array to be read. */
+    void readVertexArray(RexVertexArray& array);
+
+    /// Reads an index array resource.
+    /** @param array The array to be read. */
+    void readIndexArray(RexIndexArray& array);
+
+    /// Skips the padding before the elements of an array, in files with aligned arrays.
+    void skipArrayPadding();
+
+    /// Counts the elements of an array at the current position for the array statistics.
+    /** @param size Size of the elements in bytes. */
+    void countArray(uint64_t size);
+
+    /// Reads a texture 2d resource.
+    /** @param texture The texture to be read. */
+    void readTexture2D(RexTexture2D& texture);
+
+    /// Reads a scene.
+    /** @param scene The scene to be read. */
+    void readScene(RexScene& scene);
+
+    /// Reads the tile meta data.
+    /** @param tile The tile to be read. */
+    void readTile(RexTile& tile);
+
+    /// Reads a uint8 value.
+    /** @param value The read value is returned here. */
+    void read_uint8(uint8_t& value);
+
+    /// Reads a uint32 value.
+    /** @param value The read value is returned here. */
+    void read_uint32(uint32_t& value);
+
+    /// Reads a int32 value.
+    /** @param value The read value is returned here. */
+    void read_int32(int32_t& value);
+
+    /// Reads a float value.
+    /** @param value The read value is returned here. */
+    void read_float(float& value);
+
+    /// Reads a string.
+    /** @param value The string is returned here. */
+    void read_string(std::string& value);
+
+    /// Reads a vector3.
+    /** @param value The read value is returned here. */
+    void read(Vector3& value);
+
+    /// Reads a color.
+    /** @param color The read value is returned here. */
+    void read(Vector4& color);
+
+    /// Reads a bounding box.
+    /** @param bbox The read value is returned here. */
+    void read(BoundingBox& bbox);
+
+    /// Reads a number of bytes.
+    /** Sets the error flag and fills the destination with zeros, when not enough data is left.
+     *  @param dest Destination where to write the read data.
+     *  @param size Size of the data to be read. */
+    void read(void* dest, uint64_t size);
+
+    /// Callback function for reading CTM compressed data.
+    /** @param buffer Data that was read.
+     *  @param count Number of bytes that are stored in buffer.
+     *  @param userData The reader instance. */
+    static CTMuint CTMRead(void* buffer, CTMuint count, void* userData);
+
+    /// The ".rex" archive file.
+    RexArchive m_archive;
+
+    /// Decompressed data of the object currently read.
+    std::vector<uint8_t> m_dataBuffer;
+
+    /// Pointer to the current data.
+    const uint8_t* m_data = nullptr;
+
+    /// End of the current data.
+    const uint8_t* m_dataEnd = nullptr;
+
+    /// Start of the object data currently read, for the padding of the arrays.
+    const uint8_t* m_dataBegin = nullptr;
+
+    /// Size of the array elements read.
+    uint64_t m_arraySize = 0;
+
+    /// Size of the unaligned array elements read.
+    uint64_t m_unalignedArraySize = 0;
+
+    /// Stores all read objects by id.
+    std::vector<RexObjectPtr> m_object;
+
+    /// Set, when the data of the current object is malformed.
+    bool m_error = false;
+};
+
+#endif
@@ -0,0 +1,226 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_REXOBJECTS_H
+#define RAMSES_CITYMODEL_REXOBJECTS_H
+
+#include "ramses-citymodel/AnimationPath.h"
+#include "ramses-citymodel/BoundingBox.h"
+#include "ramses-citymodel/EObjectType.h"
+#include "ramses-citymodel/Vector4.h"
+
+#include "memory"
+#include "string"
+#include "vector"
+
+/// In-memory representation of an object of a ".rex" file, independent of RAMSES.
+/** Used by the offline tools for reading, modifying and writing ".rex" files. Objects referenced more than once are
+ *  shared by pointer and written as EType_Index back-references. */
+class RexObject
+{
+public:
+    /// Constructor.
+    /** @param type The object type. */
+    RexObject(EObjectType type);
+
+    /// Destructor.
+    virtual ~RexObject();
+
+    /// Returns the object type.
+    /** @return The type. */
+    EObjectType getType() const;
+
+private:
+    /// The object type.
+    EObjectType m_type;
+};
+
+typedef std::shared_ptr<RexObject> RexObjectPtr;
+
+/// Texture 2D resource, the data is an ASTC file including the header.
+class RexTexture2D : public RexObject
+{
+public:
+    /// Constructor.
+    /** @param type EType_Texture2DResource or EType_Texture2DMipMapResource. */
+    RexTexture2D(EObjectType type = EType_Texture2DResource);
+
+    /// Maximum number of mip levels, enough for textures of 32768 texels.
+    static const uint32_t MaxMipLevels = 16;
+
+    std::vector<uint8_t> m_data;
+
+    /// The mip levels after the first one, each an ASTC file including the header. Only for
+    /// EType_Texture2DMipMapResource.
+    std::vector<std::vector<uint8_t>> m_mipMaps;
+};
+
+/// Vertex array resource with 2, 3 or 4 float components per element.
+/** The quantized types store 16 bit values: EType_QuantizedVertexArrayResource2f and
+ *  EType_QuantizedVertexArrayResource3f (texture coordinates and positions) in the bounding box of the array, see
+ *  VertexQuantization, EType_OctahedralNormalArrayResource normals with 2 values each. For these, m_data holds the
+ *  dequantized elements and m_quantized the stored values. */
+class RexVertexArray : public RexObject
+{
+public:
+    /// Constructor.
+    /** @param type EType_VertexArrayResource2f, EType_VertexArrayResource3f, EType_VertexArrayResource4f or one of
+     *  the quantized types. */
+    RexVertexArray(EObjectType type);
+
+    /// Returns the number of float components per element.
+    /** @return The number of components. */
+    uint32_t getComponents() const;
+
+    /// Returns the number of elements.
+    /** @return The number of elements. */
+    uint32_t getCount() const;
+
+    /// Returns if the elements are stored quantized.
+    /** @return "true" for the quantized types. */
+    bool isQuantized() const;
+
+    /// Returns the number of 16 bit values stored per element of the quantized types.
+    /** @return The number of values, 2 for normals. */
+    uint32_t getQuantizedComponents() const;
+
+    /// Restores m_data from the quantized values.
+    void dequantize();
+
+    /// Creates a quantized copy of a float array.
+    /** @param array The float array.
+     *  @param type The quantized type, EType_QuantizedVertexArrayResource2f for arrays with 2 components,
+     *  EType_QuantizedVertexArrayResource3f or EType_OctahedralNormalArrayResource for arrays with 3 components.
+     *  @param maxError The largest difference of a component of the dequantized elements is returned here, for
+     *  normals the largest angle in degrees.
+     *  @return The quantized array. */
+    static std::shared_ptr<RexVertexArray> Quantize(const RexVertexArray& array, EObjectType type, float& maxError);
+
+    std::vector<float> m_data;
+
+    /// The stored values of the quantized types, for normals signed values.
+    std::vector<uint16_t> m_quantized;
+
+    /// Offset of each component of EType_QuantizedVertexArrayResource2f and EType_QuantizedVertexArrayResource3f.
+    float m_offset[3] = {0.0f, 0.0f, 0.0f};
+
+    /// Size of a quantization step of each component.
+    float m_scale[3] = {0.0f, 0.0f, 0.0f};
+};
+
+/// Index array resource.
+/** EType_ShortIndexArrayResource stores the indices with 16 bit, for geometry with at most MaxShortIndexVertices
+ *  vertices. m_data holds the indices with 32 bit for both types. */
+class RexIndexArray : public RexObject
+{
+public:
+    /// Constructor.
+    /** @param type EType_IndexArrayResource or EType_ShortIndexArrayResource. */
+    RexIndexArray(EObjectType type = EType_IndexArrayResource);
+
+    /// Maximum number of vertices, which can be referenced with 16 bit indices.
+    static const uint32_t MaxShortIndexVertices = 65536;
+
+    /// Returns if all indices fit into 16 bit.
+    /** @return "true", when all indices are less than MaxShortIndexVertices. */
+    bool fitsShortIndices() const;
+
+    std::vector<uint32_t> m_data;
+};
+
+/// Geometry node, either a CTM stream or a set of vertex array resources.
+/** EType_EncodedGeometryNode stores the positions, normals, texture coordinates and indices encoded with MeshCodec
+ *  within the geometry node instead of as resources. Its arrays are held by m_positions, m_normals, m_texCoords and
+ *  m_indices as well, but are not shared with other geometry nodes and have no texCoords2. */
+class RexGeometryNode : public RexObject
+{
+public:
+    /// Constructor.
+    /** @param type EType_GeometryNode or EType_EncodedGeometryNode. */
+    RexGeometryNode(EObjectType type = EType_GeometryNode);
+
+    uint32_t m_effect = 0;
+    bool     m_useCTM = false;
+
+    /// The CTM stream, when m_useCTM is set.
+    std::vector<uint8_t> m_ctmData;
+
+    /// Number of vertices and indices of the CTM stream, set by RexObjectReader for the statistics of the tools.
+    uint32_t m_ctmVertexCount = 0;
+    uint32_t m_ctmIndexCount  = 0;
+
+    std::shared_ptr<RexVertexArray> m_positions;
+    std::shared_ptr<RexVertexArray> m_normals;
+    std::shared_ptr<RexVertexArray> m_texCoords;
+    std::shared_ptr<RexVertexArray> m_texCoords2;
+    std::shared_ptr<RexIndexArray>  m_indices;
+};
+
+/// Material.
+class RexMaterial : public RexObject
+{
+public:
+    RexMaterial();
+
+    Vector4                       m_diffuseColor;
+    uint32_t                      m_effect = 0;
+    std::shared_ptr<RexTexture2D> m_texture;
+};
+
+/// Node with transformation and children.
+class RexNode : public RexObject
+{
+public:
+    /// Constructor.
+    /** @param type EType_Node or EType_MeshNode. */
+    RexNode(EObjectType type = EType_Node);
+
+    Vector3                               m_rotation;
+    Vector3                               m_translation;
+    Vector3                               m_scaling;
+    std::vector<std::shared_ptr<RexNode>> m_children;
+};
+
+/// Mesh node, drawing a range of indices of a geometry node with a material.
+class RexMeshNode : public RexNode
+{
+public:
+    RexMeshNode();
+
+    uint32_t                         m_startIndex  = 0;
+    int32_t                          m_indexCount  = 0;
+    uint32_t                         m_renderOrder = 0;
+    std::shared_ptr<RexMaterial>     m_material;
+    std::shared_ptr<RexGeometryNode> m_geometry;
+};
+
+/// Tile meta data.
+class RexTile : public RexObject
+{
+public:
+    RexTile();
+
+    BoundingBox m_boundingBox;
+};
+
+/// The scene, object 0 of a ".rex" file.
+class RexScene : public RexObject
+{
+public:
+    RexScene();
+
+    std::vector<std::shared_ptr<RexMaterial>> m_materials;
+    std::vector<std::shared_ptr<RexTile>>     m_tiles;
+    std::shared_ptr<RexNode>                  m_carsor;
+    std::vector<AnimationPath::Key>           m_animationKeys;
+    std::vector<std::string>                  m_names;
+    std::vector<Vector3>                      m_namePoints;
+    std::vector<Vector3>                      m_routePoints;
+};
+
+#endif
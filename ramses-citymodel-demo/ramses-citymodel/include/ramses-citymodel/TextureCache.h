@@ -0,0 +1,141 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+
+#ifndef RAMSES_CITYMODEL_TEXTURECACHE_H
+#define RAMSES_CITYMODEL_TEXTURECACHE_H
+
+#include "map"
+#include "stddef.h"
+#include "stdint.h"
+
+class TextureResidency;
+
+namespace ramses
+{
+    class RamsesClient;
+    class Texture2D;
+}
+
+/// Reference counted cache of textures, shared by all tiles.
+/** Textures with the same content, which are stored again for each tile using them, are created once. The content is
+ *  identified by its size and its 64 bit XXHash64, the data itself is not kept, since keeping it for a comparison
+ *  would double the memory of the textures. For n distinct textures of the same size, the probability of a collision
+ *  is about n^2 / 2^65, below 10^-9 for 100000 textures, which is accepted for the shared appearance of a texture.
+ *  Not thread safe, the reader and the main thread call it with the scene lock held. */
+class TextureCache
+{
+public:
+    /// Identifies the content of a texture.
+    struct Key
+    {
+        /// Size of the texture data in bytes.
+        uint32_t size;
+
+        /// XXHash64 of the texture data.
+        uint64_t hash;
+
+        /// Orders the keys for the cache.
+        /** @param other The other key.
+         *  @return "true", when this key is ordered before the other key. */
+        bool operator<(const Key& other) const;
+    };
+
+    /// Computes the key of texture data.
+    /** @param data The texture data, as stored in the file.
+     *  @param size Size of the data in bytes.
+     *  @return The key. */
+    static Key ComputeKey(const void* data, size_t size);
+
+    /// Returns a cached texture and increments its reference count.
+    /** @param key Content of the texture.
+     *  @return The texture, nullptr when there is no texture for the key yet. */
+    ramses::Texture2D* acquire(const Key& key);
+
+    /// Adds a newly created texture with a reference count of 1.
+    /** @param key Content of the texture.
+     *  @param texture The texture. */
+    void add(const Key& key, ramses::Texture2D* texture);
+
+    /// Sets the texture residency, which is informed before a texture is destroyed.
+    /** @param residency The texture residency. */
+    void setTextureResidency(TextureResidency* residency);
+
+    /// Decrements the reference count of a texture, the texture is destroyed when it is no longer used.
+    /** @param texture The texture.
+     *  @param client The RAMSES client, which created the texture. */
+    void release(ramses::Texture2D* texture, ramses::RamsesClient& client);
+
+    /// Returns the number of textures requested, as read from the file.
+    /** @return The number of acquire() calls. */
+    uint32_t getNumberOfRequests() const;
+
+    /// Returns the number of textures created.
+    /** @return The number of add() calls. */
+    uint32_t getNumberOfCreatedTextures() const;
+
+    /// Returns the number of textures currently in use.
+    /** @return The number of cached textures. */
+    uint32_t getNumberOfCachedTextures() const;
+
+    /// Returns the texture data size of all requests.
+    /** @return The size in bytes. */
+    uint64_t getRequestedSize() const;
+
+    /// Returns the texture data size of the created textures.
+    /** @return The size in bytes. */
+    uint64_t getCreatedSize() const;
+
+    /// Returns the texture data size of the textures currently in use.
+    /** @return The size in bytes. */
+    uint64_t getCachedSize() const;
+
+    /// Returns the texture data size, which the textures currently in use would need without sharing.
+    /** @return The size in bytes. */
+    uint64_t getReferencedSize() const;
+
+private:
+    /// A cached texture.
+    struct Entry
+    {
+        /// The texture.
+        ramses::Texture2D* texture;
+
+        /// Number of users of the texture.
+        uint32_t refCount;
+    };
+
+    /// The cached textures by their content.
+    std::map<Key, Entry> m_entries;
+
+    /// The content of the cached textures, for finding them on release().
+    std::map<ramses::Texture2D*, Key> m_keys;
+
+    /// The texture residency, nullptr when not set.
+    TextureResidency* m_textureResidency = nullptr;
+
+    /// Number of acquire() calls.
+    uint32_t m_numberOfRequests = 0;
+
+    /// Number of add() calls.
+    uint32_t m_numberOfCreatedTextures = 0;
+
+    /// Data size of all acquire() calls.
+    uint64_t m_requestedSize = 0;
+
+    /// Data size of all add() calls.
+    uint64_t m_createdSize = 0;
+
+    /// Data size of the cached textures.
+    uint64_t m_cachedSize = 0;
+
+    /// Data size of the cached textures times their reference count.
+    uint64_t m_referencedSize = 0;
+};
+
+#endif
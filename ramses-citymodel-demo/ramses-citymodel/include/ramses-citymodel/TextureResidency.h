@@ -0,0 +1,274 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+
+#ifndef RAMSES_CITYMODEL_TEXTURERESIDENCY_H
+#define RAMSES_CITYMODEL_TEXTURERESIDENCY_H
+
+#include "ramses-citymodel/Vector3.h"
+#include "ramses-client-api/UniformInput.h"
+
+#include "functional"
+#include "map"
+#include "stdint.h"
+#include "vector"
+
+class Material;
+
+namespace ramses
+{
+    class RamsesClient;
+    class Scene;
+    class Texture2D;
+    class TextureSampler;
+}
+
+/// Uploads the fine mip levels of textures only for tiles near the camera, under a texture memory budget.
+/** The reader creates textures with mip levels only from the coarse levels, which stay resident as long as the
+ *  texture is used. The residency keeps only where the levels are stored in the file, and creates an additional
+ *  texture with the finer levels, when a tile using the texture gets near the camera. The finer levels are read again
+ *  from the file by the level loader in the background and passed to completeUpgrade(), the textures of one object
+ *  are requested together, so that the object is read and decompressed once for them. The projected size of a tile
+ *  halves, when its distance doubles, so one level is dropped per doubling of the distance beyond the detail distance.
+ *  The materials using the texture then sample the finer texture, until the camera is farther away again. When the
+ *  finer textures exceed the budget, the textures farthest away are reduced first. The levels needed are only
+ *  computed again, when the camera moved by a quarter of the detail distance or the textures or their users changed.
+ *  Not thread safe, the reader and the main thread call it with the scene lock held. */
+class TextureResidency
+{
+public:
+    /// Width and height of the coarsest level, which is kept resident.
+    static const uint32_t CoarseTextureSize = 128;
+
+    /// Maximum number of objects, whose finer levels are read at the same time, to spread the reads and uploads over
+    /// several frames.
+    static const uint32_t MaxPendingLoads = 2;
+
+    /// Where the levels of a texture are stored in the file.
+    struct LevelSource
+    {
+        /// Index of the object in the file, which stores the texture.
+        uint32_t objectIndex;
+
+        /// Position of the ASTC block data of each level in the decompressed object data.
+        std::vector<uint32_t> offsets;
+
+        /// Size of the ASTC block data of each level.
+        std::vector<uint32_t> sizes;
+    };
+
+    /// An upgrade request passed to the level loader.
+    struct UpgradeRequest
+    {
+        /// The texture.
+        ramses::Texture2D* texture;
+
+        /// The number of the upgrade request.
+        uint32_t request;
+    };
+
+    /// Sets the budget for the finer textures.
+    /** @param budget The budget in bytes, 0 disables the residency and the reader creates all levels at once.
+     *  @param detailDistance Distance in meters, up to which the finest level is used. */
+    void setBudget(uint64_t budget, float detailDistance);
+
+    /// Returns if the residency is enabled.
+    /** @return "true", when a budget is set. */
+    bool isEnabled() const;
+
+    /// Returns the level, from which the reader creates a texture with the given mip levels.
+    /** @param widths Width of each level.
+     *  @param heights Height of each level.
+     *  @return The first level not larger than CoarseTextureSize, 0 when the residency is disabled. */
+    uint32_t getCoarseLevel(const std::vector<uint32_t>& widths, const std::vector<uint32_t>& heights) const;
+
+    /// Sets the function, which loads the finer levels of the textures of an object in the background.
+    /** Without a level loader, no finer textures are created. The function is called by update() with the scene lock
+     *  held and must not block, it reads the levels given by getLevelSource() and passes the finer textures to
+     *  completeUpgrade().
+     *  @param loader Called with the index of the object and the upgrade requests of its textures. */
+    void setLevelLoader(const std::function<void(uint32_t, const std::vector<UpgradeRequest>&)>& loader);
+
+    /// Adds a texture created from the coarse levels.
+    /** @param texture The texture.
+     *  @param coarseLevel The first level of the texture.
+     *  @param widths Width of each level.
+     *  @param heights Height of each level.
+     *  @param source Where the levels are stored in the file. */
+    void addTexture(ramses::Texture2D*           texture,
+                    uint32_t                     coarseLevel,
+                    const std::vector<uint32_t>& widths,
+                    const std::vector<uint32_t>& heights,
+                    LevelSource&&                source);
+
+    /// Removes a texture, before it is destroyed. Does nothing for textures not added.
+    /** @param texture The texture.
+     *  @param client The RAMSES client. */
+    void removeTexture(ramses::Texture2D* texture, ramses::RamsesClient& client);
+
+    /// Adds a material, which uses the texture of the material. Does nothing for textures not added.
+    /** @param material The material.
+     *  @param input The texture input of the material appearance. */
+    void addMaterial(Material& material, const ramses::UniformInput& input);
+
+    /// Removes a material, before it is destroyed.
+    /** @param material The material.
+     *  @param scene The RAMSES scene. */
+    void removeMaterial(Material& material, ramses::Scene& scene);
+
+    /// Adds a tile using a texture.
+    /** @param texture The texture.
+     *  @param position Center of the tile. */
+    void addUse(ramses::Texture2D* texture, const Vector3& position);
+
+    /// Removes a tile using a texture.
+    /** @param texture The texture.
+     *  @param position Center of the tile. */
+    void removeUse(ramses::Texture2D* texture, const Vector3& position);
+
+    /// Requests and destroys the finer textures for the current camera position.
+    /** @param client The RAMSES client.
+     *  @param scene The RAMSES scene.
+     *  @param cameraPosition Position of the camera. */
+    void update(ramses::RamsesClient& client, ramses::Scene& scene, const Vector3& cameraPosition);
+
+    /// Returns the levels to be read for an upgrade request of the level loader.
+    /** @param texture The texture.
+     *  @param request The number of the upgrade request.
+     *  @param source Where the levels are stored in the file, starting with the first level of the finer texture.
+     *  @param width Width of the first level of the finer texture.
+     *  @param height Height of the first level of the finer texture.
+     *  @return "false", when the request was cancelled or the texture removed. */
+    bool getLevelSource(ramses::Texture2D* texture, uint32_t request, LevelSource& source, uint32_t& width, uint32_t& height) const;
+
+    /// Takes the finer texture created by the level loader for an upgrade request.
+    /** The finer texture is destroyed, when the request was cancelled or the texture removed meanwhile.
+     *  @param texture The texture.
+     *  @param request The number of the upgrade request.
+     *  @param fineTexture The finer texture, nullptr when the levels could not be read.
+     *  @param client The RAMSES client.
+     *  @param scene The RAMSES scene. */
+    void completeUpgrade(ramses::Texture2D*    texture,
+                         uint32_t              request,
+                         ramses::Texture2D*    fineTexture,
+                         ramses::RamsesClient& client,
+                         ramses::Scene&        scene);
+
+    /// Returns the data size of all resident levels, coarse and fine.
+    /** @return The size in bytes. */
+    uint64_t getResidentSize() const;
+
+    /// Returns the data size, which all textures would need with all levels.
+    /** @return The size in bytes. */
+    uint64_t getFullSize() const;
+
+    /// Returns the number of finer textures created so far.
+    /** @return The number of uploads. */
+    uint32_t getNumberOfUpgrades() const;
+
+private:
+    /// A material using a texture.
+    struct MaterialUse
+    {
+        /// The material.
+        Material* material;
+
+        /// The texture input of the material appearance.
+        ramses::UniformInput input;
+
+        /// Sampler of the finer texture, nullptr while the coarse texture is used.
+        ramses::TextureSampler* sampler;
+    };
+
+    /// A texture with mip levels.
+    struct Entry
+    {
+        /// Width of each level.
+        std::vector<uint32_t> widths;
+
+        /// Height of each level.
+        std::vector<uint32_t> heights;
+
+        /// Where the levels are stored in the file.
+        LevelSource source;
+
+        /// First level of the coarse texture.
+        uint32_t coarseLevel;
+
+        /// First level of the finer texture, coarseLevel while there is none.
+        uint32_t residentLevel;
+
+        /// The finer texture.
+        ramses::Texture2D* fineTexture;
+
+        /// Number of the pending upgrade request, 0 when there is none.
+        uint32_t pendingRequest;
+
+        /// First level of the finer texture of the pending upgrade request.
+        uint32_t pendingLevel;
+
+        /// Set, when the levels could not be read, so that the texture is not upgraded again.
+        bool failed;
+
+        /// Materials using the texture.
+        std::vector<MaterialUse> materials;
+
+        /// Centers of the tiles using the texture.
+        std::vector<Vector3> users;
+    };
+
+    /// Returns the data size of the levels of a texture, starting with the given level.
+    /** @param entry The texture.
+     *  @param level The first level.
+     *  @return The size in bytes. */
+    static uint64_t GetSize(const Entry& entry, uint32_t level);
+
+    /// Replaces the finer texture of a texture.
+    /** @param entry The texture.
+     *  @param level The first level of the new finer texture, ignored without finer texture.
+     *  @param fineTexture The new finer texture, nullptr for using the coarse texture only.
+     *  @param client The RAMSES client.
+     *  @param scene The RAMSES scene. */
+    void setFineTexture(Entry& entry, uint32_t level, ramses::Texture2D* fineTexture, ramses::RamsesClient& client, ramses::Scene& scene);
+
+    /// Cancels the pending upgrade request of a texture, its finer texture is destroyed on completeUpgrade().
+    /** @param entry The texture. */
+    void cancelUpgrade(Entry& entry);
+
+    /// Textures with mip levels by their coarse texture.
+    std::map<ramses::Texture2D*, Entry> m_entries;
+
+    /// Loads the finer levels of the textures of an object in the background.
+    std::function<void(uint32_t, const std::vector<UpgradeRequest>&)> m_levelLoader;
+
+    /// Number of the last upgrade request.
+    uint32_t m_lastRequest = 0;
+
+    /// Set, when the textures or their users changed since the levels were computed.
+    bool m_changed = true;
+
+    /// Camera position, for which the levels were computed.
+    Vector3 m_updatePosition;
+
+    /// The budget for the finer textures in bytes, 0 when disabled.
+    uint64_t m_budget = 0;
+
+    /// Distance in meters, up to which the finest level is used.
+    float m_detailDistance = 100.0f;
+
+    /// Data size of the resident levels.
+    uint64_t m_residentSize = 0;
+
+    /// Data size of all levels.
+    uint64_t m_fullSize = 0;
+
+    /// Number of finer textures created.
+    uint32_t m_numberOfUpgrades = 0;
+};
+
+#endif
@@ -18,6 +18,7 @@ class Citymodel;
 namespace ramses
 {
     class Node;
+    class MeshNode;
 }
 
 /// Tile meta data class.
@@ -38,11 +39,23 @@ public:
     /** @return The bounding box. */
     const BoundingBox& boundingBox() const;
 
+    /// Returns the index of the object with the node of the tile in the ".rex" archive file.
+    /** @return The object index. */
+    uint32_t getObjectIndex() const;
+
     /// Makes the tile visible or invisible.
     /** Queues the tile data for visible tiles to be read by the pager worker thread, when not already read.
      *  Add tiles to the delete list, when invisible. */
     void setVisible(bool v);
 
+    /// Returns if the tile is visible.
+    /** @return "true", when visible. */
+    bool isVisible() const;
+
+    /// Returns if the tile is queued to be loaded by the pager worker thread.
+    /** @return "true", when queued. */
+    bool isQueuedToLoad() const;
+
     /// Reads the tile geometry from the ".rex" archive file.
     /** Called by the worker thread of the pager, so don't access other members than mLoadedNode. */
     void doReadNode();
@@ -73,6 +86,9 @@ private:
     /// Removes tile from the delete list.
     void removeTileToDelete();
 
+    /// Shows the bounding box proxy while the tile is visible but not loaded, hides it otherwise.
+    void updateProxy();
+
     /// The root node of this tile, loaded by the pager thread.
     ramses::Node* m_loadedNode = nullptr;
 
@@ -97,6 +113,9 @@ private:
     /// Center of the bounding box.
     Vector3 m_center;
 
+    /// Bounding box proxy shown until the tile is loaded, created on demand in progressive mode.
+    ramses::MeshNode* m_proxyNode = nullptr;
+
     /// The parent node, where to hang in this tile node, when visible.
     ramses::Node* m_parent = nullptr;
 
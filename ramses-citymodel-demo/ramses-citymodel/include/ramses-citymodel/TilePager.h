@@ -9,8 +9,11 @@
 #ifndef RAMSES_CITYMODEL_TILEPAGER_H
 #define RAMSES_CITYMODEL_TILEPAGER_H
 
+#include "ramses-citymodel/Vector3.h"
+
 #include "vector"
 #include "deque"
+#include "functional"
 #include "thread"
 #include "condition_variable"
 
@@ -29,6 +32,12 @@ public:
     /// Terminates the worker thread.
     void terminate();
 
+    /// Adds a job to be run by the worker thread before any further tile is loaded.
+    /** Used for reading the scene object in the background, before the first tile is read, and the finer levels of
+     *  textures.
+     *  @param job The job. */
+    void addJob(const std::function<void()>& job);
+
     /// Adds a set of tiles to the list to be loaded.
     /** @param tiles The tiles to be added. */
     void add(std::vector<Tile*> tiles);
@@ -37,6 +46,17 @@ public:
     /** @param tiles The tiles to be removed. */
     void remove(std::vector<Tile*> tiles);
 
+    /// Enables reading the next queued tiles ahead, while a tile is loaded.
+    /** @param count Maximum number of tiles read ahead, including the tile loaded, 0 disables reading ahead.
+     *  @param prefetch Called by the worker thread before a tile is loaded, with the object indices of the tile and
+     *                  the tiles loaded next, in the order they are loaded. */
+    void setPrefetch(uint32_t count, const std::function<void(const std::vector<uint32_t>&)>& prefetch);
+
+    /// Sets the position, for which the nearest queued tile is loaded first.
+    /** Until a position is set, the tiles are loaded in the order they were added.
+     *  @param position The position, usually the camera position. */
+    void setFocusPosition(const Vector3& position);
+
     /// Returns the set of tiles, that were newly loaded.
     /** @param tiles The set of tiles. */
     void get(std::vector<Tile*>& tiles);
@@ -56,6 +76,15 @@ private:
     /** @param tile The tile to be removed. */
     void remove(Tile* tile);
 
+    /// Removes the next tile to be loaded from the queue, the queue must not be empty.
+    /** @return The tile nearest to the focus position, when set, otherwise the tile added first. */
+    Tile* popNext();
+
+    /// Collects the object indices of the queued tiles to be loaded next, in the order of popNext().
+    /** @param count Maximum number of tiles.
+     *  @param indices The object indices are appended here. */
+    void collectNext(uint32_t count, std::vector<uint32_t>& indices);
+
     /// The worker thread for doing the tile loading.
     std::thread m_thread;
 
@@ -65,12 +94,33 @@ private:
     /// Mutex variable to synchronize access through the interface functions and the worker thread.
     std::mutex m_mutex;
 
+    /// Queue of jobs to be run by the worker thread, before the queued tiles.
+    std::deque<std::function<void()>> m_jobs;
+
     /// Queue of tiles to be read by the worker thread.
     std::deque<Tile*> m_queue;
 
     /// Vector of tiles, that were newly read and which are delivered by the get() function.
     std::vector<Tile*> m_readTiles;
 
+    /// "true", when a focus position was set.
+    bool m_hasFocusPosition = false;
+
+    /// Position, for which the nearest queued tile is loaded first.
+    Vector3 m_focusPosition;
+
+    /// Maximum number of tiles read ahead, 0 when disabled.
+    uint32_t m_prefetchCount = 0;
+
+    /// Called with the object indices of the tiles to be read ahead.
+    std::function<void(const std::vector<uint32_t>&)> m_prefetch;
+
+    /// Object indices of the tiles to be read ahead, reused for each tile.
+    std::vector<uint32_t> m_prefetchIndices;
+
+    /// Queued tiles sorted by the distance to the focus position, reused for each tile.
+    std::vector<std::pair<float, Tile*>> m_sortedTiles;
+
     /// Flag to cancel the worker thread.
     bool m_cancelRequested = false;
 };
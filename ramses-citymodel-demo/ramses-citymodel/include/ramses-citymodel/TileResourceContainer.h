@@ -11,8 +11,12 @@
 
 #include "ramses-citymodel/Vector3.h"
 #include "set"
+#include "vector"
 
 class Material;
+class MaterialCache;
+class TextureCache;
+class TextureResidency;
 class GeometryNode;
 
 namespace ramses
@@ -22,6 +26,7 @@ namespace ramses
     class Resource;
     class SceneObject;
     class RenderGroup;
+    class Texture2D;
 }
 
 class TileResourceContainer
@@ -31,10 +36,35 @@ public:
     /** @param geometryNode The geometry node. */
     void addGeometryNode(GeometryNode* geometryNode);
 
+    /// Returns if a geometry node was added to this container.
+    /** @param geometryNode The geometry node.
+     *  @return "true", when the geometry node is destroyed together with this container. */
+    bool hasGeometryNode(GeometryNode* geometryNode) const;
+
     /// Adds a material.
     /** @param material The material. */
     void addMaterial(Material* material);
 
+    /// Adds a material shared through the material cache, which is released when the container is destroyed.
+    /** @param material The material.
+     *  @param cache The cache, from which the material was acquired. */
+    void addCachedMaterial(Material* material, MaterialCache& cache);
+
+    /// Adds a texture shared through the texture cache, which is released when the container is destroyed.
+    /** @param texture The texture.
+     *  @param cache The cache, from which the texture was acquired. */
+    void addCachedTexture(ramses::Texture2D* texture, TextureCache& cache);
+
+    /// Sets the position of the tile, at which the textures of the tile are used.
+    /** @param position Center of the tile. */
+    void setPosition(const Vector3& position);
+
+    /// Adds the use of a texture at the position of the tile to the texture residency, which is removed when the
+    /// container is destroyed. Does nothing, when no position is set.
+    /** @param texture The texture.
+     *  @param residency The texture residency. */
+    void addTextureUse(ramses::Texture2D* texture, TextureResidency& residency);
+
     /// Adds a resource.
     /** @param resource The resource. */
     void addResource(const ramses::Resource* resource);
@@ -59,6 +89,17 @@ private:
     /// Destroys the stored materials.
     void destroyMaterials();
 
+    /// Releases the materials acquired from the material cache.
+    /** @param scene The RAMSES scene. */
+    void releaseCachedMaterials(ramses::Scene& scene);
+
+    /// Releases the textures acquired from the texture cache.
+    /** @param client The RAMSES client. */
+    void releaseCachedTextures(ramses::RamsesClient& client);
+
+    /// Removes the texture uses from the texture residency.
+    void removeTextureUses();
+
     /// Destroys the stored geometry nodes.
     void destroyGeometryNodes();
 
@@ -87,6 +128,30 @@ private:
     /// Set of stored material.
     std::set<Material*> m_materials;
 
+    /// Materials acquired from the material cache, once per acquire.
+    std::vector<Material*> m_cachedMaterials;
+
+    /// The cache of m_cachedMaterials.
+    MaterialCache* m_materialCache = nullptr;
+
+    /// Textures acquired from the texture cache, once per acquire.
+    std::vector<ramses::Texture2D*> m_cachedTextures;
+
+    /// The cache of m_cachedTextures.
+    TextureCache* m_textureCache = nullptr;
+
+    /// Textures used at m_position, once per addTextureUse().
+    std::vector<ramses::Texture2D*> m_textureUses;
+
+    /// The residency of m_textureUses.
+    TextureResidency* m_textureResidency = nullptr;
+
+    /// Center of the tile.
+    Vector3 m_position;
+
+    /// "true", when m_position is set.
+    bool m_hasPosition = false;
+
     /// Set of stored geometry nodes.
     std::set<GeometryNode*> m_geometryNodes;
 
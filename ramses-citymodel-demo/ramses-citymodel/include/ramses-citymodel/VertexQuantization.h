@@ -0,0 +1,67 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_VERTEXQUANTIZATION_H
+#define RAMSES_CITYMODEL_VERTEXQUANTIZATION_H
+
+#include "stdint.h"
+
+/// Quantization of vertex attributes to 16 bit values for the quantized vertex arrays of ".rex" files.
+/** Positions and texture coordinates are stored with an offset and a step size per component, normals octahedral
+ *  encoded. */
+class VertexQuantization
+{
+public:
+    /// Maximum number of components of a quantized element.
+    static const uint32_t MaxComponents = 3;
+
+    /// Quantizes elements to 16 bit in their bounding box.
+    /** Each component is stored as unsigned value with the minimum as offset, the error is at most half a step,
+     *  1/131070 of the extent.
+     *  @param values The float elements.
+     *  @param count Number of elements.
+     *  @param components Number of components per element, at most MaxComponents.
+     *  @param quantized The quantized values are returned here, components * count values.
+     *  @param offset The offset of each component is returned here.
+     *  @param scale The size of a quantization step of each component is returned here. */
+    static void Quantize(const float* values,
+                         uint32_t     count,
+                         uint32_t     components,
+                         uint16_t*    quantized,
+                         float*       offset,
+                         float*       scale);
+
+    /// Restores quantized elements.
+    /** @param quantized The quantized values.
+     *  @param count Number of elements.
+     *  @param components Number of components per element.
+     *  @param offset The offset of each component.
+     *  @param scale The size of a quantization step of each component.
+     *  @param values The float elements are returned here, components * count values. */
+    static void Dequantize(const uint16_t* quantized,
+                           uint32_t        count,
+                           uint32_t        components,
+                           const float*    offset,
+                           const float*    scale,
+                           float*          values);
+
+    /// Encodes normals octahedral as two signed normalized values.
+    /** The angular error is a few thousandths of a degree.
+     *  @param normals The normals, 3 floats each, need not be normalized.
+     *  @param count Number of normals.
+     *  @param encoded The encoded normals are returned here, 2 values each. Zero normals are encoded as (0, 0, 1). */
+    static void EncodeNormals(const float* normals, uint32_t count, int16_t* encoded);
+
+    /// Decodes octahedral encoded normals.
+    /** @param encoded The encoded normals, 2 values each.
+     *  @param count Number of normals.
+     *  @param normals The normalized normals are returned here, 3 floats each. */
+    static void DecodeNormals(const int16_t* encoded, uint32_t count, float* normals);
+};
+
+#endif
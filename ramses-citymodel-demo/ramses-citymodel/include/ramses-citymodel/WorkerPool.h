@@ -0,0 +1,81 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_WORKERPOOL_H
+#define RAMSES_CITYMODEL_WORKERPOOL_H
+
+#include "atomic"
+#include "condition_variable"
+#include "functional"
+#include "mutex"
+#include "thread"
+#include "vector"
+
+/// Pool of worker threads for processing a number of independent work items in parallel.
+class WorkerPool
+{
+public:
+    /// Constructor.
+    /** @param numberOfThreads Number of worker threads, 0 for one less than the number of hardware threads. */
+    WorkerPool(uint32_t numberOfThreads = 0);
+
+    /// Destructor, terminates the worker threads.
+    ~WorkerPool();
+
+    /// Processes work items in parallel and returns when all are done.
+    /** The calling thread takes part in the work, so that items are also processed with 0 worker threads.
+     *  @param count Number of work items.
+     *  @param task Function called with the index of each work item. */
+    void run(uint32_t count, const std::function<void(uint32_t)>& task);
+
+    /// Returns the number of worker threads.
+    /** @return The number of worker threads. */
+    uint32_t getNumberOfThreads() const;
+
+private:
+    /// Main function of the worker threads.
+    void workerLoop();
+
+    /// Processes work items, until all items are taken.
+    void processItems();
+
+    /// The worker threads.
+    std::vector<std::thread> m_threads;
+
+    /// Serializes calls of run().
+    std::mutex m_runMutex;
+
+    /// Mutex for the state shared with the worker threads.
+    std::mutex m_mutex;
+
+    /// Condition to wake up the worker threads, when new work is started.
+    std::condition_variable m_startCondition;
+
+    /// Condition to signal, that all worker threads finished the current work.
+    std::condition_variable m_doneCondition;
+
+    /// The task of the current work.
+    const std::function<void(uint32_t)>* m_task = nullptr;
+
+    /// Number of work items of the current work.
+    uint32_t m_count = 0;
+
+    /// Index of the next work item to be taken.
+    std::atomic<uint32_t> m_nextItem;
+
+    /// Number of worker threads still busy with the current work.
+    uint32_t m_busyThreads = 0;
+
+    /// Incremented for each new work, so that the worker threads detect new work.
+    uint64_t m_generation = 0;
+
+    /// Flag to terminate the worker threads.
+    bool m_terminate = false;
+};
+
+#endif
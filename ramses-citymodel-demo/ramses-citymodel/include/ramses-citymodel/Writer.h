@@ -0,0 +1,249 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_WRITER_H
+#define RAMSES_CITYMODEL_WRITER_H
+
+#include "ramses-citymodel/RexArchive.h"
+#include "ramses-citymodel/RexObjects.h"
+
+#include "fstream"
+#include "map"
+
+/// Writer for ".rex" files, the counterpart of Reader and RexObjectReader.
+/** Objects are serialized in the order expected by the readers and get their ids in the same pre-order. An object
+ *  that is referenced a second time is written as EType_Index back-reference, nullptr is written as EType_Null.
+ *  Ids of an object written with resetIds = false (the scene) stay valid for all objects written afterwards.
+ *  EType_TextureCubeResource is not supported, same as in Reader. EType_Texture2DMipMapResource is written for
+ *  textures with mip levels, the quantized vertex array types for quantized arrays, EType_ShortIndexArrayResource
+ *  for 16 bit indices and EType_EncodedGeometryNode for encoded geometry, which older readers cannot read. */
+class Writer
+{
+public:
+    /// Opens the file for writing.
+    /** @param filename The name of the file to be written.
+     *  @param legacyFormat "true" for writing the legacy format without header, checksums and tile index, readable by
+     *                      older readers. Only possible, when all objects use ECodec_LZ4.
+     *  @return "true" on success. */
+    bool open(const std::string& filename, bool legacyFormat = false);
+
+    /// Sets if the elements of vertex and index arrays are aligned to RexArchive::ArrayAlignment.
+    /** Call before open(), files with aligned arrays (the default) are written with RexArchive::FormatVersion,
+     *  otherwise with the previous version, for copying objects of older files. Legacy files are never aligned.
+     *  @param alignedArrays "true" for aligning the array elements. */
+    void setAlignedArrays(bool alignedArrays);
+
+    /// Sets the chunk size for objects written afterwards.
+    /** @param chunkSize Uncompressed size of the chunks, objects larger than this size are stored in chunked mode.
+     *                   0 (the default) stores all objects as single LZ4 blocks, readable by older readers. */
+    void setChunkSize(uint32_t chunkSize);
+
+    /// Sets the compression codec for objects written afterwards.
+    /** @param codec The compression codec, ECodec_LZ4 by default.
+     *  @param level Compression level, 0 for the default level of the codec. */
+    void setCodec(ECodec codec, int32_t level = 0);
+
+    /// Sets the tile index from the tiles of the scene, tile i is stored in object i + 1, and the start key from the
+    /// first key of the animation path.
+    /** @param scene The scene. */
+    void setSceneIndex(const RexScene& scene);
+
+    /// Serializes an object, compresses it and appends it to the file.
+    /** @param object The object to be written.
+     *  @param resetIds When set to "true", the written objects are not referenced by further objects.
+     *  @return "true" on success. */
+    bool write(const RexObjectPtr& object, bool resetIds = true);
+
+    /// Compresses already serialized object data and appends it to the file.
+    /** @param data The uncompressed object data.
+     *  @return "true" on success. */
+    bool writeData(const std::vector<uint8_t>& data);
+
+    /// Compresses already serialized object data and appends it to the file.
+    /** Objects written this way may be written in any order, the object table is ordered by index.
+     *  @param index Index of the object in the object table.
+     *  @param data The uncompressed object data.
+     *  @return "true" on success. */
+    bool writeData(uint32_t index, const std::vector<uint8_t>& data);
+
+    /// Appends object data as stored in another ".rex" file, without recompressing it.
+    /** Objects written this way may be written in any order, the object table is ordered by index.
+     *  @param index Index of the object in the object table.
+     *  @param reference Reference of the object in the source file, giving the stored and uncompressed size.
+     *  @param data The stored data.
+     *  @return "true" on success. */
+    bool writeStoredData(uint32_t index, const RexArchive::FileReference& reference, const std::vector<char>& data);
+
+    /// Serializes an object without writing it to the file.
+    /** @param object The object to be serialized.
+     *  @param resetIds When set to "true", the serialized objects are not referenced by further objects.
+     *  @param data The uncompressed object data is returned here. */
+    void serialize(const RexObjectPtr& object, bool resetIds, std::vector<uint8_t>& data);
+
+    /// Writes the object table and closes the file.
+    /** @return "true" on success. */
+    bool close();
+
+    /// Returns the number of objects written so far.
+    /** @return The number of objects. */
+    uint32_t getNumberOfObjects() const;
+
+    /// Returns the number of bytes written so far.
+    /** @return The size in bytes. */
+    uint64_t getFileSize() const;
+
+protected:
+    /// Writes the legacy object table.
+    void writeLegacyTable();
+
+    /// Writes the object table with checksums, the tile index and the start key.
+    void writeVersionedTable();
+
+    /// Writes an object or a back-reference to an already written object.
+    /** @param object The object to be written. */
+    void writeObject(const RexObjectPtr& object);
+
+    /// Writes the node transformation and childs.
+    /** @param node The node to be written. */
+    void writeNode(const RexNode& node);
+
+    /// Writes a mesh node.
+    /** @param mesh The mesh node to be written. */
+    void writeMeshNode(const RexMeshNode& mesh);
+
+    /// Writes a geometry node.
+    /** @param geometryNode The geometry node to be written. */
+    void writeGeometryNode(const RexGeometryNode& geometryNode);
+
+    /// Writes the vertices and indices of an EType_EncodedGeometryNode.
+    /** @param geometryNode The geometry node with positions and indices. */
+    void writeEncodedGeometry(const RexGeometryNode& geometryNode);
+
+    /// Writes a material.
+    /** @param material The material to be written. */
+    void writeMaterial(const RexMaterial& material);
+
+    /// Writes a vertex array resource.
+    /** @param array The array to be written. */
+    void writeVertexArray(const RexVertexArray& array);
+
+    /// Writes an index array resource.
+    /** @param array The array to be written. */
+    void writeIndexArray(const RexIndexArray& array);
+
+    /// Writes the padding before the elements of an array, when arrays are aligned.
+    void writeArrayPadding();
+
+    /// Writes a texture 2d resource.
+    /** @param texture The texture to be written. */
+    void writeTexture2D(const RexTexture2D& texture);
+
+    /// Writes a scene.
+    /** @param scene The scene to be written. */
+    void writeScene(const RexScene& scene);
+
+    /// Writes the tile meta data.
+    /** @param tile The tile to be written. */
+    void writeTile(const RexTile& tile);
+
+    /// Writes a uint8 value.
+    /** @param value The value to be written. */
+    void write_uint8(uint8_t value);
+
+    /// Writes a uint32 value.
+    /** @param value The value to be written. */
+    void write_uint32(uint32_t value);
+
+    /// Writes a int32 value.
+    /** @param value The value to be written. */
+    void write_int32(int32_t value);
+
+    /// Writes a float value.
+    /** @param value The value to be written. */
+    void write_float(float value);
+
+    /// Writes a string.
+    /** @param value The string to be written. */
+    void write_string(const std::string& value);
+
+    /// Writes a vector3.
+    /** @param value The value to be written. */
+    void write(const Vector3& value);
+
+    /// Writes a color.
+    /** @param color The value to be written. */
+    void write(const Vector4& color);
+
+    /// Writes a bounding box.
+    /** @param bbox The value to be written. */
+    void write(const BoundingBox& bbox);
+
+    /// Writes a number of bytes.
+    /** @param data The data to be written.
+     *  @param size Size of the data in bytes. */
+    void write(const void* data, uint64_t size);
+
+    /// The output stream.
+    std::ofstream m_f;
+
+    /// Current write position in the file.
+    uint64_t m_position = 0;
+
+    /// The object table.
+    std::vector<RexArchive::FileReference> m_objectReferences;
+
+    /// The tile index.
+    std::vector<RexArchive::TileIndexEntry> m_tileIndex;
+
+    /// "true", when a start key is set.
+    bool m_hasStartKey = false;
+
+    /// Car position of the start key.
+    Vector3 m_startPosition;
+
+    /// Car rotation of the start key.
+    Vector3 m_startRotation;
+
+    /// "true" for writing the legacy format.
+    bool m_legacyFormat = false;
+
+    /// "true" for aligning the array elements.
+    bool m_alignedArrays = true;
+
+    /// Format version of the file.
+    uint32_t m_formatVersion = RexArchive::FormatVersion;
+
+    /// Number of objects written, less than the size of the object table while objects are written out of order.
+    uint32_t m_writtenObjects = 0;
+
+    /// Buffer for the uncompressed data of the object currently written.
+    std::vector<uint8_t> m_dataBuffer;
+
+    /// Buffer for the compressed data.
+    std::vector<char> m_compressedData;
+
+    /// Uncompressed size of the chunks in chunked mode, 0 for single LZ4 blocks.
+    uint32_t m_chunkSize = 0;
+
+    /// Compression codec of the objects.
+    ECodec m_codec = ECodec_LZ4;
+
+    /// Compression level, 0 for the default level of the codec.
+    int32_t m_level = 0;
+
+    /// Destination of the object currently serialized.
+    std::vector<uint8_t>* m_data = nullptr;
+
+    /// Ids of the written objects.
+    std::map<const RexObject*, uint32_t> m_ids;
+
+    /// Written objects by id, keeps the referenced objects alive as long as their ids are valid.
+    std::vector<RexObjectPtr> m_object;
+};
+
+#endif
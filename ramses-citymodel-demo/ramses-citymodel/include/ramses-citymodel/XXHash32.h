@@ -0,0 +1,52 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_XXHASH32_H
+#define RAMSES_CITYMODEL_XXHASH32_H
+
+#include "stddef.h"
+#include "stdint.h"
+
+/// The 32 bit xxHash checksum (XXH32), used for the integrity check of the objects in ".rex" files.
+class XXHash32
+{
+public:
+    /// Computes the checksum of a block of data.
+    /** @param data The data.
+     *  @param size Size of the data in bytes.
+     *  @param seed Seed of the hash.
+     *  @return The checksum. */
+    static uint32_t Compute(const void* data, size_t size, uint32_t seed = 0);
+
+private:
+    /// Primes of the hash function.
+    static const uint32_t Prime1 = 2654435761u;
+    static const uint32_t Prime2 = 2246822519u;
+    static const uint32_t Prime3 = 3266489917u;
+    static const uint32_t Prime4 = 668265263u;
+    static const uint32_t Prime5 = 374761393u;
+
+    /// Reads a little endian uint32 value.
+    /** @param data Pointer to the value.
+     *  @return The value. */
+    static uint32_t Read32(const uint8_t* data);
+
+    /// Rotates a value to the left.
+    /** @param value The value.
+     *  @param bits Number of bits to rotate.
+     *  @return The rotated value. */
+    static uint32_t RotateLeft(uint32_t value, uint32_t bits);
+
+    /// Processes a value of a stripe.
+    /** @param accumulator The accumulator of the lane.
+     *  @param value The input value.
+     *  @return The new accumulator. */
+    static uint32_t Round(uint32_t accumulator, uint32_t value);
+};
+
+#endif
@@ -0,0 +1,63 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifndef RAMSES_CITYMODEL_XXHASH64_H
+#define RAMSES_CITYMODEL_XXHASH64_H
+
+#include "stddef.h"
+#include "stdint.h"
+
+/// The 64 bit xxHash (XXH64), used where content is identified by its hash alone.
+class XXHash64
+{
+public:
+    /// Computes the hash of a block of data.
+    /** @param data The data.
+     *  @param size Size of the data in bytes.
+     *  @param seed Seed of the hash.
+     *  @return The hash. */
+    static uint64_t Compute(const void* data, size_t size, uint64_t seed = 0);
+
+private:
+    /// Primes of the hash function.
+    static const uint64_t Prime1 = 11400714785074694791ull;
+    static const uint64_t Prime2 = 14029467366897019727ull;
+    static const uint64_t Prime3 = 1609587929392839161ull;
+    static const uint64_t Prime4 = 9650029242287828579ull;
+    static const uint64_t Prime5 = 2870177450012600261ull;
+
+    /// Reads a little endian uint64 value.
+    /** @param data Pointer to the value.
+     *  @return The value. */
+    static uint64_t Read64(const uint8_t* data);
+
+    /// Reads a little endian uint32 value.
+    /** @param data Pointer to the value.
+     *  @return The value. */
+    static uint32_t Read32(const uint8_t* data);
+
+    /// Rotates a value to the left.
+    /** @param value The value.
+     *  @param bits Number of bits to rotate.
+     *  @return The rotated value. */
+    static uint64_t RotateLeft(uint64_t value, uint32_t bits);
+
+    /// Processes a value of a stripe.
+    /** @param accumulator The accumulator of the lane.
+     *  @param value The input value.
+     *  @return The new accumulator. */
+    static uint64_t Round(uint64_t accumulator, uint64_t value);
+
+    /// Merges the accumulator of a lane into the hash.
+    /** @param hash The hash.
+     *  @param accumulator The accumulator of the lane.
+     *  @return The new hash. */
+    static uint64_t MergeRound(uint64_t hash, uint64_t accumulator);
+};
+
+#endif
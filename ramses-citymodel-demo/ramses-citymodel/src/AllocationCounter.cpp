@@ -0,0 +1,54 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#ifdef RAMSES_CITYMODEL_COUNT_ALLOCATIONS
+
+#include "ramses-citymodel/AllocationCounter.h"
+
+#include "cstdlib"
+#include "new"
+
+thread_local uint64_t AllocationCounter::m_numberOfAllocations = 0;
+
+uint64_t AllocationCounter::GetNumberOfAllocations()
+{
+    return m_numberOfAllocations;
+}
+
+void AllocationCounter::CountAllocation()
+{
+    m_numberOfAllocations++;
+}
+
+void* operator new(size_t size)
+{
+    AllocationCounter::CountAllocation();
+    void* memory = std::malloc(size > 0 ? size : 1);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+#endif
@@ -14,12 +14,12 @@ AnimationPath::Key::Key(const Vector3& carPosition, const Vector3& carRotation)
 {
 }
 
-const Vector3& AnimationPath::Key::getCarPosition()
+const Vector3& AnimationPath::Key::getCarPosition() const
 {
     return m_carPosition;
 }
 
-const Vector3& AnimationPath::Key::getCarRotation()
+const Vector3& AnimationPath::Key::getCarRotation() const
 {
     return m_carRotation;
 }
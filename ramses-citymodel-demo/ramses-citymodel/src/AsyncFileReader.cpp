@@ -0,0 +1,369 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/AsyncFileReader.h"
+
+#include "algorithm"
+#include "cerrno"
+#include "cstdio"
+#include "cstring"
+#include "fcntl.h"
+#include "unistd.h"
+
+#ifdef RAMSES_CITYMODEL_HAS_IO_URING
+#include "linux/io_uring.h"
+#include "sys/mman.h"
+#include "sys/syscall.h"
+
+struct AsyncFileReader::Ring
+{
+    int           fd         = -1;
+    void*         sqRing     = MAP_FAILED;
+    size_t        sqRingSize = 0;
+    void*         cqRing     = MAP_FAILED;
+    size_t        cqRingSize = 0;
+    io_uring_sqe* sqes       = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t        sqesSize   = 0;
+    uint32_t*     sqTail     = nullptr;
+    uint32_t*     sqMask     = nullptr;
+    uint32_t*     sqArray    = nullptr;
+    uint32_t*     cqHead     = nullptr;
+    uint32_t*     cqTail     = nullptr;
+    uint32_t*     cqMask     = nullptr;
+    io_uring_cqe* cqes       = nullptr;
+    uint32_t      inFlight   = 0;
+    bool          failed     = false;
+};
+#else
+struct AsyncFileReader::Ring
+{
+    uint32_t inFlight = 0;
+};
+#endif
+
+AsyncFileReader::AsyncFileReader()
+{
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    close();
+}
+
+bool AsyncFileReader::IsIoUringSupported()
+{
+    AsyncFileReader reader;
+    return reader.openRing(1);
+}
+
+bool AsyncFileReader::open(const std::string& filename, uint32_t queueDepth, bool useIoUring)
+{
+    close();
+    m_fd = ::open(filename.c_str(), O_RDONLY);
+    if (m_fd < 0)
+    {
+        printf("AsyncFileReader::open Could not open %s\n", filename.c_str());
+        return false;
+    }
+    m_queueDepth = queueDepth > 0 ? queueDepth : 1;
+    if (useIoUring && !openRing(m_queueDepth))
+    {
+        printf("AsyncFileReader::open io_uring not available, reading with pread\n");
+    }
+    return true;
+}
+
+void AsyncFileReader::close()
+{
+    closeRing();
+    m_requests.clear();
+    m_order.clear();
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool AsyncFileReader::usesIoUring() const
+{
+    return m_ring != nullptr;
+}
+
+uint32_t AsyncFileReader::getQueueDepth() const
+{
+    return m_queueDepth;
+}
+
+uint32_t AsyncFileReader::getNumberOfPending() const
+{
+    return static_cast<uint32_t>(m_requests.size());
+}
+
+bool AsyncFileReader::submit(uint64_t id, uint64_t position, void* buffer, uint32_t size)
+{
+    if (m_fd < 0 || m_requests.size() >= m_queueDepth || m_requests.find(id) != m_requests.end())
+    {
+        return false;
+    }
+
+    Request request;
+    request.position  = position;
+    request.buffer    = buffer;
+    request.size      = size;
+    request.submitted = m_ring && submitRing(id, request);
+    m_requests[id]    = request;
+    m_order.push_back(id);
+    return true;
+}
+
+bool AsyncFileReader::wait(Completion& completion)
+{
+    if (m_requests.empty())
+    {
+        return false;
+    }
+
+    // reads not submitted to io_uring are done with pread in the order of submission
+    uint64_t id     = m_order.front();
+    int32_t  result = -1;
+    if (m_ring && m_ring->inFlight > 0 && !waitRing(id, result))
+    {
+        // the kernel may still write into the buffers of the reads in flight, they are drained or cancelled by closing
+        // the ring, before all pending reads are done with pread
+        closeRing();
+        for (auto& pending : m_requests)
+        {
+            pending.second.submitted = false;
+        }
+        id     = m_order.front();
+        result = -1;
+    }
+
+    auto it = m_requests.find(id);
+    if (it == m_requests.end())
+    {
+        printf("AsyncFileReader::wait Completion of an unknown read\n");
+        return false;
+    }
+    const Request request = it->second;
+    m_requests.erase(it);
+    if (request.submitted)
+    {
+        m_ring->inFlight--;
+    }
+    for (auto orderIt = m_order.begin(); orderIt != m_order.end(); ++orderIt)
+    {
+        if (*orderIt == id)
+        {
+            m_order.erase(orderIt);
+            break;
+        }
+    }
+
+    completion.id = id;
+    if (result >= 0 && static_cast<uint32_t>(result) == request.size)
+    {
+        completion.success = true;
+    }
+    else
+    {
+        // not read by io_uring or short read, the rest is read synchronously
+        const uint32_t done = result > 0 ? static_cast<uint32_t>(result) : 0;
+        completion.success =
+            read(request.position + done, static_cast<uint8_t*>(request.buffer) + done, request.size - done);
+    }
+    return true;
+}
+
+bool AsyncFileReader::read(uint64_t position, void* buffer, uint32_t size) const
+{
+    uint8_t* data = static_cast<uint8_t*>(buffer);
+    while (size > 0)
+    {
+        const ssize_t n = pread(m_fd, data, size, static_cast<off_t>(position));
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        data += n;
+        position += static_cast<uint64_t>(n);
+        size -= static_cast<uint32_t>(n);
+    }
+    return true;
+}
+
+#ifdef RAMSES_CITYMODEL_HAS_IO_URING
+
+bool AsyncFileReader::openRing(uint32_t entries)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    std::unique_ptr<Ring> ring(new Ring());
+    ring->fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring->fd < 0)
+    {
+        return false;
+    }
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring->sqesSize   = params.sq_entries * sizeof(io_uring_sqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ring->sqRingSize = ring->cqRingSize = std::max(ring->sqRingSize, ring->cqRingSize);
+    }
+
+    ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing != MAP_FAILED)
+    {
+        ring->cqRing = (params.features & IORING_FEAT_SINGLE_MMAP)
+                           ? ring->sqRing
+                           : mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        ring->sqes = static_cast<io_uring_sqe*>(
+            mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+    }
+
+    m_ring.swap(ring);
+    if (m_ring->sqRing == MAP_FAILED || m_ring->cqRing == MAP_FAILED || m_ring->sqes == MAP_FAILED)
+    {
+        closeRing();
+        return false;
+    }
+
+    uint8_t* sq     = static_cast<uint8_t*>(m_ring->sqRing);
+    uint8_t* cq     = static_cast<uint8_t*>(m_ring->cqRing);
+    m_ring->sqTail  = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    m_ring->sqMask  = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    m_ring->sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    m_ring->cqHead  = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    m_ring->cqTail  = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    m_ring->cqMask  = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    m_ring->cqes    = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+}
+
+void AsyncFileReader::closeRing()
+{
+    if (!m_ring)
+    {
+        return;
+    }
+
+    // the kernel may still write into the buffers of the reads in flight
+    uint64_t id;
+    int32_t  result;
+    while (m_ring->inFlight > 0 && waitRing(id, result))
+    {
+        m_ring->inFlight--;
+    }
+
+    if (m_ring->sqes != MAP_FAILED)
+    {
+        munmap(m_ring->sqes, m_ring->sqesSize);
+    }
+    if (m_ring->cqRing != MAP_FAILED && m_ring->cqRing != m_ring->sqRing)
+    {
+        munmap(m_ring->cqRing, m_ring->cqRingSize);
+    }
+    if (m_ring->sqRing != MAP_FAILED)
+    {
+        munmap(m_ring->sqRing, m_ring->sqRingSize);
+    }
+    ::close(m_ring->fd);
+    m_ring.reset();
+}
+
+bool AsyncFileReader::submitRing(uint64_t id, const Request& request)
+{
+    if (m_ring->failed)
+    {
+        return false;
+    }
+
+    // single producer, the kernel only advances the head
+    const uint32_t tail  = *m_ring->sqTail;
+    const uint32_t index = tail & *m_ring->sqMask;
+    io_uring_sqe&  sqe   = m_ring->sqes[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode    = IORING_OP_READ;
+    sqe.fd        = m_fd;
+    sqe.off       = request.position;
+    sqe.addr      = reinterpret_cast<uint64_t>(request.buffer);
+    sqe.len       = request.size;
+    sqe.user_data = id;
+    m_ring->sqArray[index] = index;
+    __atomic_store_n(m_ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    for (;;)
+    {
+        const long submitted = syscall(__NR_io_uring_enter, m_ring->fd, 1, 0, 0, nullptr, 0);
+        if (submitted == 1)
+        {
+            m_ring->inFlight++;
+            return true;
+        }
+        if (submitted < 0 && (errno == EINTR || errno == EAGAIN))
+        {
+            continue;
+        }
+        // the entry stays unsubmitted, no further entries are submitted
+        printf("AsyncFileReader::submitRing io_uring submission failed, reading with pread\n");
+        m_ring->failed = true;
+        return false;
+    }
+}
+
+bool AsyncFileReader::waitRing(uint64_t& id, int32_t& result)
+{
+    for (;;)
+    {
+        const uint32_t head = *m_ring->cqHead;
+        if (head != __atomic_load_n(m_ring->cqTail, __ATOMIC_ACQUIRE))
+        {
+            const io_uring_cqe& cqe = m_ring->cqes[head & *m_ring->cqMask];
+            id                      = cqe.user_data;
+            result                  = cqe.res;
+            __atomic_store_n(m_ring->cqHead, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+        const long entered = syscall(__NR_io_uring_enter, m_ring->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (entered < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            printf("AsyncFileReader::waitRing io_uring wait failed\n");
+            return false;
+        }
+    }
+}
+
+#else
+
+bool AsyncFileReader::openRing(uint32_t)
+{
+    return false;
+}
+
+void AsyncFileReader::closeRing()
+{
+}
+
+bool AsyncFileReader::submitRing(uint64_t, const Request&)
+{
+    return false;
+}
+
+bool AsyncFileReader::waitRing(uint64_t&, int32_t&)
+{
+    return false;
+}
+
+#endif
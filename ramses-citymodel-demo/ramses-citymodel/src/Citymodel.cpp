@@ -10,6 +10,8 @@
 #include "ramses-citymodel/AnimationPath.h"
 #include "ramses-citymodel/CitymodelScene.h"
 #include "ramses-citymodel/CullingNode.h"
+#include "ramses-citymodel/HttpTileSource.h"
+#include "ramses-citymodel/MappedTileSource.h"
 #include "ramses-citymodel/Math.h"
 #include "ramses-citymodel/Name.h"
 #include "ramses-citymodel/Name2D.h"
@@ -79,6 +81,7 @@ ramses::sceneId_t Citymodel::getSceneId() const
 
 void Citymodel::init()
 {
+    m_startupTimer.reset();
     m_ramsesClient = new ramses::RamsesClient("citymodel", m_framework);
 
     // create a scene for distributing content
@@ -93,6 +96,41 @@ void Citymodel::init()
     m_renderPass->addRenderGroup(*m_renderGroup);
 
     m_reader = new Reader(*this);
+    m_reader->setBatchMeshes(m_arguments.m_batchMeshes);
+    m_reader->setPickingGeometry(m_arguments.m_pickingGeometry);
+    m_reader->setDecodeArena(!m_arguments.m_disableDecodeArena);
+    if (HttpTileSource::IsUrl(m_arguments.m_filePath))
+    {
+        m_httpTileSource = new HttpTileSource();
+        m_httpTileSource->setConnections(m_arguments.m_httpConnections);
+        if (!m_arguments.m_httpCache.empty())
+        {
+            m_httpTileSource->setCache(m_arguments.m_httpCache, static_cast<uint64_t>(m_arguments.m_httpCacheSize) * 1024 * 1024);
+        }
+        m_reader->setTileSource(std::unique_ptr<ITileSource>(m_httpTileSource));
+    }
+    else if (m_arguments.m_mapFile)
+    {
+        m_reader->setTileSource(std::unique_ptr<ITileSource>(new MappedTileSource()));
+    }
+    m_reader->setReadQueue(m_arguments.m_readQueueDepth, !m_arguments.m_disableIoUring);
+    m_reader->setReadCoalescing(m_arguments.m_readGapTolerance * 1024);
+    if (m_arguments.m_readQueueDepth > 0)
+    {
+        m_pager.setPrefetch(m_arguments.m_readQueueDepth,
+                            [this](const std::vector<uint32_t>& indices) { m_reader->prefetch(indices); });
+    }
+    if (!m_arguments.m_geometryCache.empty())
+    {
+        m_reader->setGeometryCache(m_arguments.m_geometryCache,
+                                   static_cast<uint64_t>(m_arguments.m_geometryCacheSize) * 1024 * 1024);
+    }
+    m_reader->getTextureResidency().setBudget(static_cast<uint64_t>(m_arguments.m_textureBudget) * 1024 * 1024,
+                                              m_arguments.m_textureDetailDistance);
+    m_reader->getTextureResidency().setLevelLoader(
+        [this](uint32_t objectIndex, const std::vector<TextureResidency::UpgradeRequest>& requests) {
+            m_pager.addJob([this, objectIndex, requests]() { m_reader->readTextureLevels(objectIndex, requests); });
+        });
 
     // when a specific frame is set, we don't do animation
     if (m_arguments.m_staticFrame >= 0)
@@ -104,6 +142,7 @@ void Citymodel::init()
 
     createEffects();
     createMarkerGeometry();
+    createProxyGeometry();
 
     m_rootCameraTranslate = m_ramsesScene->createNode();
 
@@ -114,7 +153,6 @@ void Citymodel::init()
     m_cameraRotate->addChild(*m_rootCameraTranslate);
     m_rootCameraTranslate->addChild(*m_camera);
 
-    readScene();
     if (!m_arguments.m_disableRoute)
     {
         m_route = new LineContainer(Vector3(1.0f, 0.8f, 0.0f),
@@ -125,9 +163,6 @@ void Citymodel::init()
                                     *m_ramsesClient,
                                     *m_renderGroup,
                                     m_arguments.m_resPath);
-
-        m_routePoints = m_scene->getRoutePoints();
-        createRoute();
     }
 
     m_naming = new NamingManager(*m_ramsesClient,
@@ -140,11 +175,7 @@ void Citymodel::init()
                                  m_showAnimation,
                                  m_arguments.m_resPath);
 
-    if (!m_arguments.m_disableNaming)
-    {
-        m_namingPoints = m_scene->getNamePoints();
-        createNaming();
-    }
+    readScene();
 
     const float aspect = static_cast<float>(m_arguments.m_windowWidth) / static_cast<float>(m_arguments.m_windowHeight);
     m_frustum.init(m_arguments.m_fovy, aspect, 1500.0f);
@@ -165,18 +196,77 @@ bool Citymodel::shouldExit() const
 
 void Citymodel::readScene()
 {
-    m_reader->open(m_arguments.m_filePath + "/ramses-citymodel.rex");
+    const std::string filename = m_arguments.m_filePath + "/ramses-citymodel.rex";
+    if (!m_reader->open(filename, m_arguments.m_verifyChecksums))
+    {
+        printf("Could not open %s !!!\n", filename.c_str());
+        exit(1);
+    }
+
+    if (bootstrapScene())
+    {
+        printf("Bootstrapped %u tiles from the tile index in %.1f ms, reading the scene in the background\n",
+               static_cast<uint32_t>(m_tiles.size()),
+               m_startupTimer.getTime() * 1000.0f);
+
+        // The pager runs jobs before any tile, so the scene ids are known when the first tile is read.
+        m_pager.addJob([this]() {
+            TileResourceContainer globalResources;
+            m_loadedScene = static_cast<CitymodelScene*>(m_reader->read(0, globalResources, false));
+            m_sceneReadDone = true;
+        });
+        return;
+    }
 
     TileResourceContainer globalResources;
-    m_scene = static_cast<CitymodelScene*>(m_reader->read(0, globalResources, false));
+    CitymodelScene*       scene = static_cast<CitymodelScene*>(m_reader->read(0, globalResources, false));
 
-    if (!m_scene)
+    if (!scene)
     {
         printf("Could not read scene !!!\n");
         exit(1);
     }
 
+    m_tiles = scene->getTiles();
     buildTree();
+    setScene(scene);
+}
+
+bool Citymodel::bootstrapScene()
+{
+    const RexArchive&                              archive   = m_reader->getArchive();
+    const std::vector<RexArchive::TileIndexEntry>& tileIndex = archive.getTileIndex();
+
+    Vector3 carPosition;
+    Vector3 carRotation;
+    if (tileIndex.empty() || !archive.getStartKey(carPosition, carRotation))
+    {
+        return false;
+    }
+
+    // Tile i of the scene is stored in object i + 1, same as for tiles created when reading the scene.
+    for (uint32_t i = 0; i < tileIndex.size(); i++)
+    {
+        if (tileIndex[i].tileId != i || tileIndex[i].objectIndex != i + 1)
+        {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < tileIndex.size(); i++)
+    {
+        m_tiles.push_back(new Tile(tileIndex[i].boundingBox, *this, i));
+    }
+    m_reader->setTiles(m_tiles);
+    buildTree();
+
+    m_startPath.add(AnimationPath::Key(carPosition, carRotation));
+    return true;
+}
+
+void Citymodel::setScene(CitymodelScene* scene)
+{
+    m_scene = scene;
 
     ramses::Node* carsorModel = m_scene->getCarsor();
 
@@ -196,16 +286,37 @@ void Citymodel::readScene()
     {
         scaler->addChild(*carsorModel);
     }
+
+    if (m_route)
+    {
+        m_routePoints = m_scene->getRoutePoints();
+        createRoute();
+    }
+
+    if (!m_arguments.m_disableNaming)
+    {
+        m_namingPoints = m_scene->getNamePoints();
+        createNaming();
+    }
+}
+
+AnimationPath::Key* Citymodel::getAnimationKey()
+{
+    if (m_scene)
+    {
+        return m_scene->getAnimationPath().getKey(m_frame);
+    }
+    return m_startPath.getKey(0);
 }
 
 void Citymodel::buildTree()
 {
-    m_cullingTree = new CullingNode(m_scene->getTiles(), this);
+    m_cullingTree = new CullingNode(m_tiles, this);
 }
 
 void Citymodel::doAnimation(float dt)
 {
-    AnimationPath::Key* key = m_scene->getAnimationPath().getKey(m_frame);
+    AnimationPath::Key* key = getAnimationKey();
 
     if (nullptr != key)
     {
@@ -279,9 +390,17 @@ void Citymodel::doAnimation(float dt)
     Matrix44 invViewMatrix = viewMatrix.inverse();
 
     Vector3 camPos = invViewMatrix.getTranslationVector();
+    if (m_arguments.m_progressive)
+    {
+        m_pager.setFocusPosition(camPos);
+    }
+    m_reader->getTextureResidency().update(*m_ramsesClient, *m_ramsesScene, camPos);
 
     const float lightConeFactor = 35.0f / distance;
-    m_scene->setLightConeFactor(lightConeFactor);
+    if (m_scene)
+    {
+        m_scene->setLightConeFactor(lightConeFactor);
+    }
 
     if (m_naming)
     {
@@ -294,20 +413,37 @@ void Citymodel::doFrame(float dt)
 {
     m_reader->getSceneLock().lock();
 
+    if (!m_scene && m_sceneReadDone)
+    {
+        if (!m_loadedScene)
+        {
+            printf("Could not read scene !!!\n");
+            exit(1);
+        }
+        setScene(m_loadedScene);
+        printf("Scene read after %.1f ms\n", m_startupTimer.getTime() * 1000.0f);
+    }
+
     doAnimation(m_showAnimation ? dt : 0.0f);
     doCulling();
     doPaging();
 
     m_ramsesScene->flush();
 
-    if (!m_ramsesScene->isPublished() && (m_pager.getNumTilesToLoad() == 0))
+    // publish when the visible tiles are loaded, but latest after the first frame budget, or immediately in
+    // progressive mode, where the tiles not loaded yet are shown as proxies
+    const bool budgetExceeded = m_startupTimer.getTime() * 1000.0f >= m_arguments.m_firstFrameBudget;
+    if (!m_ramsesScene->isPublished() &&
+        (m_arguments.m_progressive || (m_scene && m_pager.getNumTilesToLoad() == 0) || budgetExceeded))
     {
         m_ramsesScene->publish();
+        printf("Scene published after %.1f ms (time to first frame)\n", m_startupTimer.getTime() * 1000.0f);
     }
+    checkViewComplete();
 
     m_reader->getSceneLock().unlock();
 
-    if (m_showAnimation)
+    if (m_showAnimation && m_scene)
     {
         m_frame += 1;
         const uint32_t frames = m_scene->getAnimationPath().getNumberOfKeys();
@@ -315,6 +451,7 @@ void Citymodel::doFrame(float dt)
         {
             m_numRoundsDriven++;
             m_frame = 0;
+            printRoundStatistics();
 
             if (m_arguments.m_roundsToDrive != 0 && m_numRoundsDriven == m_arguments.m_roundsToDrive)
             {
@@ -342,6 +479,154 @@ void Citymodel::doFrame(float dt)
     }
 }
 
+void Citymodel::checkViewComplete()
+{
+    if (m_viewComplete || !m_scene || !m_ramsesScene->isPublished())
+    {
+        return;
+    }
+
+    uint32_t numberOfVisibleTiles = 0;
+    for (auto tile : m_tiles)
+    {
+        if (tile->isVisible())
+        {
+            if (tile->isQueuedToLoad())
+            {
+                return;
+            }
+            numberOfVisibleTiles++;
+        }
+    }
+
+    m_viewComplete = true;
+    printf("View complete after %.1f ms (time to complete view), %u visible tiles, %u tile proxies created\n",
+           m_startupTimer.getTime() * 1000.0f,
+           numberOfVisibleTiles,
+           m_numberOfProxies);
+
+    if (m_arguments.m_showPerformanceValues)
+    {
+        printStatistics();
+    }
+}
+
+void Citymodel::printStatistics() const
+{
+    const float    megabyte          = 1024.0f * 1024.0f;
+    const uint32_t numberOfTilesRead = m_reader->getNumberOfTilesRead();
+    // KB per tile, 0 before the first tile is read
+    const float perTileKB = numberOfTilesRead > 0 ? 1.0f / (1024.0f * static_cast<float>(numberOfTilesRead)) : 0.0f;
+
+    const MaterialCache& materialCache = m_reader->getMaterialCache();
+    printf("Materials: %u read, %u appearances created, %u in use\n",
+           materialCache.getNumberOfRequests(),
+           materialCache.getNumberOfCreatedMaterials(),
+           materialCache.getNumberOfCachedMaterials());
+
+    const TextureCache& textureCache = m_reader->getTextureCache();
+    printf("Textures: %u read, %u created, %u in use, %.1f MB of %.1f MB read saved, %.1f MB saved in use\n",
+           textureCache.getNumberOfRequests(),
+           textureCache.getNumberOfCreatedTextures(),
+           textureCache.getNumberOfCachedTextures(),
+           static_cast<float>(textureCache.getRequestedSize() - textureCache.getCreatedSize()) / megabyte,
+           static_cast<float>(textureCache.getRequestedSize()) / megabyte,
+           static_cast<float>(textureCache.getReferencedSize() - textureCache.getCachedSize()) / megabyte);
+
+    const TextureResidency& textureResidency = m_reader->getTextureResidency();
+    printf("Texture residency: %.1f MB resident of %.1f MB with all mip levels, %u fine textures created\n",
+           static_cast<float>(textureResidency.getResidentSize()) / megabyte,
+           static_cast<float>(textureResidency.getFullSize()) / megabyte,
+           textureResidency.getNumberOfUpgrades());
+
+    const float meshCreationTime = m_reader->getMeshCreationTime();
+    printf("Meshes: %u created with %u geometry bindings in %.1f ms (%.0f meshes/s)\n",
+           m_reader->getNumberOfMeshes(),
+           m_reader->getNumberOfGeometryBindings(),
+           meshCreationTime * 1000.0f,
+           meshCreationTime > 0.0f ? static_cast<float>(m_reader->getNumberOfMeshes()) / meshCreationTime : 0.0f);
+
+    printf("Tiles: %u read, %.2f ms per tile, %u meshes of the file merged into batches\n",
+           numberOfTilesRead,
+           numberOfTilesRead > 0 ? m_reader->getTileReadTime() * 1000.0f / static_cast<float>(numberOfTilesRead) : 0.0f,
+           m_reader->getNumberOfBatchedMeshes());
+    if (m_arguments.m_readQueueDepth > 0)
+    {
+        printf("Read queue: %s, depth %u, %u tiles read ahead, %u dropped\n",
+               m_reader->usesIoUring() ? "io_uring" : "pread",
+               m_arguments.m_readQueueDepth,
+               m_reader->getNumberOfPrefetchedReads(),
+               m_reader->getNumberOfDroppedPrefetches());
+    }
+    printf("Reads: %u read operations for %u tiles, %.1f MB read\n",
+           m_reader->getNumberOfReadOperations(),
+           numberOfTilesRead,
+           static_cast<float>(m_reader->getReadSize()) / megabyte);
+    printf("Picking geometry (%s): %.1f KB per tile\n",
+           PickingMesh::GetName(m_arguments.m_pickingGeometry),
+           static_cast<float>(m_reader->getPickingGeometrySize()) * perTileKB);
+    printf("Arrays: %.1f KB per tile, %.1f KB per tile copied\n",
+           static_cast<float>(m_reader->getArraySize()) * perTileKB,
+           static_cast<float>(m_reader->getCopiedArraySize()) * perTileKB);
+    printf("Index arrays: %u of %u with 16 bit indices, %.1f KB per tile saved\n",
+           m_reader->getNumberOfShortIndexArrays(),
+           m_reader->getNumberOfIndexArrays(),
+           static_cast<float>(m_reader->getShortIndexSavedSize()) * perTileKB);
+
+    const GeometryDecodeStatistics& ctmDecoding     = m_reader->getCTMDecodeStatistics();
+    const GeometryDecodeStatistics& encodedDecoding = m_reader->getEncodedDecodeStatistics();
+    const GeometryDecodeStatistics& cachedDecoding  = m_reader->getCachedDecodeStatistics();
+    printf("Geometry decoding: %u CTM nodes, %.1f ns per vertex, %u encoded nodes, %.1f ns per vertex, %u cached nodes, %.1f ns per vertex\n",
+           ctmDecoding.m_numberOfGeometryNodes,
+           GetDecodeTimePerVertex(ctmDecoding) * 1e9f,
+           encodedDecoding.m_numberOfGeometryNodes,
+           GetDecodeTimePerVertex(encodedDecoding) * 1e9f,
+           cachedDecoding.m_numberOfGeometryNodes,
+           GetDecodeTimePerVertex(cachedDecoding) * 1e9f);
+    if (!m_arguments.m_geometryCache.empty())
+    {
+        PrintCacheStatistics("Geometry cache", m_reader->getGeometryCacheStatistics());
+    }
+    if (m_httpTileSource)
+    {
+        const HttpTileSourceStatistics http = m_httpTileSource->getStatistics();
+        printf("HTTP: %u range requests, %u failed, %.1f MB fetched in %u blocks, %u blocks from the block cache\n",
+               http.m_numberOfRequests,
+               http.m_numberOfFailedRequests,
+               static_cast<float>(http.m_fetchedSize) / megabyte,
+               http.m_numberOfFetchedBlocks,
+               http.m_numberOfCachedBlocks);
+        if (!m_arguments.m_httpCache.empty())
+        {
+            PrintCacheStatistics("HTTP block cache", m_httpTileSource->getCacheStatistics());
+        }
+    }
+#ifdef RAMSES_CITYMODEL_COUNT_ALLOCATIONS
+    printf("Allocations: %.1f per tile\n",
+           numberOfTilesRead > 0 ? static_cast<float>(m_reader->getNumberOfAllocations()) / static_cast<float>(numberOfTilesRead) : 0.0f);
+#endif
+    printf("Decode arena: %s (%.1f KB)\n",
+           m_arguments.m_disableDecodeArena ? "disabled" : "enabled",
+           static_cast<float>(m_reader->getDecodeArenaSize()) / 1024.0f);
+}
+
+void Citymodel::PrintCacheStatistics(const char* name, const DiskCacheStatistics& statistics)
+{
+    printf("%s: %u hits, %u misses, %u stored, %u evicted, %u entries with %.1f MB\n",
+           name,
+           statistics.m_numberOfHits,
+           statistics.m_numberOfMisses,
+           statistics.m_numberOfStores,
+           statistics.m_numberOfEvictions,
+           statistics.m_numberOfEntries,
+           static_cast<float>(statistics.m_size) / (1024.0f * 1024.0f));
+}
+
+float Citymodel::GetDecodeTimePerVertex(const GeometryDecodeStatistics& statistics)
+{
+    return statistics.m_numberOfVertices > 0 ? statistics.m_decodeTime / static_cast<float>(statistics.m_numberOfVertices) : 0.0f;
+}
+
 void Citymodel::doPaging()
 {
     m_openTilesToLoad += static_cast<int32_t>(m_tilesAddToRead.size());
@@ -419,6 +704,11 @@ void Citymodel::createEffects()
         createEffect(effectDesc, "ramses-citymodel-untextured.vert", "ramses-citymodel-untextured.frag"));
 
     m_markerEffect = createEffect(effectDesc, "ramses-citymodel-marker.vert", "ramses-citymodel-marker.frag");
+
+    if (m_arguments.m_progressive)
+    {
+        m_proxyEffect = createEffect(effectDesc, "ramses-citymodel-proxy.vert", "ramses-citymodel-proxy.frag");
+    }
 }
 
 ramses::Effect* Citymodel::createEffect(ramses::EffectDescription& effectDesc,
@@ -540,7 +830,10 @@ void Citymodel::removeTileToDelete(Tile* tile)
 
 void Citymodel::setCarPosInMaterials(const Vector3& carPos)
 {
-    m_scene->setCarPos(carPos);
+    if (m_scene)
+    {
+        m_scene->setCarPos(carPos);
+    }
 }
 
 ramses::Scene& Citymodel::getRamsesScene()
@@ -727,7 +1020,21 @@ void Citymodel::mouseEvent(ramses::EMouseEvent eventType, int32_t mousePosX, int
 
 void Citymodel::createMarkerGeometry()
 {
-    m_markerGeometry = m_ramsesScene->createGeometryBinding(*m_markerEffect);
+    m_markerGeometry = createBoxGeometry(*m_markerEffect);
+}
+
+void Citymodel::createProxyGeometry()
+{
+    if (m_proxyEffect)
+    {
+        m_proxyGeometry   = createBoxGeometry(*m_proxyEffect);
+        m_proxyAppearance = m_ramsesScene->createAppearance(*m_proxyEffect);
+    }
+}
+
+ramses::GeometryBinding* Citymodel::createBoxGeometry(const ramses::Effect& effect)
+{
+    ramses::GeometryBinding* geometry = m_ramsesScene->createGeometryBinding(effect);
 
     const float vertexPositionsArray[] = {-1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f,  1.0f,  1.0f,
                                           1.0f,  -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, 1.0f,
@@ -740,9 +1047,30 @@ void Citymodel::createMarkerGeometry()
     const ramses::UInt16Array*   indices         = m_ramsesClient->createConstUInt16Array(36, indexArray);
 
     ramses::AttributeInput positionsInput;
-    m_markerEffect->findAttributeInput("a_position", positionsInput);
-    m_markerGeometry->setInputBuffer(positionsInput, *vertexPositions);
-    m_markerGeometry->setIndices(*indices);
+    effect.findAttributeInput("a_position", positionsInput);
+    geometry->setInputBuffer(positionsInput, *vertexPositions);
+    geometry->setIndices(*indices);
+    return geometry;
+}
+
+ramses::MeshNode* Citymodel::createTileProxy(const BoundingBox& boundingBox)
+{
+    if (!m_proxyGeometry)
+    {
+        return nullptr;
+    }
+
+    const Vector3 center     = (boundingBox.getMinimumBoxCorner() + boundingBox.getMaximumBoxCorner()) * 0.5;
+    const Vector3 halfExtent = (boundingBox.getMaximumBoxCorner() - boundingBox.getMinimumBoxCorner()) * 0.5;
+
+    ramses::MeshNode* meshNode = m_ramsesScene->createMeshNode();
+    meshNode->setAppearance(*m_proxyAppearance);
+    meshNode->setGeometryBinding(*m_proxyGeometry);
+    m_renderGroup->addMeshNode(*meshNode, 0);
+    meshNode->setTranslation(center.getX(), center.getY(), center.getZ());
+    meshNode->setScaling(halfExtent.getX(), halfExtent.getY(), halfExtent.getZ());
+    m_numberOfProxies++;
+    return meshNode;
 }
 
 
@@ -764,8 +1092,7 @@ bool Citymodel::computeIntersection(const Vector3& p,
     m_reader->getSceneLock().lock();
 
     float                      r     = std::numeric_limits<float>::max();
-    const std::vector<Tile*>& tiles = m_scene->getTiles();
-    for (auto tile : tiles)
+    for (auto tile : m_tiles)
     {
         tile->computeIntersection(p, d, r);
     }
@@ -880,6 +1207,24 @@ void Citymodel::printNamingPoints()
     }
 }
 
+void Citymodel::printRoundStatistics()
+{
+    m_reader->getSceneLock().lock();
+    const uint32_t numberOfTilesRead      = m_reader->getNumberOfTilesRead();
+    const uint32_t numberOfReadOperations = m_reader->getNumberOfReadOperations();
+    const uint64_t readSize               = m_reader->getReadSize();
+    m_reader->getSceneLock().unlock();
+
+    printf("Round %u: %u tiles read with %u read operations, %.1f MB read\n",
+           m_numRoundsDriven,
+           numberOfTilesRead - m_roundStartTilesRead,
+           numberOfReadOperations - m_roundStartReadOperations,
+           static_cast<float>(readSize - m_roundStartReadSize) / (1024.0f * 1024.0f));
+    m_roundStartTilesRead      = numberOfTilesRead;
+    m_roundStartReadOperations = numberOfReadOperations;
+    m_roundStartReadSize       = readSize;
+}
+
 void Citymodel::setInteractionMode(EInteractionMode interactionMode)
 {
     m_interactionMode = interactionMode;
@@ -0,0 +1,95 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/DecodeArena.h"
+
+#include "algorithm"
+
+const size_t DecodeArena::MinimumBlockSize;
+
+void* DecodeArena::allocate(size_t size, size_t alignment)
+{
+    if (!m_enabled || m_blocks.empty())
+    {
+        addBlock(size, alignment);
+    }
+
+    uintptr_t address = reinterpret_cast<uintptr_t>(m_blocks.back().data.get()) + m_offset;
+    size_t    padding = (alignment - address % alignment) % alignment;
+    if (m_offset + padding + size > m_blocks.back().size)
+    {
+        addBlock(size, alignment);
+        address = reinterpret_cast<uintptr_t>(m_blocks.back().data.get());
+        padding = (alignment - address % alignment) % alignment;
+    }
+
+    m_offset += padding + size;
+    m_size += size;
+    m_peakSize = std::max(m_peakSize, m_size);
+    return reinterpret_cast<void*>(address + padding);
+}
+
+void DecodeArena::reset()
+{
+    if (m_enabled && m_blocks.size() > 1)
+    {
+        // the next object of the same size fits into a single block
+        size_t capacity = 0;
+        for (const auto& block : m_blocks)
+        {
+            capacity += block.size;
+        }
+        m_blocks.clear();
+        m_blocks.push_back(Block{std::unique_ptr<uint8_t[]>(new uint8_t[capacity]), capacity});
+    }
+    else if (!m_enabled)
+    {
+        m_blocks.clear();
+    }
+    m_offset = 0;
+    m_size   = 0;
+}
+
+void DecodeArena::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    m_blocks.clear();
+    m_offset = 0;
+    m_size   = 0;
+}
+
+size_t DecodeArena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const auto& block : m_blocks)
+    {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+size_t DecodeArena::getPeakSize() const
+{
+    return m_peakSize;
+}
+
+void DecodeArena::addBlock(size_t size, size_t alignment)
+{
+    // without the arena, each allocation takes exactly its size from the heap, like the containers did before
+    size_t blockSize = size + alignment;
+    if (m_enabled)
+    {
+        blockSize = std::max(blockSize, MinimumBlockSize);
+        if (!m_blocks.empty())
+        {
+            blockSize = std::max(blockSize, 2 * m_blocks.back().size);
+        }
+    }
+    m_blocks.push_back(Block{std::unique_ptr<uint8_t[]>(new uint8_t[blockSize]), blockSize});
+    m_offset = 0;
+}
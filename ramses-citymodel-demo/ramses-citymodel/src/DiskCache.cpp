@@ -0,0 +1,218 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/DiskCache.h"
+#include "ramses-citymodel/XXHash32.h"
+
+#include "algorithm"
+#include "cerrno"
+#include "cstdio"
+#include "cstring"
+#include "dirent.h"
+#include "sys/stat.h"
+#include "utime.h"
+
+const char* const DiskCache::EntryExtension = ".cache";
+
+bool DiskCache::open(const std::string& directory, uint64_t maximumSize)
+{
+    m_directory   = directory;
+    m_maximumSize = maximumSize;
+    m_entries.clear();
+    m_statistics = DiskCacheStatistics();
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        printf("DiskCache::open Could not create the cache directory %s\n", directory.c_str());
+        return false;
+    }
+
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+    {
+        printf("DiskCache::open Could not open the cache directory %s\n", directory.c_str());
+        return false;
+    }
+
+    // the entries are ordered by the time of their last use in a previous run
+    std::vector<std::pair<time_t, std::string>> found;
+    const size_t                                extensionLength = strlen(EntryExtension);
+    while (const dirent* dirEntry = readdir(dir))
+    {
+        const std::string name = dirEntry->d_name;
+        if (name.size() <= extensionLength || name.compare(name.size() - extensionLength, extensionLength, EntryExtension) != 0)
+        {
+            continue;
+        }
+        struct stat status;
+        if (stat((directory + "/" + name).c_str(), &status) == 0 && S_ISREG(status.st_mode))
+        {
+            found.push_back(std::make_pair(status.st_mtime, name));
+            Entry& entry  = m_entries[name];
+            entry.size    = static_cast<uint64_t>(status.st_size);
+            entry.lastUse = 0;
+            m_statistics.m_size += entry.size;
+        }
+    }
+    closedir(dir);
+
+    std::sort(found.begin(), found.end());
+    for (const auto& file : found)
+    {
+        m_entries[file.second].lastUse = ++m_useCounter;
+    }
+    m_statistics.m_numberOfEntries = static_cast<uint32_t>(m_entries.size());
+
+    evict(std::string());
+    return true;
+}
+
+bool DiskCache::load(uint32_t key, uint32_t index, uint32_t identity, std::vector<uint8_t>& data)
+{
+    const std::string name = GetEntryName(key, index);
+    const std::string path = m_directory + "/" + name;
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        m_statistics.m_numberOfMisses++;
+        return false;
+    }
+
+    // the data size is checked against the size of the file, before the data is allocated
+    struct stat status;
+    uint32_t    header[EntryHeaderSize / sizeof(uint32_t)];
+    bool        valid = fstat(fileno(file), &status) == 0 && fread(header, EntryHeaderSize, 1, file) == 1;
+    valid = valid && header[0] == EntryMagic && header[1] == EntryVersion && header[2] == key && header[3] == index &&
+            header[4] == identity && static_cast<uint64_t>(status.st_size) == EntryHeaderSize + static_cast<uint64_t>(header[5]);
+    if (valid)
+    {
+        data.resize(header[5]);
+        valid = (data.empty() || fread(data.data(), data.size(), 1, file) == 1) &&
+                XXHash32::Compute(data.data(), data.size()) == header[6];
+    }
+    fclose(file);
+
+    if (!valid)
+    {
+        // stale, truncated or damaged, the caller creates the data again and stores it
+        data.clear();
+        remove(name);
+        m_statistics.m_numberOfMisses++;
+        return false;
+    }
+
+    // the modification time keeps the order of use for the next run
+    utime(path.c_str(), nullptr);
+    Entry& entry  = m_entries[name];
+    entry.size    = EntryHeaderSize + data.size();
+    entry.lastUse = ++m_useCounter;
+    m_statistics.m_numberOfHits++;
+    return true;
+}
+
+bool DiskCache::store(uint32_t key, uint32_t index, uint32_t identity, const std::vector<uint8_t>& data)
+{
+    const uint64_t size = EntryHeaderSize + data.size();
+    if (m_directory.empty() || size > m_maximumSize || data.size() > UINT32_MAX)
+    {
+        return false;
+    }
+
+    const std::string name     = GetEntryName(key, index);
+    const std::string path     = m_directory + "/" + name;
+    const std::string tempPath = path + ".tmp";
+
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file)
+    {
+        printf("DiskCache::store Could not create %s\n", tempPath.c_str());
+        return false;
+    }
+
+    const uint32_t header[EntryHeaderSize / sizeof(uint32_t)] = {
+        EntryMagic,
+        EntryVersion,
+        key,
+        index,
+        identity,
+        static_cast<uint32_t>(data.size()),
+        XXHash32::Compute(data.data(), data.size())};
+    bool written = fwrite(header, EntryHeaderSize, 1, file) == 1;
+    written      = written && (data.empty() || fwrite(data.data(), data.size(), 1, file) == 1);
+    written      = (fclose(file) == 0) && written;
+    if (!written || rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        printf("DiskCache::store Could not write %s\n", path.c_str());
+        ::remove(tempPath.c_str());
+        return false;
+    }
+
+    auto it = m_entries.find(name);
+    if (it != m_entries.end())
+    {
+        m_statistics.m_size -= it->second.size;
+    }
+    Entry& entry  = m_entries[name];
+    entry.size    = size;
+    entry.lastUse = ++m_useCounter;
+    m_statistics.m_size += size;
+    m_statistics.m_numberOfEntries = static_cast<uint32_t>(m_entries.size());
+    m_statistics.m_numberOfStores++;
+
+    evict(name);
+    return true;
+}
+
+const DiskCacheStatistics& DiskCache::getStatistics() const
+{
+    return m_statistics;
+}
+
+std::string DiskCache::GetEntryName(uint32_t key, uint32_t index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%08x-%u", key, index);
+    return std::string(name) + EntryExtension;
+}
+
+void DiskCache::remove(const std::string& name)
+{
+    ::remove((m_directory + "/" + name).c_str());
+
+    auto it = m_entries.find(name);
+    if (it != m_entries.end())
+    {
+        m_statistics.m_size -= it->second.size;
+        m_entries.erase(it);
+        m_statistics.m_numberOfEntries = static_cast<uint32_t>(m_entries.size());
+    }
+}
+
+void DiskCache::evict(const std::string& keep)
+{
+    while (m_statistics.m_size > m_maximumSize)
+    {
+        // the number of entries is in the order of the tiles of a file, a linear search is fast enough compared to
+        // deleting the file
+        auto oldest = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            if (it->first != keep && (oldest == m_entries.end() || it->second.lastUse < oldest->second.lastUse))
+            {
+                oldest = it;
+            }
+        }
+        if (oldest == m_entries.end())
+        {
+            break;
+        }
+        remove(oldest->first);
+        m_statistics.m_numberOfEvictions++;
+    }
+}
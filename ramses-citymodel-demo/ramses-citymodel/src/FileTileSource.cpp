@@ -0,0 +1,90 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/FileTileSource.h"
+
+#include "cerrno"
+#include "cstdio"
+#include "fcntl.h"
+#include "sys/stat.h"
+#include "unistd.h"
+
+FileTileSource::~FileTileSource()
+{
+    close();
+}
+
+bool FileTileSource::open(const std::string& name)
+{
+    close();
+    m_fd = ::open(name.c_str(), O_RDONLY);
+    struct stat status;
+    if (m_fd < 0 || fstat(m_fd, &status) != 0)
+    {
+        printf("FileTileSource::open Could not open file: %s !!!\n", name.c_str());
+        close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(status.st_size);
+    return true;
+}
+
+void FileTileSource::close()
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_size = 0;
+}
+
+uint64_t FileTileSource::getSize() const
+{
+    return m_size;
+}
+
+bool FileTileSource::read(uint64_t position, void* buffer, uint32_t size)
+{
+    uint8_t* data = static_cast<uint8_t*>(buffer);
+    while (size > 0)
+    {
+        const ssize_t n = pread(m_fd, data, size, static_cast<off_t>(position));
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        data += n;
+        position += static_cast<uint64_t>(n);
+        size -= static_cast<uint32_t>(n);
+    }
+    return true;
+}
+
+void FileTileSource::prefetch(const std::vector<ReadPlanner::Slice>& ranges)
+{
+    // the kernel reads the ranges into the page cache in the background
+    for (const auto& range : ranges)
+    {
+        posix_fadvise(m_fd, static_cast<off_t>(range.position), static_cast<off_t>(range.size), POSIX_FADV_WILLNEED);
+    }
+}
+
+bool FileTileSource::isLocalFile() const
+{
+    return true;
+}
+
+const char* FileTileSource::getType() const
+{
+    return "file";
+}
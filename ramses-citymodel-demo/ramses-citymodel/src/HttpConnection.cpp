@@ -0,0 +1,278 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/HttpConnection.h"
+
+#include "algorithm"
+#include "cerrno"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "netdb.h"
+#include "netinet/in.h"
+#include "netinet/tcp.h"
+#include "sys/socket.h"
+#include "sys/time.h"
+#include "unistd.h"
+
+HttpConnection::~HttpConnection()
+{
+    close();
+}
+
+bool HttpConnection::ParseUrl(const std::string& url, std::string& host, std::string& port, std::string& path)
+{
+    const std::string scheme = "http://";
+    if (url.compare(0, scheme.size(), scheme) != 0)
+    {
+        return false;
+    }
+
+    const size_t      pathStart = url.find('/', scheme.size());
+    const std::string authority = url.substr(scheme.size(), pathStart - scheme.size());
+    const size_t      colon     = authority.rfind(':');
+    host                        = authority.substr(0, colon);
+    port                        = colon != std::string::npos ? authority.substr(colon + 1) : "80";
+    path                        = pathStart != std::string::npos ? url.substr(pathStart) : "/";
+    return !host.empty() && !port.empty();
+}
+
+bool HttpConnection::open(const std::string& url)
+{
+    close();
+    if (!ParseUrl(url, m_host, m_port, m_path))
+    {
+        printf("HttpConnection::open Invalid URL: %s\n", url.c_str());
+        return false;
+    }
+    return true;
+}
+
+void HttpConnection::close()
+{
+    if (m_socket >= 0)
+    {
+        ::close(m_socket);
+        m_socket = -1;
+    }
+    m_received.clear();
+}
+
+bool HttpConnection::connect()
+{
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(m_host.c_str(), m_port.c_str(), &hints, &addresses) != 0)
+    {
+        printf("HttpConnection::connect Could not resolve %s\n", m_host.c_str());
+        return false;
+    }
+
+    for (addrinfo* address = addresses; address && m_socket < 0; address = address->ai_next)
+    {
+        m_socket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (m_socket >= 0 && ::connect(m_socket, address->ai_addr, address->ai_addrlen) != 0)
+        {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (m_socket < 0)
+    {
+        printf("HttpConnection::connect Could not connect to %s:%s\n", m_host.c_str(), m_port.c_str());
+        return false;
+    }
+
+    // a stalled server fails the request instead of blocking the reader
+    const int     noDelay = 1;
+    const timeval timeout = {10, 0};
+    setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    return true;
+}
+
+bool HttpConnection::requestRange(uint64_t position, uint32_t size, void* buffer, uint64_t& fileSize, std::string& validator)
+{
+    if (m_host.empty() || size == 0)
+    {
+        return false;
+    }
+
+    // the server may have closed a connection kept open, it is opened again once
+    for (uint32_t attempt = 0; attempt < 2; attempt++)
+    {
+        const bool reused = m_socket >= 0;
+        if (!reused && !connect())
+        {
+            return false;
+        }
+
+        bool received = false;
+        if (transfer(position, size, buffer, fileSize, validator, received))
+        {
+            return true;
+        }
+        close();
+        if (received || !reused)
+        {
+            break;
+        }
+    }
+    printf("HttpConnection::requestRange Failed to read %u bytes at %llu from %s:%s%s\n",
+           size,
+           static_cast<unsigned long long>(position),
+           m_host.c_str(),
+           m_port.c_str(),
+           m_path.c_str());
+    return false;
+}
+
+bool HttpConnection::transfer(
+    uint64_t position, uint32_t size, void* buffer, uint64_t& fileSize, std::string& validator, bool& received)
+{
+    char request[1024];
+    const int requestSize = snprintf(request,
+                                     sizeof(request),
+                                     "GET %s HTTP/1.1\r\nHost: %s:%s\r\nRange: bytes=%llu-%llu\r\n\r\n",
+                                     m_path.c_str(),
+                                     m_host.c_str(),
+                                     m_port.c_str(),
+                                     static_cast<unsigned long long>(position),
+                                     static_cast<unsigned long long>(position + size - 1));
+    if (requestSize <= 0 || static_cast<size_t>(requestSize) >= sizeof(request))
+    {
+        return false;
+    }
+    for (int sent = 0; sent < requestSize;)
+    {
+        const ssize_t n = send(m_socket, request + sent, static_cast<size_t>(requestSize - sent), MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        sent += static_cast<int>(n);
+    }
+
+    // headers, the bytes after them are the start of the body
+    std::string headers = m_received;
+    m_received.clear();
+    size_t headerEnd = headers.find("\r\n\r\n");
+    while (headerEnd == std::string::npos)
+    {
+        char         chunk[4096];
+        const size_t n = receive(chunk, sizeof(chunk));
+        if (n == 0 || headers.size() > 65536)
+        {
+            return false;
+        }
+        headers.append(chunk, n);
+        received  = true;
+        headerEnd = headers.find("\r\n\r\n");
+    }
+    received   = true;
+    m_received = headers.substr(headerEnd + 4);
+    headers.resize(headerEnd + 2);
+
+    uint32_t status = 0;
+    if (sscanf(headers.c_str(), "HTTP/%*u.%*u %u", &status) != 1 || status != 206)
+    {
+        printf("HttpConnection::transfer Server answered the range request with status %u\n", status);
+        return false;
+    }
+
+    uint64_t contentLength = 0;
+    bool     closeAfter    = false;
+    fileSize               = 0;
+    validator.clear();
+    for (size_t start = headers.find("\r\n") + 2; start < headers.size();)
+    {
+        const size_t end  = headers.find("\r\n", start);
+        std::string  line = headers.substr(start, end - start);
+        start             = end + 2;
+
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos)
+        {
+            continue;
+        }
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        const size_t      valueStart = line.find_first_not_of(' ', colon + 1);
+        const std::string value      = valueStart != std::string::npos ? line.substr(valueStart) : std::string();
+        if (name == "content-length")
+        {
+            contentLength = strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (name == "content-range")
+        {
+            const size_t slash = value.find('/');
+            if (slash != std::string::npos)
+            {
+                fileSize = strtoull(value.c_str() + slash + 1, nullptr, 10);
+            }
+        }
+        else if (name == "etag" || (name == "last-modified" && validator.empty()))
+        {
+            validator = value;
+        }
+        else if (name == "connection" && value.find("close") != std::string::npos)
+        {
+            closeAfter = true;
+        }
+    }
+    if (contentLength != size || fileSize == 0)
+    {
+        printf("HttpConnection::transfer Server returned %llu bytes instead of %u\n",
+               static_cast<unsigned long long>(contentLength),
+               size);
+        return false;
+    }
+
+    uint8_t*     data  = static_cast<uint8_t*>(buffer);
+    const size_t first = std::min(m_received.size(), static_cast<size_t>(size));
+    memcpy(data, m_received.data(), first);
+    m_received.erase(0, first);
+    for (size_t done = first; done < size;)
+    {
+        const size_t n = receive(data + done, size - done);
+        if (n == 0)
+        {
+            return false;
+        }
+        done += n;
+    }
+
+    if (closeAfter)
+    {
+        close();
+    }
+    return true;
+}
+
+size_t HttpConnection::receive(void* buffer, size_t size)
+{
+    for (;;)
+    {
+        const ssize_t n = recv(m_socket, buffer, size, 0);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+}
@@ -0,0 +1,369 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/HttpTileSource.h"
+#include "ramses-citymodel/XXHash32.h"
+
+#include "algorithm"
+#include "cstdio"
+#include "cstring"
+
+HttpTileSource::HttpTileSource()
+{
+}
+
+HttpTileSource::~HttpTileSource()
+{
+    close();
+}
+
+bool HttpTileSource::IsUrl(const std::string& name)
+{
+    return name.compare(0, 7, "http://") == 0;
+}
+
+void HttpTileSource::setConnections(uint32_t numberOfConnections)
+{
+    m_numberOfConnections = numberOfConnections;
+}
+
+bool HttpTileSource::setCache(const std::string& directory, uint64_t maximumSize)
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_cache.reset(new DiskCache());
+    if (!m_cache->open(directory, maximumSize))
+    {
+        m_cache.reset();
+        return false;
+    }
+    return true;
+}
+
+bool HttpTileSource::open(const std::string& name)
+{
+    close();
+    uint8_t firstByte = 0;
+    if (!m_readConnection.open(name) || !m_readConnection.requestRange(0, 1, &firstByte, m_size, m_validator))
+    {
+        printf("HttpTileSource::open Could not open %s !!!\n", name.c_str());
+        m_size = 0;
+        return false;
+    }
+    m_url = name;
+    m_statistics.m_numberOfRequests++;
+    m_statistics.m_fetchedSize++;
+
+    const std::string identity = std::to_string(m_size) + " " + m_validator;
+    m_cacheKey                 = XXHash32::Compute(name.data(), name.size());
+    m_cacheIdentity            = XXHash32::Compute(identity.data(), identity.size());
+
+    m_terminate = false;
+    for (uint32_t i = 0; i < m_numberOfConnections; i++)
+    {
+        HttpConnection* connection = new HttpConnection();
+        m_connections.push_back(std::unique_ptr<HttpConnection>(connection));
+        connection->open(name);
+        m_threads.push_back(std::thread([this, connection]() { fetchLoop(*connection); }));
+    }
+    return true;
+}
+
+void HttpTileSource::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_terminate = true;
+    }
+    m_fetchCondition.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+    m_connections.clear();
+    m_readConnection.close();
+
+    m_blocks.clear();
+    m_queue.clear();
+    m_queuedBlocks.clear();
+    m_pendingBlocks.clear();
+    m_size = 0;
+}
+
+uint64_t HttpTileSource::getSize() const
+{
+    return m_size;
+}
+
+bool HttpTileSource::read(uint64_t position, void* buffer, uint32_t size)
+{
+    if (position > m_size || size > m_size - position)
+    {
+        return false;
+    }
+
+    uint8_t*                     data = static_cast<uint8_t*>(buffer);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (size > 0)
+    {
+        const uint64_t block = position / BlockSize;
+        auto           it    = m_blocks.find(block);
+        if (it != m_blocks.end())
+        {
+            const uint32_t offset = static_cast<uint32_t>(position - block * BlockSize);
+            const uint32_t count  = std::min(size, static_cast<uint32_t>(it->second.data.size()) - offset);
+            memcpy(data, it->second.data.data() + offset, count);
+            it->second.lastUse = ++m_useCounter;
+            data += count;
+            position += count;
+            size -= count;
+            continue;
+        }
+
+        if (m_pendingBlocks.count(block) > 0 && m_queuedBlocks.count(block) == 0)
+        {
+            // a fetching thread has the block
+            m_blockCondition.wait(lock);
+            continue;
+        }
+
+        // the block is fetched by the reading thread, together with the following missing blocks of the read, queued
+        // blocks are taken from the queue
+        const uint64_t lastBlock      = (position + size - 1) / BlockSize;
+        uint32_t       numberOfBlocks = 0;
+        for (uint64_t next = block; next <= lastBlock && numberOfBlocks < MaximumRequestBlocks; next++)
+        {
+            if (m_blocks.count(next) > 0 || (m_pendingBlocks.count(next) > 0 && m_queuedBlocks.count(next) == 0))
+            {
+                break;
+            }
+            m_queuedBlocks.erase(next);
+            m_pendingBlocks.insert(next);
+            numberOfBlocks++;
+        }
+
+        lock.unlock();
+        const bool success = fetchBlocks(m_readConnection, block, numberOfBlocks);
+        lock.lock();
+        for (uint32_t i = 0; i < numberOfBlocks; i++)
+        {
+            m_pendingBlocks.erase(block + i);
+        }
+        m_blockCondition.notify_all();
+        if (!success)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HttpTileSource::prefetch(const std::vector<ReadPlanner::Slice>& ranges)
+{
+    if (m_threads.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& range : ranges)
+    {
+        if (range.size == 0 || range.position >= m_size)
+        {
+            continue;
+        }
+
+        const uint64_t lastBlock = (std::min(range.position + range.size, m_size) - 1) / BlockSize;
+        for (uint64_t block = range.position / BlockSize; block <= lastBlock; block++)
+        {
+            auto it = m_blocks.find(block);
+            if (it != m_blocks.end())
+            {
+                // blocks needed soon are not dropped for fetched blocks
+                it->second.lastUse = ++m_useCounter;
+            }
+            else if (m_pendingBlocks.count(block) == 0 && 2 * m_pendingBlocks.size() < MaximumMemoryBlocks)
+            {
+                m_queue.push_back(block);
+                m_queuedBlocks.insert(block);
+                m_pendingBlocks.insert(block);
+            }
+        }
+    }
+    m_fetchCondition.notify_all();
+}
+
+bool HttpTileSource::isLocalFile() const
+{
+    return false;
+}
+
+const char* HttpTileSource::getType() const
+{
+    return "http";
+}
+
+HttpTileSourceStatistics HttpTileSource::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+DiskCacheStatistics HttpTileSource::getCacheStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    return m_cache ? m_cache->getStatistics() : DiskCacheStatistics();
+}
+
+void HttpTileSource::fetchLoop(HttpConnection& connection)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_terminate)
+    {
+        // blocks taken by read() are still in the queue
+        while (!m_queue.empty() && m_queuedBlocks.count(m_queue.front()) == 0)
+        {
+            m_queue.pop_front();
+        }
+        if (m_queue.empty())
+        {
+            m_fetchCondition.wait(lock);
+            continue;
+        }
+
+        const uint64_t firstBlock     = m_queue.front();
+        uint32_t       numberOfBlocks = 0;
+        while (numberOfBlocks < MaximumRequestBlocks && m_queuedBlocks.erase(firstBlock + numberOfBlocks) > 0)
+        {
+            numberOfBlocks++;
+        }
+
+        lock.unlock();
+        fetchBlocks(connection, firstBlock, numberOfBlocks);
+        lock.lock();
+        for (uint32_t i = 0; i < numberOfBlocks; i++)
+        {
+            m_pendingBlocks.erase(firstBlock + i);
+        }
+        m_blockCondition.notify_all();
+    }
+}
+
+bool HttpTileSource::fetchBlocks(HttpConnection& connection, uint64_t firstBlock, uint32_t numberOfBlocks)
+{
+    // blocks found in the cache split the blocks into runs requested from the server
+    bool                 success   = true;
+    uint64_t             runStart  = firstBlock;
+    uint32_t             runLength = 0;
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i <= numberOfBlocks; i++)
+    {
+        const uint64_t block = firstBlock + i;
+        if (i < numberOfBlocks)
+        {
+            bool cached = false;
+            if (m_cache)
+            {
+                std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
+                cached = m_cache->load(m_cacheKey, static_cast<uint32_t>(block), m_cacheIdentity, data) &&
+                         data.size() == getBlockSize(block);
+            }
+            if (!cached)
+            {
+                if (runLength == 0)
+                {
+                    runStart = block;
+                }
+                runLength++;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            insertBlock(block, data);
+            m_statistics.m_numberOfCachedBlocks++;
+        }
+
+        if (runLength > 0)
+        {
+            success   = requestBlocks(connection, runStart, runLength) && success;
+            runLength = 0;
+        }
+    }
+    return success;
+}
+
+bool HttpTileSource::requestBlocks(HttpConnection& connection, uint64_t firstBlock, uint32_t numberOfBlocks)
+{
+    const uint64_t       position = firstBlock * BlockSize;
+    const uint32_t       size     = static_cast<uint32_t>(std::min<uint64_t>(numberOfBlocks * BlockSize, m_size - position));
+    std::vector<uint8_t> data(size);
+    uint64_t             fileSize = 0;
+    std::string          validator;
+    bool                 success = connection.requestRange(position, size, data.data(), fileSize, validator);
+    if (success && (fileSize != m_size || validator != m_validator))
+    {
+        printf("HttpTileSource::requestBlocks %s changed on the server since it was opened\n", m_url.c_str());
+        success = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_statistics.m_numberOfRequests++;
+        if (!success)
+        {
+            m_statistics.m_numberOfFailedRequests++;
+            return false;
+        }
+        m_statistics.m_fetchedSize += size;
+        m_statistics.m_numberOfFetchedBlocks += numberOfBlocks;
+    }
+
+    std::vector<uint8_t> blockData;
+    for (uint32_t i = 0; i < numberOfBlocks; i++)
+    {
+        const uint64_t block  = firstBlock + i;
+        const size_t   offset = static_cast<size_t>(i) * BlockSize;
+        blockData.assign(data.begin() + offset, data.begin() + offset + getBlockSize(block));
+        if (m_cache)
+        {
+            std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
+            m_cache->store(m_cacheKey, static_cast<uint32_t>(block), m_cacheIdentity, blockData);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        insertBlock(block, blockData);
+    }
+    return true;
+}
+
+void HttpTileSource::insertBlock(uint64_t block, std::vector<uint8_t>& data)
+{
+    Block& entry = m_blocks[block];
+    entry.data.swap(data);
+    entry.lastUse = ++m_useCounter;
+    if (m_blocks.size() <= MaximumMemoryBlocks)
+    {
+        return;
+    }
+
+    auto leastRecentlyUsed = m_blocks.begin();
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    {
+        if (it->second.lastUse < leastRecentlyUsed->second.lastUse)
+        {
+            leastRecentlyUsed = it;
+        }
+    }
+    m_blocks.erase(leastRecentlyUsed);
+}
+
+uint32_t HttpTileSource::getBlockSize(uint64_t block) const
+{
+    const uint64_t remaining = m_size - block * BlockSize;
+    return static_cast<uint32_t>(remaining < BlockSize ? remaining : BlockSize);
+}
@@ -0,0 +1,102 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/MappedTileSource.h"
+
+#include "algorithm"
+#include "cstdio"
+#include "cstring"
+#include "fcntl.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#include "unistd.h"
+
+MappedTileSource::~MappedTileSource()
+{
+    close();
+}
+
+bool MappedTileSource::open(const std::string& name)
+{
+    close();
+    const int   fd = ::open(name.c_str(), O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0 || status.st_size == 0)
+    {
+        printf("MappedTileSource::open Could not open file: %s !!!\n", name.c_str());
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    // the mapping keeps the file open
+    const size_t size    = static_cast<size_t>(status.st_size);
+    void*        mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        printf("MappedTileSource::open Could not map file: %s !!!\n", name.c_str());
+        return false;
+    }
+    madvise(mapping, size, MADV_RANDOM);
+    m_data = static_cast<const uint8_t*>(mapping);
+    m_size = size;
+    return true;
+}
+
+void MappedTileSource::close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+        m_data = nullptr;
+    }
+    m_size = 0;
+}
+
+uint64_t MappedTileSource::getSize() const
+{
+    return m_size;
+}
+
+bool MappedTileSource::read(uint64_t position, void* buffer, uint32_t size)
+{
+    if (!m_data || position > m_size || size > m_size - position)
+    {
+        return false;
+    }
+    memcpy(buffer, m_data + position, size);
+    return true;
+}
+
+void MappedTileSource::prefetch(const std::vector<ReadPlanner::Slice>& ranges)
+{
+    const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    for (const auto& range : ranges)
+    {
+        if (!m_data || range.position >= m_size)
+        {
+            continue;
+        }
+        const uint64_t start = range.position & ~(pageSize - 1);
+        const uint64_t end   = std::min(range.position + range.size, m_size);
+        madvise(const_cast<uint8_t*>(m_data) + start, static_cast<size_t>(end - start), MADV_WILLNEED);
+    }
+}
+
+bool MappedTileSource::isLocalFile() const
+{
+    return false;
+}
+
+const char* MappedTileSource::getType() const
+{
+    return "mmap";
+}
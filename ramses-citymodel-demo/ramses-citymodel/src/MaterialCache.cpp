@@ -0,0 +1,117 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/MaterialCache.h"
+#include "ramses-citymodel/TextureResidency.h"
+#include "ramses-citymodel/Material.h"
+
+#include "ramses-client-api/Appearance.h"
+#include "ramses-client-api/Scene.h"
+#include "ramses-client-api/TextureSampler.h"
+
+#include "assert.h"
+#include "cstdio"
+
+bool MaterialCache::Key::operator<(const Key& other) const
+{
+    if (effect != other.effect)
+    {
+        return effect < other.effect;
+    }
+    if (texture != other.texture)
+    {
+        return texture < other.texture;
+    }
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        if (color.get(i) != other.color.get(i))
+        {
+            return color.get(i) < other.color.get(i);
+        }
+    }
+    return blending < other.blending;
+}
+
+MaterialCache::~MaterialCache()
+{
+    for (auto& entry : m_entries)
+    {
+        delete entry.second.material;
+    }
+}
+
+Material* MaterialCache::acquire(const Key& key)
+{
+    m_numberOfRequests++;
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        return nullptr;
+    }
+    it->second.refCount++;
+    return it->second.material;
+}
+
+void MaterialCache::add(const Key& key, Material* material)
+{
+    assert(m_entries.find(key) == m_entries.end());
+    m_numberOfCreatedMaterials++;
+    m_entries[key] = {material, 1};
+    m_keys[material] = key;
+}
+
+void MaterialCache::setTextureResidency(TextureResidency* residency)
+{
+    m_textureResidency = residency;
+}
+
+void MaterialCache::release(Material* material, ramses::Scene& scene)
+{
+    auto keyIt = m_keys.find(material);
+    if (keyIt == m_keys.end())
+    {
+        printf("MaterialCache::release ERROR - Material not cached !!!\n");
+        return;
+    }
+
+    auto it = m_entries.find(keyIt->second);
+    assert(it != m_entries.end() && it->second.refCount > 0);
+    if (--it->second.refCount > 0)
+    {
+        return;
+    }
+
+    if (m_textureResidency)
+    {
+        m_textureResidency->removeMaterial(*material, scene);
+    }
+    scene.destroy(material->getAppearance());
+    if (material->getTextureSampler())
+    {
+        scene.destroy(*material->getTextureSampler());
+    }
+    delete material;
+
+    m_entries.erase(it);
+    m_keys.erase(keyIt);
+}
+
+uint32_t MaterialCache::getNumberOfRequests() const
+{
+    return m_numberOfRequests;
+}
+
+uint32_t MaterialCache::getNumberOfCreatedMaterials() const
+{
+    return m_numberOfCreatedMaterials;
+}
+
+uint32_t MaterialCache::getNumberOfCachedMaterials() const
+{
+    return static_cast<uint32_t>(m_entries.size());
+}
@@ -0,0 +1,91 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/MeshBatch.h"
+#include "ramses-citymodel/Reader.h"
+
+MeshBatch::MeshBatch(bool hasNormals, bool hasTexCoords, bool hasTexCoords2)
+    : m_hasNormals(hasNormals)
+    , m_hasTexCoords(hasTexCoords)
+    , m_hasTexCoords2(hasTexCoords2)
+{
+}
+
+void MeshBatch::reset(bool hasNormals, bool hasTexCoords, bool hasTexCoords2)
+{
+    m_hasNormals    = hasNormals;
+    m_hasTexCoords  = hasTexCoords;
+    m_hasTexCoords2 = hasTexCoords2;
+    m_positions.clear();
+    m_normals.clear();
+    m_texCoords.clear();
+    m_texCoords2.clear();
+    m_indices.clear();
+}
+
+bool MeshBatch::append(const GeometryNode& geometryNode, const Matrix44& transform, uint32_t startIndex, uint32_t indexCount)
+{
+    const uint32_t* indices        = geometryNode.m_indexData;
+    const uint32_t  numberVertices = geometryNode.m_numberOfVertices;
+    if (static_cast<uint64_t>(startIndex) + indexCount > geometryNode.m_numberOfIndices ||
+        (m_hasNormals && !geometryNode.m_normalsData) ||
+        (m_hasTexCoords && !geometryNode.m_texCoordsData) ||
+        (m_hasTexCoords2 && !geometryNode.m_texCoords2Data))
+    {
+        return false;
+    }
+
+    for (uint32_t i = startIndex; i < startIndex + indexCount; i++)
+    {
+        if (indices[i] >= numberVertices)
+        {
+            return false;
+        }
+    }
+
+    const Matrix44 normalTransform = transform.inverse().transpose();
+
+    const uint32_t unused = 0xffffffffu;
+    m_remap.assign(numberVertices, unused);
+
+    for (uint32_t i = startIndex; i < startIndex + indexCount; i++)
+    {
+        const uint32_t index = indices[i];
+        if (m_remap[index] == unused)
+        {
+            m_remap[index] = static_cast<uint32_t>(m_positions.size());
+            m_positions.push_back(transform * geometryNode.m_positionsData[index]);
+
+            if (m_hasNormals)
+            {
+                const Vector3 normal = Vector3(normalTransform * Vector4(geometryNode.m_normalsData[index], 0.0f));
+                const float   length = normal.length();
+                m_normals.push_back(length > 0.0f ? normal * (1.0f / length) : normal);
+            }
+            if (m_hasTexCoords)
+            {
+                m_texCoords.insert(m_texCoords.end(),
+                                   geometryNode.m_texCoordsData + index * 2,
+                                   geometryNode.m_texCoordsData + index * 2 + 2);
+            }
+            if (m_hasTexCoords2)
+            {
+                m_texCoords2.insert(m_texCoords2.end(),
+                                    geometryNode.m_texCoords2Data + index * 4,
+                                    geometryNode.m_texCoords2Data + index * 4 + 4);
+            }
+        }
+        m_indices.push_back(m_remap[index]);
+    }
+    return true;
+}
+
+uint32_t MeshBatch::getNumberOfVertices() const
+{
+    return static_cast<uint32_t>(m_positions.size());
+}
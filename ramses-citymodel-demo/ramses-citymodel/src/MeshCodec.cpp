@@ -0,0 +1,142 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/MeshCodec.h"
+
+#include "cstring"
+
+void MeshCodec::EncodeIndices(const uint32_t* indices, uint32_t count, std::vector<uint8_t>& data)
+{
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // 0 for a new vertex, small values for recently used ones
+        const int32_t difference = static_cast<int32_t>(next - indices[i]);
+        uint32_t      value      = (static_cast<uint32_t>(difference) << 1) ^ static_cast<uint32_t>(difference >> 31);
+        while (value >= 0x80)
+        {
+            data.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<uint8_t>(value));
+
+        if (indices[i] >= next)
+        {
+            next = indices[i] + 1;
+        }
+    }
+}
+
+bool MeshCodec::DecodeIndices(const uint8_t* data, uint32_t size, uint32_t count, uint32_t numberOfVertices, uint32_t* indices)
+{
+    const uint8_t* end  = data + size;
+    uint32_t       next = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (data == end)
+        {
+            return false;
+        }
+        uint32_t value = *data++;
+        if (value & 0x80)
+        {
+            // indices of vertices used long ago need more than one byte
+            value &= 0x7f;
+            uint32_t shift = 7;
+            uint8_t  byte  = 0x80;
+            while (byte & 0x80)
+            {
+                if (data == end || shift > 28)
+                {
+                    return false;
+                }
+                byte = *data++;
+                value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+                shift += 7;
+            }
+        }
+
+        const uint32_t index = next - ((value >> 1) ^ (0u - (value & 1)));
+        if (index >= numberOfVertices)
+        {
+            return false;
+        }
+        indices[i] = index;
+        if (index >= next)
+        {
+            next = index + 1;
+        }
+    }
+    return data == end;
+}
+
+uint64_t MeshCodec::GetEncodedVertexSize(uint32_t count, uint32_t components)
+{
+    return static_cast<uint64_t>(count) * components * sizeof(float);
+}
+
+void MeshCodec::EncodeVertices(const float* values, uint32_t count, uint32_t components, std::vector<uint8_t>& data)
+{
+    const size_t start = data.size();
+    data.resize(start + static_cast<size_t>(GetEncodedVertexSize(count, components)));
+
+    // per component four planes of count bytes, from the lowest to the highest byte
+    for (uint32_t k = 0; k < components; k++)
+    {
+        uint8_t* planes   = &data[start] + static_cast<size_t>(k) * 4 * count;
+        uint32_t previous = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &values[static_cast<size_t>(i) * components + k], sizeof(bits));
+            const int32_t  difference = static_cast<int32_t>(bits - previous);
+            const uint32_t value      = (static_cast<uint32_t>(difference) << 1) ^ static_cast<uint32_t>(difference >> 31);
+            previous                  = bits;
+
+            planes[i]             = static_cast<uint8_t>(value);
+            planes[count + i]     = static_cast<uint8_t>(value >> 8);
+            planes[2 * count + i] = static_cast<uint8_t>(value >> 16);
+            planes[3 * count + i] = static_cast<uint8_t>(value >> 24);
+        }
+    }
+}
+
+void MeshCodec::DecodeVertices(const uint8_t* data, uint32_t count, uint32_t components, float* values)
+{
+    // decoded in blocks of vertices, so that the output of a block stays in the cache while its components are
+    // decoded one after the other. The planes of a block are combined in a loop without dependencies, which the
+    // compiler vectorizes, and then summed up.
+    uint32_t previous[MaxComponents] = {};
+    uint32_t differences[VertexBlockSize];
+    for (uint32_t start = 0; start < count; start += VertexBlockSize)
+    {
+        const uint32_t blockCount = count - start < VertexBlockSize ? count - start : VertexBlockSize;
+        float*         block      = values + static_cast<size_t>(start) * components;
+        for (uint32_t k = 0; k < components; k++)
+        {
+            const uint8_t* plane0 = data + static_cast<size_t>(k) * 4 * count + start;
+            const uint8_t* plane1 = plane0 + count;
+            const uint8_t* plane2 = plane1 + count;
+            const uint8_t* plane3 = plane2 + count;
+            for (uint32_t i = 0; i < blockCount; i++)
+            {
+                const uint32_t value = static_cast<uint32_t>(plane0[i]) | (static_cast<uint32_t>(plane1[i]) << 8) |
+                                       (static_cast<uint32_t>(plane2[i]) << 16) | (static_cast<uint32_t>(plane3[i]) << 24);
+                differences[i] = (value >> 1) ^ (0u - (value & 1));
+            }
+
+            uint32_t bits = previous[k];
+            for (uint32_t i = 0; i < blockCount; i++)
+            {
+                bits += differences[i];
+                std::memcpy(&block[static_cast<size_t>(i) * components + k], &bits, sizeof(bits));
+            }
+            previous[k] = bits;
+        }
+    }
+}
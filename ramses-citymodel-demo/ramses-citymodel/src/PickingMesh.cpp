@@ -0,0 +1,156 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+
+#include "ramses-citymodel/PickingMesh.h"
+
+#include "algorithm"
+#include "cmath"
+#include "limits"
+
+const char* PickingMesh::GetName(EPickingGeometry mode)
+{
+    switch (mode)
+    {
+    case EPickingGeometry_None:
+        return "none";
+    case EPickingGeometry_Compact:
+        return "compact";
+    case EPickingGeometry_Full:
+        return "full";
+    default:
+        return "unknown";
+    }
+}
+
+bool PickingMesh::FromName(const std::string& name, EPickingGeometry& mode)
+{
+    for (uint32_t i = 0; i < EPickingGeometry_NumberOfModes; i++)
+    {
+        if (name == GetName(static_cast<EPickingGeometry>(i)))
+        {
+            mode = static_cast<EPickingGeometry>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PickingMesh::set(EPickingGeometry mode,
+                      const float*     positions,
+                      uint32_t         numberOfVertices,
+                      const uint32_t*  indices,
+                      uint32_t         numberOfIndices)
+{
+    std::vector<Vector3>().swap(m_positions);
+    std::vector<uint16_t>().swap(m_quantizedPositions);
+    std::vector<uint32_t>().swap(m_indices);
+    std::vector<uint16_t>().swap(m_shortIndices);
+
+    if (mode == EPickingGeometry_None || numberOfVertices == 0)
+    {
+        return;
+    }
+
+    // triangles with indices out of range are dropped
+    std::vector<uint32_t> validIndices;
+    validIndices.reserve(numberOfIndices);
+    for (uint32_t i = 0; i + 2 < numberOfIndices; i += 3)
+    {
+        if (indices[i] < numberOfVertices && indices[i + 1] < numberOfVertices && indices[i + 2] < numberOfVertices)
+        {
+            validIndices.insert(validIndices.end(), indices + i, indices + i + 3);
+        }
+    }
+
+    if (mode == EPickingGeometry_Full)
+    {
+        m_positions.resize(numberOfVertices);
+        for (uint32_t i = 0; i < numberOfVertices; i++)
+        {
+            m_positions[i] = Vector3(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+        }
+        m_indices.swap(validIndices);
+        return;
+    }
+
+    float minimum[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float maximum[3] = {-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+    for (uint32_t i = 0; i < numberOfVertices; i++)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            minimum[k] = std::min(minimum[k], positions[3 * i + k]);
+            maximum[k] = std::max(maximum[k], positions[3 * i + k]);
+        }
+    }
+
+    const float steps = 65535.0f;
+    m_offset = Vector3(minimum[0], minimum[1], minimum[2]);
+    m_scale  = Vector3((maximum[0] - minimum[0]) / steps, (maximum[1] - minimum[1]) / steps, (maximum[2] - minimum[2]) / steps);
+
+    m_quantizedPositions.resize(3 * numberOfVertices);
+    for (uint32_t i = 0; i < numberOfVertices; i++)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            const float extent = maximum[k] - minimum[k];
+            const float value  = extent > 0.0f ? (positions[3 * i + k] - minimum[k]) / extent * steps : 0.0f;
+            m_quantizedPositions[3 * i + k] = static_cast<uint16_t>(std::lround(value));
+        }
+    }
+
+    if (numberOfVertices <= 65536)
+    {
+        m_shortIndices.assign(validIndices.begin(), validIndices.end());
+    }
+    else
+    {
+        m_indices.swap(validIndices);
+    }
+}
+
+uint32_t PickingMesh::getNumberOfTriangles() const
+{
+    return static_cast<uint32_t>((m_indices.size() + m_shortIndices.size()) / 3);
+}
+
+void PickingMesh::getTriangle(uint32_t triangle, Vector3& a, Vector3& b, Vector3& c) const
+{
+    const uint32_t i = 3 * triangle;
+    if (m_shortIndices.empty())
+    {
+        a = getPosition(m_indices[i]);
+        b = getPosition(m_indices[i + 1]);
+        c = getPosition(m_indices[i + 2]);
+    }
+    else
+    {
+        a = getPosition(m_shortIndices[i]);
+        b = getPosition(m_shortIndices[i + 1]);
+        c = getPosition(m_shortIndices[i + 2]);
+    }
+}
+
+size_t PickingMesh::getMemorySize() const
+{
+    return m_positions.size() * sizeof(Vector3) + m_quantizedPositions.size() * sizeof(uint16_t) +
+           m_indices.size() * sizeof(uint32_t) + m_shortIndices.size() * sizeof(uint16_t);
+}
+
+Vector3 PickingMesh::getPosition(uint32_t index) const
+{
+    if (!m_positions.empty())
+    {
+        return m_positions[index];
+    }
+    const uint16_t* quantized = &m_quantizedPositions[3 * index];
+    return Vector3(m_offset.getX() + quantized[0] * m_scale.getX(),
+                   m_offset.getY() + quantized[1] * m_scale.getY(),
+                   m_offset.getZ() + quantized[2] * m_scale.getZ());
+}
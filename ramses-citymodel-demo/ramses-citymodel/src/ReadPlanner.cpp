@@ -0,0 +1,41 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/ReadPlanner.h"
+
+#include "algorithm"
+
+void ReadPlanner::Plan(uint32_t gapTolerance, uint32_t maximumReadSize, std::vector<Slice>& slices, std::vector<Read>& reads)
+{
+    reads.clear();
+    std::sort(slices.begin(), slices.end(), [](const Slice& a, const Slice& b) { return a.position < b.position; });
+
+    for (uint32_t i = 0; i < slices.size(); i++)
+    {
+        const Slice&   slice = slices[i];
+        const uint64_t end   = slice.position + slice.size;
+        if (!reads.empty())
+        {
+            Read&          read    = reads.back();
+            const uint64_t readEnd = read.position + read.size;
+            if (slice.position <= readEnd + gapTolerance && std::max(end, readEnd) - read.position <= maximumReadSize)
+            {
+                read.size = static_cast<uint32_t>(std::max(end, readEnd) - read.position);
+                read.numberOfSlices++;
+                continue;
+            }
+        }
+
+        Read read;
+        read.position       = slice.position;
+        read.size           = slice.size;
+        read.firstSlice     = i;
+        read.numberOfSlices = 1;
+        reads.push_back(read);
+    }
+}
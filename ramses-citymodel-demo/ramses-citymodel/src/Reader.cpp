@@ -7,14 +7,22 @@
 //  -------------------------------------------------------------------------
 
 #include "ramses-citymodel/Reader.h"
+#include "ramses-citymodel/AllocationCounter.h"
+#include "ramses-citymodel/RexObjects.h"
 #include "ramses-citymodel/Citymodel.h"
 #include "ramses-citymodel/CitymodelScene.h"
 #include "ramses-citymodel/EObjectType.h"
 #include "ramses-citymodel/Material.h"
+#include "ramses-citymodel/MeshBatch.h"
+#include "ramses-citymodel/MeshCodec.h"
+#include "ramses-citymodel/Name2D.h"
 #include "ramses-citymodel/TileResourceContainer.h"
+#include "ramses-citymodel/Timer.h"
+#include "ramses-citymodel/VertexQuantization.h"
 #include "ramses-citymodel/Vector2.h"
 #include "ramses-citymodel/Vector3.h"
 #include "ramses-citymodel/Vector4.h"
+#include "ramses-citymodel/XXHash32.h"
 
 #include "ramses-client-api/RamsesClient.h"
 #include "ramses-client-api/RenderGroup.h"
@@ -26,6 +34,7 @@
 #include "ramses-client-api/MeshNode.h"
 #include "ramses-client-api/Node.h"
 #include "ramses-client-api/Scene.h"
+#include "ramses-client-api/UInt16Array.h"
 #include "ramses-client-api/UInt32Array.h"
 #include "ramses-client-api/Vector3fArray.h"
 #include "ramses-client-api/Vector4fArray.h"
@@ -36,41 +45,31 @@
 #include "ramses-client-api/TextureSampler.h"
 #include "ramses-client-api/UniformInput.h"
 
-#include "lz4.h"
+#include "algorithm"
 #include "istream"
+#include "limits"
+#include "new"
+#include "tuple"
 #include "assert.h"
 #include "cstring"
 
-Reader::FileReference::FileReference(uint64_t position, uint32_t compressedSize, uint32_t uncompressedSize)
-    : m_position(position)
-    , m_compressedSize(compressedSize)
-    , m_uncompressedSize(uncompressedSize)
-{
-}
-
-uint64_t Reader::FileReference::position() const
-{
-    return m_position;
-}
-
-uint32_t Reader::FileReference::compressedSize() const
-{
-    return m_compressedSize;
-}
-
-uint32_t Reader::FileReference::uncompressedSize() const
-{
-    return m_uncompressedSize;
-}
-
 Reader::Reader(Citymodel& citymodel)
     : m_citymodel(citymodel)
-
+    , m_meshBatch(false, false, false)
+    , m_arrayElements(std::less<const void*>(), ArenaAllocator<std::pair<const void* const, ArrayElements>>(m_arena))
 {
+    m_materialCache.setTextureResidency(&m_textureResidency);
+    m_textureCache.setTextureResidency(&m_textureResidency);
 }
 
 void* Reader::readObject(TileResourceContainer& resourceContainer)
 {
+    // nothing is read past the object data, e.g. after a corrupt geometry node was dropped
+    if (static_cast<size_t>(m_dataBuffer.data() + m_dataBuffer.size() - m_data) < sizeof(uint32_t))
+    {
+        return 0;
+    }
+
     EObjectType type;
     uint32_t    valueAsUInt32 = 0;
     read_uint32(valueAsUInt32);
@@ -87,11 +86,17 @@ void* Reader::readObject(TileResourceContainer& resourceContainer)
     }
     case EType_Index:
     {
-        uint32_t index;
-        read_uint32(index);
+        uint32_t index = std::numeric_limits<uint32_t>::max();
+        if (static_cast<size_t>(m_dataBuffer.data() + m_dataBuffer.size() - m_data) >= sizeof(uint32_t))
+        {
+            read_uint32(index);
+        }
         if (index >= m_object.size())
         {
-            printf("Reader::readObject ERROR - id %d out of range mObject.size: %ld\n", id, m_object.size());
+            // corrupt object data, the remaining objects are not read
+            printf("Reader::readObject ERROR - id %u out of range mObject.size: %ld\n", index, static_cast<long>(m_object.size()));
+            m_data = m_dataBuffer.data() + m_dataBuffer.size();
+            return nullptr;
         }
         return m_object[index];
     }
@@ -115,39 +120,50 @@ void* Reader::readObject(TileResourceContainer& resourceContainer)
         break;
     }
     case EType_GeometryNode:
+    case EType_EncodedGeometryNode:
     {
         id     = createId();
-        retval = readGeometryNode(resourceContainer);
+        retval = readGeometryNode(type, resourceContainer);
         break;
     }
     case EType_VertexArrayResource2f:
     {
         id     = createId();
-        retval = readVector2fArrayResource(resourceContainer);
+        retval = m_batching ? readArrayData(type) : readVector2fArrayResource(resourceContainer);
         break;
     }
     case EType_VertexArrayResource3f:
     {
         id     = createId();
-        retval = readVector3fArrayResource(resourceContainer);
+        retval = m_batching ? readArrayData(type) : readVector3fArrayResource(resourceContainer);
         break;
     }
     case EType_VertexArrayResource4f:
     {
         id     = createId();
-        retval = readVector4fArrayResource(resourceContainer);
+        retval = m_batching ? readArrayData(type) : readVector4fArrayResource(resourceContainer);
+        break;
+    }
+    case EType_QuantizedVertexArrayResource2f:
+    case EType_QuantizedVertexArrayResource3f:
+    case EType_OctahedralNormalArrayResource:
+    {
+        id     = createId();
+        retval = m_batching ? readArrayData(type) : readQuantizedVertexArrayResource(type, resourceContainer);
         break;
     }
     case EType_IndexArrayResource:
+    case EType_ShortIndexArrayResource:
     {
         id     = createId();
-        retval = const_cast<void*>(reinterpret_cast<const void*>(readIndexArrayResource(resourceContainer)));
+        retval = m_batching ? readArrayData(type) : readIndexArrayResource(type, resourceContainer);
         break;
     }
     case EType_Texture2DResource:
+    case EType_Texture2DMipMapResource:
     {
         id     = createId();
-        retval = readTexture2DResource(resourceContainer);
+        retval = readTexture2DResource(resourceContainer, type == EType_Texture2DMipMapResource);
         break;
     }
     case EType_Scene:
@@ -179,76 +195,168 @@ void* Reader::readObject(TileResourceContainer& resourceContainer)
     return retval;
 }
 
-void Reader::open(const std::string& filename)
+bool Reader::open(const std::string& filename, bool verifyChecksums)
 {
     m_object.clear();
-    m_f.close();
-    m_f.open(filename.c_str(), std::fstream::binary | std::fstream::in);
-    if (!m_f.good())
+    m_archive.setVerifyChecksums(verifyChecksums);
+    if (!m_archive.open(filename))
     {
-        printf("CReader::open Could not open file: %s !!!\n", filename.c_str());
-        exit(1);
+        return false;
     }
+    m_geometryCacheKey = ComputeGeometryCacheKey(m_archive);
+    return true;
+}
 
-    uint32_t numberOfObjects = 0;
-    m_f.seekg(-static_cast<int32_t>(sizeof(numberOfObjects)), m_f.end);
-    m_f.read(reinterpret_cast<char*>(&numberOfObjects), sizeof(numberOfObjects));
+void Reader::setTileSource(std::unique_ptr<ITileSource> source)
+{
+    m_archive.setTileSource(std::move(source));
+}
 
-    m_f.seekg(-static_cast<int32_t>(sizeof(FileReference) * numberOfObjects + sizeof(numberOfObjects)), m_f.end);
-    for (uint32_t i = 0; i < numberOfObjects; i++)
-    {
-        uint64_t position;
-        uint32_t compressedSize;
-        uint32_t uncompressedSize;
+void Reader::setReadQueue(uint32_t queueDepth, bool useIoUring)
+{
+    m_archive.setReadQueue(queueDepth, useIoUring);
+}
 
-        m_f.read(reinterpret_cast<char*>(&position), sizeof(position));
-        m_f.read(reinterpret_cast<char*>(&compressedSize), sizeof(compressedSize));
-        m_f.read(reinterpret_cast<char*>(&uncompressedSize), sizeof(uncompressedSize));
+void Reader::setReadCoalescing(uint32_t gapTolerance)
+{
+    m_archive.setReadCoalescing(gapTolerance);
+}
 
-        m_objectReferences.push_back(FileReference(position, compressedSize, uncompressedSize));
-    }
+void Reader::prefetch(const std::vector<uint32_t>& indices)
+{
+    m_archive.prefetch(indices);
 }
 
-void* Reader::read(uint32_t index, TileResourceContainer& resourceContainer, bool resetIds)
+bool Reader::usesIoUring() const
 {
-    uint32_t objectCount = static_cast<uint32_t>(m_object.size());
+    return m_archive.usesIoUring();
+}
 
-    assert(index < m_objectReferences.size());
-    const FileReference& fileRef = m_objectReferences[index];
+uint32_t Reader::getNumberOfPrefetchedReads() const
+{
+    return m_numberOfPrefetchedReads;
+}
+
+uint32_t Reader::getNumberOfDroppedPrefetches() const
+{
+    return m_numberOfDroppedPrefetches;
+}
 
-    char* compressedDataBuffer = new char[fileRef.compressedSize()];
-    // CTime mTimer;
-    m_f.seekg(fileRef.position());
-    m_f.read(compressedDataBuffer, fileRef.compressedSize());
+uint32_t Reader::getNumberOfReadOperations() const
+{
+    return m_numberOfReadOperations;
+}
 
-    m_dataBuffer = new uint8_t[fileRef.uncompressedSize()];
-    m_data       = m_dataBuffer;
+uint64_t Reader::getReadSize() const
+{
+    return m_readSize;
+}
 
-    uint32_t decompressedSize = LZ4_decompress_safe(compressedDataBuffer,
-                                                    reinterpret_cast<char*>(m_dataBuffer),
-                                                    fileRef.compressedSize(),
-                                                    fileRef.uncompressedSize());
-    if (decompressedSize != fileRef.uncompressedSize())
+bool Reader::setGeometryCache(const std::string& directory, uint64_t maximumSize)
+{
+    m_geometryCache.reset(new DiskCache());
+    if (!m_geometryCache->open(directory, maximumSize))
     {
-        printf("CReader::open Failed to read decompress object decompressed size: %d differs from expected size: %d\n",
-               decompressedSize,
-               fileRef.uncompressedSize());
-        exit(1);
+        m_geometryCache.reset();
+        return false;
     }
+    m_geometryCacheStatistics = m_geometryCache->getStatistics();
+    return true;
+}
 
-    delete[] compressedDataBuffer;
+void* Reader::read(uint32_t index, TileResourceContainer& resourceContainer, bool resetIds)
+{
+    Timer    timer;
+    uint32_t objectCount = static_cast<uint32_t>(m_object.size());
+#ifdef RAMSES_CITYMODEL_COUNT_ALLOCATIONS
+    const uint64_t allocations = AllocationCounter::GetNumberOfAllocations();
+#endif
 
-    if (!m_f.good())
+    if (index >= m_archive.getNumberOfObjects() || !m_archive.read(index, m_dataBuffer))
+    {
+        printf("CReader::read Failed to read object %u\n", index);
+        return nullptr;
+    }
+    m_data        = m_dataBuffer.data();
+    m_objectIndex = index;
+
+    // the decoded CTM geometry of the object is taken from the geometry cache, or recorded for storing it there
+    const uint32_t checksum = m_archive.getObjectReference(index).checksum();
+    m_cachedGeometry.clear();
+    m_cachedGeometryPosition = 0;
+    m_recordedGeometry.clear();
+    m_recordGeometry = false;
+    if (m_geometryCache && m_geometryCacheKey != 0)
     {
-        printf("CReader::open Failed to read object\n");
-        exit(1);
+        Timer loadTimer;
+        m_recordGeometry = !m_geometryCache->load(m_geometryCacheKey, index, checksum, m_cachedGeometry);
+        if (!m_recordGeometry)
+        {
+            m_sceneLock.lock();
+            m_cachedDecodeStatistics.m_decodeTime += loadTimer.getTime();
+            m_sceneLock.unlock();
+        }
     }
 
+    // tiles are read with resetIds, the meshes of a tile are merged when batching is enabled
+    m_batching   = m_batchMeshes && resetIds;
     void* object = readObject(resourceContainer);
+    if (m_batching && object && !m_pendingMeshes.empty())
+    {
+        batchMeshes(*static_cast<ramses::Node*>(object), resourceContainer);
+    }
+
+    if (object && m_recordGeometry && !m_recordedGeometry.empty())
+    {
+        m_geometryCache->store(m_geometryCacheKey, index, checksum, m_recordedGeometry);
+    }
+    m_recordGeometry = false;
+
+    // the vertex data of the merged geometry nodes is freed with the decode arena, intersections are computed with the
+    // picking meshes of the batches
+    for (const PendingMesh& pendingMesh : m_pendingMeshes)
+    {
+        GeometryNode* geometryNode       = pendingMesh.geometryNode;
+        geometryNode->m_positionsData    = nullptr;
+        geometryNode->m_normalsData      = nullptr;
+        geometryNode->m_texCoordsData    = nullptr;
+        geometryNode->m_texCoords2Data   = nullptr;
+        geometryNode->m_indexData        = nullptr;
+        geometryNode->m_numberOfVertices = 0;
+        geometryNode->m_numberOfIndices  = 0;
+    }
+    m_batching = false;
+    m_pendingMeshes.clear();
+    m_arrayElements.clear();
+    m_arena.reset();
+
+    m_data = 0;
 
-    delete[] m_dataBuffer;
-    m_dataBuffer = 0;
-    m_data       = 0;
+    if (resetIds)
+    {
+        m_sceneLock.lock();
+        m_numberOfTilesRead++;
+        m_tileReadTime += timer.getTime();
+        m_pickingGeometrySize += m_tilePickingGeometrySize;
+        m_arraySize += m_tileArraySize;
+        m_copiedArraySize += m_tileCopiedArraySize;
+#ifdef RAMSES_CITYMODEL_COUNT_ALLOCATIONS
+        m_numberOfAllocations += AllocationCounter::GetNumberOfAllocations() - allocations;
+#endif
+        m_decodeArenaSize = m_arena.getCapacity();
+        m_numberOfPrefetchedReads   = m_archive.getNumberOfPrefetchedReads();
+        m_numberOfDroppedPrefetches = m_archive.getNumberOfDroppedPrefetches();
+        m_numberOfReadOperations    = m_archive.getNumberOfReadOperations();
+        m_readSize                  = m_archive.getReadSize();
+        if (m_geometryCache)
+        {
+            m_geometryCacheStatistics = m_geometryCache->getStatistics();
+        }
+        m_sceneLock.unlock();
+    }
+    m_tilePickingGeometrySize = 0;
+    m_tileArraySize           = 0;
+    m_tileCopiedArraySize     = 0;
 
     if (resetIds)
     {
@@ -263,6 +371,31 @@ std::mutex& Reader::getSceneLock()
     return m_sceneLock;
 }
 
+const RexArchive& Reader::getArchive() const
+{
+    return m_archive;
+}
+
+const MaterialCache& Reader::getMaterialCache() const
+{
+    return m_materialCache;
+}
+
+const TextureCache& Reader::getTextureCache() const
+{
+    return m_textureCache;
+}
+
+TextureResidency& Reader::getTextureResidency()
+{
+    return m_textureResidency;
+}
+
+void Reader::setTiles(const std::vector<Tile*>& tiles)
+{
+    m_tiles = tiles;
+}
+
 void Reader::read_uint8(uint8_t& value)
 {
     std::memcpy(&value, m_data, sizeof(value));
@@ -382,12 +515,14 @@ void Reader::readNode(ramses::Node* node, TileResourceContainer& resourceContain
 
 ramses::Node* Reader::readMeshNode(TileResourceContainer& resourceContainer)
 {
+    // While batching, the mesh node is read as a node with the transformation and the children of the mesh node,
+    // the mesh itself is merged into a batch by batchMeshes().
     m_sceneLock.lock();
-    ramses::MeshNode* mesh = m_citymodel.getRamsesScene().createMeshNode();
+    ramses::Node* node = m_batching ? m_citymodel.getRamsesScene().createNode() : m_citymodel.getRamsesScene().createMeshNode();
     m_sceneLock.unlock();
-    resourceContainer.addSceneObject(mesh);
+    resourceContainer.addSceneObject(node);
 
-    readNode(mesh, resourceContainer);
+    readNode(node, resourceContainer);
 
     uint32_t startIndex;
     int32_t  indexCount;
@@ -407,54 +542,257 @@ ramses::Node* Reader::readMeshNode(TileResourceContainer& resourceContainer)
 
     GeometryNode* geometryNode = static_cast<GeometryNode*>(readObject(resourceContainer));
 
-    ramses::Appearance& appearance = material->getAppearance();
-    const ramses::Effect& effect = material->getEffect();
+    if (!geometryNode)
+    {
+        // the node is kept with its transformation and children, only the mesh is dropped
+        printf("CReader::readMesh ERROR - Could not read geometry !!!\n");
+    }
+    else if (!m_batching)
+    {
+        setupMeshNode(*static_cast<ramses::MeshNode*>(node), *material, *geometryNode, startIndex, indexCount, renderOrder, resourceContainer);
+    }
+    else if (geometryNode->m_hasVertexData)
+    {
+        PendingMesh pendingMesh = {node, material, geometryNode, startIndex, static_cast<uint32_t>(indexCount), renderOrder};
+        m_pendingMeshes.push_back(pendingMesh);
+    }
+    else if (geometryNode->m_positions && (geometryNode->m_indexArray || geometryNode->m_shortIndexArray))
+    {
+        // geometry read before batching was enabled, e.g. referenced from the scene object, is not merged
+        m_sceneLock.lock();
+        ramses::MeshNode* mesh = m_citymodel.getRamsesScene().createMeshNode();
+        node->addChild(*mesh);
+        m_sceneLock.unlock();
+        resourceContainer.addSceneObject(mesh);
+
+        setupMeshNode(*mesh, *material, *geometryNode, startIndex, indexCount, renderOrder, resourceContainer);
+    }
+    else
+    {
+        printf("CReader::readMesh ERROR - Geometry has no vertex data !!!\n");
+    }
+
+    return node;
+}
+
+void Reader::setupMeshNode(ramses::MeshNode&      mesh,
+                           Material&              material,
+                           GeometryNode&          geometryNode,
+                           uint32_t               startIndex,
+                           uint32_t               indexCount,
+                           uint32_t               renderOrder,
+                           TileResourceContainer& resourceContainer)
+{
+    ramses::Appearance&  appearance = material.getAppearance();
+    const ramses::Effect& effect     = material.getEffect();
+    const EffectInputs&   inputs     = getEffectInputs(effect);
 
     m_sceneLock.lock();
+    Timer timer;
 
-    m_citymodel.getRenderGroup().addMeshNode(*mesh, renderOrder);
-    ramses::GeometryBinding* geometry = m_citymodel.getRamsesScene().createGeometryBinding(effect);
+    m_citymodel.getRenderGroup().addMeshNode(mesh, renderOrder);
 
-    ramses::AttributeInput normalsInput;
-    if (effect.findAttributeInput("a_normal", normalsInput) == ramses::StatusOK)
+    // Mesh nodes referencing the same geometry node with different index ranges share the geometry binding. It is
+    // only shared within the container of the geometry node, which destroys it together with the geometry node.
+    const bool               shareGeometry = resourceContainer.hasGeometryNode(&geometryNode);
+    ramses::GeometryBinding* geometry      = nullptr;
+    if (shareGeometry)
     {
-        geometry->setInputBuffer(normalsInput, *geometryNode->m_normals);
+        auto it = geometryNode.m_geometryBindings.find(&effect);
+        if (it != geometryNode.m_geometryBindings.end())
+        {
+            geometry = it->second;
+        }
     }
 
-    ramses::AttributeInput positionsInput;
-    if (effect.findAttributeInput("a_position", positionsInput) == ramses::StatusOK)
+    const bool createGeometry = (geometry == nullptr);
+    if (createGeometry)
     {
-        geometry->setInputBuffer(positionsInput, *geometryNode->m_positions);
-    }
+        geometry = m_citymodel.getRamsesScene().createGeometryBinding(effect);
 
-    if (nullptr != geometryNode->m_texCoords)
-    {
-        ramses::AttributeInput texCoordsInput;
-        if (effect.findAttributeInput("a_texcoord", texCoordsInput) == ramses::StatusOK)
+        if (inputs.normals.isValid())
+        {
+            geometry->setInputBuffer(inputs.normals, *geometryNode.m_normals);
+        }
+
+        if (inputs.positions.isValid())
+        {
+            geometry->setInputBuffer(inputs.positions, *geometryNode.m_positions);
+        }
+
+        if (nullptr != geometryNode.m_texCoords && inputs.texCoords.isValid())
+        {
+            geometry->setInputBuffer(inputs.texCoords, *geometryNode.m_texCoords);
+        }
+        if (nullptr != geometryNode.m_texCoords2 && inputs.texCoords2.isValid())
+        {
+            geometry->setInputBuffer(inputs.texCoords2, *geometryNode.m_texCoords2);
+        }
+        if (geometryNode.m_shortIndexArray)
+        {
+            geometry->setIndices(*geometryNode.m_shortIndexArray);
+        }
+        else
+        {
+            geometry->setIndices(*geometryNode.m_indexArray);
+        }
+
+        if (shareGeometry)
         {
-            geometry->setInputBuffer(texCoordsInput, *geometryNode->m_texCoords);
+            geometryNode.m_geometryBindings[&effect] = geometry;
         }
+        m_numberOfGeometryBindings++;
+    }
+
+    mesh.setAppearance(appearance);
+    mesh.setGeometryBinding(*geometry);
+    mesh.setStartIndex(startIndex);
+    mesh.setIndexCount(indexCount);
+
+    m_meshCreationTime += timer.getTime();
+    m_numberOfMeshes++;
+    m_sceneLock.unlock();
+
+    if (createGeometry)
+    {
+        resourceContainer.addSceneObject(geometry);
+    }
+}
+
+void Reader::batchMeshes(ramses::Node& root, TileResourceContainer& resourceContainer)
+{
+    // the transformations of the meshes relative to the tile root node are baked into the merged vertices
+    Matrix44* transforms = m_arena.allocateArray<Matrix44>(m_pendingMeshes.size());
+    m_sceneLock.lock();
+    const Matrix44 rootInverse = Name2D::GetObjectSpaceMatrixOfNode(root);
+    for (size_t i = 0; i < m_pendingMeshes.size(); i++)
+    {
+        new (&transforms[i]) Matrix44(rootInverse * Name2D::GetWorldSpaceMatrixOfNode(*m_pendingMeshes[i].node));
+    }
+    m_sceneLock.unlock();
+
+    // meshes with the same material, render order and vertex attributes are merged, the pending meshes are sorted by
+    // these properties, so that the meshes of a batch follow each other
+    typedef std::tuple<Material*, uint32_t, bool, bool, bool> BatchKey;
+    typedef std::pair<BatchKey, uint32_t>                     SortedMesh;
+    const uint32_t numberOfMeshes = static_cast<uint32_t>(m_pendingMeshes.size());
+    SortedMesh*    sortedMeshes   = m_arena.allocateArray<SortedMesh>(numberOfMeshes);
+    for (uint32_t i = 0; i < numberOfMeshes; i++)
+    {
+        const PendingMesh&  pendingMesh  = m_pendingMeshes[i];
+        const GeometryNode& geometryNode = *pendingMesh.geometryNode;
+        const BatchKey      key(pendingMesh.material,
+                                pendingMesh.renderOrder,
+                                geometryNode.m_normalsData != nullptr,
+                                geometryNode.m_texCoordsData != nullptr,
+                                geometryNode.m_texCoords2Data != nullptr);
+        new (&sortedMeshes[i]) SortedMesh(key, i);
     }
-    if (nullptr != geometryNode->m_texCoords2)
+    std::sort(sortedMeshes, sortedMeshes + numberOfMeshes);
+
+    uint32_t batchEnd = 0;
+    for (uint32_t batchStart = 0; batchStart < numberOfMeshes; batchStart = batchEnd)
     {
-        ramses::AttributeInput texCoords2Input;
-        if (effect.findAttributeInput("a_customAttribute", texCoords2Input) == ramses::StatusOK)
+        const BatchKey& key = sortedMeshes[batchStart].first;
+        batchEnd            = batchStart + 1;
+        while (batchEnd < numberOfMeshes && sortedMeshes[batchEnd].first == key)
+        {
+            batchEnd++;
+        }
+
+        m_meshBatch.reset(std::get<2>(key), std::get<3>(key), std::get<4>(key));
+        for (uint32_t k = batchStart; k < batchEnd; k++)
+        {
+            const uint32_t     i           = sortedMeshes[k].second;
+            const PendingMesh& pendingMesh = m_pendingMeshes[i];
+            if (!m_meshBatch.append(*pendingMesh.geometryNode, transforms[i], pendingMesh.startIndex, pendingMesh.indexCount))
+            {
+                printf("CReader::batchMeshes ERROR - Index range exceeds the geometry, mesh skipped !!!\n");
+            }
+        }
+        if (m_meshBatch.m_indices.empty())
         {
-            geometry->setInputBuffer(texCoords2Input, *geometryNode->m_texCoords2);
+            continue;
         }
+
+        const uint32_t indexCount   = static_cast<uint32_t>(m_meshBatch.m_indices.size());
+        GeometryNode*  geometryNode = createGeometryNode(m_meshBatch, resourceContainer);
+
+        m_sceneLock.lock();
+        ramses::MeshNode* mesh = m_citymodel.getRamsesScene().createMeshNode();
+        root.addChild(*mesh);
+        m_sceneLock.unlock();
+        resourceContainer.addSceneObject(mesh);
+
+        setupMeshNode(*mesh, *std::get<0>(key), *geometryNode, 0, indexCount, std::get<1>(key), resourceContainer);
+
+        m_sceneLock.lock();
+        m_numberOfBatchedMeshes += batchEnd - batchStart;
+        m_sceneLock.unlock();
     }
-    geometry->setIndices(*geometryNode->m_indexArray);
+}
+
+GeometryNode* Reader::createGeometryNode(MeshBatch& meshBatch, TileResourceContainer& resourceContainer)
+{
+    GeometryNode* geometryNode = new GeometryNode();
+    resourceContainer.addGeometryNode(geometryNode);
 
-    mesh->setAppearance(appearance);
-    mesh->setGeometryBinding(*geometry);
-    mesh->setStartIndex(startIndex);
-    mesh->setIndexCount(indexCount);
+    const uint32_t        numberVertices = meshBatch.getNumberOfVertices();
+    ramses::RamsesClient& client         = m_citymodel.getRamsesClient();
 
+    m_sceneLock.lock();
+    geometryNode->m_positions = client.createConstVector3fArray(numberVertices, reinterpret_cast<const float*>(meshBatch.m_positions.data()));
+    if (!meshBatch.m_normals.empty())
+    {
+        geometryNode->m_normals = client.createConstVector3fArray(numberVertices, reinterpret_cast<const float*>(meshBatch.m_normals.data()));
+    }
+    if (!meshBatch.m_texCoords.empty())
+    {
+        geometryNode->m_texCoords = client.createConstVector2fArray(numberVertices, meshBatch.m_texCoords.data());
+    }
+    if (!meshBatch.m_texCoords2.empty())
+    {
+        geometryNode->m_texCoords2 = client.createConstVector4fArray(numberVertices, meshBatch.m_texCoords2.data());
+    }
     m_sceneLock.unlock();
 
-    resourceContainer.addSceneObject(geometry);
+    SetIndexArray(*geometryNode,
+                  createIndexArray(meshBatch.m_indices.data(),
+                                   static_cast<uint32_t>(meshBatch.m_indices.size()),
+                                   numberVertices <= RexIndexArray::MaxShortIndexVertices,
+                                   resourceContainer));
+
+    resourceContainer.addResource(geometryNode->m_positions);
+    if (geometryNode->m_normals)
+    {
+        resourceContainer.addResource(geometryNode->m_normals);
+    }
+    if (geometryNode->m_texCoords)
+    {
+        resourceContainer.addResource(geometryNode->m_texCoords);
+    }
+    if (geometryNode->m_texCoords2)
+    {
+        resourceContainer.addResource(geometryNode->m_texCoords2);
+    }
+
+    setPickingMesh(*geometryNode,
+                   reinterpret_cast<const float*>(meshBatch.m_positions.data()),
+                   numberVertices,
+                   meshBatch.m_indices.data(),
+                   static_cast<uint32_t>(meshBatch.m_indices.size()));
 
-    return mesh;
+    return geometryNode;
+}
+
+void Reader::setPickingMesh(GeometryNode&   geometryNode,
+                            const float*    positions,
+                            uint32_t        numberOfVertices,
+                            const uint32_t* indices,
+                            uint32_t        numberOfIndices)
+{
+    geometryNode.m_pickingMesh.set(m_pickingGeometry, positions, numberOfVertices, indices, numberOfIndices);
+    m_tilePickingGeometrySize += geometryNode.m_pickingMesh.getMemorySize();
 }
 
 CTMuint Reader::CTMRead(void* buffer, CTMuint count, void* userData)
@@ -470,57 +808,111 @@ CTMuint Reader::ctmRead(void* buffer, CTMuint count)
     return count;
 }
 
-GeometryNode* Reader::readGeometryNode(TileResourceContainer& resourceContainer)
+GeometryNode* Reader::readGeometryNode(EObjectType type, TileResourceContainer& resourceContainer)
 {
     uint32_t effectNumber;
     read_uint32(effectNumber);
 
-    uint8_t useCTM;
-    read_uint8(useCTM);
-
     ramses::Effect* effect       = getEffect(effectNumber);
     GeometryNode*   geometryNode = new GeometryNode();
     resourceContainer.addGeometryNode(geometryNode);
 
+    if (type == EType_EncodedGeometryNode)
+    {
+        if (!readEncodedGeometry(*geometryNode, resourceContainer))
+        {
+            return nullptr;
+        }
+        geometryNode->m_effect = effect;
+        return geometryNode;
+    }
+
+    uint8_t useCTM;
+    read_uint8(useCTM);
+
     const ramses::Vector3fArray* positions  = 0;
     const ramses::Vector3fArray* normals    = 0;
     const ramses::Vector2fArray* texCoords  = 0;
     const ramses::Vector4fArray* texCoords2 = 0;
-    const ramses::UInt32Array*   indexArray = 0;
+    const ramses::Resource*      indexArray = 0;
 
     if (useCTM)
     {
-        CTMimporter ctm;
-        ctm.LoadCustom(CTMRead, this);
+        // the importer keeps the decoded arrays, until the resources are created
+        Timer           decodeTimer;
+        CTMimporter     ctm;
+        DecodedGeometry geometry;
+        const bool      cached = readCachedGeometry(geometry);
+        if (!cached)
+        {
+            const uint8_t* ctmData = m_data;
+            ctm.LoadCustom(CTMRead, this);
+
+            geometry.numberOfVertices = ctm.GetInteger(CTM_VERTEX_COUNT);
+            geometry.numberOfIndices  = ctm.GetInteger(CTM_TRIANGLE_COUNT) * 3;
+            geometry.positions        = ctm.GetFloatArray(CTM_VERTICES);
+            geometry.texCoords        = ctm.GetFloatArray(CTM_UV_MAP_1);
+            geometry.indices          = ctm.GetIntegerArray(CTM_INDICES);
+            if (m_recordGeometry)
+            {
+                recordGeometry(geometry, static_cast<uint32_t>(m_data - ctmData));
+            }
+        }
 
-        const uint32_t numberVertices = ctm.GetInteger(CTM_VERTEX_COUNT);
-        const uint32_t numberIndices  = ctm.GetInteger(CTM_TRIANGLE_COUNT) * 3;
+        const uint32_t numberVertices = geometry.numberOfVertices;
+        const uint32_t numberIndices  = geometry.numberOfIndices;
 
-        const CTMfloat* positionsData = ctm.GetFloatArray(CTM_VERTICES);
-        geometryNode->m_positionsData.resize(numberVertices);
-        std::memcpy(geometryNode->m_positionsData.data(), positionsData, sizeof(CTMfloat) * numberVertices * 3);
+        m_sceneLock.lock();
+        GeometryDecodeStatistics& decodeStatistics = cached ? m_cachedDecodeStatistics : m_ctmDecodeStatistics;
+        decodeStatistics.m_numberOfGeometryNodes++;
+        decodeStatistics.m_numberOfVertices += numberVertices;
+        decodeStatistics.m_decodeTime += decodeTimer.getTime();
+        m_sceneLock.unlock();
 
-        const CTMuint* indexData = ctm.GetIntegerArray(CTM_INDICES);
-        geometryNode->m_indexData.resize(numberIndices);
-        std::memcpy(geometryNode->m_indexData.data(), indexData, sizeof(CTMuint) * numberIndices);
+        const float*    positionsData = geometry.positions;
+        const uint32_t* indexData     = geometry.indices;
 
-        /// Releasing lock between this heavy-weight operations, so that the main thread can continue in between.
+        if (m_batching)
+        {
+            // the resources and the picking mesh are created for the merged meshes by batchMeshes()
+            // copied into the decode arena, the data of the importer is freed with it
+            float* positionsCopy = m_arena.allocateArray<float>(static_cast<size_t>(numberVertices) * 3);
+            std::memcpy(positionsCopy, positionsData, sizeof(CTMfloat) * numberVertices * 3);
+            uint32_t* indexCopy = m_arena.allocateArray<uint32_t>(numberIndices);
+            std::memcpy(indexCopy, indexData, sizeof(CTMuint) * numberIndices);
+
+            if (geometry.texCoords)
+            {
+                float* texCoordsCopy = m_arena.allocateArray<float>(numberVertices * 2);
+                std::memcpy(texCoordsCopy, geometry.texCoords, sizeof(CTMfloat) * numberVertices * 2);
+                geometryNode->m_texCoordsData = texCoordsCopy;
+            }
+            geometryNode->m_positionsData    = reinterpret_cast<const Vector3*>(positionsCopy);
+            geometryNode->m_indexData        = indexCopy;
+            geometryNode->m_numberOfVertices = numberVertices;
+            geometryNode->m_numberOfIndices  = numberIndices;
+            geometryNode->m_hasVertexData    = true;
+        }
+        else
+        {
+            /// Releasing lock between this heavy-weight operations, so that the main thread can continue in between.
 
-        m_sceneLock.lock();
-        positions = m_citymodel.getRamsesClient().createConstVector3fArray(numberVertices, positionsData);
-        m_sceneLock.unlock();
+            m_sceneLock.lock();
+            positions = m_citymodel.getRamsesClient().createConstVector3fArray(numberVertices, positionsData);
+            m_sceneLock.unlock();
 
-        m_sceneLock.lock();
-        texCoords = m_citymodel.getRamsesClient().createConstVector2fArray(numberVertices, ctm.GetFloatArray(CTM_UV_MAP_1));
-        m_sceneLock.unlock();
+            m_sceneLock.lock();
+            texCoords = m_citymodel.getRamsesClient().createConstVector2fArray(numberVertices, geometry.texCoords);
+            m_sceneLock.unlock();
 
-        m_sceneLock.lock();
-        indexArray = m_citymodel.getRamsesClient().createConstUInt32Array(numberIndices, indexData);
-        m_sceneLock.unlock();
+            indexArray = createIndexArray(
+                indexData, numberIndices, numberVertices <= RexIndexArray::MaxShortIndexVertices, resourceContainer);
 
-        resourceContainer.addResource(positions);
-        resourceContainer.addResource(texCoords);
-        resourceContainer.addResource(indexArray);
+            resourceContainer.addResource(positions);
+            resourceContainer.addResource(texCoords);
+
+            setPickingMesh(*geometryNode, positionsData, numberVertices, indexData, numberIndices);
+        }
     }
     else
     {
@@ -530,33 +922,56 @@ GeometryNode* Reader::readGeometryNode(TileResourceContainer& resourceContainer)
         void* texCoords2Object = readObject(resourceContainer);
         void* indexArrayObject = readObject(resourceContainer);
 
-        if (0 != positionsObject)
+        if (m_batching)
         {
-            positions = static_cast<ramses::Vector3fArray*>(positionsObject);
+            setVertexData(*geometryNode,
+                          findArrayElements(positionsObject),
+                          findArrayElements(normalsObject),
+                          findArrayElements(texCoordsObject),
+                          findArrayElements(texCoords2Object),
+                          findArrayElements(indexArrayObject));
         }
-
-        if (0 != normalsObject)
+        else
         {
-            normals = static_cast<ramses::Vector3fArray*>(normalsObject);
-        }
+            if (0 != positionsObject)
+            {
+                positions = static_cast<ramses::Vector3fArray*>(positionsObject);
+            }
 
-        if (0 != texCoordsObject)
-        {
-            texCoords = static_cast<ramses::Vector2fArray*>(texCoordsObject);
-        }
+            if (0 != normalsObject)
+            {
+                normals = static_cast<ramses::Vector3fArray*>(normalsObject);
+            }
 
-        if (0 != texCoords2Object)
-        {
-            texCoords2 = static_cast<ramses::Vector4fArray*>(texCoords2Object);
-        }
+            if (0 != texCoordsObject)
+            {
+                texCoords = static_cast<ramses::Vector2fArray*>(texCoordsObject);
+            }
 
-        if (0 != indexArrayObject)
-        {
-            indexArray = static_cast<ramses::UInt32Array*>(indexArrayObject);
+            if (0 != texCoords2Object)
+            {
+                texCoords2 = static_cast<ramses::Vector4fArray*>(texCoords2Object);
+            }
+
+            if (0 != indexArrayObject)
+            {
+                indexArray = static_cast<ramses::Resource*>(indexArrayObject);
+            }
+
+            const ArrayElements* positionsData = findArrayElements(positionsObject);
+            const ArrayElements* indexData     = findArrayElements(indexArrayObject);
+            if (positionsData && indexData)
+            {
+                setPickingMesh(*geometryNode,
+                               static_cast<const float*>(positionsData->m_data),
+                               positionsData->m_numberOfValues / 3,
+                               static_cast<const uint32_t*>(indexData->m_data),
+                               indexData->m_numberOfValues);
+            }
         }
     }
 
-    geometryNode->m_indexArray = indexArray;
+    SetIndexArray(*geometryNode, indexArray);
     geometryNode->m_positions  = positions;
     geometryNode->m_normals    = normals;
     geometryNode->m_texCoords  = texCoords;
@@ -566,23 +981,386 @@ GeometryNode* Reader::readGeometryNode(TileResourceContainer& resourceContainer)
     return geometryNode;
 }
 
-Material* Reader::readMaterial(TileResourceContainer& resourceContainer)
+uint32_t Reader::ComputeGeometryCacheKey(const RexArchive& archive)
 {
-    Vector4 diffuseColor;
-    read(diffuseColor);
+    if (!archive.hasChecksums())
+    {
+        return 0;
+    }
 
-    uint32_t effectNumber;
-    read_uint32(effectNumber);
+    std::vector<uint32_t> table;
+    table.reserve(archive.getNumberOfObjects() * 4);
+    for (uint32_t i = 0; i < archive.getNumberOfObjects(); i++)
+    {
+        const RexArchive::FileReference& fileRef = archive.getObjectReference(i);
+        table.push_back(static_cast<uint32_t>(fileRef.position()));
+        table.push_back(static_cast<uint32_t>(fileRef.position() >> 32));
+        table.push_back(fileRef.uncompressedSize());
+        table.push_back(fileRef.checksum());
+    }
+    const uint32_t key = XXHash32::Compute(table.data(), table.size() * sizeof(uint32_t), archive.getFormatVersion());
 
-    ramses::Texture2D*      texture = static_cast<ramses::Texture2D*>(readObject(resourceContainer));
-    ramses::TextureSampler* sampler(0);
-    ramses::Effect*         effect = getEffect(effectNumber);
+    // 0 marks files, which can not be cached
+    return key != 0 ? key : 1;
+}
 
-    m_sceneLock.lock();
-    ramses::Appearance* appearance = m_citymodel.getRamsesScene().createAppearance(*effect);
-    appearance->setColorWriteMask(true, true, true, false);
+bool Reader::readCachedGeometry(DecodedGeometry& geometry)
+{
+    const size_t headerSize = 4 * sizeof(uint32_t);
+    if (m_cachedGeometryPosition + headerSize > m_cachedGeometry.size())
+    {
+        return false;
+    }
+
+    const uint8_t* data = m_cachedGeometry.data() + m_cachedGeometryPosition;
+    uint32_t       header[4];
+    std::memcpy(header, data, headerSize);
+    const uint32_t ctmSize        = header[0];
+    const uint32_t hasTexCoords   = header[3];
+    const uint64_t numberOfFloats = static_cast<uint64_t>(header[1]) * (hasTexCoords ? 5 : 3);
+    const uint64_t size           = headerSize + (numberOfFloats + header[2]) * sizeof(uint32_t);
+    const size_t   remainingData  = m_dataBuffer.size() - static_cast<size_t>(m_data - m_dataBuffer.data());
+    if (m_cachedGeometryPosition + size > m_cachedGeometry.size() || ctmSize > remainingData)
+    {
+        // the entry does not fit the object, the remaining geometry of the object is decoded
+        printf("CReader::readCachedGeometry Invalid cache entry, decoding the geometry\n");
+        m_cachedGeometry.clear();
+        return false;
+    }
+
+    // the entries are 4 byte aligned, as the data of the cache is
+    const float* floats       = reinterpret_cast<const float*>(data + headerSize);
+    geometry.numberOfVertices = header[1];
+    geometry.numberOfIndices  = header[2];
+    geometry.positions        = floats;
+    geometry.texCoords        = hasTexCoords ? floats + 3 * geometry.numberOfVertices : nullptr;
+    geometry.indices          = reinterpret_cast<const uint32_t*>(floats + numberOfFloats);
+
+    m_cachedGeometryPosition += static_cast<size_t>(size);
+    m_data += ctmSize;
+    return true;
+}
+
+void Reader::recordGeometry(const DecodedGeometry& geometry, uint32_t ctmSize)
+{
+    const uint32_t header[4]     = {ctmSize, geometry.numberOfVertices, geometry.numberOfIndices, geometry.texCoords ? 1u : 0u};
+    const size_t   positionsSize = sizeof(float) * geometry.numberOfVertices * 3;
+    const size_t   texCoordsSize = geometry.texCoords ? sizeof(float) * geometry.numberOfVertices * 2 : 0;
+    const size_t   indicesSize   = sizeof(uint32_t) * geometry.numberOfIndices;
+
+    const size_t position = m_recordedGeometry.size();
+    m_recordedGeometry.resize(position + sizeof(header) + positionsSize + texCoordsSize + indicesSize);
+    uint8_t* data = m_recordedGeometry.data() + position;
+    std::memcpy(data, header, sizeof(header));
+    data += sizeof(header);
+    std::memcpy(data, geometry.positions, positionsSize);
+    data += positionsSize;
+    if (texCoordsSize > 0)
+    {
+        std::memcpy(data, geometry.texCoords, texCoordsSize);
+        data += texCoordsSize;
+    }
+    std::memcpy(data, geometry.indices, indicesSize);
+}
+
+bool Reader::readEncodedGeometry(GeometryNode& geometryNode, TileResourceContainer& resourceContainer)
+{
+    uint8_t*     dataEnd    = m_dataBuffer.data() + m_dataBuffer.size();
+    const size_t headerSize = 3 * sizeof(uint32_t) + sizeof(uint8_t);
+    if (static_cast<size_t>(dataEnd - m_data) < headerSize)
+    {
+        printf("CReader::readEncodedGeometry ERROR - Unexpected end of object data !!!\n");
+        m_data = dataEnd;
+        return false;
+    }
+
+    Timer    decodeTimer;
+    uint32_t numberVertices;
+    uint32_t numberIndices;
+    uint8_t  attributes;
+    uint32_t indexSize;
+    read_uint32(numberVertices);
+    read_uint32(numberIndices);
+    read_uint8(attributes);
+    read_uint32(indexSize);
+
+    // checked before allocating, every index is encoded into at least one byte
+    const uint32_t components = 3 + ((attributes & MeshCodec::HasNormals) ? 3 : 0) + ((attributes & MeshCodec::HasTexCoords) ? 2 : 0);
+    if (numberIndices > indexSize || static_cast<uint64_t>(indexSize) + MeshCodec::GetEncodedVertexSize(numberVertices, components) >
+                                         static_cast<uint64_t>(dataEnd - m_data))
+    {
+        printf("CReader::readEncodedGeometry ERROR - Invalid sizes, %u vertices and %u indices in %u bytes !!!\n",
+               numberVertices,
+               numberIndices,
+               indexSize);
+        m_data = dataEnd;
+        return false;
+    }
+
+    // decoded into the decode arena, from where the resources are created or the meshes are merged
+    uint32_t* indexData = m_arena.allocateArray<uint32_t>(numberIndices);
+    if (!MeshCodec::DecodeIndices(m_data, indexSize, numberIndices, numberVertices, indexData))
+    {
+        // the sizes fit, so the geometry is skipped and the remaining objects are still read
+        printf("CReader::readEncodedGeometry ERROR - Invalid index data !!!\n");
+        m_data += indexSize + MeshCodec::GetEncodedVertexSize(numberVertices, components);
+        return false;
+    }
+    m_data += indexSize;
+
+    Vector3* positionsData = m_arena.allocateArray<Vector3>(numberVertices);
+    MeshCodec::DecodeVertices(m_data, numberVertices, 3, reinterpret_cast<float*>(positionsData));
+    m_data += MeshCodec::GetEncodedVertexSize(numberVertices, 3);
+
+    Vector3* normalsData = nullptr;
+    if (attributes & MeshCodec::HasNormals)
+    {
+        normalsData = m_arena.allocateArray<Vector3>(numberVertices);
+        MeshCodec::DecodeVertices(m_data, numberVertices, 3, reinterpret_cast<float*>(normalsData));
+        m_data += MeshCodec::GetEncodedVertexSize(numberVertices, 3);
+    }
+
+    float* texCoordsData = nullptr;
+    if (attributes & MeshCodec::HasTexCoords)
+    {
+        texCoordsData = m_arena.allocateArray<float>(static_cast<size_t>(numberVertices) * 2);
+        MeshCodec::DecodeVertices(m_data, numberVertices, 2, texCoordsData);
+        m_data += MeshCodec::GetEncodedVertexSize(numberVertices, 2);
+    }
+
+    m_sceneLock.lock();
+    m_encodedDecodeStatistics.m_numberOfGeometryNodes++;
+    m_encodedDecodeStatistics.m_numberOfVertices += numberVertices;
+    m_encodedDecodeStatistics.m_decodeTime += decodeTimer.getTime();
+    m_sceneLock.unlock();
+
+    if (m_batching)
+    {
+        // the resources and the picking mesh are created for the merged meshes by batchMeshes()
+        geometryNode.m_positionsData    = positionsData;
+        geometryNode.m_normalsData      = normalsData;
+        geometryNode.m_texCoordsData    = texCoordsData;
+        geometryNode.m_indexData        = indexData;
+        geometryNode.m_numberOfVertices = numberVertices;
+        geometryNode.m_numberOfIndices  = numberIndices;
+        geometryNode.m_hasVertexData    = true;
+        return true;
+    }
+
+    const ramses::Vector3fArray* positions = nullptr;
+    const ramses::Vector3fArray* normals   = nullptr;
+    const ramses::Vector2fArray* texCoords = nullptr;
+
+    m_sceneLock.lock();
+    positions = m_citymodel.getRamsesClient().createConstVector3fArray(numberVertices, reinterpret_cast<const float*>(positionsData));
+    if (normalsData)
+    {
+        normals = m_citymodel.getRamsesClient().createConstVector3fArray(numberVertices, reinterpret_cast<const float*>(normalsData));
+    }
+    if (texCoordsData)
+    {
+        texCoords = m_citymodel.getRamsesClient().createConstVector2fArray(numberVertices, texCoordsData);
+    }
+    m_sceneLock.unlock();
+
+    resourceContainer.addResource(positions);
+    if (normals)
+    {
+        resourceContainer.addResource(normals);
+    }
+    if (texCoords)
+    {
+        resourceContainer.addResource(texCoords);
+    }
+
+    const ramses::Resource* indexArray =
+        createIndexArray(indexData, numberIndices, numberVertices <= RexIndexArray::MaxShortIndexVertices, resourceContainer);
+    setPickingMesh(geometryNode, reinterpret_cast<const float*>(positionsData), numberVertices, indexData, numberIndices);
+
+    SetIndexArray(geometryNode, indexArray);
+    geometryNode.m_positions = positions;
+    geometryNode.m_normals   = normals;
+    geometryNode.m_texCoords = texCoords;
+    return true;
+}
+
+void Reader::setVertexData(GeometryNode&        geometryNode,
+                           const ArrayElements* positions,
+                           const ArrayElements* normals,
+                           const ArrayElements* texCoords,
+                           const ArrayElements* texCoords2,
+                           const ArrayElements* indices)
+{
+    if (!positions || !indices)
+    {
+        printf("CReader::readGeometryNode ERROR - Geometry without positions or indices can not be batched !!!\n");
+        return;
+    }
+
+    // positions and normals are copied into the decode arena as vectors, the other elements are used in place
+    const uint32_t numberVertices = positions->m_numberOfValues / 3;
+    float*         positionsCopy  = m_arena.allocateArray<float>(static_cast<size_t>(numberVertices) * 3);
+    std::memcpy(positionsCopy, positions->m_data, sizeof(float) * numberVertices * 3);
+    geometryNode.m_positionsData = reinterpret_cast<const Vector3*>(positionsCopy);
+    m_tileCopiedArraySize += sizeof(float) * numberVertices * 3;
+
+    if (normals && normals->m_numberOfValues == numberVertices * 3)
+    {
+        float* normalsCopy = m_arena.allocateArray<float>(static_cast<size_t>(numberVertices) * 3);
+        std::memcpy(normalsCopy, normals->m_data, sizeof(float) * numberVertices * 3);
+        geometryNode.m_normalsData = reinterpret_cast<const Vector3*>(normalsCopy);
+        m_tileCopiedArraySize += sizeof(float) * numberVertices * 3;
+    }
+    if (texCoords && texCoords->m_numberOfValues == numberVertices * 2)
+    {
+        geometryNode.m_texCoordsData = static_cast<const float*>(texCoords->m_data);
+    }
+    if (texCoords2 && texCoords2->m_numberOfValues == numberVertices * 4)
+    {
+        geometryNode.m_texCoords2Data = static_cast<const float*>(texCoords2->m_data);
+    }
+    geometryNode.m_indexData        = static_cast<const uint32_t*>(indices->m_data);
+    geometryNode.m_numberOfVertices = numberVertices;
+    geometryNode.m_numberOfIndices  = indices->m_numberOfValues;
+    geometryNode.m_hasVertexData    = true;
+}
+
+void* Reader::readArrayData(EObjectType type)
+{
+    uint32_t n;
+    read_uint32(n);
+
+    ArrayElements* elements = m_arena.allocateArray<ArrayElements>(1);
+    if (type == EType_QuantizedVertexArrayResource2f || type == EType_QuantizedVertexArrayResource3f ||
+        type == EType_OctahedralNormalArrayResource)
+    {
+        elements->m_data           = readQuantizedArrayElements(type, n);
+        elements->m_numberOfValues = (type == EType_QuantizedVertexArrayResource2f ? 2 : 3) * n;
+        m_arrayElements[elements]  = *elements;
+        return elements;
+    }
+
+    if (type == EType_ShortIndexArrayResource)
+    {
+        elements->m_data           = readShortIndexElements(n);
+        elements->m_numberOfValues = n;
+        m_arrayElements[elements]  = *elements;
+        return elements;
+    }
+
+    const uint32_t components = type == EType_IndexArrayResource
+                                    ? 1
+                                    : (type == EType_VertexArrayResource2f ? 2 : (type == EType_VertexArrayResource3f ? 3 : 4));
+
+    // the elements stay in place, the arena allocated object identifies the array for later references, floats and
+    // indices have the same size
+    elements->m_data           = readArrayElements(sizeof(uint32_t) * components * n);
+    elements->m_numberOfValues = components * n;
+    m_arrayElements[elements]  = *elements;
+    return elements;
+}
+
+const ArrayElements* Reader::findArrayElements(const void* object) const
+{
+    auto it = m_arrayElements.find(object);
+    return it != m_arrayElements.end() ? &it->second : nullptr;
+}
+
+const uint8_t* Reader::readArrayElements(uint32_t size)
+{
+    if (m_archive.hasAlignedArrays())
+    {
+        const size_t offset = static_cast<size_t>(m_data - m_dataBuffer.data()) % RexArchive::ArrayAlignment;
+        if (offset != 0)
+        {
+            m_data += RexArchive::ArrayAlignment - offset;
+        }
+    }
+    m_tileArraySize += size;
+
+    if (reinterpret_cast<uintptr_t>(m_data) % RexArchive::ArrayAlignment == 0)
+    {
+        return read(size);
+    }
+
+    uint8_t* copy = static_cast<uint8_t*>(m_arena.allocate(size, RexArchive::ArrayAlignment));
+    read(copy, size);
+    m_tileCopiedArraySize += size;
+    return copy;
+}
+
+const float* Reader::readQuantizedArrayElements(EObjectType type, uint32_t n)
+{
+    const uint32_t components = type == EType_QuantizedVertexArrayResource2f ? 2 : 3;
+    float          offset[VertexQuantization::MaxComponents];
+    float          scale[VertexQuantization::MaxComponents];
+    if (type != EType_OctahedralNormalArrayResource)
+    {
+        for (uint32_t k = 0; k < components; k++)
+        {
+            read_float(offset[k]);
+        }
+        for (uint32_t k = 0; k < components; k++)
+        {
+            read_float(scale[k]);
+        }
+    }
+
+    float* values = m_arena.allocateArray<float>(static_cast<size_t>(components) * n);
+    if (type == EType_OctahedralNormalArrayResource)
+    {
+        const uint8_t* data = readArrayElements(sizeof(int16_t) * 2 * n);
+        VertexQuantization::DecodeNormals(reinterpret_cast<const int16_t*>(data), n, values);
+    }
+    else
+    {
+        const uint8_t* data = readArrayElements(sizeof(uint16_t) * components * n);
+        VertexQuantization::Dequantize(reinterpret_cast<const uint16_t*>(data), n, components, offset, scale, values);
+    }
+    return values;
+}
+
+Material* Reader::readMaterial(TileResourceContainer& resourceContainer)
+{
+    Vector4 diffuseColor;
+    read(diffuseColor);
+
+    uint32_t effectNumber;
+    read_uint32(effectNumber);
+
+    ramses::Texture2D* texture = static_cast<ramses::Texture2D*>(readObject(resourceContainer));
+    ramses::Effect*    effect  = getEffect(effectNumber);
+
+    MaterialCache::Key key;
+    key.effect   = effect;
+    key.texture  = texture;
+    key.blending = effectNumber == 6 || effectNumber == 5 || effectNumber == 2 || effectNumber == 3;
+    // the color is only used by untextured materials, so textured materials are shared regardless of it
+    key.color = texture ? Vector4() : diffuseColor;
+
+    m_sceneLock.lock();
+    Material* material = m_materialCache.acquire(key);
+    if (!material)
+    {
+        material = createMaterial(*effect, texture, key);
+        m_materialCache.add(key, material);
+    }
+    m_sceneLock.unlock();
+
+    resourceContainer.addCachedMaterial(material, m_materialCache);
+
+    return material;
+}
+
+Material* Reader::createMaterial(ramses::Effect& effect, ramses::Texture2D* texture, const MaterialCache::Key& key)
+{
+    const EffectInputs&     inputs = getEffectInputs(effect);
+    ramses::TextureSampler* sampler(0);
+
+    ramses::Appearance* appearance = m_citymodel.getRamsesScene().createAppearance(effect);
+    appearance->setColorWriteMask(true, true, true, false);
 
-    if (effectNumber == 6 || effectNumber == 5 || effectNumber == 2 || effectNumber == 3)
+    if (key.blending)
     {
         appearance->setBlendingFactors(ramses::EBlendFactor_SrcAlpha,
                                        ramses::EBlendFactor_OneMinusSrcAlpha,
@@ -590,69 +1368,49 @@ Material* Reader::readMaterial(TileResourceContainer& resourceContainer)
                                        ramses::EBlendFactor_One);
         appearance->setBlendingOperations(ramses::EBlendOperation_Add, ramses::EBlendOperation_Add);
     }
-    m_sceneLock.unlock();
-
-    resourceContainer.addSceneObject(appearance);
 
     if (texture)
     {
-        ramses::UniformInput input;
-        m_sceneLock.lock();
         sampler = m_citymodel.getRamsesScene().createTextureSampler(ramses::ETextureAddressMode_Repeat,
                                                                     ramses::ETextureAddressMode_Repeat,
                                                                     ramses::ETextureSamplingMethod_Linear_MipMapNearest,
                                                                     ramses::ETextureSamplingMethod_Linear,
                                                                     *texture);
 
-        const ramses::status_t stat = effect->findUniformInput("u_texture", input);
-        if (stat == ramses::StatusOK)
+        if (inputs.texture.isValid())
         {
-            appearance->setInputTexture(input, *sampler);
+            appearance->setInputTexture(inputs.texture, *sampler);
         }
-        m_sceneLock.unlock();
-
-        resourceContainer.addSceneObject(sampler);
     }
-    else
+    else if (inputs.color.isValid())
     {
-        ramses::UniformInput   input;
-        m_sceneLock.lock();
-        const ramses::status_t stat = effect->findUniformInput("u_color", input);
-        if (stat == ramses::StatusOK)
-        {
-            appearance->setInputValueVector4f(input, diffuseColor.getX(), diffuseColor.getY(), diffuseColor.getZ(), diffuseColor.getW());
-        }
-        m_sceneLock.unlock();
+        appearance->setInputValueVector4f(inputs.color, key.color.getX(), key.color.getY(), key.color.getZ(), key.color.getW());
     }
 
-    ramses::UniformInput m_carPosInput;
-    ramses::UniformInput m_lightConeScaleInput;
-
-    m_sceneLock.lock();
-    effect->findUniformInput("u_carPos", m_carPosInput);
-    effect->findUniformInput("u_lightConeScale", m_lightConeScaleInput);
-
-    if (m_carPosInput.isValid())
+    if (inputs.carPos.isValid())
     {
-        appearance->bindInput(m_carPosInput, m_scene->getDataVectorOfCarPosition());
+        appearance->bindInput(inputs.carPos, m_scene->getDataVectorOfCarPosition());
     }
 
-    if (m_lightConeScaleInput.isValid())
+    if (inputs.lightConeScale.isValid())
     {
-        appearance->bindInput(m_lightConeScaleInput, m_scene->getDataOfLightConeScale());
+        appearance->bindInput(inputs.lightConeScale, m_scene->getDataOfLightConeScale());
     }
-    m_sceneLock.unlock();
-
-    Material* material = new Material(*appearance, *effect, texture, sampler);
-    resourceContainer.addMaterial(material);
 
+    Material* material = new Material(*appearance, effect, texture, sampler);
+    if (texture && inputs.texture.isValid())
+    {
+        m_textureResidency.addMaterial(*material, inputs.texture);
+    }
     return material;
 }
 
 CitymodelScene* Reader::readScene(TileResourceContainer& resourceContainer)
 {
+    m_sceneLock.lock();
     CitymodelScene* scene = new CitymodelScene(m_citymodel.getRamsesScene());
-    m_scene               = scene;
+    m_sceneLock.unlock();
+    m_scene = scene;
     {
         uint32_t n;
         read_uint32(n);
@@ -699,6 +1457,10 @@ Tile* Reader::readTile()
 {
     BoundingBox bbox;
     read(bbox);
+    if (m_tileIndex < m_tiles.size())
+    {
+        return m_tiles[m_tileIndex++];
+    }
     Tile* tile = new Tile(bbox, m_citymodel, m_tileIndex++);
     return tile;
 }
@@ -721,16 +1483,13 @@ void* Reader::readVector2fArrayResource(TileResourceContainer& resourceContainer
     uint32_t n;
     read_uint32(n);
 
-    uint32_t size = sizeof(float) * 2 * n;
-    uint8_t* data = new uint8_t[size];
-    read(data, size);
+    const uint8_t* data = readArrayElements(sizeof(float) * 2 * n);
 
-	m_sceneLock.lock();
+    m_sceneLock.lock();
     const ramses::Resource* returnValue =
-        m_citymodel.getRamsesClient().createConstVector2fArray(n, reinterpret_cast<float*>(data));
+        m_citymodel.getRamsesClient().createConstVector2fArray(n, reinterpret_cast<const float*>(data));
     m_sceneLock.unlock();
 
-    delete[] data;
     resourceContainer.addResource(returnValue);
 
     return const_cast<ramses::Resource*>(returnValue);
@@ -741,16 +1500,50 @@ void* Reader::readVector3fArrayResource(TileResourceContainer& resourceContainer
     uint32_t n;
     read_uint32(n);
 
-    uint32_t size = sizeof(float) * 3 * n;
-    uint8_t* data = new uint8_t[size];
-    read(data, size);
+    const uint8_t* data = readArrayElements(sizeof(float) * 3 * n);
 
     m_sceneLock.lock();
     const ramses::Resource* returnValue =
-        m_citymodel.getRamsesClient().createConstVector3fArray(n, reinterpret_cast<float*>(data));
+        m_citymodel.getRamsesClient().createConstVector3fArray(n, reinterpret_cast<const float*>(data));
     m_sceneLock.unlock();
 
-    delete[] data;
+    if (m_pickingGeometry != EPickingGeometry_None)
+    {
+        // valid until the end of the read, for the picking mesh, in case these are the positions of a geometry node
+        m_arrayElements[returnValue] = ArrayElements{data, 3 * n};
+    }
+
+    resourceContainer.addResource(returnValue);
+
+    return const_cast<ramses::Resource*>(returnValue);
+}
+
+void* Reader::readQuantizedVertexArrayResource(EObjectType type, TileResourceContainer& resourceContainer)
+{
+    uint32_t n;
+    read_uint32(n);
+
+    const float* data = readQuantizedArrayElements(type, n);
+
+    // RAMSES vertex attributes are floats, so the dequantized elements are passed
+    const ramses::Resource* returnValue = nullptr;
+    m_sceneLock.lock();
+    if (type == EType_QuantizedVertexArrayResource2f)
+    {
+        returnValue = m_citymodel.getRamsesClient().createConstVector2fArray(n, data);
+    }
+    else
+    {
+        returnValue = m_citymodel.getRamsesClient().createConstVector3fArray(n, data);
+    }
+    m_sceneLock.unlock();
+
+    if (type == EType_QuantizedVertexArrayResource3f && m_pickingGeometry != EPickingGeometry_None)
+    {
+        // valid until the end of the read, for the picking mesh, in case these are the positions of a geometry node
+        m_arrayElements[returnValue] = ArrayElements{data, 3 * n};
+    }
+
     resourceContainer.addResource(returnValue);
 
     return const_cast<ramses::Resource*>(returnValue);
@@ -761,46 +1554,116 @@ void* Reader::readVector4fArrayResource(TileResourceContainer& resourceContainer
     uint32_t n;
     read_uint32(n);
 
-    uint32_t size = sizeof(float) * 4 * n;
-    uint8_t* data = new uint8_t[size];
-    read(data, size);
+    const uint8_t* data = readArrayElements(sizeof(float) * 4 * n);
 
-	m_sceneLock.lock();
+    m_sceneLock.lock();
     const ramses::Resource* returnValue =
-        m_citymodel.getRamsesClient().createConstVector4fArray(n, reinterpret_cast<float*>(data));
+        m_citymodel.getRamsesClient().createConstVector4fArray(n, reinterpret_cast<const float*>(data));
     m_sceneLock.unlock();
 
-    delete[] data;
     resourceContainer.addResource(returnValue);
 
     return const_cast<ramses::Resource*>(returnValue);
 }
 
-const ramses::UInt32Array* Reader::readIndexArrayResource(TileResourceContainer& resourceContainer)
+void* Reader::readIndexArrayResource(EObjectType type, TileResourceContainer& resourceContainer)
 {
     uint32_t n;
     read_uint32(n);
 
-    int      size = sizeof(uint32_t) * n;
-    uint8_t* data = new uint8_t[size];
-    read(data, size);
+    if (type == EType_ShortIndexArrayResource)
+    {
+        const uint8_t* data = readArrayElements(sizeof(uint16_t) * n);
+
+        m_sceneLock.lock();
+        const ramses::UInt16Array* array = m_citymodel.getRamsesClient().createConstUInt16Array(
+            n, reinterpret_cast<const uint16_t*>(data));
+        m_numberOfIndexArrays++;
+        m_numberOfShortIndexArrays++;
+        m_shortIndexSavedSize += sizeof(uint16_t) * n;
+        m_sceneLock.unlock();
+
+        if (m_pickingGeometry != EPickingGeometry_None)
+        {
+            // the picking mesh takes 32 bit indices, valid until the end of the read
+            uint32_t* indices = m_arena.allocateArray<uint32_t>(n);
+            std::copy(reinterpret_cast<const uint16_t*>(data), reinterpret_cast<const uint16_t*>(data) + n, indices);
+            m_arrayElements[array] = ArrayElements{indices, n};
+        }
+        resourceContainer.addResource(array);
+        return const_cast<ramses::UInt16Array*>(array);
+    }
+
+    const uint8_t*  data    = readArrayElements(sizeof(uint32_t) * n);
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(data);
+
+    // the vertices are read before, but not known here, so the indices are narrowed, when all of them fit
+    const bool shortIndices = n == 0 || *std::max_element(indices, indices + n) < RexIndexArray::MaxShortIndexVertices;
+    const ramses::Resource* array = createIndexArray(indices, n, shortIndices, resourceContainer);
+
+    if (m_pickingGeometry != EPickingGeometry_None)
+    {
+        // valid until the end of the read, for the picking mesh
+        m_arrayElements[array] = ArrayElements{data, n};
+    }
+    return const_cast<ramses::Resource*>(array);
+}
 
+const uint32_t* Reader::readShortIndexElements(uint32_t n)
+{
+    const uint16_t* data    = reinterpret_cast<const uint16_t*>(readArrayElements(sizeof(uint16_t) * n));
+    uint32_t*       indices = m_arena.allocateArray<uint32_t>(n);
+    std::copy(data, data + n, indices);
+    return indices;
+}
+
+const ramses::Resource* Reader::createIndexArray(const uint32_t*        indices,
+                                                 uint32_t               numberOfIndices,
+                                                 bool                   shortIndices,
+                                                 TileResourceContainer& resourceContainer)
+{
+    uint16_t* shortIndexData = nullptr;
+    if (shortIndices)
+    {
+        shortIndexData = m_arena.allocateArray<uint16_t>(numberOfIndices);
+        std::copy(indices, indices + numberOfIndices, shortIndexData);
+    }
+
+    const ramses::Resource* array = nullptr;
     m_sceneLock.lock();
-    const ramses::UInt32Array* array = m_citymodel.getRamsesClient().createConstUInt32Array(
-        n, reinterpret_cast<uint32_t*>(data));
+    if (shortIndices)
+    {
+        array = m_citymodel.getRamsesClient().createConstUInt16Array(numberOfIndices, shortIndexData);
+        m_numberOfShortIndexArrays++;
+        m_shortIndexSavedSize += sizeof(uint16_t) * numberOfIndices;
+    }
+    else
+    {
+        array = m_citymodel.getRamsesClient().createConstUInt32Array(numberOfIndices, indices);
+    }
+    m_numberOfIndexArrays++;
     m_sceneLock.unlock();
-    delete[] data;
+
     resourceContainer.addResource(array);
     return array;
 }
 
-ramses::Texture2D* Reader::readTexture2DResource(TileResourceContainer& resourceContainer)
+void Reader::SetIndexArray(GeometryNode& geometryNode, const ramses::Resource* indexArray)
 {
-    uint32_t textureSize;
-    read_uint32(textureSize);
-
-    uint8_t* textureData = read(textureSize);
+    if (indexArray && indexArray->isOfType(ramses::ERamsesObjectType_UInt16Array))
+    {
+        geometryNode.m_shortIndexArray = static_cast<const ramses::UInt16Array*>(indexArray);
+        geometryNode.m_indexArray      = nullptr;
+    }
+    else
+    {
+        geometryNode.m_shortIndexArray = nullptr;
+        geometryNode.m_indexArray      = static_cast<const ramses::UInt32Array*>(indexArray);
+    }
+}
 
+ramses::Texture2D* Reader::readTexture2DResource(TileResourceContainer& resourceContainer, bool mipMaps)
+{
     struct astc_header
     {
         unsigned char magic[4];
@@ -812,24 +1675,157 @@ ramses::Texture2D* Reader::readTexture2DResource(TileResourceContainer& resource
         unsigned char zsize[3];
     };
 
-    astc_header* header = reinterpret_cast<astc_header*>(textureData);
-
-    uint32_t width  = header->xsize[0] + (header->xsize[1] << 8) + (header->xsize[2] << 16);
-    uint32_t height = header->ysize[0] + (header->ysize[1] << 8) + (header->ysize[2] << 16);
+    uint8_t* dataEnd        = m_dataBuffer.data() + m_dataBuffer.size();
+    uint32_t numberOfLevels = 1;
+    if (mipMaps)
+    {
+        if (static_cast<size_t>(dataEnd - m_data) >= sizeof(uint32_t))
+        {
+            read_uint32(numberOfLevels);
+        }
+        else
+        {
+            numberOfLevels = 0;
+        }
+        if (numberOfLevels == 0 || numberOfLevels > RexTexture2D::MaxMipLevels)
+        {
+            printf("CReader::readTexture2DResource Invalid number of mip levels %u !!!\n", numberOfLevels);
+            m_data = dataEnd;
+            return nullptr;
+        }
+    }
 
-    const uint32_t       numMipMaps = 1;
-    ramses::MipLevelData mipLevelData(textureSize - sizeof(astc_header), textureData + sizeof(astc_header));
+    // every level is an ASTC file, with its header, the remaining objects are not read after a corrupt texture
+    const uint8_t*  objectData = m_data;
+    const uint8_t** levelData  = m_arena.allocateArray<const uint8_t*>(numberOfLevels);
+    uint32_t*       levelSizes = m_arena.allocateArray<uint32_t>(numberOfLevels);
+    for (uint32_t i = 0; i < numberOfLevels; i++)
+    {
+        levelSizes[i] = 0;
+        if (static_cast<size_t>(dataEnd - m_data) >= sizeof(uint32_t))
+        {
+            read_uint32(levelSizes[i]);
+        }
+        if (levelSizes[i] < sizeof(astc_header) || levelSizes[i] > static_cast<size_t>(dataEnd - m_data))
+        {
+            printf("CReader::readTexture2DResource Texture size %u exceeds object data !!!\n", levelSizes[i]);
+            m_data = dataEnd;
+            return nullptr;
+        }
+        levelData[i] = read(levelSizes[i]);
+    }
 
+    const TextureCache::Key key = TextureCache::ComputeKey(objectData, m_data - objectData);
     m_sceneLock.lock();
-    ramses::Texture2D* texture = m_citymodel.getRamsesClient().createTexture2D(
-        width, height, ramses::ETextureFormat_ASTC_RGBA_12x12, numMipMaps, &mipLevelData, false);
+    ramses::Texture2D* cachedTexture = m_textureCache.acquire(key);
+    if (cachedTexture)
+    {
+        resourceContainer.addCachedTexture(cachedTexture, m_textureCache);
+        resourceContainer.addTextureUse(cachedTexture, m_textureResidency);
+    }
     m_sceneLock.unlock();
+    if (cachedTexture)
+    {
+        return cachedTexture;
+    }
 
-    resourceContainer.addResource(texture);
+    std::vector<uint32_t> widths(numberOfLevels);
+    std::vector<uint32_t> heights(numberOfLevels);
+    for (uint32_t i = 0; i < numberOfLevels; i++)
+    {
+        const astc_header* header = reinterpret_cast<const astc_header*>(levelData[i]);
+
+        widths[i]  = header->xsize[0] + (header->xsize[1] << 8) + (header->xsize[2] << 16);
+        heights[i] = header->ysize[0] + (header->ysize[1] << 8) + (header->ysize[2] << 16);
+    }
+
+    // with the texture residency, only the coarse levels are created here, the finer ones when the camera gets near
+    const uint32_t coarseLevel = m_textureResidency.getCoarseLevel(widths, heights);
+
+    ramses::MipLevelData* mipLevelData = m_arena.allocateArray<ramses::MipLevelData>(numberOfLevels - coarseLevel);
+    for (uint32_t i = coarseLevel; i < numberOfLevels; i++)
+    {
+        new (&mipLevelData[i - coarseLevel]) ramses::MipLevelData(levelSizes[i] - sizeof(astc_header), levelData[i] + sizeof(astc_header));
+    }
+
+    m_sceneLock.lock();
+    ramses::Texture2D* texture = m_citymodel.getRamsesClient().createTexture2D(widths[coarseLevel],
+                                                                              heights[coarseLevel],
+                                                                              ramses::ETextureFormat_ASTC_RGBA_12x12,
+                                                                              numberOfLevels - coarseLevel,
+                                                                              mipLevelData,
+                                                                              false);
+    m_textureCache.add(key, texture);
+    resourceContainer.addCachedTexture(texture, m_textureCache);
+    if (coarseLevel > 0)
+    {
+        // the finer levels are read again from the object, when they are needed
+        TextureResidency::LevelSource source;
+        source.objectIndex = m_objectIndex;
+        for (uint32_t i = 0; i < numberOfLevels; i++)
+        {
+            source.offsets.push_back(static_cast<uint32_t>(levelData[i] + sizeof(astc_header) - m_dataBuffer.data()));
+            source.sizes.push_back(levelSizes[i] - static_cast<uint32_t>(sizeof(astc_header)));
+        }
+        m_textureResidency.addTexture(texture, coarseLevel, widths, heights, std::move(source));
+        resourceContainer.addTextureUse(texture, m_textureResidency);
+    }
+    m_sceneLock.unlock();
 
     return texture;
 }
 
+void Reader::readTextureLevels(uint32_t objectIndex, const std::vector<TextureResidency::UpgradeRequest>& requests)
+{
+    std::vector<uint8_t> data;
+    const bool           objectRead = m_archive.read(objectIndex, data);
+    if (!objectRead)
+    {
+        printf("CReader::readTextureLevels Failed to read the texture levels of object %u !!!\n", objectIndex);
+    }
+
+    for (const TextureResidency::UpgradeRequest& upgrade : requests)
+    {
+        TextureResidency::LevelSource source;
+        uint32_t                      width  = 0;
+        uint32_t                      height = 0;
+        m_sceneLock.lock();
+        const bool requested = m_textureResidency.getLevelSource(upgrade.texture, upgrade.request, source, width, height);
+        m_sceneLock.unlock();
+        if (!requested)
+        {
+            continue;
+        }
+
+        bool success = objectRead;
+        for (uint32_t i = 0; success && i < source.offsets.size(); i++)
+        {
+            success = static_cast<uint64_t>(source.offsets[i]) + source.sizes[i] <= data.size();
+        }
+
+        std::vector<ramses::MipLevelData> mipLevelData;
+        for (uint32_t i = 0; success && i < source.offsets.size(); i++)
+        {
+            mipLevelData.push_back(ramses::MipLevelData(source.sizes[i], data.data() + source.offsets[i]));
+        }
+
+        m_sceneLock.lock();
+        ramses::Texture2D* fineTexture = nullptr;
+        if (success)
+        {
+            fineTexture = m_citymodel.getRamsesClient().createTexture2D(width,
+                                                                       height,
+                                                                       ramses::ETextureFormat_ASTC_RGBA_12x12,
+                                                                       static_cast<uint32_t>(mipLevelData.size()),
+                                                                       mipLevelData.data(),
+                                                                       false);
+        }
+        m_textureResidency.completeUpgrade(
+            upgrade.texture, upgrade.request, fineTexture, m_citymodel.getRamsesClient(), m_citymodel.getRamsesScene());
+        m_sceneLock.unlock();
+    }
+}
+
 uint32_t Reader::createId()
 {
     uint32_t i = static_cast<uint32_t>(m_object.size());
@@ -896,9 +1892,143 @@ ramses::Effect* Reader::getEffect(uint32_t effectNumber)
 
 void Reader::addEffect(ramses::Effect* effect)
 {
+    // the inputs are looked up once here, instead of for each mesh and material read
+    EffectInputs inputs;
+    inputs.effect = effect;
+    effect->findAttributeInput("a_position", inputs.positions);
+    effect->findAttributeInput("a_normal", inputs.normals);
+    effect->findAttributeInput("a_texcoord", inputs.texCoords);
+    effect->findAttributeInput("a_customAttribute", inputs.texCoords2);
+    effect->findUniformInput("u_texture", inputs.texture);
+    effect->findUniformInput("u_color", inputs.color);
+    effect->findUniformInput("u_carPos", inputs.carPos);
+    effect->findUniformInput("u_lightConeScale", inputs.lightConeScale);
+    m_effectInputs.push_back(inputs);
+
     m_effects.push_back(effect);
 }
 
+const Reader::EffectInputs& Reader::getEffectInputs(const ramses::Effect& effect) const
+{
+    for (const EffectInputs& inputs : m_effectInputs)
+    {
+        if (inputs.effect == &effect)
+        {
+            return inputs;
+        }
+    }
+    // all effects of the file are added by addEffect()
+    assert(false);
+    return m_effectInputs.front();
+}
+
+uint32_t Reader::getNumberOfMeshes() const
+{
+    return m_numberOfMeshes;
+}
+
+void Reader::setBatchMeshes(bool batchMeshes)
+{
+    m_batchMeshes = batchMeshes;
+}
+
+void Reader::setPickingGeometry(EPickingGeometry pickingGeometry)
+{
+    m_pickingGeometry = pickingGeometry;
+}
+
+uint32_t Reader::getNumberOfIndexArrays() const
+{
+    return m_numberOfIndexArrays;
+}
+
+uint32_t Reader::getNumberOfShortIndexArrays() const
+{
+    return m_numberOfShortIndexArrays;
+}
+
+uint64_t Reader::getShortIndexSavedSize() const
+{
+    return m_shortIndexSavedSize;
+}
+
+uint64_t Reader::getPickingGeometrySize() const
+{
+    return m_pickingGeometrySize;
+}
+
+uint64_t Reader::getArraySize() const
+{
+    return m_arraySize;
+}
+
+uint64_t Reader::getCopiedArraySize() const
+{
+    return m_copiedArraySize;
+}
+
+void Reader::setDecodeArena(bool enabled)
+{
+    m_arena.setEnabled(enabled);
+}
+
+#ifdef RAMSES_CITYMODEL_COUNT_ALLOCATIONS
+uint64_t Reader::getNumberOfAllocations() const
+{
+    return m_numberOfAllocations;
+}
+#endif
+
+size_t Reader::getDecodeArenaSize() const
+{
+    return m_decodeArenaSize;
+}
+
+const GeometryDecodeStatistics& Reader::getCTMDecodeStatistics() const
+{
+    return m_ctmDecodeStatistics;
+}
+
+const GeometryDecodeStatistics& Reader::getCachedDecodeStatistics() const
+{
+    return m_cachedDecodeStatistics;
+}
+
+const DiskCacheStatistics& Reader::getGeometryCacheStatistics() const
+{
+    return m_geometryCacheStatistics;
+}
+
+const GeometryDecodeStatistics& Reader::getEncodedDecodeStatistics() const
+{
+    return m_encodedDecodeStatistics;
+}
+
+uint32_t Reader::getNumberOfBatchedMeshes() const
+{
+    return m_numberOfBatchedMeshes;
+}
+
+uint32_t Reader::getNumberOfTilesRead() const
+{
+    return m_numberOfTilesRead;
+}
+
+float Reader::getTileReadTime() const
+{
+    return m_tileReadTime;
+}
+
+uint32_t Reader::getNumberOfGeometryBindings() const
+{
+    return m_numberOfGeometryBindings;
+}
+
+float Reader::getMeshCreationTime() const
+{
+    return m_meshCreationTime;
+}
+
 Vector3 Reader::ConvertXYZRotationToZYX(const Vector3& rotationXYZ)
 {
     Vector3 rotationZYX;
@@ -0,0 +1,794 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/RexArchive.h"
+#include "ramses-citymodel/FileTileSource.h"
+#include "ramses-citymodel/HttpTileSource.h"
+#include "ramses-citymodel/XXHash32.h"
+
+#include "algorithm"
+#include "assert.h"
+#include "cstring"
+
+RexArchive::FileReference::FileReference(
+    uint64_t position, uint32_t compressedSize, uint32_t uncompressedSize, bool chunked, ECodec codec, uint32_t checksum)
+    : m_position(position)
+    , m_compressedSize(compressedSize)
+    , m_uncompressedSize(uncompressedSize)
+    , m_chunked(chunked)
+    , m_codec(codec)
+    , m_checksum(checksum)
+{
+}
+
+uint64_t RexArchive::FileReference::position() const
+{
+    return m_position;
+}
+
+uint32_t RexArchive::FileReference::compressedSize() const
+{
+    return m_compressedSize;
+}
+
+uint32_t RexArchive::FileReference::uncompressedSize() const
+{
+    return m_uncompressedSize;
+}
+
+bool RexArchive::FileReference::chunked() const
+{
+    return m_chunked;
+}
+
+ECodec RexArchive::FileReference::codec() const
+{
+    return m_codec;
+}
+
+uint32_t RexArchive::FileReference::checksum() const
+{
+    return m_checksum;
+}
+
+bool RexArchive::Compress(const std::vector<uint8_t>& data,
+                          ECodec                      codec,
+                          int32_t                     level,
+                          uint32_t                    chunkSize,
+                          std::vector<char>&          stored,
+                          bool&                       chunked)
+{
+    chunked = codec != ECodec_Stored && chunkSize > 0 && data.size() > chunkSize;
+
+    if (!chunked)
+    {
+        stored.resize(RexCodec::GetCompressBound(codec, data.size()));
+        const size_t compressedSize = RexCodec::Compress(codec, level, data.data(), data.size(), stored.data(), stored.size());
+        stored.resize(compressedSize);
+        return compressedSize > 0 || data.empty();
+    }
+
+    const uint32_t numberOfChunks = static_cast<uint32_t>((data.size() + chunkSize - 1) / chunkSize);
+    const size_t   headerSize     = (2 + numberOfChunks) * sizeof(uint32_t);
+    stored.resize(headerSize + static_cast<size_t>(numberOfChunks) * RexCodec::GetCompressBound(codec, chunkSize));
+
+    uint32_t* header = reinterpret_cast<uint32_t*>(stored.data());
+    header[0]        = chunkSize;
+    header[1]        = numberOfChunks;
+
+    size_t position = headerSize;
+    for (uint32_t i = 0; i < numberOfChunks; i++)
+    {
+        const size_t start          = static_cast<size_t>(i) * chunkSize;
+        const size_t size           = std::min<size_t>(chunkSize, data.size() - start);
+        const size_t compressedSize = RexCodec::Compress(codec, level, data.data() + start, size, stored.data() + position, stored.size() - position);
+        if (compressedSize == 0)
+        {
+            return false;
+        }
+        reinterpret_cast<uint32_t*>(stored.data())[2 + i] = static_cast<uint32_t>(compressedSize);
+        position += compressedSize;
+    }
+    stored.resize(position);
+    return true;
+}
+
+void RexArchive::setReadQueue(uint32_t queueDepth, bool useIoUring)
+{
+    m_readQueueDepth = queueDepth;
+    m_useIoUring     = useIoUring;
+}
+
+void RexArchive::setReadCoalescing(uint32_t gapTolerance, uint32_t maximumReadSize)
+{
+    m_gapTolerance    = gapTolerance;
+    m_maximumReadSize = maximumReadSize;
+}
+
+void RexArchive::setTileSource(std::unique_ptr<ITileSource> source)
+{
+    m_source          = std::move(source);
+    m_isDefaultSource = !m_source;
+}
+
+bool RexArchive::open(const std::string& filename)
+{
+    m_asyncReader.reset();
+    m_prefetched.clear();
+    m_coalescedReads.clear();
+    m_objectReferences.clear();
+    m_tileIndex.clear();
+    m_formatVersion = 0;
+    m_hasStartKey   = false;
+    if (m_isDefaultSource)
+    {
+        if (HttpTileSource::IsUrl(filename))
+        {
+            m_source.reset(new HttpTileSource());
+        }
+        else
+        {
+            m_source.reset(new FileTileSource());
+        }
+    }
+    if (!m_source->open(filename))
+    {
+        printf("RexArchive::open Could not open file: %s !!!\n", filename.c_str());
+        return false;
+    }
+    const uint64_t fileSize = m_source->getSize();
+
+    bool isVersioned = false;
+    bool success     = readVersionedTable(fileSize, isVersioned);
+    if (success && !isVersioned)
+    {
+        success = readLegacyTable(fileSize);
+    }
+
+    if (!success)
+    {
+        printf("RexArchive::open Failed to read object table of file: %s !!!\n", filename.c_str());
+        m_objectReferences.clear();
+        m_tileIndex.clear();
+        return false;
+    }
+
+    if (m_readQueueDepth > 0 && m_source->isLocalFile())
+    {
+        // without the read queue, objects are read synchronously, other sources read ahead themselves
+        m_asyncReader.reset(new AsyncFileReader());
+        if (!m_asyncReader->open(filename, m_readQueueDepth, m_useIoUring))
+        {
+            m_asyncReader.reset();
+        }
+    }
+    return true;
+}
+
+bool RexArchive::readVersionedTable(uint64_t fileSize, bool& isVersioned)
+{
+    uint32_t footer[3] = {0, 0, 0};
+    isVersioned        = false;
+    if (fileSize < sizeof(footer))
+    {
+        return true;
+    }
+
+    if (!readFile(fileSize - sizeof(footer), footer, sizeof(footer)) || footer[2] != TableMagic)
+    {
+        return true;
+    }
+    isVersioned = true;
+
+    const uint32_t version         = footer[0];
+    const uint32_t numberOfObjects = footer[1];
+    if (version < 1 || version > FormatVersion)
+    {
+        printf("RexArchive::open Unsupported format version: %u\n", version);
+        return false;
+    }
+    m_formatVersion = version;
+
+    uint32_t numberOfTiles = 0;
+    uint64_t footerSize    = sizeof(footer);
+    uint64_t dataStart     = 0;
+    uint32_t entrySize     = FileReferenceSizeV1;
+    if (version >= 2)
+    {
+        footerSize += sizeof(numberOfTiles);
+        dataStart = HeaderSize;
+        entrySize = VersionedFileReferenceSize;
+        if (fileSize < HeaderSize + footerSize || !readHeader())
+        {
+            return false;
+        }
+        if (!readFile(fileSize - footerSize, &numberOfTiles, sizeof(numberOfTiles)))
+        {
+            return false;
+        }
+    }
+    if (version >= 3)
+    {
+        footerSize += StartKeySize;
+        if (fileSize < HeaderSize + footerSize)
+        {
+            return false;
+        }
+
+        uint32_t startKey[7];
+        if (!readFile(fileSize - footerSize, startKey, sizeof(startKey)))
+        {
+            return false;
+        }
+        const uint32_t flags = startKey[0];
+        float          key[6];
+        memcpy(key, startKey + 1, sizeof(key));
+        m_hasStartKey   = (flags & 1u) != 0;
+        m_startPosition = Vector3(key[0], key[1], key[2]);
+        m_startRotation = Vector3(key[3], key[4], key[5]);
+    }
+
+    const uint64_t tableSize =
+        static_cast<uint64_t>(entrySize) * numberOfObjects + static_cast<uint64_t>(TileIndexEntrySize) * numberOfTiles + footerSize;
+    if (tableSize + dataStart > fileSize)
+    {
+        printf("RexArchive::open Object table exceeds the file, the file is truncated\n");
+        return false;
+    }
+    const uint64_t dataEnd = fileSize - tableSize;
+
+    // the object table and the tile index are read at once, which saves requests for sources like HttpTileSource
+    std::vector<uint8_t> table(static_cast<size_t>(tableSize - footerSize));
+    if (!readFile(dataEnd, table.data(), table.size()))
+    {
+        return false;
+    }
+    size_t offset = 0;
+    auto   take   = [&table, &offset](void* value, size_t size) {
+        memcpy(value, table.data() + offset, size);
+        offset += size;
+    };
+
+    for (uint32_t i = 0; i < numberOfObjects; i++)
+    {
+        uint64_t position;
+        uint32_t storedSize;
+        uint32_t uncompressedSize;
+        uint8_t  codec;
+        uint8_t  flags;
+        uint16_t reserved;
+        uint32_t checksum = 0;
+
+        take(&position, sizeof(position));
+        take(&storedSize, sizeof(storedSize));
+        take(&uncompressedSize, sizeof(uncompressedSize));
+        take(&codec, sizeof(codec));
+        take(&flags, sizeof(flags));
+        take(&reserved, sizeof(reserved));
+        if (version >= 2)
+        {
+            take(&checksum, sizeof(checksum));
+        }
+
+        if (codec >= ECodec_NumberOfCodecs || !RexCodec::IsSupported(static_cast<ECodec>(codec)))
+        {
+            printf("RexArchive::open Object %u uses codec %u, which is not supported by this build\n", i, codec);
+            return false;
+        }
+        if (position < dataStart || position > dataEnd || storedSize > dataEnd - position ||
+            uncompressedSize > MaximumUncompressedSize)
+        {
+            printf("RexArchive::open Object %u exceeds the object data, the file is truncated or corrupt !!!\n", i);
+            return false;
+        }
+
+        m_objectReferences.push_back(FileReference(
+            position, storedSize, uncompressedSize, (flags & ChunkedEntryFlag) != 0, static_cast<ECodec>(codec), checksum));
+    }
+
+    for (uint32_t i = 0; i < numberOfTiles; i++)
+    {
+        TileIndexEntry entry;
+        float          bounds[6];
+        take(&entry.tileId, sizeof(entry.tileId));
+        take(&entry.objectIndex, sizeof(entry.objectIndex));
+        take(bounds, sizeof(bounds));
+        if (entry.objectIndex >= numberOfObjects)
+        {
+            printf("RexArchive::open Tile %u references object %u, which does not exist\n", entry.tileId, entry.objectIndex);
+            return false;
+        }
+        entry.boundingBox = BoundingBox(Vector3(bounds[0], bounds[1], bounds[2]), Vector3(bounds[3], bounds[4], bounds[5]));
+        m_tileIndex.push_back(entry);
+    }
+    return true;
+}
+
+bool RexArchive::readHeader()
+{
+    uint32_t header[4] = {0, 0, 0, 0};
+    if (!readFile(0, header, sizeof(header)) || header[0] != HeaderMagic || header[1] != m_formatVersion)
+    {
+        printf("RexArchive::open Invalid file header\n");
+        return false;
+    }
+    return true;
+}
+
+bool RexArchive::readFile(uint64_t position, void* buffer, uint64_t size)
+{
+    if (size > UINT32_MAX)
+    {
+        return false;
+    }
+    return m_source->read(position, buffer, static_cast<uint32_t>(size));
+}
+
+bool RexArchive::readLegacyTable(uint64_t fileSize)
+{
+    uint32_t numberOfObjects = 0;
+    if (fileSize < sizeof(numberOfObjects))
+    {
+        return false;
+    }
+    if (!readFile(fileSize - sizeof(numberOfObjects), &numberOfObjects, sizeof(numberOfObjects)))
+    {
+        return false;
+    }
+
+    const uint64_t tableSize = static_cast<uint64_t>(FileReferenceSize) * numberOfObjects + sizeof(numberOfObjects);
+    std::vector<uint8_t> table(static_cast<size_t>(tableSize > fileSize ? 0 : tableSize - sizeof(numberOfObjects)));
+    if (tableSize > fileSize || !readFile(fileSize - tableSize, table.data(), table.size()))
+    {
+        return false;
+    }
+
+    const uint64_t dataEnd = fileSize - tableSize;
+    const uint8_t* entry   = table.data();
+    for (uint32_t i = 0; i < numberOfObjects; i++)
+    {
+        uint64_t position;
+        uint32_t compressedSize;
+        uint32_t uncompressedSize;
+
+        memcpy(&position, entry, sizeof(position));
+        memcpy(&compressedSize, entry + sizeof(position), sizeof(compressedSize));
+        memcpy(&uncompressedSize, entry + sizeof(position) + sizeof(compressedSize), sizeof(uncompressedSize));
+        entry += FileReferenceSize;
+
+        const uint32_t storedSize = compressedSize & ~ChunkedFlag;
+        if (position > dataEnd || storedSize > dataEnd - position || uncompressedSize > MaximumUncompressedSize)
+        {
+            printf("RexArchive::open Object %u exceeds the object data, the file is truncated or corrupt !!!\n", i);
+            return false;
+        }
+
+        m_objectReferences.push_back(FileReference(position, storedSize, uncompressedSize, (compressedSize & ChunkedFlag) != 0));
+    }
+    return true;
+}
+
+uint32_t RexArchive::getFormatVersion() const
+{
+    return m_formatVersion;
+}
+
+bool RexArchive::hasChecksums() const
+{
+    return m_formatVersion >= 2;
+}
+
+bool RexArchive::hasAlignedArrays() const
+{
+    return m_formatVersion >= AlignedArraysVersion;
+}
+
+void RexArchive::setVerifyChecksums(bool verify)
+{
+    m_verifyChecksums = verify;
+}
+
+const std::vector<RexArchive::TileIndexEntry>& RexArchive::getTileIndex() const
+{
+    return m_tileIndex;
+}
+
+bool RexArchive::getStartKey(Vector3& carPosition, Vector3& carRotation) const
+{
+    if (m_hasStartKey)
+    {
+        carPosition = m_startPosition;
+        carRotation = m_startRotation;
+    }
+    return m_hasStartKey;
+}
+
+bool RexArchive::findTile(uint32_t tileId, uint32_t& objectIndex) const
+{
+    // tiles are usually written in id order, so the entry is found directly
+    if (tileId < m_tileIndex.size() && m_tileIndex[tileId].tileId == tileId)
+    {
+        objectIndex = m_tileIndex[tileId].objectIndex;
+        return true;
+    }
+    for (const auto& entry : m_tileIndex)
+    {
+        if (entry.tileId == tileId)
+        {
+            objectIndex = entry.objectIndex;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RexArchive::verify(uint32_t index)
+{
+    if (!readStored(index, m_compressedData))
+    {
+        return false;
+    }
+    // readStored() checked the checksum already, when verifying is enabled
+    return m_verifyChecksums || !hasChecksums() || checkChecksum(index, m_compressedData.data(), m_compressedData.size());
+}
+
+bool RexArchive::checkChecksum(uint32_t index, const void* data, size_t size) const
+{
+    const uint32_t checksum = XXHash32::Compute(data, size);
+    if (checksum != getObjectReference(index).checksum())
+    {
+        printf("RexArchive::read Checksum mismatch of object %u, the file is corrupt\n", index);
+        return false;
+    }
+    return true;
+}
+
+const ITileSource* RexArchive::getTileSource() const
+{
+    return m_source.get();
+}
+
+uint32_t RexArchive::getNumberOfObjects() const
+{
+    return static_cast<uint32_t>(m_objectReferences.size());
+}
+
+const RexArchive::FileReference& RexArchive::getObjectReference(uint32_t index) const
+{
+    assert(index < m_objectReferences.size());
+    return m_objectReferences[index];
+}
+
+bool RexArchive::readStored(uint32_t index, std::vector<char>& data)
+{
+    const FileReference& fileRef = getObjectReference(index);
+
+    if (!takePrefetched(index, data))
+    {
+        data.resize(fileRef.compressedSize());
+        m_numberOfReadOperations++;
+        m_readSize += fileRef.compressedSize();
+        if (!readFile(fileRef.position(), data.data(), fileRef.compressedSize()))
+        {
+            printf("RexArchive::read Failed to read object %u\n", index);
+            return false;
+        }
+    }
+    return !m_verifyChecksums || !hasChecksums() || checkChecksum(index, data.data(), data.size());
+}
+
+bool RexArchive::read(uint32_t index, std::vector<uint8_t>& data)
+{
+    const FileReference& fileRef = getObjectReference(index);
+    if (fileRef.codec() == ECodec_Stored && !fileRef.chunked() && m_prefetched.find(index) == m_prefetched.end())
+    {
+        // uncompressed objects are read directly into the destination
+        if (fileRef.compressedSize() != fileRef.uncompressedSize())
+        {
+            printf("RexArchive::read Stored size of uncompressed object %u differs from its size\n", index);
+            return false;
+        }
+        data.resize(fileRef.uncompressedSize());
+        m_numberOfReadOperations++;
+        m_readSize += fileRef.uncompressedSize();
+        if (!readFile(fileRef.position(), data.data(), fileRef.uncompressedSize()))
+        {
+            printf("RexArchive::read Failed to read object %u\n", index);
+            return false;
+        }
+        return !m_verifyChecksums || !hasChecksums() || checkChecksum(index, data.data(), data.size());
+    }
+
+    if (!readStored(index, m_compressedData))
+    {
+        return false;
+    }
+
+    if (!decompress(fileRef, m_compressedData, data))
+    {
+        printf("RexArchive::read Failed to decompress object %u\n", index);
+        return false;
+    }
+    return true;
+}
+
+void RexArchive::prefetch(const std::vector<uint32_t>& indices)
+{
+    if (!m_source || m_readQueueDepth == 0)
+    {
+        return;
+    }
+
+    // completed reads of objects no longer needed free their place in the queue
+    for (auto it = m_prefetched.begin(); it != m_prefetched.end();)
+    {
+        if (it->second.completed && std::find(indices.begin(), indices.end(), it->first) == indices.end())
+        {
+            m_freeBuffers.push_back(std::move(it->second.data));
+            it = m_prefetched.erase(it);
+            m_numberOfDroppedPrefetches++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // with merging, the queue is refilled once half of it is free, so that there are several objects to merge
+    const bool coalesce = m_maximumReadSize > 0;
+    if (coalesce && 2 * m_prefetched.size() > m_readQueueDepth && !indices.empty() &&
+        m_prefetched.find(indices.front()) != m_prefetched.end())
+    {
+        return;
+    }
+
+    m_slices.clear();
+    for (uint32_t index : indices)
+    {
+        if (m_prefetched.size() + m_slices.size() >= m_readQueueDepth)
+        {
+            break;
+        }
+        if (index >= m_objectReferences.size() || m_prefetched.find(index) != m_prefetched.end() ||
+            std::find_if(m_slices.begin(), m_slices.end(), [index](const ReadPlanner::Slice& slice) {
+                return slice.index == index;
+            }) != m_slices.end())
+        {
+            continue;
+        }
+
+        const FileReference& fileRef = m_objectReferences[index];
+        ReadPlanner::Slice   slice;
+        slice.index    = index;
+        slice.position = fileRef.position();
+        slice.size     = fileRef.compressedSize();
+        m_slices.push_back(slice);
+    }
+
+    if (!m_asyncReader)
+    {
+        // sources other than local files fetch the objects themselves
+        m_source->prefetch(m_slices);
+        return;
+    }
+
+    ReadPlanner::Plan(coalesce ? m_gapTolerance : 0, m_maximumReadSize, m_slices, m_reads);
+
+    for (const auto& read : m_reads)
+    {
+        std::vector<char> buffer;
+        if (!m_freeBuffers.empty())
+        {
+            buffer.swap(m_freeBuffers.back());
+            m_freeBuffers.pop_back();
+        }
+        buffer.resize(read.size);
+
+        // a single object is read directly into its buffer, the data of a merged read is copied when it completes
+        uint64_t id = m_slices[read.firstSlice].index;
+        if (read.numberOfSlices > 1)
+        {
+            id = m_nextReadId++ | CoalescedReadFlag;
+        }
+        if (!m_asyncReader->submit(id, read.position, buffer.data(), read.size))
+        {
+            m_freeBuffers.push_back(std::move(buffer));
+            break;
+        }
+        m_numberOfReadOperations++;
+        m_readSize += read.size;
+
+        if (read.numberOfSlices > 1)
+        {
+            CoalescedRead& coalescedRead = m_coalescedReads[id];
+            coalescedRead.data.swap(buffer);
+            coalescedRead.position = read.position;
+            coalescedRead.objects.clear();
+            for (uint32_t i = 0; i < read.numberOfSlices; i++)
+            {
+                const uint32_t index = m_slices[read.firstSlice + i].index;
+                coalescedRead.objects.push_back(index);
+                m_prefetched[index];
+            }
+        }
+        else
+        {
+            m_prefetched[static_cast<uint32_t>(id)].data.swap(buffer);
+        }
+    }
+}
+
+bool RexArchive::takePrefetched(uint32_t index, std::vector<char>& data)
+{
+    auto it = m_prefetched.find(index);
+    if (it == m_prefetched.end())
+    {
+        return false;
+    }
+
+    // completions of other objects are recorded, their data is taken when they are read
+    AsyncFileReader::Completion completion;
+    while (!it->second.completed && m_asyncReader->wait(completion))
+    {
+        completeRead(completion);
+    }
+
+    const bool success = it->second.completed && it->second.success;
+    if (success)
+    {
+        data.swap(it->second.data);
+        m_numberOfPrefetchedReads++;
+    }
+    else
+    {
+        printf("RexArchive::read Failed to read ahead object %u, reading it again\n", index);
+    }
+    m_freeBuffers.push_back(std::move(it->second.data));
+    m_prefetched.erase(it);
+    return success;
+}
+
+void RexArchive::completeRead(const AsyncFileReader::Completion& completion)
+{
+    if ((completion.id & CoalescedReadFlag) == 0)
+    {
+        auto completed = m_prefetched.find(static_cast<uint32_t>(completion.id));
+        if (completed != m_prefetched.end())
+        {
+            completed->second.completed = true;
+            completed->second.success   = completion.success;
+        }
+        return;
+    }
+
+    auto read = m_coalescedReads.find(completion.id);
+    if (read == m_coalescedReads.end())
+    {
+        return;
+    }
+    for (uint32_t index : read->second.objects)
+    {
+        auto completed = m_prefetched.find(index);
+        if (completed == m_prefetched.end())
+        {
+            continue;
+        }
+
+        PrefetchedObject&    object  = completed->second;
+        const FileReference& fileRef = m_objectReferences[index];
+        object.completed             = true;
+        object.success               = completion.success;
+        if (completion.success)
+        {
+            if (!m_freeBuffers.empty())
+            {
+                object.data.swap(m_freeBuffers.back());
+                m_freeBuffers.pop_back();
+            }
+            object.data.resize(fileRef.compressedSize());
+            memcpy(object.data.data(),
+                   read->second.data.data() + (fileRef.position() - read->second.position),
+                   fileRef.compressedSize());
+        }
+    }
+    m_freeBuffers.push_back(std::move(read->second.data));
+    m_coalescedReads.erase(read);
+}
+
+bool RexArchive::usesIoUring() const
+{
+    return m_asyncReader && m_asyncReader->usesIoUring();
+}
+
+uint32_t RexArchive::getNumberOfPrefetchedReads() const
+{
+    return m_numberOfPrefetchedReads;
+}
+
+uint32_t RexArchive::getNumberOfDroppedPrefetches() const
+{
+    return m_numberOfDroppedPrefetches;
+}
+
+uint32_t RexArchive::getNumberOfReadOperations() const
+{
+    return m_numberOfReadOperations;
+}
+
+uint64_t RexArchive::getReadSize() const
+{
+    return m_readSize;
+}
+
+bool RexArchive::decompress(const FileReference& fileRef, const std::vector<char>& stored, std::vector<uint8_t>& data)
+{
+    if (fileRef.chunked())
+    {
+        return decompressChunks(fileRef, stored, data);
+    }
+
+    data.resize(fileRef.uncompressedSize());
+    return RexCodec::Decompress(fileRef.codec(), stored.data(), stored.size(), data.data(), data.size());
+}
+
+bool RexArchive::decompressChunks(const FileReference& fileRef, const std::vector<char>& stored, std::vector<uint8_t>& data)
+{
+    data.resize(fileRef.uncompressedSize());
+
+    uint32_t chunkSize      = 0;
+    uint32_t numberOfChunks = 0;
+    if (stored.size() >= 2 * sizeof(uint32_t))
+    {
+        memcpy(&chunkSize, stored.data(), sizeof(chunkSize));
+        memcpy(&numberOfChunks, stored.data() + sizeof(chunkSize), sizeof(numberOfChunks));
+    }
+
+    const uint64_t headerSize = (2 + static_cast<uint64_t>(numberOfChunks)) * sizeof(uint32_t);
+    if (chunkSize == 0 || numberOfChunks == 0 || headerSize > stored.size() ||
+        static_cast<uint64_t>(chunkSize) * numberOfChunks < fileRef.uncompressedSize() ||
+        static_cast<uint64_t>(chunkSize) * (numberOfChunks - 1) >= fileRef.uncompressedSize())
+    {
+        printf("RexArchive::read Invalid chunk header\n");
+        return false;
+    }
+
+    std::vector<uint64_t>& chunkPosition = m_chunkPositions;
+    chunkPosition.resize(numberOfChunks + 1);
+    chunkPosition[0] = headerSize;
+    for (uint32_t i = 0; i < numberOfChunks; i++)
+    {
+        uint32_t compressedSize = 0;
+        memcpy(&compressedSize, stored.data() + (2 + i) * sizeof(uint32_t), sizeof(compressedSize));
+        chunkPosition[i + 1] = chunkPosition[i] + compressedSize;
+    }
+    if (chunkPosition[numberOfChunks] > stored.size())
+    {
+        printf("RexArchive::read Chunks exceed the stored data\n");
+        return false;
+    }
+
+    if (!m_workerPool)
+    {
+        m_workerPool.reset(new WorkerPool());
+    }
+
+    std::atomic<bool> success(true);
+    m_workerPool->run(numberOfChunks, [&](uint32_t i) {
+        const uint64_t start = static_cast<uint64_t>(i) * chunkSize;
+        const size_t   size  = static_cast<size_t>(std::min<uint64_t>(chunkSize, fileRef.uncompressedSize() - start));
+        if (!RexCodec::Decompress(fileRef.codec(),
+                                  stored.data() + chunkPosition[i],
+                                  static_cast<size_t>(chunkPosition[i + 1] - chunkPosition[i]),
+                                  data.data() + start,
+                                  size))
+        {
+            success = false;
+        }
+    });
+    return success;
+}
@@ -0,0 +1,161 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/RexCodec.h"
+
+#include "lz4.h"
+#include "lz4hc.h"
+#ifdef RAMSES_CITYMODEL_HAS_ZSTD
+#include "zstd.h"
+#endif
+
+#include "cstdio"
+#include "cstring"
+
+bool RexCodec::IsSupported(ECodec codec)
+{
+    switch (codec)
+    {
+    case ECodec_LZ4:
+    case ECodec_LZ4HC:
+    case ECodec_Stored:
+        return true;
+    case ECodec_Zstd:
+#ifdef RAMSES_CITYMODEL_HAS_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return false;
+    }
+}
+
+const char* RexCodec::GetName(ECodec codec)
+{
+    switch (codec)
+    {
+    case ECodec_LZ4:
+        return "lz4";
+    case ECodec_LZ4HC:
+        return "lz4hc";
+    case ECodec_Zstd:
+        return "zstd";
+    case ECodec_Stored:
+        return "stored";
+    default:
+        return "unknown";
+    }
+}
+
+bool RexCodec::FromName(const std::string& name, ECodec& codec)
+{
+    for (uint32_t i = 0; i < ECodec_NumberOfCodecs; i++)
+    {
+        if (name == GetName(static_cast<ECodec>(i)))
+        {
+            codec = static_cast<ECodec>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t RexCodec::GetCompressBound(ECodec codec, size_t size)
+{
+    switch (codec)
+    {
+    case ECodec_LZ4:
+    case ECodec_LZ4HC:
+        return LZ4_compressBound(static_cast<int>(size));
+#ifdef RAMSES_CITYMODEL_HAS_ZSTD
+    case ECodec_Zstd:
+        return ZSTD_compressBound(size);
+#endif
+    default:
+        return size;
+    }
+}
+
+size_t RexCodec::Compress(ECodec codec, int32_t level, const uint8_t* source, size_t sourceSize, char* destination, size_t destinationCapacity)
+{
+    switch (codec)
+    {
+    case ECodec_LZ4:
+    {
+        const int size = LZ4_compress_default(reinterpret_cast<const char*>(source),
+                                              destination,
+                                              static_cast<int>(sourceSize),
+                                              static_cast<int>(destinationCapacity));
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+    case ECodec_LZ4HC:
+    {
+        const int size = LZ4_compress_HC(reinterpret_cast<const char*>(source),
+                                         destination,
+                                         static_cast<int>(sourceSize),
+                                         static_cast<int>(destinationCapacity),
+                                         level > 0 ? level : LZ4HC_CLEVEL_DEFAULT);
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+#ifdef RAMSES_CITYMODEL_HAS_ZSTD
+    case ECodec_Zstd:
+    {
+        const size_t size = ZSTD_compress(destination, destinationCapacity, source, sourceSize, level > 0 ? level : ZSTD_CLEVEL_DEFAULT);
+        return ZSTD_isError(size) ? 0 : size;
+    }
+#endif
+    case ECodec_Stored:
+    {
+        if (destinationCapacity < sourceSize)
+        {
+            return 0;
+        }
+        memcpy(destination, source, sourceSize);
+        return sourceSize;
+    }
+    default:
+        printf("RexCodec::Compress Codec %s not supported\n", GetName(codec));
+        return 0;
+    }
+}
+
+bool RexCodec::Decompress(ECodec codec, const char* source, size_t sourceSize, uint8_t* destination, size_t destinationSize)
+{
+    switch (codec)
+    {
+    case ECodec_LZ4:
+    case ECodec_LZ4HC:
+    {
+        const int size = LZ4_decompress_safe(source,
+                                             reinterpret_cast<char*>(destination),
+                                             static_cast<int>(sourceSize),
+                                             static_cast<int>(destinationSize));
+        return size == static_cast<int>(destinationSize);
+    }
+#ifdef RAMSES_CITYMODEL_HAS_ZSTD
+    case ECodec_Zstd:
+    {
+        const size_t size = ZSTD_decompress(destination, destinationSize, source, sourceSize);
+        return !ZSTD_isError(size) && size == destinationSize;
+    }
+#endif
+    case ECodec_Stored:
+    {
+        if (sourceSize != destinationSize)
+        {
+            return false;
+        }
+        memcpy(destination, source, sourceSize);
+        return true;
+    }
+    default:
+        printf("RexCodec::Decompress Codec %s not supported\n", GetName(codec));
+        return false;
+    }
+}
@@ -0,0 +1,704 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/RexObjectReader.h"
+#include "ramses-citymodel/MeshCodec.h"
+
+#include "cstring"
+
+bool RexObjectReader::open(const std::string& filename)
+{
+    m_object.clear();
+    m_arraySize          = 0;
+    m_unalignedArraySize = 0;
+    return m_archive.open(filename);
+}
+
+uint32_t RexObjectReader::getNumberOfObjects() const
+{
+    return m_archive.getNumberOfObjects();
+}
+
+RexArchive& RexObjectReader::getArchive()
+{
+    return m_archive;
+}
+
+uint64_t RexObjectReader::getArraySize() const
+{
+    return m_arraySize;
+}
+
+uint64_t RexObjectReader::getUnalignedArraySize() const
+{
+    return m_unalignedArraySize;
+}
+
+RexObjectPtr RexObjectReader::read(uint32_t index, bool resetIds)
+{
+    if (index >= m_archive.getNumberOfObjects() || !m_archive.read(index, m_dataBuffer))
+    {
+        printf("RexObjectReader::read Failed to read object %u\n", index);
+        return nullptr;
+    }
+    return read(m_dataBuffer, resetIds);
+}
+
+RexObjectPtr RexObjectReader::read(const std::vector<uint8_t>& data, bool resetIds)
+{
+    const size_t objectCount = m_object.size();
+
+    m_data      = data.data();
+    m_dataEnd   = data.data() + data.size();
+    m_dataBegin = data.data();
+    m_error     = false;
+
+    RexObjectPtr object = readObject();
+
+    if (m_data != m_dataEnd)
+    {
+        printf("RexObjectReader::read %ld bytes left after reading object\n", static_cast<long>(m_dataEnd - m_data));
+        m_error = true;
+    }
+
+    m_data      = nullptr;
+    m_dataEnd   = nullptr;
+    m_dataBegin = nullptr;
+
+    if (resetIds || m_error)
+    {
+        m_object.resize(objectCount);
+    }
+
+    if (m_error)
+    {
+        return nullptr;
+    }
+    return object;
+}
+
+RexObjectPtr RexObjectReader::readObject()
+{
+    uint32_t valueAsUInt32 = 0;
+    read_uint32(valueAsUInt32);
+    const EObjectType type = static_cast<EObjectType>(valueAsUInt32);
+
+    RexObjectPtr retval;
+
+    switch (type)
+    {
+    case EType_Null:
+    {
+        return nullptr;
+    }
+    case EType_Index:
+    {
+        uint32_t index = 0;
+        read_uint32(index);
+        if (index >= m_object.size())
+        {
+            printf("RexObjectReader::readObject ERROR - id %u out of range mObject.size: %ld\n",
+                   index,
+                   static_cast<long>(m_object.size()));
+            m_error = true;
+            return nullptr;
+        }
+        return m_object[index];
+    }
+    case EType_Node:
+    case EType_MeshNode:
+    case EType_Material:
+    case EType_GeometryNode:
+    case EType_EncodedGeometryNode:
+    case EType_VertexArrayResource2f:
+    case EType_VertexArrayResource3f:
+    case EType_VertexArrayResource4f:
+    case EType_QuantizedVertexArrayResource2f:
+    case EType_QuantizedVertexArrayResource3f:
+    case EType_OctahedralNormalArrayResource:
+    case EType_IndexArrayResource:
+    case EType_ShortIndexArrayResource:
+    case EType_Texture2DResource:
+    case EType_Texture2DMipMapResource:
+    case EType_Scene:
+    case EType_Tile:
+        break;
+    default:
+    {
+        printf("RexObjectReader::readObject Wrong object id: %d !\n", type);
+        m_error = true;
+        return nullptr;
+    }
+    }
+
+    /// Ids are created before the object content is read, same as in Reader.
+    const size_t id = m_object.size();
+    m_object.push_back(nullptr);
+
+    switch (type)
+    {
+    case EType_Node:
+    {
+        std::shared_ptr<RexNode> node(new RexNode());
+        m_object[id] = node;
+        readNode(*node);
+        retval = node;
+        break;
+    }
+    case EType_MeshNode:
+    {
+        std::shared_ptr<RexMeshNode> mesh(new RexMeshNode());
+        m_object[id] = mesh;
+        readMeshNode(*mesh);
+        retval = mesh;
+        break;
+    }
+    case EType_Material:
+    {
+        std::shared_ptr<RexMaterial> material(new RexMaterial());
+        m_object[id] = material;
+        readMaterial(*material);
+        retval = material;
+        break;
+    }
+    case EType_GeometryNode:
+    case EType_EncodedGeometryNode:
+    {
+        std::shared_ptr<RexGeometryNode> geometryNode(new RexGeometryNode(type));
+        m_object[id] = geometryNode;
+        readGeometryNode(*geometryNode);
+        retval = geometryNode;
+        break;
+    }
+    case EType_VertexArrayResource2f:
+    case EType_VertexArrayResource3f:
+    case EType_VertexArrayResource4f:
+    case EType_QuantizedVertexArrayResource2f:
+    case EType_QuantizedVertexArrayResource3f:
+    case EType_OctahedralNormalArrayResource:
+    {
+        std::shared_ptr<RexVertexArray> array(new RexVertexArray(type));
+        m_object[id] = array;
+        readVertexArray(*array);
+        retval = array;
+        break;
+    }
+    case EType_IndexArrayResource:
+    case EType_ShortIndexArrayResource:
+    {
+        std::shared_ptr<RexIndexArray> array(new RexIndexArray(type));
+        m_object[id] = array;
+        readIndexArray(*array);
+        retval = array;
+        break;
+    }
+    case EType_Texture2DResource:
+    case EType_Texture2DMipMapResource:
+    {
+        std::shared_ptr<RexTexture2D> texture(new RexTexture2D(type));
+        m_object[id] = texture;
+        readTexture2D(*texture);
+        retval = texture;
+        break;
+    }
+    case EType_Scene:
+    {
+        std::shared_ptr<RexScene> scene(new RexScene());
+        m_object[id] = scene;
+        readScene(*scene);
+        retval = scene;
+        break;
+    }
+    case EType_Tile:
+    {
+        std::shared_ptr<RexTile> tile(new RexTile());
+        m_object[id] = tile;
+        readTile(*tile);
+        retval = tile;
+        break;
+    }
+    default:
+        break;
+    }
+
+    return retval;
+}
+
+template <typename T>
+std::shared_ptr<T> RexObjectReader::readObjectOfType(const EObjectType* types)
+{
+    RexObjectPtr object = readObject();
+    if (!object)
+    {
+        return nullptr;
+    }
+
+    for (const EObjectType* type = types; *type != EType_Null; type++)
+    {
+        if (object->getType() == *type)
+        {
+            return std::static_pointer_cast<T>(object);
+        }
+    }
+
+    printf("RexObjectReader::readObjectOfType Unexpected object type: %d !\n", object->getType());
+    m_error = true;
+    return nullptr;
+}
+
+void RexObjectReader::readNode(RexNode& node)
+{
+    read(node.m_rotation);
+    read(node.m_translation);
+    read(node.m_scaling);
+
+    static const EObjectType nodeTypes[] = {EType_Node, EType_MeshNode, EType_Null};
+
+    uint32_t childCount = 0;
+    read_uint32(childCount);
+    for (uint32_t i = 0; i < childCount && !m_error; i++)
+    {
+        std::shared_ptr<RexNode> child = readObjectOfType<RexNode>(nodeTypes);
+        if (!child)
+        {
+            printf("RexObjectReader::readNode ERROR - Could not read child node !!!\n");
+            m_error = true;
+        }
+        node.m_children.push_back(child);
+    }
+}
+
+void RexObjectReader::readMeshNode(RexMeshNode& mesh)
+{
+    readNode(mesh);
+
+    read_uint32(mesh.m_startIndex);
+    read_int32(mesh.m_indexCount);
+
+    static const EObjectType materialTypes[] = {EType_Material, EType_Null};
+    mesh.m_material = readObjectOfType<RexMaterial>(materialTypes);
+    if (!mesh.m_material)
+    {
+        printf("RexObjectReader::readMeshNode ERROR - Could not read material !!!\n");
+        m_error = true;
+    }
+
+    read_uint32(mesh.m_renderOrder);
+
+    static const EObjectType geometryTypes[] = {EType_GeometryNode, EType_EncodedGeometryNode, EType_Null};
+    mesh.m_geometry = readObjectOfType<RexGeometryNode>(geometryTypes);
+    if (!mesh.m_geometry)
+    {
+        printf("RexObjectReader::readMeshNode ERROR - Could not read geometry node !!!\n");
+        m_error = true;
+    }
+}
+
+CTMuint RexObjectReader::CTMRead(void* buffer, CTMuint count, void* userData)
+{
+    RexObjectReader* reader = static_cast<RexObjectReader*>(userData);
+    reader->read(buffer, count);
+    return reader->m_error ? 0 : count;
+}
+
+void RexObjectReader::readGeometryNode(RexGeometryNode& geometryNode)
+{
+    read_uint32(geometryNode.m_effect);
+    if (geometryNode.getType() == EType_EncodedGeometryNode)
+    {
+        readEncodedGeometry(geometryNode);
+        return;
+    }
+
+    uint8_t useCTM = 0;
+    read_uint8(useCTM);
+    geometryNode.m_useCTM = useCTM != 0;
+
+    if (geometryNode.m_useCTM)
+    {
+        /// The CTM stream has no size prefix, so its end is found by decoding it.
+        const uint8_t* ctmStart = m_data;
+        try
+        {
+            CTMimporter ctm;
+            ctm.LoadCustom(CTMRead, this);
+            geometryNode.m_ctmVertexCount = ctm.GetInteger(CTM_VERTEX_COUNT);
+            geometryNode.m_ctmIndexCount  = ctm.GetInteger(CTM_TRIANGLE_COUNT) * 3;
+        }
+        catch (ctm_error& e)
+        {
+            printf("RexObjectReader::readGeometryNode ERROR - Could not read CTM data: %s\n", e.what());
+            m_error = true;
+        }
+        geometryNode.m_ctmData.assign(ctmStart, m_data);
+    }
+    else
+    {
+        static const EObjectType positionTypes[] = {EType_VertexArrayResource3f, EType_QuantizedVertexArrayResource3f, EType_Null};
+        static const EObjectType normalTypes[]   = {EType_VertexArrayResource3f, EType_OctahedralNormalArrayResource, EType_Null};
+        static const EObjectType array2fTypes[]  = {EType_VertexArrayResource2f, EType_QuantizedVertexArrayResource2f, EType_Null};
+        static const EObjectType array4fTypes[]  = {EType_VertexArrayResource4f, EType_Null};
+        static const EObjectType indexTypes[]    = {EType_IndexArrayResource, EType_ShortIndexArrayResource, EType_Null};
+
+        geometryNode.m_positions  = readObjectOfType<RexVertexArray>(positionTypes);
+        geometryNode.m_normals    = readObjectOfType<RexVertexArray>(normalTypes);
+        geometryNode.m_texCoords  = readObjectOfType<RexVertexArray>(array2fTypes);
+        geometryNode.m_texCoords2 = readObjectOfType<RexVertexArray>(array4fTypes);
+        geometryNode.m_indices    = readObjectOfType<RexIndexArray>(indexTypes);
+    }
+}
+
+void RexObjectReader::readEncodedGeometry(RexGeometryNode& geometryNode)
+{
+    uint32_t numberOfVertices = 0;
+    uint32_t numberOfIndices  = 0;
+    uint8_t  attributes       = 0;
+    uint32_t indexSize        = 0;
+    read_uint32(numberOfVertices);
+    read_uint32(numberOfIndices);
+    read_uint8(attributes);
+    read_uint32(indexSize);
+
+    const uint32_t components = 3 + ((attributes & MeshCodec::HasNormals) ? 3 : 0) + ((attributes & MeshCodec::HasTexCoords) ? 2 : 0);
+    if (m_error || static_cast<uint64_t>(indexSize) + MeshCodec::GetEncodedVertexSize(numberOfVertices, components) >
+                       static_cast<uint64_t>(m_dataEnd - m_data))
+    {
+        printf("RexObjectReader::readEncodedGeometry ERROR - Unexpected end of object data !!!\n");
+        m_error = true;
+        return;
+    }
+
+    geometryNode.m_indices.reset(new RexIndexArray());
+    geometryNode.m_indices->m_data.resize(numberOfIndices);
+    if (!MeshCodec::DecodeIndices(m_data, indexSize, numberOfIndices, numberOfVertices, geometryNode.m_indices->m_data.data()))
+    {
+        printf("RexObjectReader::readEncodedGeometry ERROR - Invalid index data !!!\n");
+        m_error = true;
+        return;
+    }
+    m_data += indexSize;
+
+    geometryNode.m_positions = readEncodedVertices(EType_VertexArrayResource3f, numberOfVertices);
+    if (attributes & MeshCodec::HasNormals)
+    {
+        geometryNode.m_normals = readEncodedVertices(EType_VertexArrayResource3f, numberOfVertices);
+    }
+    if (attributes & MeshCodec::HasTexCoords)
+    {
+        geometryNode.m_texCoords = readEncodedVertices(EType_VertexArrayResource2f, numberOfVertices);
+    }
+}
+
+std::shared_ptr<RexVertexArray> RexObjectReader::readEncodedVertices(EObjectType type, uint32_t numberOfVertices)
+{
+    std::shared_ptr<RexVertexArray> array(new RexVertexArray(type));
+    const uint32_t                  components = array->getComponents();
+    array->m_data.resize(static_cast<size_t>(numberOfVertices) * components);
+    MeshCodec::DecodeVertices(m_data, numberOfVertices, components, array->m_data.data());
+    m_data += MeshCodec::GetEncodedVertexSize(numberOfVertices, components);
+    return array;
+}
+
+void RexObjectReader::readMaterial(RexMaterial& material)
+{
+    read(material.m_diffuseColor);
+    read_uint32(material.m_effect);
+
+    static const EObjectType textureTypes[] = {EType_Texture2DResource, EType_Texture2DMipMapResource, EType_Null};
+    material.m_texture = readObjectOfType<RexTexture2D>(textureTypes);
+}
+
+void RexObjectReader::readVertexArray(RexVertexArray& array)
+{
+    uint32_t n = 0;
+    read_uint32(n);
+
+    const bool quantized = array.isQuantized();
+    if (quantized && array.getType() != EType_OctahedralNormalArrayResource)
+    {
+        for (uint32_t k = 0; k < array.getComponents(); k++)
+        {
+            read_float(array.m_offset[k]);
+        }
+        for (uint32_t k = 0; k < array.getComponents(); k++)
+        {
+            read_float(array.m_scale[k]);
+        }
+    }
+    skipArrayPadding();
+
+    const uint64_t size = quantized ? static_cast<uint64_t>(n) * array.getQuantizedComponents() * sizeof(uint16_t)
+                                    : static_cast<uint64_t>(n) * array.getComponents() * sizeof(float);
+    if (size > static_cast<uint64_t>(m_dataEnd - m_data))
+    {
+        printf("RexObjectReader::readVertexArray ERROR - Array size %u exceeds object data !!!\n", n);
+        m_error = true;
+        m_data  = m_dataEnd;
+        return;
+    }
+
+    countArray(size);
+    if (quantized)
+    {
+        array.m_quantized.resize(static_cast<size_t>(n) * array.getQuantizedComponents());
+        read(array.m_quantized.data(), size);
+        array.dequantize();
+        return;
+    }
+    array.m_data.resize(static_cast<size_t>(n) * array.getComponents());
+    read(array.m_data.data(), size);
+}
+
+void RexObjectReader::readIndexArray(RexIndexArray& array)
+{
+    uint32_t n = 0;
+    read_uint32(n);
+    skipArrayPadding();
+
+    const bool     shortIndices = array.getType() == EType_ShortIndexArrayResource;
+    const uint64_t size         = static_cast<uint64_t>(n) * (shortIndices ? sizeof(uint16_t) : sizeof(uint32_t));
+    if (size > static_cast<uint64_t>(m_dataEnd - m_data))
+    {
+        printf("RexObjectReader::readIndexArray ERROR - Array size %u exceeds object data !!!\n", n);
+        m_error = true;
+        m_data  = m_dataEnd;
+        return;
+    }
+
+    countArray(size);
+    array.m_data.resize(n);
+    if (shortIndices)
+    {
+        std::vector<uint16_t> values(n);
+        read(values.data(), size);
+        array.m_data.assign(values.begin(), values.end());
+        return;
+    }
+    read(array.m_data.data(), size);
+}
+
+void RexObjectReader::skipArrayPadding()
+{
+    if (!m_archive.hasAlignedArrays())
+    {
+        return;
+    }
+
+    const size_t offset  = static_cast<size_t>(m_data - m_dataBegin) % RexArchive::ArrayAlignment;
+    const size_t padding = offset != 0 ? RexArchive::ArrayAlignment - offset : 0;
+    if (padding > static_cast<size_t>(m_dataEnd - m_data))
+    {
+        printf("RexObjectReader::skipArrayPadding ERROR - Padding exceeds object data !!!\n");
+        m_error = true;
+        m_data  = m_dataEnd;
+        return;
+    }
+    m_data += padding;
+}
+
+void RexObjectReader::countArray(uint64_t size)
+{
+    m_arraySize += size;
+    if (static_cast<size_t>(m_data - m_dataBegin) % RexArchive::ArrayAlignment != 0)
+    {
+        m_unalignedArraySize += size;
+    }
+}
+
+void RexObjectReader::readTexture2D(RexTexture2D& texture)
+{
+    uint32_t numberOfLevels = 1;
+    if (texture.getType() == EType_Texture2DMipMapResource)
+    {
+        read_uint32(numberOfLevels);
+        if (numberOfLevels == 0 || numberOfLevels > RexTexture2D::MaxMipLevels)
+        {
+            printf("RexObjectReader::readTexture2D ERROR - Invalid number of mip levels %u !!!\n", numberOfLevels);
+            m_error = true;
+            m_data  = m_dataEnd;
+            return;
+        }
+        texture.m_mipMaps.resize(numberOfLevels - 1);
+    }
+
+    for (uint32_t i = 0; i < numberOfLevels; i++)
+    {
+        uint32_t textureSize = 0;
+        read_uint32(textureSize);
+
+        if (textureSize > static_cast<uint64_t>(m_dataEnd - m_data))
+        {
+            printf("RexObjectReader::readTexture2D ERROR - Texture size %u exceeds object data !!!\n", textureSize);
+            m_error = true;
+            m_data  = m_dataEnd;
+            return;
+        }
+
+        std::vector<uint8_t>& data = i == 0 ? texture.m_data : texture.m_mipMaps[i - 1];
+        data.resize(textureSize);
+        read(data.data(), textureSize);
+    }
+}
+
+void RexObjectReader::readScene(RexScene& scene)
+{
+    static const EObjectType materialTypes[] = {EType_Material, EType_Null};
+    static const EObjectType tileTypes[]     = {EType_Tile, EType_Null};
+    static const EObjectType nodeTypes[]     = {EType_Node, EType_MeshNode, EType_Null};
+
+    uint32_t n = 0;
+    read_uint32(n);
+    for (uint32_t i = 0; i < n && !m_error; i++)
+    {
+        std::shared_ptr<RexMaterial> material = readObjectOfType<RexMaterial>(materialTypes);
+        if (!material)
+        {
+            printf("RexObjectReader::readScene Could not read material !!!\n");
+            m_error = true;
+        }
+        scene.m_materials.push_back(material);
+    }
+
+    read_uint32(n);
+    for (uint32_t i = 0; i < n && !m_error; i++)
+    {
+        std::shared_ptr<RexTile> tile = readObjectOfType<RexTile>(tileTypes);
+        if (!tile)
+        {
+            printf("RexObjectReader::readScene Could not read tile !!!\n");
+            m_error = true;
+        }
+        scene.m_tiles.push_back(tile);
+    }
+
+    scene.m_carsor = readObjectOfType<RexNode>(nodeTypes);
+
+    read_uint32(n);
+    for (uint32_t i = 0; i < n && !m_error; i++)
+    {
+        Vector3 carPosition;
+        Vector3 carRotation;
+        read(carPosition);
+        read(carRotation);
+        scene.m_animationKeys.push_back(AnimationPath::Key(carPosition, carRotation));
+    }
+
+    read_uint32(n);
+    for (uint32_t i = 0; i < n && !m_error; i++)
+    {
+        std::string name;
+        read_string(name);
+        scene.m_names.push_back(name);
+    }
+
+    read_uint32(n);
+    for (uint32_t i = 0; i < n && !m_error; i++)
+    {
+        Vector3 point;
+        read(point);
+        scene.m_namePoints.push_back(point);
+    }
+
+    read_uint32(n);
+    for (uint32_t i = 0; i < n && !m_error; i++)
+    {
+        Vector3 point;
+        read(point);
+        scene.m_routePoints.push_back(point);
+    }
+}
+
+void RexObjectReader::readTile(RexTile& tile)
+{
+    read(tile.m_boundingBox);
+}
+
+void RexObjectReader::read_uint8(uint8_t& value)
+{
+    read(&value, sizeof(value));
+}
+
+void RexObjectReader::read_uint32(uint32_t& value)
+{
+    read(&value, sizeof(value));
+}
+
+void RexObjectReader::read_int32(int32_t& value)
+{
+    read(&value, sizeof(value));
+}
+
+void RexObjectReader::read_float(float& value)
+{
+    read(&value, sizeof(value));
+}
+
+void RexObjectReader::read_string(std::string& value)
+{
+    uint32_t n = 0;
+    read_uint32(n);
+    if (n > static_cast<uint64_t>(m_dataEnd - m_data))
+    {
+        printf("RexObjectReader::read_string ERROR - String size %u exceeds object data !!!\n", n);
+        m_error = true;
+        m_data  = m_dataEnd;
+        return;
+    }
+    value = std::string(reinterpret_cast<const char*>(m_data), n);
+    m_data += n;
+}
+
+void RexObjectReader::read(Vector3& value)
+{
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    read_float(x);
+    read_float(y);
+    read_float(z);
+    value = Vector3(x, y, z);
+}
+
+void RexObjectReader::read(Vector4& color)
+{
+    float r = 0.0f;
+    float g = 0.0f;
+    float b = 0.0f;
+    float a = 0.0f;
+    read_float(r);
+    read_float(g);
+    read_float(b);
+    read_float(a);
+    color = Vector4(r, g, b, a);
+}
+
+void RexObjectReader::read(BoundingBox& bbox)
+{
+    Vector3 min;
+    Vector3 max;
+    read(min);
+    read(max);
+    bbox.set(min, max);
+}
+
+void RexObjectReader::read(void* dest, uint64_t size)
+{
+    if (size > static_cast<uint64_t>(m_dataEnd - m_data))
+    {
+        if (!m_error)
+        {
+            printf("RexObjectReader::read ERROR - Unexpected end of object data !!!\n");
+        }
+        m_error = true;
+        std::memset(dest, 0, static_cast<size_t>(size));
+        m_data = m_dataEnd;
+        return;
+    }
+    std::memcpy(dest, m_data, static_cast<size_t>(size));
+    m_data += size;
+}
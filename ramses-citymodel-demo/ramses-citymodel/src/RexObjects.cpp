@@ -0,0 +1,179 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/RexObjects.h"
+#include "ramses-citymodel/Math.h"
+#include "ramses-citymodel/VertexQuantization.h"
+
+#include "algorithm"
+#include "assert.h"
+#include "cmath"
+
+RexObject::RexObject(EObjectType type)
+    : m_type(type)
+{
+}
+
+RexObject::~RexObject()
+{
+}
+
+EObjectType RexObject::getType() const
+{
+    return m_type;
+}
+
+RexTexture2D::RexTexture2D(EObjectType type)
+    : RexObject(type)
+{
+    assert(type == EType_Texture2DResource || type == EType_Texture2DMipMapResource);
+}
+
+RexVertexArray::RexVertexArray(EObjectType type)
+    : RexObject(type)
+{
+    assert(type == EType_VertexArrayResource2f || type == EType_VertexArrayResource3f ||
+           type == EType_VertexArrayResource4f || type == EType_QuantizedVertexArrayResource2f ||
+           type == EType_QuantizedVertexArrayResource3f || type == EType_OctahedralNormalArrayResource);
+}
+
+uint32_t RexVertexArray::getComponents() const
+{
+    switch (getType())
+    {
+    case EType_QuantizedVertexArrayResource2f:
+        return 2;
+    case EType_QuantizedVertexArrayResource3f:
+    case EType_OctahedralNormalArrayResource:
+        return 3;
+    default:
+        return static_cast<uint32_t>(getType() - EType_VertexArrayResource2f) + 2;
+    }
+}
+
+uint32_t RexVertexArray::getCount() const
+{
+    return static_cast<uint32_t>(m_data.size() / getComponents());
+}
+
+bool RexVertexArray::isQuantized() const
+{
+    return getType() == EType_QuantizedVertexArrayResource2f || getType() == EType_QuantizedVertexArrayResource3f ||
+           getType() == EType_OctahedralNormalArrayResource;
+}
+
+uint32_t RexVertexArray::getQuantizedComponents() const
+{
+    return getType() == EType_OctahedralNormalArrayResource ? 2 : getComponents();
+}
+
+void RexVertexArray::dequantize()
+{
+    const uint32_t count = static_cast<uint32_t>(m_quantized.size() / getQuantizedComponents());
+    m_data.resize(static_cast<size_t>(count) * getComponents());
+    if (getType() == EType_OctahedralNormalArrayResource)
+    {
+        VertexQuantization::DecodeNormals(reinterpret_cast<const int16_t*>(m_quantized.data()), count, m_data.data());
+    }
+    else
+    {
+        VertexQuantization::Dequantize(m_quantized.data(), count, getComponents(), m_offset, m_scale, m_data.data());
+    }
+}
+
+std::shared_ptr<RexVertexArray> RexVertexArray::Quantize(const RexVertexArray& array, EObjectType type, float& maxError)
+{
+    std::shared_ptr<RexVertexArray> quantized(new RexVertexArray(type));
+    assert(quantized->isQuantized() && !array.isQuantized() && quantized->getComponents() == array.getComponents());
+
+    const uint32_t count = array.getCount();
+    quantized->m_quantized.resize(static_cast<size_t>(count) * quantized->getQuantizedComponents());
+    if (type == EType_OctahedralNormalArrayResource)
+    {
+        VertexQuantization::EncodeNormals(array.m_data.data(), count, reinterpret_cast<int16_t*>(quantized->m_quantized.data()));
+    }
+    else
+    {
+        VertexQuantization::Quantize(
+            array.m_data.data(), count, array.getComponents(), quantized->m_quantized.data(), quantized->m_offset, quantized->m_scale);
+    }
+    quantized->dequantize();
+
+    maxError = 0.0f;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (type == EType_OctahedralNormalArrayResource)
+        {
+            const float* original = &array.m_data[3 * i];
+            const float* restored = &quantized->m_data[3 * i];
+            // the angle from the cross product, acos of the dot product is too imprecise for small angles
+            const float dot    = original[0] * restored[0] + original[1] * restored[1] + original[2] * restored[2];
+            const float crossX = original[1] * restored[2] - original[2] * restored[1];
+            const float crossY = original[2] * restored[0] - original[0] * restored[2];
+            const float crossZ = original[0] * restored[1] - original[1] * restored[0];
+            const float cross  = std::sqrt(crossX * crossX + crossY * crossY + crossZ * crossZ);
+            if (dot != 0.0f || cross != 0.0f)
+            {
+                maxError = std::max(maxError, Math::Rad2Deg(std::atan2(cross, dot)));
+            }
+        }
+        else
+        {
+            const uint32_t components = array.getComponents();
+            for (uint32_t k = 0; k < components; k++)
+            {
+                maxError = std::max(maxError, std::abs(array.m_data[components * i + k] - quantized->m_data[components * i + k]));
+            }
+        }
+    }
+    return quantized;
+}
+
+RexIndexArray::RexIndexArray(EObjectType type)
+    : RexObject(type)
+{
+    assert(type == EType_IndexArrayResource || type == EType_ShortIndexArrayResource);
+}
+
+bool RexIndexArray::fitsShortIndices() const
+{
+    return m_data.empty() || *std::max_element(m_data.begin(), m_data.end()) < MaxShortIndexVertices;
+}
+
+RexGeometryNode::RexGeometryNode(EObjectType type)
+    : RexObject(type)
+{
+    assert(type == EType_GeometryNode || type == EType_EncodedGeometryNode);
+}
+
+RexMaterial::RexMaterial()
+    : RexObject(EType_Material)
+{
+}
+
+RexNode::RexNode(EObjectType type)
+    : RexObject(type)
+    , m_scaling(1.0f, 1.0f, 1.0f)
+{
+    assert(type == EType_Node || type == EType_MeshNode);
+}
+
+RexMeshNode::RexMeshNode()
+    : RexNode(EType_MeshNode)
+{
+}
+
+RexTile::RexTile()
+    : RexObject(EType_Tile)
+{
+}
+
+RexScene::RexScene()
+    : RexObject(EType_Scene)
+{
+}
@@ -0,0 +1,129 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+
+#include "ramses-citymodel/TextureCache.h"
+#include "ramses-citymodel/TextureResidency.h"
+#include "ramses-citymodel/XXHash64.h"
+
+#include "ramses-client-api/RamsesClient.h"
+#include "ramses-client-api/Texture2D.h"
+
+#include "assert.h"
+#include "cstdio"
+
+bool TextureCache::Key::operator<(const Key& other) const
+{
+    if (size != other.size)
+    {
+        return size < other.size;
+    }
+    return hash < other.hash;
+}
+
+TextureCache::Key TextureCache::ComputeKey(const void* data, size_t size)
+{
+    Key key;
+    key.size = static_cast<uint32_t>(size);
+    key.hash = XXHash64::Compute(data, size);
+    return key;
+}
+
+ramses::Texture2D* TextureCache::acquire(const Key& key)
+{
+    m_numberOfRequests++;
+    m_requestedSize += key.size;
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        return nullptr;
+    }
+    it->second.refCount++;
+    m_referencedSize += key.size;
+    return it->second.texture;
+}
+
+void TextureCache::add(const Key& key, ramses::Texture2D* texture)
+{
+    assert(m_entries.find(key) == m_entries.end());
+    m_numberOfCreatedTextures++;
+    m_createdSize += key.size;
+    m_cachedSize += key.size;
+    m_referencedSize += key.size;
+    m_entries[key]  = {texture, 1};
+    m_keys[texture] = key;
+}
+
+void TextureCache::setTextureResidency(TextureResidency* residency)
+{
+    m_textureResidency = residency;
+}
+
+void TextureCache::release(ramses::Texture2D* texture, ramses::RamsesClient& client)
+{
+    auto keyIt = m_keys.find(texture);
+    if (keyIt == m_keys.end())
+    {
+        printf("TextureCache::release ERROR - Texture not cached !!!\n");
+        return;
+    }
+
+    const Key key = keyIt->second;
+    auto      it  = m_entries.find(key);
+    assert(it != m_entries.end() && it->second.refCount > 0);
+    m_referencedSize -= key.size;
+    if (--it->second.refCount > 0)
+    {
+        return;
+    }
+
+    if (m_textureResidency)
+    {
+        m_textureResidency->removeTexture(texture, client);
+    }
+    client.destroy(*texture);
+    m_cachedSize -= key.size;
+
+    m_entries.erase(it);
+    m_keys.erase(keyIt);
+}
+
+uint32_t TextureCache::getNumberOfRequests() const
+{
+    return m_numberOfRequests;
+}
+
+uint32_t TextureCache::getNumberOfCreatedTextures() const
+{
+    return m_numberOfCreatedTextures;
+}
+
+uint32_t TextureCache::getNumberOfCachedTextures() const
+{
+    return static_cast<uint32_t>(m_entries.size());
+}
+
+uint64_t TextureCache::getRequestedSize() const
+{
+    return m_requestedSize;
+}
+
+uint64_t TextureCache::getCreatedSize() const
+{
+    return m_createdSize;
+}
+
+uint64_t TextureCache::getCachedSize() const
+{
+    return m_cachedSize;
+}
+
+uint64_t TextureCache::getReferencedSize() const
+{
+    return m_referencedSize;
+}
@@ -0,0 +1,395 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+
+#include "ramses-citymodel/TextureResidency.h"
+#include "ramses-citymodel/Material.h"
+
+#include "ramses-client-api/Appearance.h"
+#include "ramses-client-api/RamsesClient.h"
+#include "ramses-client-api/Scene.h"
+#include "ramses-client-api/Texture2D.h"
+#include "ramses-client-api/TextureSampler.h"
+
+#include "algorithm"
+#include "assert.h"
+#include "limits"
+#include "set"
+
+void TextureResidency::setBudget(uint64_t budget, float detailDistance)
+{
+    m_budget         = budget;
+    m_detailDistance = detailDistance;
+}
+
+bool TextureResidency::isEnabled() const
+{
+    return m_budget > 0;
+}
+
+uint32_t TextureResidency::getCoarseLevel(const std::vector<uint32_t>& widths, const std::vector<uint32_t>& heights) const
+{
+    if (!isEnabled())
+    {
+        return 0;
+    }
+    uint32_t level = 0;
+    while (level + 1 < widths.size() && std::max(widths[level], heights[level]) > CoarseTextureSize)
+    {
+        level++;
+    }
+    return level;
+}
+
+void TextureResidency::setLevelLoader(const std::function<void(uint32_t, const std::vector<UpgradeRequest>&)>& loader)
+{
+    m_levelLoader = loader;
+}
+
+void TextureResidency::addTexture(ramses::Texture2D*           texture,
+                                  uint32_t                     coarseLevel,
+                                  const std::vector<uint32_t>& widths,
+                                  const std::vector<uint32_t>& heights,
+                                  LevelSource&&                source)
+{
+    assert(m_entries.find(texture) == m_entries.end());
+    assert(coarseLevel < widths.size() && heights.size() == widths.size());
+    assert(source.offsets.size() == widths.size() && source.sizes.size() == widths.size());
+
+    Entry& entry         = m_entries[texture];
+    entry.widths         = widths;
+    entry.heights        = heights;
+    entry.source         = std::move(source);
+    entry.coarseLevel    = coarseLevel;
+    entry.residentLevel  = coarseLevel;
+    entry.fineTexture    = nullptr;
+    entry.pendingRequest = 0;
+    entry.pendingLevel   = coarseLevel;
+    entry.failed         = false;
+
+    m_residentSize += GetSize(entry, coarseLevel);
+    m_fullSize += GetSize(entry, 0);
+    m_changed = true;
+}
+
+void TextureResidency::removeTexture(ramses::Texture2D* texture, ramses::RamsesClient& client)
+{
+    auto it = m_entries.find(texture);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    Entry& entry = it->second;
+    assert(entry.materials.empty());
+    cancelUpgrade(entry);
+    if (entry.fineTexture)
+    {
+        client.destroy(*entry.fineTexture);
+        m_residentSize -= GetSize(entry, entry.residentLevel);
+    }
+    m_residentSize -= GetSize(entry, entry.coarseLevel);
+    m_fullSize -= GetSize(entry, 0);
+    m_entries.erase(it);
+    m_changed = true;
+}
+
+void TextureResidency::addMaterial(Material& material, const ramses::UniformInput& input)
+{
+    auto it = m_entries.find(material.getTexture());
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    // a new material samples the coarse texture, until the next update
+    it->second.materials.push_back({&material, input, nullptr});
+}
+
+void TextureResidency::removeMaterial(Material& material, ramses::Scene& scene)
+{
+    auto it = m_entries.find(material.getTexture());
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    std::vector<MaterialUse>& materials = it->second.materials;
+    for (auto use = materials.begin(); use != materials.end(); ++use)
+    {
+        if (use->material == &material)
+        {
+            if (use->sampler)
+            {
+                material.getAppearance().setInputTexture(use->input, *material.getTextureSampler());
+                scene.destroy(*use->sampler);
+            }
+            materials.erase(use);
+            return;
+        }
+    }
+}
+
+void TextureResidency::addUse(ramses::Texture2D* texture, const Vector3& position)
+{
+    auto it = m_entries.find(texture);
+    if (it != m_entries.end())
+    {
+        it->second.users.push_back(position);
+        m_changed = true;
+    }
+}
+
+void TextureResidency::removeUse(ramses::Texture2D* texture, const Vector3& position)
+{
+    auto it = m_entries.find(texture);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    std::vector<Vector3>& users = it->second.users;
+    for (auto user = users.begin(); user != users.end(); ++user)
+    {
+        if ((*user - position).length() == 0.0f)
+        {
+            users.erase(user);
+            m_changed = true;
+            return;
+        }
+    }
+}
+
+void TextureResidency::update(ramses::RamsesClient& client, ramses::Scene& scene, const Vector3& cameraPosition)
+{
+    if (!isEnabled() || !m_levelLoader)
+    {
+        return;
+    }
+
+    // the levels change only with the distance doubling, so they are computed again after moving a quarter of the
+    // detail distance
+    if (!m_changed && (cameraPosition - m_updatePosition).length() < m_detailDistance * 0.25f)
+    {
+        return;
+    }
+    m_changed        = false;
+    m_updatePosition = cameraPosition;
+
+    struct Candidate
+    {
+        ramses::Texture2D* texture;
+        Entry*             entry;
+        float              distance;
+        uint32_t           level;
+    };
+
+    // the level needed for the nearest tile using the texture
+    std::vector<Candidate> candidates;
+    candidates.reserve(m_entries.size());
+    uint64_t fineSize = 0;
+    for (auto& it : m_entries)
+    {
+        Entry& entry    = it.second;
+        float  distance = std::numeric_limits<float>::max();
+        for (const Vector3& user : entry.users)
+        {
+            distance = std::min(distance, (user - cameraPosition).length());
+        }
+
+        uint32_t level         = entry.failed ? entry.coarseLevel : 0;
+        float    levelDistance = m_detailDistance;
+        while (level < entry.coarseLevel && distance > levelDistance)
+        {
+            level++;
+            levelDistance *= 2.0f;
+        }
+        candidates.push_back({it.first, &entry, distance, level});
+        if (level < entry.coarseLevel)
+        {
+            fineSize += GetSize(entry, level);
+        }
+    }
+
+    // within the budget, the textures farthest away are reduced first
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.distance > b.distance;
+    });
+    for (Candidate& candidate : candidates)
+    {
+        while (fineSize > m_budget && candidate.level < candidate.entry->coarseLevel)
+        {
+            fineSize -= GetSize(*candidate.entry, candidate.level);
+            candidate.level++;
+            if (candidate.level < candidate.entry->coarseLevel)
+            {
+                fineSize += GetSize(*candidate.entry, candidate.level);
+            }
+        }
+    }
+
+    // reductions free memory and are done at once by dropping the finer texture, a coarser level than the finest is
+    // requested again like an upgrade
+    for (Candidate& candidate : candidates)
+    {
+        Entry& entry = *candidate.entry;
+        if (entry.pendingRequest != 0 && entry.pendingLevel != candidate.level)
+        {
+            cancelUpgrade(entry);
+        }
+        if (entry.fineTexture && candidate.level > entry.residentLevel)
+        {
+            setFineTexture(entry, entry.coarseLevel, nullptr, client, scene);
+        }
+    }
+
+    // the nearest textures are refined first, together with the other textures of their object
+    std::set<uint32_t> pendingObjects;
+    for (const auto& it : m_entries)
+    {
+        if (it.second.pendingRequest != 0)
+        {
+            pendingObjects.insert(it.second.source.objectIndex);
+        }
+    }
+    std::map<uint32_t, std::vector<UpgradeRequest>> loads;
+    for (auto candidate = candidates.rbegin(); candidate != candidates.rend(); ++candidate)
+    {
+        Entry& entry = *candidate->entry;
+        if (candidate->level >= entry.residentLevel || entry.pendingRequest != 0)
+        {
+            continue;
+        }
+        const uint32_t objectIndex = entry.source.objectIndex;
+        if (loads.find(objectIndex) == loads.end() && pendingObjects.size() + loads.size() >= MaxPendingLoads)
+        {
+            continue;
+        }
+        if (++m_lastRequest == 0)
+        {
+            m_lastRequest++;
+        }
+        entry.pendingRequest = m_lastRequest;
+        entry.pendingLevel   = candidate->level;
+        loads[objectIndex].push_back({candidate->texture, entry.pendingRequest});
+    }
+    for (const auto& load : loads)
+    {
+        m_levelLoader(load.first, load.second);
+    }
+}
+
+bool TextureResidency::getLevelSource(ramses::Texture2D* texture, uint32_t request, LevelSource& source, uint32_t& width, uint32_t& height) const
+{
+    auto it = m_entries.find(texture);
+    if (it == m_entries.end() || it->second.pendingRequest != request)
+    {
+        return false;
+    }
+
+    const Entry& entry = it->second;
+    source.objectIndex = entry.source.objectIndex;
+    source.offsets.assign(entry.source.offsets.begin() + entry.pendingLevel, entry.source.offsets.end());
+    source.sizes.assign(entry.source.sizes.begin() + entry.pendingLevel, entry.source.sizes.end());
+    width  = entry.widths[entry.pendingLevel];
+    height = entry.heights[entry.pendingLevel];
+    return true;
+}
+
+void TextureResidency::completeUpgrade(ramses::Texture2D*    texture,
+                                       uint32_t              request,
+                                       ramses::Texture2D*    fineTexture,
+                                       ramses::RamsesClient& client,
+                                       ramses::Scene&        scene)
+{
+    auto it = m_entries.find(texture);
+    if (it == m_entries.end() || it->second.pendingRequest != request)
+    {
+        if (fineTexture)
+        {
+            client.destroy(*fineTexture);
+        }
+        return;
+    }
+
+    Entry& entry = it->second;
+    cancelUpgrade(entry);
+    m_changed = true;
+    if (!fineTexture)
+    {
+        entry.failed = true;
+        return;
+    }
+    setFineTexture(entry, entry.pendingLevel, fineTexture, client, scene);
+    m_numberOfUpgrades++;
+}
+
+uint64_t TextureResidency::getResidentSize() const
+{
+    return m_residentSize;
+}
+
+uint64_t TextureResidency::getFullSize() const
+{
+    return m_fullSize;
+}
+
+uint32_t TextureResidency::getNumberOfUpgrades() const
+{
+    return m_numberOfUpgrades;
+}
+
+uint64_t TextureResidency::GetSize(const Entry& entry, uint32_t level)
+{
+    uint64_t size = 0;
+    for (uint32_t i = level; i < entry.source.sizes.size(); i++)
+    {
+        size += entry.source.sizes[i];
+    }
+    return size;
+}
+
+void TextureResidency::setFineTexture(Entry& entry, uint32_t level, ramses::Texture2D* fineTexture, ramses::RamsesClient& client, ramses::Scene& scene)
+{
+    if (fineTexture)
+    {
+        m_residentSize += GetSize(entry, level);
+    }
+
+    for (MaterialUse& use : entry.materials)
+    {
+        ramses::TextureSampler* sampler = nullptr;
+        if (fineTexture)
+        {
+            sampler = scene.createTextureSampler(ramses::ETextureAddressMode_Repeat,
+                                                 ramses::ETextureAddressMode_Repeat,
+                                                 ramses::ETextureSamplingMethod_Linear_MipMapNearest,
+                                                 ramses::ETextureSamplingMethod_Linear,
+                                                 *fineTexture);
+        }
+        use.material->getAppearance().setInputTexture(use.input, sampler ? *sampler : *use.material->getTextureSampler());
+        if (use.sampler)
+        {
+            scene.destroy(*use.sampler);
+        }
+        use.sampler = sampler;
+    }
+
+    if (entry.fineTexture)
+    {
+        client.destroy(*entry.fineTexture);
+        m_residentSize -= GetSize(entry, entry.residentLevel);
+    }
+    entry.fineTexture   = fineTexture;
+    entry.residentLevel = fineTexture ? level : entry.coarseLevel;
+}
+
+void TextureResidency::cancelUpgrade(Entry& entry)
+{
+    entry.pendingRequest = 0;
+}
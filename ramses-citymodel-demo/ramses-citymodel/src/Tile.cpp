@@ -10,6 +10,7 @@
 #include "ramses-citymodel/Citymodel.h"
 #include "ramses-citymodel/Reader.h"
 #include "ramses-citymodel/Timer.h"
+#include "ramses-client-api/MeshNode.h"
 #include "ramses-client-api/Node.h"
 
 #include "assert.h"
@@ -20,6 +21,7 @@ Tile::Tile(const BoundingBox& boundingBox, Citymodel& citymodel, uint32_t index)
     , m_index(index)
 {
     m_center = (m_boundingBox.getMinimumBoxCorner() + m_boundingBox.getMaximumBoxCorner()) * 0.5;
+    m_loadedRamsesResources.setPosition(m_center);
 }
 
 const BoundingBox& Tile::boundingBox() const
@@ -32,6 +34,12 @@ const Vector3& Tile::center() const
     return m_center;
 }
 
+uint32_t Tile::getObjectIndex() const
+{
+    // object 0 is the scene, followed by the nodes of the tiles
+    return m_index + 1;
+}
+
 void Tile::setVisible(bool v)
 {
     assert(m_visible != v);
@@ -63,18 +71,35 @@ void Tile::setVisible(bool v)
             removeTileToRead();
         }
     }
+    updateProxy();
+}
+
+bool Tile::isVisible() const
+{
+    return m_visible;
+}
+
+bool Tile::isQueuedToLoad() const
+{
+    return m_queuedToLoad;
 }
 
 void Tile::loaded()
 {
     m_rootNode   = m_loadedNode;
     m_loadedNode = 0;
+    if (!m_rootNode)
+    {
+        m_queuedToLoad = false;
+        return;
+    }
     if (!m_visible)
     {
         m_rootNode->setVisibility(false);
         addTileToDelete();
     }
     m_queuedToLoad = false;
+    updateProxy();
 }
 
 void Tile::addTileToRead()
@@ -103,6 +128,19 @@ void Tile::removeTileToDelete()
     m_citymodel.removeTileToDelete(this);
 }
 
+void Tile::updateProxy()
+{
+    const bool showProxy = m_visible && !m_rootNode;
+    if (showProxy && !m_proxyNode)
+    {
+        m_proxyNode = m_citymodel.createTileProxy(m_boundingBox);
+    }
+    if (m_proxyNode)
+    {
+        m_proxyNode->setVisibility(showProxy);
+    }
+}
+
 void Tile::decDeleteCounter()
 {
     assert(m_deleteCounter > 0);
@@ -122,13 +160,15 @@ void Tile::decDeleteCounter()
 
 void Tile::doReadNode()
 {
-    void*                 object       = m_citymodel.getReader().read(m_index + 1, m_loadedRamsesResources);
+    void*                 object       = m_citymodel.getReader().read(getObjectIndex(), m_loadedRamsesResources);
     ramses::RamsesObject* ramsesObject = static_cast<ramses::RamsesObject*>(object);
 
     if (!ramsesObject || !ramsesObject->isOfType(ramses::ERamsesObjectType_Node))
     {
-        printf("CTile:readNode Could not read node !!!");
-        exit(1);
+        // the tile stays empty, the demo continues without it
+        printf("CTile:readNode Could not read node of tile %u !!!\n", m_index);
+        m_loadedNode = nullptr;
+        return;
     }
 
     m_loadedNode = static_cast<ramses::Node*>(ramsesObject);
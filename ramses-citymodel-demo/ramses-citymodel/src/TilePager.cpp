@@ -9,6 +9,8 @@
 #include "ramses-citymodel/TilePager.h"
 #include "ramses-citymodel/Tile.h"
 
+#include "algorithm"
+
 TilePager::TilePager()
     : m_thread(TilePager::Run, this)
 {
@@ -29,12 +31,24 @@ void TilePager::terminate()
     }
 }
 
+void TilePager::addJob(const std::function<void()>& job)
+{
+    m_mutex.lock();
+    const bool wasEmpty = m_queue.empty() && m_jobs.empty();
+    m_jobs.push_back(job);
+    if (wasEmpty)
+    {
+        m_nonEmptyCondition.notify_one();
+    }
+    m_mutex.unlock();
+}
+
 void TilePager::add(std::vector<Tile*> tiles)
 {
     if (!tiles.empty())
     {
         m_mutex.lock();
-        bool wasEmpty = m_queue.empty();
+        bool wasEmpty = m_queue.empty() && m_jobs.empty();
         for (uint32_t i = 0; i < tiles.size(); i++)
         {
             m_queue.push_front(tiles[i]);
@@ -72,6 +86,69 @@ void TilePager::remove(Tile* tile)
     }
 }
 
+void TilePager::setPrefetch(uint32_t count, const std::function<void(const std::vector<uint32_t>&)>& prefetch)
+{
+    m_mutex.lock();
+    m_prefetchCount = count;
+    m_prefetch      = prefetch;
+    m_mutex.unlock();
+}
+
+void TilePager::setFocusPosition(const Vector3& position)
+{
+    m_mutex.lock();
+    m_focusPosition    = position;
+    m_hasFocusPosition = true;
+    m_mutex.unlock();
+}
+
+Tile* TilePager::popNext()
+{
+    // the queue is filled at the front, so the tile added first is at the back
+    size_t next = m_queue.size() - 1;
+    if (m_hasFocusPosition)
+    {
+        float nearestDistance = (m_queue[next]->center() - m_focusPosition).length();
+        for (size_t i = 0; i + 1 < m_queue.size(); i++)
+        {
+            const float distance = (m_queue[i]->center() - m_focusPosition).length();
+            if (distance < nearestDistance)
+            {
+                nearestDistance = distance;
+                next            = i;
+            }
+        }
+    }
+
+    Tile* tile = m_queue[next];
+    m_queue.erase(m_queue.begin() + next);
+    return tile;
+}
+
+void TilePager::collectNext(uint32_t count, std::vector<uint32_t>& indices)
+{
+    const size_t n = std::min<size_t>(count, m_queue.size());
+    if (!m_hasFocusPosition)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            indices.push_back(m_queue[m_queue.size() - 1 - i]->getObjectIndex());
+        }
+        return;
+    }
+
+    m_sortedTiles.clear();
+    for (Tile* tile : m_queue)
+    {
+        m_sortedTiles.push_back(std::make_pair((tile->center() - m_focusPosition).length(), tile));
+    }
+    std::partial_sort(m_sortedTiles.begin(), m_sortedTiles.begin() + n, m_sortedTiles.end());
+    for (size_t i = 0; i < n; i++)
+    {
+        indices.push_back(m_sortedTiles[i].second->getObjectIndex());
+    }
+}
+
 void TilePager::get(std::vector<Tile*>& tiles)
 {
     m_mutex.lock();
@@ -99,13 +176,33 @@ void TilePager::run()
 
     while (!m_cancelRequested)
     {
-        m_nonEmptyCondition.wait(lock, [this]{return !this->m_queue.empty() || this->m_cancelRequested;});
-        if (!m_queue.empty())
+        m_nonEmptyCondition.wait(lock, [this]{return !this->m_queue.empty() || !this->m_jobs.empty() || this->m_cancelRequested;});
+        if (!m_jobs.empty())
         {
-            Tile* tile = m_queue.back();
-            m_queue.pop_back();
+            std::function<void()> job = m_jobs.front();
+            m_jobs.pop_front();
+
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+        else if (!m_queue.empty())
+        {
+            Tile* tile = popNext();
+
+            // the tile and the next tiles are read together, the reads of the next tiles complete while it is loaded
+            m_prefetchIndices.clear();
+            if (m_prefetchCount > 0)
+            {
+                m_prefetchIndices.push_back(tile->getObjectIndex());
+                collectNext(m_prefetchCount - 1, m_prefetchIndices);
+            }
 
             lock.unlock();
+            if (!m_prefetchIndices.empty())
+            {
+                m_prefetch(m_prefetchIndices);
+            }
             tile->doReadNode();
             lock.lock();
             m_readTiles.push_back(tile);
@@ -17,7 +17,10 @@
 #include "ramses-client-api/Vector3fArray.h"
 #include "ramses-citymodel/CitymodelScene.h"
 #include "ramses-citymodel/Material.h"
+#include "ramses-citymodel/MaterialCache.h"
 #include "ramses-citymodel/Reader.h"
+#include "ramses-citymodel/TextureCache.h"
+#include "ramses-citymodel/TextureResidency.h"
 
 #include "assert.h"
 
@@ -27,6 +30,11 @@ void TileResourceContainer::addGeometryNode(GeometryNode* geometryNode)
     m_geometryNodes.insert(geometryNode);
 }
 
+bool TileResourceContainer::hasGeometryNode(GeometryNode* geometryNode) const
+{
+    return m_geometryNodes.find(geometryNode) != m_geometryNodes.end();
+}
+
 void TileResourceContainer::destroyGeometryNodes()
 {
     for (GeometryNode* geometryNode : m_geometryNodes)
@@ -51,6 +59,67 @@ void TileResourceContainer::destroyMaterials()
     m_materials.clear();
 }
 
+void TileResourceContainer::addCachedMaterial(Material* material, MaterialCache& cache)
+{
+    assert(nullptr != material);
+    assert(nullptr == m_materialCache || &cache == m_materialCache);
+    m_materialCache = &cache;
+    m_cachedMaterials.push_back(material);
+}
+
+void TileResourceContainer::releaseCachedMaterials(ramses::Scene& scene)
+{
+    for (Material* material : m_cachedMaterials)
+    {
+        m_materialCache->release(material, scene);
+    }
+    m_cachedMaterials.clear();
+}
+
+void TileResourceContainer::addCachedTexture(ramses::Texture2D* texture, TextureCache& cache)
+{
+    assert(nullptr != texture);
+    assert(nullptr == m_textureCache || &cache == m_textureCache);
+    m_textureCache = &cache;
+    m_cachedTextures.push_back(texture);
+}
+
+void TileResourceContainer::releaseCachedTextures(ramses::RamsesClient& client)
+{
+    for (ramses::Texture2D* texture : m_cachedTextures)
+    {
+        m_textureCache->release(texture, client);
+    }
+    m_cachedTextures.clear();
+}
+
+void TileResourceContainer::setPosition(const Vector3& position)
+{
+    m_position    = position;
+    m_hasPosition = true;
+}
+
+void TileResourceContainer::addTextureUse(ramses::Texture2D* texture, TextureResidency& residency)
+{
+    if (!m_hasPosition)
+    {
+        return;
+    }
+    assert(nullptr == m_textureResidency || &residency == m_textureResidency);
+    m_textureResidency = &residency;
+    m_textureResidency->addUse(texture, m_position);
+    m_textureUses.push_back(texture);
+}
+
+void TileResourceContainer::removeTextureUses()
+{
+    for (ramses::Texture2D* texture : m_textureUses)
+    {
+        m_textureResidency->removeUse(texture, m_position);
+    }
+    m_textureUses.clear();
+}
+
 void TileResourceContainer::addResource(const ramses::Resource* resource)
 {
     assert(nullptr != resource);
@@ -90,26 +159,33 @@ void TileResourceContainer::destroy(ramses::RamsesClient& client,
                                     ramses::Scene&        scene,
                                     ramses::RenderGroup&  renderGroup)
 {
+    removeTextureUses();
     destroyMaterials();
     destroyGeometryNodes();
 
     destroyResources(client);
     destroySceneObjects(scene, renderGroup);
+
+    // released after the mesh nodes using the appearances are destroyed
+    releaseCachedMaterials(scene);
+
+    // released after the texture samplers of the materials are destroyed
+    releaseCachedTextures(client);
 }
 
 void TileResourceContainer::computeIntersection(const Vector3& p, const Vector3& d, float& r)
 {
     for (auto geometryNode : m_geometryNodes)
     {
-        const std::vector<Vector3>&  positions     = geometryNode->m_positionsData;
-        const std::vector<uint32_t>& indices       = geometryNode->m_indexData;
-        const uint32_t               numberIndices = static_cast<uint32_t>(indices.size());
-        for (uint32_t i = 0; i < numberIndices; i += 3)
+        const PickingMesh& pickingMesh       = geometryNode->m_pickingMesh;
+        const uint32_t     numberOfTriangles = pickingMesh.getNumberOfTriangles();
+        for (uint32_t i = 0; i < numberOfTriangles; i++)
         {
-            const Vector3& a            = positions[indices[i + 0]];
-            const Vector3& b            = positions[indices[i + 1]];
-            const Vector3& c            = positions[indices[i + 2]];
-            const float    intersection = ComputeIntersectionWithTriangle(p, d, a, b, c);
+            Vector3 a;
+            Vector3 b;
+            Vector3 c;
+            pickingMesh.getTriangle(i, a, b, c);
+            const float intersection = ComputeIntersectionWithTriangle(p, d, a, b, c);
             if (intersection >= 0.0)
             {
                 if (intersection < r)
@@ -0,0 +1,110 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/VertexQuantization.h"
+
+#include "algorithm"
+#include "cmath"
+#include "limits"
+
+void VertexQuantization::Quantize(const float* values,
+                                  uint32_t     count,
+                                  uint32_t     components,
+                                  uint16_t*    quantized,
+                                  float*       offset,
+                                  float*       scale)
+{
+    const float steps = 65535.0f;
+    for (uint32_t k = 0; k < components; k++)
+    {
+        float minimum = std::numeric_limits<float>::max();
+        float maximum = -std::numeric_limits<float>::max();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            minimum = std::min(minimum, values[components * i + k]);
+            maximum = std::max(maximum, values[components * i + k]);
+        }
+        if (count == 0)
+        {
+            minimum = 0.0f;
+            maximum = 0.0f;
+        }
+
+        const float extent = maximum - minimum;
+        offset[k]          = minimum;
+        scale[k]           = extent / steps;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const float value = extent > 0.0f ? (values[components * i + k] - minimum) / extent * steps : 0.0f;
+            quantized[components * i + k] = static_cast<uint16_t>(std::lround(std::min(std::max(value, 0.0f), steps)));
+        }
+    }
+}
+
+void VertexQuantization::Dequantize(const uint16_t* quantized,
+                                    uint32_t        count,
+                                    uint32_t        components,
+                                    const float*    offset,
+                                    const float*    scale,
+                                    float*          values)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t k = 0; k < components; k++)
+        {
+            values[components * i + k] = offset[k] + quantized[components * i + k] * scale[k];
+        }
+    }
+}
+
+void VertexQuantization::EncodeNormals(const float* normals, uint32_t count, int16_t* encoded)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const float x = normals[3 * i];
+        const float y = normals[3 * i + 1];
+        const float z = normals[3 * i + 2];
+
+        // project onto the octahedron |x| + |y| + |z| = 1, the lower half is folded over the diagonals
+        const float length = std::abs(x) + std::abs(y) + std::abs(z);
+        float       u      = length > 0.0f ? x / length : 0.0f;
+        float       v      = length > 0.0f ? y / length : 0.0f;
+        if (z < 0.0f)
+        {
+            const float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+            const float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+            u                   = foldedU;
+            v                   = foldedV;
+        }
+        encoded[2 * i]     = static_cast<int16_t>(std::lround(std::min(std::max(u, -1.0f), 1.0f) * 32767.0f));
+        encoded[2 * i + 1] = static_cast<int16_t>(std::lround(std::min(std::max(v, -1.0f), 1.0f) * 32767.0f));
+    }
+}
+
+void VertexQuantization::DecodeNormals(const int16_t* encoded, uint32_t count, float* normals)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const float u = std::max(encoded[2 * i] / 32767.0f, -1.0f);
+        const float v = std::max(encoded[2 * i + 1] / 32767.0f, -1.0f);
+
+        float       x = u;
+        float       y = v;
+        const float z = 1.0f - std::abs(u) - std::abs(v);
+        if (z < 0.0f)
+        {
+            x = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+            y = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        }
+
+        const float length = std::sqrt(x * x + y * y + z * z);
+        normals[3 * i]     = x / length;
+        normals[3 * i + 1] = y / length;
+        normals[3 * i + 2] = z / length;
+    }
+}
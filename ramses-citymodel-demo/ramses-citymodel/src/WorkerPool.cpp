@@ -0,0 +1,97 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/WorkerPool.h"
+
+WorkerPool::WorkerPool(uint32_t numberOfThreads)
+    : m_nextItem(0)
+{
+    if (numberOfThreads == 0)
+    {
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        numberOfThreads                = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    for (uint32_t i = 0; i < numberOfThreads; i++)
+    {
+        m_threads.push_back(std::thread(&WorkerPool::workerLoop, this));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    m_mutex.lock();
+    m_terminate = true;
+    m_mutex.unlock();
+    m_startCondition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(uint32_t count, const std::function<void(uint32_t)>& task)
+{
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task  = &task;
+    m_count = count;
+    m_nextItem.store(0);
+    m_busyThreads = static_cast<uint32_t>(m_threads.size());
+    m_generation++;
+    lock.unlock();
+    m_startCondition.notify_all();
+
+    processItems();
+
+    lock.lock();
+    m_doneCondition.wait(lock, [this] { return m_busyThreads == 0; });
+    m_task = nullptr;
+}
+
+uint32_t WorkerPool::getNumberOfThreads() const
+{
+    return static_cast<uint32_t>(m_threads.size());
+}
+
+void WorkerPool::workerLoop()
+{
+    uint64_t generation = 0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_startCondition.wait(lock, [this, generation] { return m_terminate || m_generation != generation; });
+        if (m_terminate)
+        {
+            return;
+        }
+        generation = m_generation;
+
+        lock.unlock();
+        processItems();
+        lock.lock();
+
+        if (--m_busyThreads == 0)
+        {
+            m_doneCondition.notify_one();
+        }
+    }
+}
+
+void WorkerPool::processItems()
+{
+    uint32_t item = m_nextItem.fetch_add(1);
+    while (item < m_count)
+    {
+        (*m_task)(item);
+        item = m_nextItem.fetch_add(1);
+    }
+}
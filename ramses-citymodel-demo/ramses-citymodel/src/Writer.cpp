@@ -0,0 +1,591 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/Writer.h"
+#include "ramses-citymodel/MeshCodec.h"
+#include "ramses-citymodel/XXHash32.h"
+
+#include "assert.h"
+
+bool Writer::open(const std::string& filename, bool legacyFormat)
+{
+    m_f.close();
+    m_f.open(filename.c_str(), std::fstream::binary | std::fstream::out | std::fstream::trunc);
+    if (!m_f.good())
+    {
+        printf("Writer::open Could not open file: %s !!!\n", filename.c_str());
+        return false;
+    }
+    m_position = 0;
+    m_objectReferences.clear();
+    m_tileIndex.clear();
+    m_hasStartKey    = false;
+    m_legacyFormat   = legacyFormat;
+    m_formatVersion  = m_alignedArrays ? RexArchive::FormatVersion : RexArchive::AlignedArraysVersion - 1;
+    m_writtenObjects = 0;
+    m_ids.clear();
+    m_object.clear();
+
+    if (!m_legacyFormat)
+    {
+        const uint32_t header[4] = {RexArchive::HeaderMagic, m_formatVersion, 0, 0};
+        m_f.write(reinterpret_cast<const char*>(header), sizeof(header));
+        m_position += sizeof(header);
+    }
+    return m_f.good();
+}
+
+void Writer::setAlignedArrays(bool alignedArrays)
+{
+    m_alignedArrays = alignedArrays;
+}
+
+void Writer::setChunkSize(uint32_t chunkSize)
+{
+    m_chunkSize = chunkSize;
+}
+
+void Writer::setCodec(ECodec codec, int32_t level)
+{
+    m_codec = codec;
+    m_level = level;
+}
+
+void Writer::setSceneIndex(const RexScene& scene)
+{
+    m_hasStartKey = !scene.m_animationKeys.empty();
+    if (m_hasStartKey)
+    {
+        m_startPosition = scene.m_animationKeys[0].getCarPosition();
+        m_startRotation = scene.m_animationKeys[0].getCarRotation();
+    }
+
+    m_tileIndex.clear();
+    for (uint32_t i = 0; i < scene.m_tiles.size(); i++)
+    {
+        RexArchive::TileIndexEntry entry;
+        entry.tileId      = i;
+        entry.objectIndex = i + 1;
+        entry.boundingBox = scene.m_tiles[i]->m_boundingBox;
+        m_tileIndex.push_back(entry);
+    }
+}
+
+bool Writer::write(const RexObjectPtr& object, bool resetIds)
+{
+    serialize(object, resetIds, m_dataBuffer);
+    return writeData(m_dataBuffer);
+}
+
+bool Writer::writeData(const std::vector<uint8_t>& data)
+{
+    return writeData(getNumberOfObjects(), data);
+}
+
+bool Writer::writeData(uint32_t index, const std::vector<uint8_t>& data)
+{
+    bool chunked = false;
+    if (!RexArchive::Compress(data, m_codec, m_level, m_chunkSize, m_compressedData, chunked))
+    {
+        printf("Writer::writeData Failed to compress object %u\n", index);
+        return false;
+    }
+
+    const RexArchive::FileReference reference(
+        0, static_cast<uint32_t>(m_compressedData.size()), static_cast<uint32_t>(data.size()), chunked, m_codec);
+    return writeStoredData(index, reference, m_compressedData);
+}
+
+bool Writer::writeStoredData(uint32_t index, const RexArchive::FileReference& reference, const std::vector<char>& data)
+{
+    assert(data.size() >= reference.compressedSize());
+    if (index >= m_objectReferences.size())
+    {
+        m_objectReferences.resize(index + 1, RexArchive::FileReference(0, 0, 0));
+    }
+    m_objectReferences[index] = RexArchive::FileReference(m_position,
+                                                          reference.compressedSize(),
+                                                          reference.uncompressedSize(),
+                                                          reference.chunked(),
+                                                          reference.codec(),
+                                                          XXHash32::Compute(data.data(), reference.compressedSize()));
+    m_writtenObjects++;
+
+    m_f.write(data.data(), reference.compressedSize());
+    m_position += reference.compressedSize();
+
+    if (!m_f.good())
+    {
+        printf("Writer::writeData Failed to write object %u\n", index);
+        return false;
+    }
+    return true;
+}
+
+void Writer::serialize(const RexObjectPtr& object, bool resetIds, std::vector<uint8_t>& data)
+{
+    const size_t objectCount = m_object.size();
+
+    data.clear();
+    m_data = &data;
+    writeObject(object);
+    m_data = nullptr;
+
+    if (resetIds)
+    {
+        for (size_t i = objectCount; i < m_object.size(); i++)
+        {
+            m_ids.erase(m_object[i].get());
+        }
+        m_object.resize(objectCount);
+    }
+}
+
+bool Writer::close()
+{
+    if (m_writtenObjects != getNumberOfObjects())
+    {
+        printf("Writer::close Only %u of %u objects written !!!\n", m_writtenObjects, getNumberOfObjects());
+        m_f.close();
+        return false;
+    }
+
+    if (m_legacyFormat)
+    {
+        for (const auto& reference : m_objectReferences)
+        {
+            if (reference.codec() != ECodec_LZ4)
+            {
+                printf("Writer::close Legacy format needs LZ4 compression, codec %s is used !!!\n", RexCodec::GetName(reference.codec()));
+                m_f.close();
+                return false;
+            }
+        }
+        writeLegacyTable();
+    }
+    else
+    {
+        writeVersionedTable();
+    }
+
+    const bool success = m_f.good();
+    m_f.close();
+    if (!success)
+    {
+        printf("Writer::close Failed to write file !!!\n");
+    }
+    return success;
+}
+
+void Writer::writeLegacyTable()
+{
+    for (const auto& reference : m_objectReferences)
+    {
+        const uint64_t position         = reference.position();
+        const uint32_t compressedSize   = reference.compressedSize() | (reference.chunked() ? RexArchive::ChunkedFlag : 0);
+        const uint32_t uncompressedSize = reference.uncompressedSize();
+        m_f.write(reinterpret_cast<const char*>(&position), sizeof(position));
+        m_f.write(reinterpret_cast<const char*>(&compressedSize), sizeof(compressedSize));
+        m_f.write(reinterpret_cast<const char*>(&uncompressedSize), sizeof(uncompressedSize));
+        m_position += RexArchive::FileReferenceSize;
+    }
+
+    const uint32_t numberOfObjects = getNumberOfObjects();
+    m_f.write(reinterpret_cast<const char*>(&numberOfObjects), sizeof(numberOfObjects));
+    m_position += sizeof(numberOfObjects);
+}
+
+void Writer::writeVersionedTable()
+{
+    for (const auto& reference : m_objectReferences)
+    {
+        const uint64_t position         = reference.position();
+        const uint32_t storedSize       = reference.compressedSize();
+        const uint32_t uncompressedSize = reference.uncompressedSize();
+        const uint8_t  codec            = static_cast<uint8_t>(reference.codec());
+        const uint8_t  flags            = reference.chunked() ? RexArchive::ChunkedEntryFlag : 0;
+        const uint16_t reserved         = 0;
+        const uint32_t checksum         = reference.checksum();
+        m_f.write(reinterpret_cast<const char*>(&position), sizeof(position));
+        m_f.write(reinterpret_cast<const char*>(&storedSize), sizeof(storedSize));
+        m_f.write(reinterpret_cast<const char*>(&uncompressedSize), sizeof(uncompressedSize));
+        m_f.write(reinterpret_cast<const char*>(&codec), sizeof(codec));
+        m_f.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+        m_f.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+        m_f.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+        m_position += RexArchive::VersionedFileReferenceSize;
+    }
+
+    for (const auto& entry : m_tileIndex)
+    {
+        const Vector3 min       = entry.boundingBox.getMinimumBoxCorner();
+        const Vector3 max       = entry.boundingBox.getMaximumBoxCorner();
+        const float   bounds[6] = {min.getX(), min.getY(), min.getZ(), max.getX(), max.getY(), max.getZ()};
+        m_f.write(reinterpret_cast<const char*>(&entry.tileId), sizeof(entry.tileId));
+        m_f.write(reinterpret_cast<const char*>(&entry.objectIndex), sizeof(entry.objectIndex));
+        m_f.write(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+        m_position += RexArchive::TileIndexEntrySize;
+    }
+
+    const uint32_t flags  = m_hasStartKey ? 1u : 0u;
+    const float    key[6] = {m_startPosition.getX(),
+                          m_startPosition.getY(),
+                          m_startPosition.getZ(),
+                          m_startRotation.getX(),
+                          m_startRotation.getY(),
+                          m_startRotation.getZ()};
+    m_f.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+    m_f.write(reinterpret_cast<const char*>(key), sizeof(key));
+    m_position += RexArchive::StartKeySize;
+
+    const uint32_t footer[4] = {
+        static_cast<uint32_t>(m_tileIndex.size()), m_formatVersion, getNumberOfObjects(), RexArchive::TableMagic};
+    m_f.write(reinterpret_cast<const char*>(footer), sizeof(footer));
+    m_position += sizeof(footer);
+}
+
+uint32_t Writer::getNumberOfObjects() const
+{
+    return static_cast<uint32_t>(m_objectReferences.size());
+}
+
+uint64_t Writer::getFileSize() const
+{
+    return m_position;
+}
+
+void Writer::writeObject(const RexObjectPtr& object)
+{
+    if (!object)
+    {
+        write_uint32(EType_Null);
+        return;
+    }
+
+    auto it = m_ids.find(object.get());
+    if (it != m_ids.end())
+    {
+        write_uint32(EType_Index);
+        write_uint32(it->second);
+        return;
+    }
+
+    /// Ids are created before the object content is written, same as Reader::createId() is called.
+    m_ids[object.get()] = static_cast<uint32_t>(m_object.size());
+    m_object.push_back(object);
+
+    const EObjectType type = object->getType();
+    write_uint32(type);
+
+    switch (type)
+    {
+    case EType_Node:
+        writeNode(static_cast<const RexNode&>(*object));
+        break;
+    case EType_MeshNode:
+        writeMeshNode(static_cast<const RexMeshNode&>(*object));
+        break;
+    case EType_Material:
+        writeMaterial(static_cast<const RexMaterial&>(*object));
+        break;
+    case EType_GeometryNode:
+    case EType_EncodedGeometryNode:
+        writeGeometryNode(static_cast<const RexGeometryNode&>(*object));
+        break;
+    case EType_VertexArrayResource2f:
+    case EType_VertexArrayResource3f:
+    case EType_VertexArrayResource4f:
+    case EType_QuantizedVertexArrayResource2f:
+    case EType_QuantizedVertexArrayResource3f:
+    case EType_OctahedralNormalArrayResource:
+        writeVertexArray(static_cast<const RexVertexArray&>(*object));
+        break;
+    case EType_IndexArrayResource:
+    case EType_ShortIndexArrayResource:
+        writeIndexArray(static_cast<const RexIndexArray&>(*object));
+        break;
+    case EType_Texture2DResource:
+    case EType_Texture2DMipMapResource:
+        writeTexture2D(static_cast<const RexTexture2D&>(*object));
+        break;
+    case EType_Scene:
+        writeScene(static_cast<const RexScene&>(*object));
+        break;
+    case EType_Tile:
+        writeTile(static_cast<const RexTile&>(*object));
+        break;
+    default:
+        printf("Writer::writeObject Unsupported object type: %d !\n", type);
+        assert(false);
+        break;
+    }
+}
+
+void Writer::writeNode(const RexNode& node)
+{
+    write(node.m_rotation);
+    write(node.m_translation);
+    write(node.m_scaling);
+
+    write_uint32(static_cast<uint32_t>(node.m_children.size()));
+    for (const auto& child : node.m_children)
+    {
+        writeObject(child);
+    }
+}
+
+void Writer::writeMeshNode(const RexMeshNode& mesh)
+{
+    writeNode(mesh);
+
+    write_uint32(mesh.m_startIndex);
+    write_int32(mesh.m_indexCount);
+    writeObject(mesh.m_material);
+    write_uint32(mesh.m_renderOrder);
+    writeObject(mesh.m_geometry);
+}
+
+void Writer::writeGeometryNode(const RexGeometryNode& geometryNode)
+{
+    write_uint32(geometryNode.m_effect);
+    if (geometryNode.getType() == EType_EncodedGeometryNode)
+    {
+        writeEncodedGeometry(geometryNode);
+        return;
+    }
+    write_uint8(geometryNode.m_useCTM ? 1 : 0);
+
+    if (geometryNode.m_useCTM)
+    {
+        write(geometryNode.m_ctmData.data(), geometryNode.m_ctmData.size());
+    }
+    else
+    {
+        writeObject(geometryNode.m_positions);
+        writeObject(geometryNode.m_normals);
+        writeObject(geometryNode.m_texCoords);
+        writeObject(geometryNode.m_texCoords2);
+        writeObject(geometryNode.m_indices);
+    }
+}
+
+void Writer::writeEncodedGeometry(const RexGeometryNode& geometryNode)
+{
+    assert(geometryNode.m_positions && geometryNode.m_indices && !geometryNode.m_texCoords2);
+    const uint32_t numberOfVertices = geometryNode.m_positions->getCount();
+    const uint8_t  attributes       = (geometryNode.m_normals ? MeshCodec::HasNormals : 0) |
+                                (geometryNode.m_texCoords ? MeshCodec::HasTexCoords : 0);
+
+    std::vector<uint8_t> indices;
+    MeshCodec::EncodeIndices(geometryNode.m_indices->m_data.data(), static_cast<uint32_t>(geometryNode.m_indices->m_data.size()), indices);
+
+    write_uint32(numberOfVertices);
+    write_uint32(static_cast<uint32_t>(geometryNode.m_indices->m_data.size()));
+    write_uint8(attributes);
+    write_uint32(static_cast<uint32_t>(indices.size()));
+    write(indices.data(), indices.size());
+
+    const RexVertexArray* arrays[] = {geometryNode.m_positions.get(), geometryNode.m_normals.get(), geometryNode.m_texCoords.get()};
+    for (const RexVertexArray* array : arrays)
+    {
+        if (array)
+        {
+            assert(array->getCount() == numberOfVertices);
+            MeshCodec::EncodeVertices(array->m_data.data(), numberOfVertices, array->getComponents(), *m_data);
+        }
+    }
+}
+
+void Writer::writeMaterial(const RexMaterial& material)
+{
+    write(material.m_diffuseColor);
+    write_uint32(material.m_effect);
+    writeObject(material.m_texture);
+}
+
+void Writer::writeVertexArray(const RexVertexArray& array)
+{
+    write_uint32(array.getCount());
+    if (!array.isQuantized())
+    {
+        writeArrayPadding();
+        write(array.m_data.data(), static_cast<uint64_t>(array.getCount()) * array.getComponents() * sizeof(float));
+        return;
+    }
+
+    if (array.getType() != EType_OctahedralNormalArrayResource)
+    {
+        for (uint32_t k = 0; k < array.getComponents(); k++)
+        {
+            write_float(array.m_offset[k]);
+        }
+        for (uint32_t k = 0; k < array.getComponents(); k++)
+        {
+            write_float(array.m_scale[k]);
+        }
+    }
+    writeArrayPadding();
+    write(array.m_quantized.data(), array.m_quantized.size() * sizeof(uint16_t));
+}
+
+void Writer::writeIndexArray(const RexIndexArray& array)
+{
+    write_uint32(static_cast<uint32_t>(array.m_data.size()));
+    writeArrayPadding();
+    if (array.getType() == EType_ShortIndexArrayResource)
+    {
+        assert(array.fitsShortIndices());
+        const std::vector<uint16_t> values(array.m_data.begin(), array.m_data.end());
+        write(values.data(), values.size() * sizeof(uint16_t));
+        return;
+    }
+    write(array.m_data.data(), array.m_data.size() * sizeof(uint32_t));
+}
+
+void Writer::writeArrayPadding()
+{
+    // decided per file, legacy files are never aligned, the option stays set for the next file
+    if (!m_legacyFormat && m_formatVersion >= RexArchive::AlignedArraysVersion)
+    {
+        // offsets are relative to the start of the object data, which the reader decompresses into an aligned buffer
+        while (m_data->size() % RexArchive::ArrayAlignment != 0)
+        {
+            m_data->push_back(0);
+        }
+    }
+}
+
+void Writer::writeTexture2D(const RexTexture2D& texture)
+{
+    // the readers reject textures with more levels, the coarsest levels are left out
+    size_t numberOfMipMaps = texture.m_mipMaps.size();
+    if (numberOfMipMaps + 1 > RexTexture2D::MaxMipLevels)
+    {
+        printf("Writer::writeTexture2D Texture with %u mip levels, only %u are written !!!\n",
+               static_cast<uint32_t>(numberOfMipMaps + 1),
+               RexTexture2D::MaxMipLevels);
+        assert(false);
+        numberOfMipMaps = RexTexture2D::MaxMipLevels - 1;
+    }
+
+    if (texture.getType() == EType_Texture2DMipMapResource)
+    {
+        write_uint32(static_cast<uint32_t>(numberOfMipMaps + 1));
+    }
+    write_uint32(static_cast<uint32_t>(texture.m_data.size()));
+    write(texture.m_data.data(), texture.m_data.size());
+    if (texture.getType() == EType_Texture2DMipMapResource)
+    {
+        for (size_t i = 0; i < numberOfMipMaps; i++)
+        {
+            write_uint32(static_cast<uint32_t>(texture.m_mipMaps[i].size()));
+            write(texture.m_mipMaps[i].data(), texture.m_mipMaps[i].size());
+        }
+    }
+}
+
+void Writer::writeScene(const RexScene& scene)
+{
+    write_uint32(static_cast<uint32_t>(scene.m_materials.size()));
+    for (const auto& material : scene.m_materials)
+    {
+        writeObject(material);
+    }
+
+    write_uint32(static_cast<uint32_t>(scene.m_tiles.size()));
+    for (const auto& tile : scene.m_tiles)
+    {
+        writeObject(tile);
+    }
+
+    writeObject(scene.m_carsor);
+
+    write_uint32(static_cast<uint32_t>(scene.m_animationKeys.size()));
+    for (const auto& key : scene.m_animationKeys)
+    {
+        write(key.getCarPosition());
+        write(key.getCarRotation());
+    }
+
+    write_uint32(static_cast<uint32_t>(scene.m_names.size()));
+    for (const auto& name : scene.m_names)
+    {
+        write_string(name);
+    }
+
+    write_uint32(static_cast<uint32_t>(scene.m_namePoints.size()));
+    for (const auto& point : scene.m_namePoints)
+    {
+        write(point);
+    }
+
+    write_uint32(static_cast<uint32_t>(scene.m_routePoints.size()));
+    for (const auto& point : scene.m_routePoints)
+    {
+        write(point);
+    }
+}
+
+void Writer::writeTile(const RexTile& tile)
+{
+    write(tile.m_boundingBox);
+}
+
+void Writer::write_uint8(uint8_t value)
+{
+    write(&value, sizeof(value));
+}
+
+void Writer::write_uint32(uint32_t value)
+{
+    write(&value, sizeof(value));
+}
+
+void Writer::write_int32(int32_t value)
+{
+    write(&value, sizeof(value));
+}
+
+void Writer::write_float(float value)
+{
+    write(&value, sizeof(value));
+}
+
+void Writer::write_string(const std::string& value)
+{
+    write_uint32(static_cast<uint32_t>(value.size()));
+    write(value.data(), value.size());
+}
+
+void Writer::write(const Vector3& value)
+{
+    write_float(value.getX());
+    write_float(value.getY());
+    write_float(value.getZ());
+}
+
+void Writer::write(const Vector4& color)
+{
+    write_float(color.getX());
+    write_float(color.getY());
+    write_float(color.getZ());
+    write_float(color.getW());
+}
+
+void Writer::write(const BoundingBox& bbox)
+{
+    write(bbox.getMinimumBoxCorner());
+    write(bbox.getMaximumBoxCorner());
+}
+
+void Writer::write(const void* data, uint64_t size)
+{
+    assert(m_data);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_data->insert(m_data->end(), bytes, bytes + size);
+}
@@ -0,0 +1,80 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/XXHash32.h"
+
+uint32_t XXHash32::Compute(const void* data, size_t size, uint32_t seed)
+{
+    const uint8_t* p   = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+    uint32_t       hash;
+
+    if (size >= 16)
+    {
+        uint32_t v1 = seed + Prime1 + Prime2;
+        uint32_t v2 = seed + Prime2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - Prime1;
+
+        const uint8_t* limit = end - 16;
+        do
+        {
+            v1 = Round(v1, Read32(p));
+            v2 = Round(v2, Read32(p + 4));
+            v3 = Round(v3, Read32(p + 8));
+            v4 = Round(v4, Read32(p + 12));
+            p += 16;
+        } while (p <= limit);
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+    }
+    else
+    {
+        hash = seed + Prime5;
+    }
+
+    hash += static_cast<uint32_t>(size);
+
+    while (p + 4 <= end)
+    {
+        hash += Read32(p) * Prime3;
+        hash = RotateLeft(hash, 17) * Prime4;
+        p += 4;
+    }
+    while (p < end)
+    {
+        hash += (*p) * Prime5;
+        hash = RotateLeft(hash, 11) * Prime1;
+        p++;
+    }
+
+    hash ^= hash >> 15;
+    hash *= Prime2;
+    hash ^= hash >> 13;
+    hash *= Prime3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+uint32_t XXHash32::Read32(const uint8_t* data)
+{
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) | (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint32_t XXHash32::RotateLeft(uint32_t value, uint32_t bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+uint32_t XXHash32::Round(uint32_t accumulator, uint32_t value)
+{
+    accumulator += value * Prime2;
+    accumulator = RotateLeft(accumulator, 13);
+    return accumulator * Prime1;
+}
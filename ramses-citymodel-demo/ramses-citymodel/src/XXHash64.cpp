@@ -0,0 +1,101 @@
+//  -------------------------------------------------------------------------
+//  Copyright (C) 2019 Mentor Graphics Development GmbH
+//  -------------------------------------------------------------------------
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//  -------------------------------------------------------------------------
+
+#include "ramses-citymodel/XXHash64.h"
+
+uint64_t XXHash64::Compute(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* p   = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+    uint64_t       hash;
+
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + Prime1 + Prime2;
+        uint64_t v2 = seed + Prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - Prime1;
+
+        const uint8_t* limit = end - 32;
+        do
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+    {
+        hash = seed + Prime5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    while (p + 8 <= end)
+    {
+        hash ^= Round(0, Read64(p));
+        hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+        p += 8;
+    }
+    if (p + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(Read32(p)) * Prime1;
+        hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+        p += 4;
+    }
+    while (p < end)
+    {
+        hash ^= (*p) * Prime5;
+        hash = RotateLeft(hash, 11) * Prime1;
+        p++;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t XXHash64::Read64(const uint8_t* data)
+{
+    return static_cast<uint64_t>(Read32(data)) | (static_cast<uint64_t>(Read32(data + 4)) << 32);
+}
+
+uint32_t XXHash64::Read32(const uint8_t* data)
+{
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) | (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint64_t XXHash64::RotateLeft(uint64_t value, uint32_t bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t XXHash64::Round(uint64_t accumulator, uint64_t value)
+{
+    accumulator += value * Prime2;
+    accumulator = RotateLeft(accumulator, 31);
+    return accumulator * Prime1;
+}
+
+uint64_t XXHash64::MergeRound(uint64_t hash, uint64_t accumulator)
+{
+    hash ^= Round(0, accumulator);
+    return hash * Prime1 + Prime4;
+}
@@ -0,0 +1,10 @@
+#version 100
+
+precision highp float;
+
+varying float v_brightness;
+
+void main(void)
+{
+    gl_FragColor = vec4(v_brightness * vec3(0.8, 0.8, 0.85), 1.0);
+}
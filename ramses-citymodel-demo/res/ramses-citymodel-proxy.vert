@@ -0,0 +1,17 @@
+#version 100
+
+precision highp float;
+
+uniform highp mat4 u_mvpMatrix;
+
+attribute vec3 a_position;
+
+varying float v_brightness;
+
+void main()
+{
+    gl_Position = u_mvpMatrix * vec4(a_position, 1.0);
+
+    // darker at the bottom of the box, the box spans -1 to 1
+    v_brightness = 0.35 + 0.25 * (a_position.z + 1.0);
+}